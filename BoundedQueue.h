@@ -0,0 +1,426 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+// 고정 용량 링 버퍼 큐 (SPSC, MPMC)
+// - 인덱스는 캐시 라인 단위로 분리해서 생산자/소비자 간 false sharing 을 없앰
+// - 데이터 경로는 락이 없고, 대기 중인 스레드가 있을 때만 mutex/condvar 로 깨움
+// - 용량은 2 의 거듭제곱으로 올림
+// - close() 후 push 는 실패하고, pop 은 남은 항목을 모두 꺼낸 뒤 false 를 반환
+
+constexpr size_t kCacheLineSize = 64;
+
+namespace queue_detail {
+
+inline size_t roundUpPowerOfTwo(size_t value) {
+    size_t result = 2;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+// 대기하는 쪽이 있을 때만 락을 잡는 알림 지점
+// 깨우는 쪽이 대기자 수를 0 으로 가져가므로, 깨운 스레드가 실제로 실행되기 전까지의
+// 후속 push/pop 은 다시 락을 잡지 않음
+class alignas(kCacheLineSize) WaitPoint {
+private:
+    std::atomic<int> waiters_{0};
+    uint64_t generation_ = 0;       // mtx_ 보호, notify 마다 증가
+    std::mutex mtx_;
+    std::condition_variable cv_;
+
+public:
+    void notify() {
+        // 항목 발행(release store)과 waiters_ 읽기 사이의 순서를 보장 (waitUntil 의 fence 와 짝).
+        // RMW 대신 fence + load 를 써서 대기자가 없을 때 이 캐시 라인에 쓰지 않음
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(mtx_);
+            if (waiters_.load(std::memory_order_relaxed) > 0) {
+                waiters_.store(0, std::memory_order_relaxed);
+                ++generation_;
+                cv_.notify_all();
+            }
+        }
+    }
+
+    // ready() 가 true 가 되거나 deadline 이 지날 때까지 대기. ready() 결과를 반환
+    template <typename Predicate>
+    bool waitUntil(Predicate ready, std::chrono::steady_clock::time_point deadline) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        while (true) {
+            uint64_t generation = generation_;
+            waiters_.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            bool result = ready();
+            if (!result) {
+                cv_.wait_until(lock, deadline);
+                result = ready();
+            }
+            if (generation_ == generation) {
+                waiters_.fetch_sub(1, std::memory_order_relaxed);   // 아무도 가져가지 않았으면 직접 해제
+            }
+            if (result || std::chrono::steady_clock::now() >= deadline) {
+                return result;
+            }
+        }
+    }
+};
+
+inline std::chrono::steady_clock::time_point deadlineAfter(std::chrono::nanoseconds timeout) {
+    auto now = std::chrono::steady_clock::now();
+    if (timeout >= std::chrono::steady_clock::time_point::max() - now) {
+        return std::chrono::steady_clock::time_point::max();
+    }
+    return now + timeout;
+}
+
+} // namespace queue_detail
+
+// 단일 생산자 / 단일 소비자
+template <typename T>
+class SpscQueue {
+private:
+    const size_t mask_;
+    std::unique_ptr<T[]> slots_;
+
+    alignas(kCacheLineSize) std::atomic<size_t> head_{0};  // 소비자가 다음에 읽을 위치
+    size_t cached_tail_ = 0;                               // 소비자가 마지막으로 본 tail
+    alignas(kCacheLineSize) std::atomic<size_t> tail_{0};  // 생산자가 다음에 쓸 위치
+    size_t cached_head_ = 0;                               // 생산자가 마지막으로 본 head
+    alignas(kCacheLineSize) std::atomic<bool> closed_{false};
+    std::atomic<uint64_t> rejected_{0};
+
+    queue_detail::WaitPoint not_empty_;
+    queue_detail::WaitPoint not_full_;
+
+    size_t freeSlots() {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ > mask_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+        }
+        return mask_ + 1 - (tail - cached_head_);
+    }
+
+    // 막힌 생산자는 절반 이상 비었을 때 깨움 (한 칸마다 깨우면 문맥 전환이 항목 수만큼 생김)
+    void notifyNotFull() {
+        if (size() <= (mask_ + 1) / 2) {
+            not_full_.notify();
+        }
+    }
+
+    size_t readySlots() {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (cached_tail_ == head) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+        }
+        return cached_tail_ - head;
+    }
+
+public:
+    explicit SpscQueue(size_t capacity)
+        : mask_(queue_detail::roundUpPowerOfTwo(capacity) - 1), slots_(new T[mask_ + 1]) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    size_t capacity() const { return mask_ + 1; }
+    size_t size() const { return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire); }
+    bool closed() const { return closed_.load(std::memory_order_acquire); }
+    uint64_t rejected() const { return rejected_.load(std::memory_order_relaxed); }
+
+    // 가득 차 있으면 즉시 false (reject 정책, 버린 개수는 rejected())
+    template <typename U>
+    bool tryPush(U&& value) {
+        if (closed() || freeSlots() == 0) {
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        slots_[tail & mask_] = std::forward<U>(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        not_empty_.notify();
+        return true;
+    }
+
+    // 들어갈 수 있는 만큼 넣고 넣은 개수를 반환 (인덱스 갱신과 알림은 한 번)
+    size_t tryPushBatch(const T* values, size_t count) {
+        if (closed()) {
+            return 0;
+        }
+        size_t n = std::min(count, freeSlots());
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < n; ++i) {
+            slots_[(tail + i) & mask_] = values[i];
+        }
+        if (n > 0) {
+            tail_.store(tail + n, std::memory_order_release);
+            not_empty_.notify();
+        }
+        if (n < count) {
+            rejected_.fetch_add(count - n, std::memory_order_relaxed);
+        }
+        return n;
+    }
+
+    // 자리가 날 때까지 최대 timeout 동안 대기 (block 정책). 닫혔거나 시간 초과면 false
+    template <typename U>
+    bool push(U&& value, std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max()) {
+        if (freeSlots() == 0 &&
+            !not_full_.waitUntil([this] { return closed() || freeSlots() > 0; },
+                                 queue_detail::deadlineAfter(timeout))) {
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return tryPush(std::forward<U>(value));
+    }
+
+    bool tryPop(T& value) {
+        if (readySlots() == 0) {
+            return false;
+        }
+        size_t head = head_.load(std::memory_order_relaxed);
+        value = std::move(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        notifyNotFull();
+        return true;
+    }
+
+    size_t tryPopBatch(T* values, size_t max_count) {
+        size_t n = std::min(max_count, readySlots());
+        size_t head = head_.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < n; ++i) {
+            values[i] = std::move(slots_[(head + i) & mask_]);
+        }
+        if (n > 0) {
+            head_.store(head + n, std::memory_order_release);
+            notifyNotFull();
+        }
+        return n;
+    }
+
+    // 항목이 올 때까지 최대 timeout 동안 대기. 닫히고 비었거나 시간 초과면 false
+    bool pop(T& value, std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max()) {
+        if (tryPop(value)) {
+            return true;
+        }
+        not_empty_.waitUntil([this] { return closed() || readySlots() > 0; }, queue_detail::deadlineAfter(timeout));
+        return tryPop(value);
+    }
+
+    void close() {
+        closed_.store(true, std::memory_order_release);
+        not_empty_.notify();
+        not_full_.notify();
+    }
+};
+
+// 다중 생산자 / 다중 소비자 (슬롯별 sequence 를 쓰는 Vyukov 방식)
+template <typename T>
+class MpmcQueue {
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    alignas(kCacheLineSize) std::atomic<size_t> enqueue_pos_{0};
+    alignas(kCacheLineSize) std::atomic<size_t> dequeue_pos_{0};
+    alignas(kCacheLineSize) std::atomic<bool> closed_{false};
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<uint64_t> overwritten_{0};
+
+    queue_detail::WaitPoint not_empty_;
+    queue_detail::WaitPoint not_full_;
+
+    template <typename U>
+    bool enqueue(U&& value) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells_[pos & mask_];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::forward<U>(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // 가득 참
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool dequeue(T& value) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells_[pos & mask_];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = std::move(cell.value);
+                    cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // 비어 있음
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool hasItems() const {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        return cells_[pos & mask_].sequence.load(std::memory_order_acquire) == pos + 1;
+    }
+
+    void notifyNotFull() {
+        size_t used = enqueue_pos_.load(std::memory_order_relaxed) - dequeue_pos_.load(std::memory_order_relaxed);
+        if (static_cast<intptr_t>(used) <= static_cast<intptr_t>((mask_ + 1) / 2)) {
+            not_full_.notify();
+        }
+    }
+
+    bool hasRoom() const {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        return cells_[pos & mask_].sequence.load(std::memory_order_acquire) == pos;
+    }
+
+public:
+    explicit MpmcQueue(size_t capacity)
+        : mask_(queue_detail::roundUpPowerOfTwo(capacity) - 1), cells_(new Cell[mask_ + 1]) {
+        for (size_t i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    size_t capacity() const { return mask_ + 1; }
+    bool closed() const { return closed_.load(std::memory_order_acquire); }
+    uint64_t rejected() const { return rejected_.load(std::memory_order_relaxed); }
+    uint64_t overwritten() const { return overwritten_.load(std::memory_order_relaxed); }
+    // 동시에 push/pop 이 진행 중이면 근사값 (점유율 보고용)
+    size_t size() const {
+        size_t dequeue = dequeue_pos_.load(std::memory_order_seq_cst);
+        size_t enqueue = enqueue_pos_.load(std::memory_order_seq_cst);
+        return enqueue > dequeue ? std::min(enqueue - dequeue, mask_ + 1) : 0;
+    }
+
+    // reject 정책
+    template <typename U>
+    bool tryPush(U&& value) {
+        if (closed() || !enqueue(std::forward<U>(value))) {
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        not_empty_.notify();
+        return true;
+    }
+
+    // drop-oldest 정책: 가득 차 있으면 가장 오래된 항목을 버리고 넣음 (최신 프레임 우선)
+    template <typename U>
+    bool pushOverwrite(U&& value) {
+        if (closed()) {
+            return false;
+        }
+        T discarded;
+        while (!enqueue(value)) {
+            if (dequeue(discarded)) {
+                overwritten_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        not_empty_.notify();
+        return true;
+    }
+
+    // block 정책: 자리가 날 때까지 최대 timeout 동안 대기
+    template <typename U>
+    bool push(U&& value, std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max()) {
+        auto deadline = queue_detail::deadlineAfter(timeout);
+        while (!closed()) {
+            if (enqueue(value)) {
+                not_empty_.notify();
+                return true;
+            }
+            if (!not_full_.waitUntil([this] { return closed() || hasRoom(); }, deadline)) {
+                break;
+            }
+        }
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    size_t tryPushBatch(const T* values, size_t count) {
+        size_t n = 0;
+        while (n < count && !closed() && enqueue(values[n])) {
+            ++n;
+        }
+        if (n > 0) {
+            not_empty_.notify();
+        }
+        if (n < count) {
+            rejected_.fetch_add(count - n, std::memory_order_relaxed);
+        }
+        return n;
+    }
+
+    bool tryPop(T& value) {
+        if (!dequeue(value)) {
+            return false;
+        }
+        notifyNotFull();
+        return true;
+    }
+
+    size_t tryPopBatch(T* values, size_t max_count) {
+        size_t n = 0;
+        while (n < max_count && dequeue(values[n])) {
+            ++n;
+        }
+        if (n > 0) {
+            notifyNotFull();
+        }
+        return n;
+    }
+
+    bool pop(T& value, std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max()) {
+        auto deadline = queue_detail::deadlineAfter(timeout);
+        while (true) {
+            if (tryPop(value)) {
+                return true;
+            }
+            if (closed() ||
+                !not_empty_.waitUntil([this] { return closed() || hasItems(); }, deadline)) {
+                return tryPop(value);
+            }
+        }
+    }
+
+    void close() {
+        closed_.store(true, std::memory_order_release);
+        not_empty_.notify();
+        not_full_.notify();
+    }
+};
+
+#endif // BOUNDED_QUEUE_H
@@ -4,12 +4,219 @@
 #include <sstream>
 #include <algorithm>
 #include <cctype>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// 따옴표로 시작하는 문자열의 닫는 따옴표 위치 (이스케이프 문자 고려)
+size_t findStringEnd(const std::string& content, size_t quote_pos) {
+    for (size_t i = quote_pos + 1; i < content.size(); ++i) {
+        if (content[i] == '\\') {
+            ++i;
+        } else if (content[i] == '"') {
+            return i;
+        }
+    }
+    return std::string::npos;
+}
+
+// 여는 괄호에 대응하는 닫는 괄호 위치
+size_t findClosing(const std::string& content, size_t open_pos) {
+    int depth = 0;
+    for (size_t i = open_pos; i < content.size(); ++i) {
+        char c = content[i];
+        if (c == '"') {
+            i = findStringEnd(content, i);
+            if (i == std::string::npos) return std::string::npos;
+        } else if (c == '{' || c == '[') {
+            depth++;
+        } else if (c == '}' || c == ']') {
+            if (--depth == 0) return i;
+        }
+    }
+    return std::string::npos;
+}
+
+// 객체 내부 범위 [begin, end) 에서 같은 깊이의 "key" 값 시작 위치를 찾음
+// 하위 객체에 같은 이름의 키가 있어도 무시함
+size_t findValue(const std::string& content, size_t begin, size_t end, const std::string& key) {
+    int depth = 0;
+    for (size_t i = begin; i < end; ++i) {
+        char c = content[i];
+        if (c == '"') {
+            size_t close = findStringEnd(content, i);
+            if (close == std::string::npos || close >= end) return std::string::npos;
+            if (depth == 0 && content.compare(i + 1, close - i - 1, key) == 0) {
+                size_t colon = content.find_first_not_of(" \t\r\n", close + 1);
+                if (colon < end && content[colon] == ':') {
+                    size_t value = content.find_first_not_of(" \t\r\n", colon + 1);
+                    return value < end ? value : std::string::npos;
+                }
+            }
+            i = close;
+        } else if (c == '{' || c == '[') {
+            depth++;
+        } else if (c == '}' || c == ']') {
+            depth--;
+        }
+    }
+    return std::string::npos;
+}
+
+// "key": { ... } 객체의 내부 범위를 찾음
+bool findSection(const std::string& content, size_t begin, size_t end, const std::string& key,
+                 size_t& section_begin, size_t& section_end) {
+    size_t value = findValue(content, begin, end, key);
+    if (value == std::string::npos || content[value] != '{') return false;
+    size_t close = findClosing(content, value);
+    if (close == std::string::npos || close > end) return false;
+    section_begin = value + 1;
+    section_end = close;
+    return true;
+}
+
+// "key": [ {...}, {...} ] 배열 안 객체들의 내부 범위
+std::vector<std::pair<size_t, size_t>> findObjects(const std::string& content, size_t begin, size_t end,
+                                                   const std::string& key) {
+    std::vector<std::pair<size_t, size_t>> objects;
+    size_t value = findValue(content, begin, end, key);
+    if (value == std::string::npos || content[value] != '[') return objects;
+    size_t close = findClosing(content, value);
+    if (close == std::string::npos || close > end) return objects;
+    for (size_t i = value + 1; i < close; ++i) {
+        if (content[i] == '{') {
+            size_t object_end = findClosing(content, i);
+            if (object_end == std::string::npos || object_end > close) break;
+            objects.emplace_back(i + 1, object_end);
+            i = object_end;
+        }
+    }
+    return objects;
+}
+
+std::string readToken(const std::string& content, size_t value, size_t end) {
+    size_t token_end = content.find_first_of(",}]\r\n", value);
+    if (token_end == std::string::npos || token_end > end) token_end = end;
+    std::string token = content.substr(value, token_end - value);
+    token.erase(remove_if(token.begin(), token.end(), isspace), token.end());
+    return token;
+}
+
+void readInt(const std::string& content, size_t begin, size_t end, const std::string& key, int& out) {
+    size_t value = findValue(content, begin, end, key);
+    if (value != std::string::npos) {
+        out = std::stoi(readToken(content, value, end));
+    }
+}
+
+void readDouble(const std::string& content, size_t begin, size_t end, const std::string& key, double& out) {
+    size_t value = findValue(content, begin, end, key);
+    if (value != std::string::npos) {
+        out = std::stod(readToken(content, value, end));
+    }
+}
+
+void readFloat(const std::string& content, size_t begin, size_t end, const std::string& key, float& out) {
+    double value = out;
+    readDouble(content, begin, end, key, value);
+    out = static_cast<float>(value);
+}
+
+void readBool(const std::string& content, size_t begin, size_t end, const std::string& key, bool& out) {
+    size_t value = findValue(content, begin, end, key);
+    if (value != std::string::npos) {
+        out = readToken(content, value, end) == "true";
+    }
+}
+
+void readString(const std::string& content, size_t begin, size_t end, const std::string& key, std::string& out) {
+    size_t value = findValue(content, begin, end, key);
+    if (value != std::string::npos && content[value] == '"') {
+        size_t close = findStringEnd(content, value);
+        if (close != std::string::npos) {
+            out = content.substr(value + 1, close - value - 1);
+        }
+    }
+}
+
+// "key": [ ... ] 안의 숫자를 중첩과 관계없이 순서대로 읽음 ([[x, y], ...] 도 평탄화)
+bool readNumbers(const std::string& content, size_t begin, size_t end, const std::string& key,
+                 std::vector<float>& out) {
+    size_t value = findValue(content, begin, end, key);
+    if (value == std::string::npos || content[value] != '[') return false;
+    size_t close = findClosing(content, value);
+    if (close == std::string::npos || close > end) return false;
+    out.clear();
+    for (size_t i = value + 1; i < close; ++i) {
+        char c = content[i];
+        if (c == '-' || c == '.' || isdigit(static_cast<unsigned char>(c))) {
+            size_t token_end = content.find_first_of(",] \t\r\n", i);
+            out.push_back(std::stof(content.substr(i, token_end - i)));
+            i = token_end - 1;
+        }
+    }
+    return true;
+}
+
+// 예전 형식의 rtsp.pipeline (appsrc name=mysrc ! ...인코더... ! rtph264pay ...) 을
+// 인코딩 파이프라인(appsink name=encsink 로 끝남)과 AU 를 받는 RTSP 파이프라인으로 나눔. 나눌 수 없으면 false
+bool splitLegacyRtspPipeline(const std::string& legacy, std::string& encoder, std::string& rtsp) {
+    size_t payloader = legacy.find("rtph264pay");
+    size_t link = payloader == std::string::npos ? std::string::npos : legacy.rfind('!', payloader);
+    if (link == std::string::npos) {
+        return false;
+    }
+    size_t encode_end = legacy.find_last_not_of(" \t", link - 1);
+    if (encode_end == std::string::npos) {
+        return false;
+    }
+    encoder = legacy.substr(0, encode_end + 1) +
+              " ! h264parse config-interval=-1 ! video/x-h264,stream-format=byte-stream,alignment=au ! appsink name=encsink";
+    rtsp = "appsrc name=ausrc ! " + legacy.substr(payloader);
+    return true;
+}
+
+} // namespace
 
 ConfigManager::ConfigManager() : loaded_(false) {
     // 기본값 설정
-    video_config_ = {1920, 1080, 30, "BGR888", 8};
-    rtsp_config_ = {8554, "/stream", 2000000, "v4l2h264enc", 
-                   "appsrc name=mysrc ! queue ! v4l2convert ! video/x-raw,format=NV12 ! queue ! v4l2h264enc ! video/x-h264,level=(string)4 ! rtph264pay name=pay0 pt=96"};
+    video_config_ = {1920, 1080, 30, "BGR888", 8, false, 640, 480, "YUV420"};
+    rtsp_config_ = {8554, "/stream", 2000000, "v4l2h264enc", "appsrc name=ausrc ! rtph264pay name=pay0 pt=96",
+                    false, false, "239.255.42.1", "239.255.42.16", 5000, 5031, 1, ""};
+    encoder_config_ = {"appsrc name=mysrc ! queue ! v4l2convert ! video/x-raw,format=NV12 ! queue ! v4l2h264enc ! "
+                       "video/x-h264,level=(string)4 ! h264parse config-interval=-1 ! "
+                       "video/x-h264,stream-format=byte-stream,alignment=au ! appsink name=encsink",
+                       64};
+    privacy_config_ = {false, "pixelate", 16, 12, {}};
+    pacing_config_ = {false, 0, 2};
+    recording_config_ = {false, "/tmp/capture.craw", 8, 0};
+    replay_config_ = {false, "/tmp/capture.craw", "realtime", false};
+    motion_config_ = {false, 8, 8, 12, 5, 2, 15, 0.5};
+    inference_config_ = {false, "yolo_model/yolov5n.xml", "FP32", 320, "CPU", "model_cache", 0.35f, 0.45f, 1, 0,
+                         false, 32, "round_robin", 4, true};
+    tracker_config_ = {false, 64, 128, 0.5f, 0.1f, 0.3f, 90, 3};
+    metrics_config_ = {false, 9110, "0.0.0.0"};
+    control_config_ = {false, "/tmp/camstream.sock"};
+    logging_config_ = {"info", "text", 10, 256};
+    tracing_config_ = {false, 8192, 10, "/tmp", false};
+    memory_config_ = {false, false, "off", 64, false};
+    watchdog_config_ = {true, 1000, 2000};
+    governor_config_ = {false, 2000, "/sys/class/thermal/thermal_zone0/temp",
+                        "/sys/devices/platform/soc/soc:firmware/get_throttled", "/proc/stat", 0xE,
+                        75.0, 68.0, 0.9, 0.7, 10, "inference,fps,bitrate,resolution", 3, 15, 1000000, 640, 360};
+    // 기본 그래프: 메인 프레임 → 프라이버시 마스크 → pacer → RTSP, 분석 프레임 → 모션 → 검출기, 분석 프레임 → 추적기
+    // (마스크나 pacing 이 꺼져 있으면 해당 단계는 통과)
+    graph_config_ = {0, {
+        {"camera", "camera", "", "main", 2, "drop_oldest", 0, 0},
+        {"analytics", "camera", "", "analytics", 2, "drop_oldest", 0, 0},
+        {"privacy", "privacy", "camera", "", 2, "drop_oldest", 0, 0},
+        {"pacer", "pacer", "privacy", "", 2, "drop_oldest", 0, 0},
+        {"rtsp", "rtsp", "pacer", "", 2, "drop_oldest", 0, 0},
+        {"motion", "motion", "analytics", "", 2, "drop_oldest", 0, 0},
+        {"detector", "detector", "motion", "", 2, "drop_oldest", 0, 0},
+        {"tracker", "tracker", "analytics", "", 4, "drop_oldest", 0, 0},
+    }};
 }
 
 bool ConfigManager::loadFromFile(const std::string& config_file) {
@@ -26,98 +233,257 @@ bool ConfigManager::loadFromFile(const std::string& config_file) {
 
     // 간단한 JSON 파싱 (실제 프로젝트에서는 nlohmann/json 등을 사용 권장)
     try {
+        size_t root_begin = content.find('{');
+        size_t root_end = root_begin == std::string::npos ? std::string::npos : findClosing(content, root_begin);
+        if (root_end == std::string::npos) {
+            throw std::runtime_error("malformed JSON object");
+        }
+        root_begin++;
+
+        size_t section_begin, section_end;
+        bool encoder_pipeline_set = false;
+
         // video 설정 파싱
-        size_t video_pos = content.find("\"video\"");
-        if (video_pos != std::string::npos) {
-            size_t width_pos = content.find("\"width\"", video_pos);
-            if (width_pos != std::string::npos) {
-                size_t colon_pos = content.find(":", width_pos);
-                size_t comma_pos = content.find(",", colon_pos);
-                std::string width_str = content.substr(colon_pos + 1, comma_pos - colon_pos - 1);
-                // 공백 제거
-                width_str.erase(remove_if(width_str.begin(), width_str.end(), isspace), width_str.end());
-                video_config_.width = std::stoi(width_str);
-            }
+        if (findSection(content, root_begin, root_end, "video", section_begin, section_end)) {
+            readInt(content, section_begin, section_end, "width", video_config_.width);
+            readInt(content, section_begin, section_end, "height", video_config_.height);
+            readInt(content, section_begin, section_end, "fps", video_config_.fps);
+            readString(content, section_begin, section_end, "pixel_format", video_config_.pixel_format);
+            readInt(content, section_begin, section_end, "buffer_count", video_config_.buffer_count);
 
-            size_t height_pos = content.find("\"height\"", video_pos);
-            if (height_pos != std::string::npos) {
-                size_t colon_pos = content.find(":", height_pos);
-                size_t comma_pos = content.find(",", colon_pos);
-                std::string height_str = content.substr(colon_pos + 1, comma_pos - colon_pos - 1);
-                height_str.erase(remove_if(height_str.begin(), height_str.end(), isspace), height_str.end());
-                video_config_.height = std::stoi(height_str);
+            size_t analytics_begin, analytics_end;
+            if (findSection(content, section_begin, section_end, "analytics_stream", analytics_begin, analytics_end)) {
+                readBool(content, analytics_begin, analytics_end, "enabled", video_config_.analytics_enabled);
+                readInt(content, analytics_begin, analytics_end, "width", video_config_.analytics_width);
+                readInt(content, analytics_begin, analytics_end, "height", video_config_.analytics_height);
+                readString(content, analytics_begin, analytics_end, "pixel_format", video_config_.analytics_pixel_format);
             }
+        }
 
-            size_t fps_pos = content.find("\"fps\"", video_pos);
-            if (fps_pos != std::string::npos) {
-                size_t colon_pos = content.find(":", fps_pos);
-                size_t comma_pos = content.find(",", colon_pos);
-                std::string fps_str = content.substr(colon_pos + 1, comma_pos - colon_pos - 1);
-                fps_str.erase(remove_if(fps_str.begin(), fps_str.end(), isspace), fps_str.end());
-                video_config_.fps = std::stoi(fps_str);
-            }
+        // rtsp 설정 파싱
+        if (findSection(content, root_begin, root_end, "rtsp", section_begin, section_end)) {
+            readInt(content, section_begin, section_end, "port", rtsp_config_.port);
+            readString(content, section_begin, section_end, "mount_point", rtsp_config_.mount_point);
+            readInt(content, section_begin, section_end, "bitrate", rtsp_config_.bitrate);
+            readString(content, section_begin, section_end, "encoder", rtsp_config_.encoder);
+            readString(content, section_begin, section_end, "pipeline", rtsp_config_.pipeline);
 
-            size_t pixel_format_pos = content.find("\"pixel_format\"", video_pos);
-            if (pixel_format_pos != std::string::npos) {
-                size_t colon_pos = content.find(":", pixel_format_pos);
-                size_t quote1_pos = content.find("\"", colon_pos);
-                size_t quote2_pos = content.find("\"", quote1_pos + 1);
-                video_config_.pixel_format = content.substr(quote1_pos + 1, quote2_pos - quote1_pos - 1);
+            size_t multicast_begin, multicast_end;
+            if (findSection(content, section_begin, section_end, "multicast", multicast_begin, multicast_end)) {
+                readBool(content, multicast_begin, multicast_end, "enabled", rtsp_config_.multicast_enabled);
+                readBool(content, multicast_begin, multicast_end, "only", rtsp_config_.multicast_only);
+                readString(content, multicast_begin, multicast_end, "address_min", rtsp_config_.multicast_address_min);
+                readString(content, multicast_begin, multicast_end, "address_max", rtsp_config_.multicast_address_max);
+                readInt(content, multicast_begin, multicast_end, "port_min", rtsp_config_.multicast_port_min);
+                readInt(content, multicast_begin, multicast_end, "port_max", rtsp_config_.multicast_port_max);
+                readInt(content, multicast_begin, multicast_end, "ttl", rtsp_config_.multicast_ttl);
+                readString(content, multicast_begin, multicast_end, "iface", rtsp_config_.multicast_iface);
             }
+        }
 
-            size_t buffer_count_pos = content.find("\"buffer_count\"", video_pos);
-            if (buffer_count_pos != std::string::npos) {
-                size_t colon_pos = content.find(":", buffer_count_pos);
-                size_t end_pos = content.find_first_of(",}", colon_pos);
-                std::string buffer_str = content.substr(colon_pos + 1, end_pos - colon_pos - 1);
-                buffer_str.erase(remove_if(buffer_str.begin(), buffer_str.end(), isspace), buffer_str.end());
-                video_config_.buffer_count = std::stoi(buffer_str);
-            }
+        // motion 설정 파싱
+        if (findSection(content, root_begin, root_end, "motion", section_begin, section_end)) {
+            readBool(content, section_begin, section_end, "enabled", motion_config_.enabled);
+            readInt(content, section_begin, section_end, "downscale", motion_config_.downscale);
+            readInt(content, section_begin, section_end, "block_size", motion_config_.block_size);
+            readInt(content, section_begin, section_end, "sad_threshold", motion_config_.sad_threshold);
+            readInt(content, section_begin, section_end, "background_shift", motion_config_.background_shift);
+            readInt(content, section_begin, section_end, "min_blocks", motion_config_.min_blocks);
+            readInt(content, section_begin, section_end, "hold_frames", motion_config_.hold_frames);
+            readDouble(content, section_begin, section_end, "keepalive_fps", motion_config_.keepalive_fps);
         }
 
-        // rtsp 설정 파싱
-        size_t rtsp_pos = content.find("\"rtsp\"");
-        if (rtsp_pos != std::string::npos) {
-            size_t port_pos = content.find("\"port\"", rtsp_pos);
-            if (port_pos != std::string::npos) {
-                size_t colon_pos = content.find(":", port_pos);
-                size_t comma_pos = content.find(",", colon_pos);
-                std::string port_str = content.substr(colon_pos + 1, comma_pos - colon_pos - 1);
-                port_str.erase(remove_if(port_str.begin(), port_str.end(), isspace), port_str.end());
-                rtsp_config_.port = std::stoi(port_str);
-            }
+        // inference 설정 파싱
+        if (findSection(content, root_begin, root_end, "inference", section_begin, section_end)) {
+            readBool(content, section_begin, section_end, "enabled", inference_config_.enabled);
+            readString(content, section_begin, section_end, "model_path", inference_config_.model_path);
+            readString(content, section_begin, section_end, "precision", inference_config_.precision);
+            readInt(content, section_begin, section_end, "input_size", inference_config_.input_size);
+            readString(content, section_begin, section_end, "device", inference_config_.device);
+            readString(content, section_begin, section_end, "cache_dir", inference_config_.cache_dir);
+            readFloat(content, section_begin, section_end, "conf_threshold", inference_config_.conf_threshold);
+            readFloat(content, section_begin, section_end, "nms_threshold", inference_config_.nms_threshold);
+            readInt(content, section_begin, section_end, "frame_interval", inference_config_.frame_interval);
+            readInt(content, section_begin, section_end, "threads", inference_config_.threads);
 
-            size_t mount_pos = content.find("\"mount_point\"", rtsp_pos);
-            if (mount_pos != std::string::npos) {
-                size_t colon_pos = content.find(":", mount_pos);
-                size_t quote1_pos = content.find("\"", colon_pos);
-                size_t quote2_pos = content.find("\"", quote1_pos + 1);
-                rtsp_config_.mount_point = content.substr(quote1_pos + 1, quote2_pos - quote1_pos - 1);
+            size_t tiling_begin, tiling_end;
+            if (findSection(content, section_begin, section_end, "tiling", tiling_begin, tiling_end)) {
+                readBool(content, tiling_begin, tiling_end, "enabled", inference_config_.tiling_enabled);
+                readInt(content, tiling_begin, tiling_end, "overlap", inference_config_.tile_overlap);
+                readString(content, tiling_begin, tiling_end, "schedule", inference_config_.tile_schedule);
+                readInt(content, tiling_begin, tiling_end, "tiles_per_frame", inference_config_.tiles_per_frame);
+                readBool(content, tiling_begin, tiling_end, "full_frame", inference_config_.tile_full_frame);
             }
+        }
+
+        // tracker 설정 파싱
+        if (findSection(content, root_begin, root_end, "tracker", section_begin, section_end)) {
+            readBool(content, section_begin, section_end, "enabled", tracker_config_.enabled);
+            readInt(content, section_begin, section_end, "max_tracks", tracker_config_.max_tracks);
+            readInt(content, section_begin, section_end, "max_detections", tracker_config_.max_detections);
+            readFloat(content, section_begin, section_end, "high_threshold", tracker_config_.high_threshold);
+            readFloat(content, section_begin, section_end, "low_threshold", tracker_config_.low_threshold);
+            readFloat(content, section_begin, section_end, "match_iou", tracker_config_.match_iou);
+            readInt(content, section_begin, section_end, "max_age", tracker_config_.max_age);
+            readInt(content, section_begin, section_end, "min_hits", tracker_config_.min_hits);
+        }
+
+        // metrics 설정 파싱
+        if (findSection(content, root_begin, root_end, "metrics", section_begin, section_end)) {
+            readBool(content, section_begin, section_end, "enabled", metrics_config_.enabled);
+            readInt(content, section_begin, section_end, "port", metrics_config_.port);
+            readString(content, section_begin, section_end, "bind_address", metrics_config_.bind_address);
+        }
+
+        // control 설정 파싱
+        if (findSection(content, root_begin, root_end, "control", section_begin, section_end)) {
+            readBool(content, section_begin, section_end, "enabled", control_config_.enabled);
+            readString(content, section_begin, section_end, "socket_path", control_config_.socket_path);
+        }
+
+        // logging 설정 파싱
+        if (findSection(content, root_begin, root_end, "logging", section_begin, section_end)) {
+            readString(content, section_begin, section_end, "level", logging_config_.level);
+            readString(content, section_begin, section_end, "format", logging_config_.format);
+            readInt(content, section_begin, section_end, "rate_limit_per_second", logging_config_.rate_limit_per_second);
+            readInt(content, section_begin, section_end, "ring_size", logging_config_.ring_size);
+        }
+
+        // tracing 설정 파싱
+        if (findSection(content, root_begin, root_end, "tracing", section_begin, section_end)) {
+            readBool(content, section_begin, section_end, "enabled", tracing_config_.enabled);
+            readInt(content, section_begin, section_end, "buffer_events", tracing_config_.buffer_events);
+            readInt(content, section_begin, section_end, "window_seconds", tracing_config_.window_seconds);
+            readString(content, section_begin, section_end, "output_dir", tracing_config_.output_dir);
+            readBool(content, section_begin, section_end, "dump_on_drop", tracing_config_.dump_on_drop);
+        }
+
+        // memory 설정 파싱
+        if (findSection(content, root_begin, root_end, "memory", section_begin, section_end)) {
+            readBool(content, section_begin, section_end, "prefault", memory_config_.prefault);
+            readBool(content, section_begin, section_end, "lock", memory_config_.lock);
+            readString(content, section_begin, section_end, "hugepages", memory_config_.hugepages);
+            readInt(content, section_begin, section_end, "arena_mb", memory_config_.arena_mb);
+            readBool(content, section_begin, section_end, "report_page_faults", memory_config_.report_page_faults);
+        }
+
+        // watchdog 설정 파싱
+        if (findSection(content, root_begin, root_end, "watchdog", section_begin, section_end)) {
+            readBool(content, section_begin, section_end, "enabled", watchdog_config_.enabled);
+            readInt(content, section_begin, section_end, "capture_timeout_ms", watchdog_config_.capture_timeout_ms);
+            readInt(content, section_begin, section_end, "media_timeout_ms", watchdog_config_.media_timeout_ms);
+        }
 
-            size_t bitrate_pos = content.find("\"bitrate\"", rtsp_pos);
-            if (bitrate_pos != std::string::npos) {
-                size_t colon_pos = content.find(":", bitrate_pos);
-                size_t comma_pos = content.find(",", colon_pos);
-                std::string bitrate_str = content.substr(colon_pos + 1, comma_pos - colon_pos - 1);
-                bitrate_str.erase(remove_if(bitrate_str.begin(), bitrate_str.end(), isspace), bitrate_str.end());
-                rtsp_config_.bitrate = std::stoi(bitrate_str);
+        // governor 설정 파싱
+        if (findSection(content, root_begin, root_end, "governor", section_begin, section_end)) {
+            GovernorConfig& governor = governor_config_;
+            readBool(content, section_begin, section_end, "enabled", governor.enabled);
+            readInt(content, section_begin, section_end, "interval_ms", governor.interval_ms);
+            readString(content, section_begin, section_end, "temperature_path", governor.temperature_path);
+            readString(content, section_begin, section_end, "throttle_path", governor.throttle_path);
+            readString(content, section_begin, section_end, "stat_path", governor.stat_path);
+            readInt(content, section_begin, section_end, "throttle_mask", governor.throttle_mask);
+            readDouble(content, section_begin, section_end, "temp_high_c", governor.temp_high_c);
+            readDouble(content, section_begin, section_end, "temp_low_c", governor.temp_low_c);
+            readDouble(content, section_begin, section_end, "load_high", governor.load_high);
+            readDouble(content, section_begin, section_end, "load_low", governor.load_low);
+            readInt(content, section_begin, section_end, "hold_seconds", governor.hold_seconds);
+            readString(content, section_begin, section_end, "ladder", governor.ladder);
+            readInt(content, section_begin, section_end, "inference_interval_factor", governor.inference_interval_factor);
+            readInt(content, section_begin, section_end, "degraded_fps", governor.degraded_fps);
+            readInt(content, section_begin, section_end, "degraded_bitrate", governor.degraded_bitrate);
+            readInt(content, section_begin, section_end, "degraded_width", governor.degraded_width);
+            readInt(content, section_begin, section_end, "degraded_height", governor.degraded_height);
+        }
+
+        // encoder 설정 파싱
+        if (findSection(content, root_begin, root_end, "encoder", section_begin, section_end)) {
+            encoder_pipeline_set = findValue(content, section_begin, section_end, "pipeline") != std::string::npos;
+            readString(content, section_begin, section_end, "pipeline", encoder_config_.pipeline);
+            readInt(content, section_begin, section_end, "bus_size", encoder_config_.bus_size);
+        }
+
+        // privacy 설정 파싱
+        if (findSection(content, root_begin, root_end, "privacy", section_begin, section_end)) {
+            readBool(content, section_begin, section_end, "enabled", privacy_config_.enabled);
+            readString(content, section_begin, section_end, "mode", privacy_config_.mode);
+            readInt(content, section_begin, section_end, "block_size", privacy_config_.block_size);
+            readInt(content, section_begin, section_end, "blur_radius", privacy_config_.blur_radius);
+            for (const auto& range : findObjects(content, section_begin, section_end, "regions")) {
+                PrivacyRegion region;
+                std::vector<float> rect;
+                if (readNumbers(content, range.first, range.second, "rect", rect)) {
+                    // [x, y, w, h] → 시계 방향 네 꼭짓점
+                    if (rect.size() != 4) {
+                        throw std::runtime_error("privacy rect needs [x, y, w, h]");
+                    }
+                    region.points = {rect[0], rect[1], rect[0] + rect[2], rect[1],
+                                     rect[0] + rect[2], rect[1] + rect[3], rect[0], rect[1] + rect[3]};
+                } else if (!readNumbers(content, range.first, range.second, "polygon", region.points) ||
+                           region.points.size() < 6 || region.points.size() % 2 != 0) {
+                    throw std::runtime_error("privacy region needs a rect or a polygon of at least 3 points");
+                }
+                privacy_config_.regions.push_back(region);
             }
+        }
+
+        // pacing 설정 파싱
+        if (findSection(content, root_begin, root_end, "pacing", section_begin, section_end)) {
+            readBool(content, section_begin, section_end, "enabled", pacing_config_.enabled);
+            readInt(content, section_begin, section_end, "fps", pacing_config_.fps);
+            readInt(content, section_begin, section_end, "jitter_frames", pacing_config_.jitter_frames);
+        }
 
-            size_t encoder_pos = content.find("\"encoder\"", rtsp_pos);
-            if (encoder_pos != std::string::npos) {
-                size_t colon_pos = content.find(":", encoder_pos);
-                size_t quote1_pos = content.find("\"", colon_pos);
-                size_t quote2_pos = content.find("\"", quote1_pos + 1);
-                rtsp_config_.encoder = content.substr(quote1_pos + 1, quote2_pos - quote1_pos - 1);
+        // recording 설정 파싱
+        if (findSection(content, root_begin, root_end, "recording", section_begin, section_end)) {
+            readBool(content, section_begin, section_end, "enabled", recording_config_.enabled);
+            readString(content, section_begin, section_end, "path", recording_config_.path);
+            readInt(content, section_begin, section_end, "buffers", recording_config_.buffers);
+            readInt(content, section_begin, section_end, "max_frames", recording_config_.max_frames);
+        }
+
+        // replay 설정 파싱
+        if (findSection(content, root_begin, root_end, "replay", section_begin, section_end)) {
+            readBool(content, section_begin, section_end, "enabled", replay_config_.enabled);
+            readString(content, section_begin, section_end, "path", replay_config_.path);
+            readString(content, section_begin, section_end, "mode", replay_config_.mode);
+            readBool(content, section_begin, section_end, "loop", replay_config_.loop);
+        }
+
+        // graph 설정 파싱 (stages 가 있으면 기본 그래프를 대체)
+        if (findSection(content, root_begin, root_end, "graph", section_begin, section_end)) {
+            readInt(content, section_begin, section_end, "threads", graph_config_.threads);
+            auto stages = findObjects(content, section_begin, section_end, "stages");
+            if (!stages.empty()) {
+                graph_config_.stages.clear();
+            }
+            for (const auto& range : stages) {
+                StageConfig stage = {"", "", "", "main", 2, "drop_oldest", 0, 0};
+                readString(content, range.first, range.second, "name", stage.name);
+                readString(content, range.first, range.second, "type", stage.type);
+                readString(content, range.first, range.second, "input", stage.input);
+                readString(content, range.first, range.second, "stream", stage.stream);
+                readInt(content, range.first, range.second, "queue_size", stage.queue_size);
+                readString(content, range.first, range.second, "drop_policy", stage.drop_policy);
+                readInt(content, range.first, range.second, "width", stage.width);
+                readInt(content, range.first, range.second, "height", stage.height);
+                graph_config_.stages.push_back(stage);
             }
+        }
 
-            size_t pipeline_pos = content.find("\"pipeline\"", rtsp_pos);
-            if (pipeline_pos != std::string::npos) {
-                size_t colon_pos = content.find(":", pipeline_pos);
-                size_t quote1_pos = content.find("\"", colon_pos);
-                size_t quote2_pos = content.find("\"", quote1_pos + 1);
-                rtsp_config_.pipeline = content.substr(quote1_pos + 1, quote2_pos - quote1_pos - 1);
+        // 예전 설정은 rtsp.pipeline 하나에 인코더까지 들어 있었음. 인코더 부분을 encoder.pipeline 으로 옮겨 계속 실행
+        if (rtsp_config_.pipeline.find("name=ausrc") == std::string::npos &&
+            rtsp_config_.pipeline.find("name=mysrc") != std::string::npos) {
+            std::string encoder_pipeline, rtsp_pipeline;
+            if (splitLegacyRtspPipeline(rtsp_config_.pipeline, encoder_pipeline, rtsp_pipeline)) {
+                std::cerr << "[WARN] rtsp.pipeline with the encoder inside ('appsrc name=mysrc') is deprecated. Using \""
+                          << rtsp_pipeline << "\" as rtsp.pipeline";
+                if (!encoder_pipeline_set) {
+                    std::cerr << " and \"" << encoder_pipeline << "\" as encoder.pipeline";
+                    encoder_config_.pipeline = encoder_pipeline;
+                }
+                std::cerr << "; update the config file to these values" << std::endl;
+                rtsp_config_.pipeline = rtsp_pipeline;
             }
         }
 
@@ -138,6 +504,10 @@ void ConfigManager::printConfig() const {
     std::cout << "  FPS: " << video_config_.fps << std::endl;
     std::cout << "  Pixel Format: " << video_config_.pixel_format << std::endl;
     std::cout << "  Buffer Count: " << video_config_.buffer_count << std::endl;
+    if (video_config_.analytics_enabled) {
+        std::cout << "  Analytics Stream: " << video_config_.analytics_width << "x" << video_config_.analytics_height
+                  << " " << video_config_.analytics_pixel_format << std::endl;
+    }
     
     std::cout << "RTSP Config:" << std::endl;
     std::cout << "  Port: " << rtsp_config_.port << std::endl;
@@ -145,5 +515,146 @@ void ConfigManager::printConfig() const {
     std::cout << "  Bitrate: " << rtsp_config_.bitrate << std::endl;
     std::cout << "  Encoder: " << rtsp_config_.encoder << std::endl;
     std::cout << "  Pipeline: " << rtsp_config_.pipeline << std::endl;
+    std::cout << "  Multicast: " << (rtsp_config_.multicast_enabled ? "true" : "false");
+    if (rtsp_config_.multicast_enabled) {
+        std::cout << ", " << rtsp_config_.multicast_address_min << "-" << rtsp_config_.multicast_address_max
+                  << " ports " << rtsp_config_.multicast_port_min << "-" << rtsp_config_.multicast_port_max
+                  << ", TTL " << rtsp_config_.multicast_ttl
+                  << (rtsp_config_.multicast_iface.empty() ? "" : ", iface " + rtsp_config_.multicast_iface)
+                  << (rtsp_config_.multicast_only ? ", multicast only" : "");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Encoder Config:" << std::endl;
+    std::cout << "  Pipeline: " << encoder_config_.pipeline << std::endl;
+    std::cout << "  Bus Size: " << encoder_config_.bus_size << " access units" << std::endl;
+
+    std::cout << "Privacy Config:" << std::endl;
+    std::cout << "  Enabled: " << (privacy_config_.enabled ? "true" : "false");
+    if (privacy_config_.enabled) {
+        std::cout << ", Mode: " << privacy_config_.mode;
+        if (privacy_config_.mode == "pixelate") {
+            std::cout << " (block " << privacy_config_.block_size << ")";
+        } else if (privacy_config_.mode == "blur") {
+            std::cout << " (radius " << privacy_config_.blur_radius << ")";
+        }
+        std::cout << ", Regions: " << privacy_config_.regions.size();
+    }
+    std::cout << std::endl;
+
+    std::cout << "Pacing Config:" << std::endl;
+    std::cout << "  Enabled: " << (pacing_config_.enabled ? "true" : "false");
+    if (pacing_config_.enabled) {
+        std::cout << ", FPS: " << (pacing_config_.fps > 0 ? std::to_string(pacing_config_.fps) : "video")
+                  << ", Jitter Buffer: " << pacing_config_.jitter_frames << " frames";
+    }
+    std::cout << std::endl;
+
+    std::cout << "Recording Config:" << std::endl;
+    std::cout << "  Enabled: " << (recording_config_.enabled ? "true" : "false");
+    if (recording_config_.enabled) {
+        std::cout << ", Path: " << recording_config_.path << ", Buffers: " << recording_config_.buffers
+                  << ", Max Frames: " << (recording_config_.max_frames > 0 ? std::to_string(recording_config_.max_frames)
+                                                                           : "unlimited");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Replay Config:" << std::endl;
+    std::cout << "  Enabled: " << (replay_config_.enabled ? "true" : "false");
+    if (replay_config_.enabled) {
+        std::cout << ", Path: " << replay_config_.path << ", Mode: " << replay_config_.mode
+                  << (replay_config_.loop ? ", looping" : "");
+    }
+    std::cout << std::endl;
+
+    std::cout << "Motion Config:" << std::endl;
+    std::cout << "  Enabled: " << (motion_config_.enabled ? "true" : "false") << std::endl;
+    std::cout << "  Downscale: 1/" << motion_config_.downscale << ", Block: " << motion_config_.block_size
+              << ", SAD Threshold: " << motion_config_.sad_threshold << std::endl;
+    std::cout << "  Keep-alive FPS: " << motion_config_.keepalive_fps << std::endl;
+
+    std::cout << "Inference Config:" << std::endl;
+    std::cout << "  Enabled: " << (inference_config_.enabled ? "true" : "false") << std::endl;
+    std::cout << "  Model: " << inference_config_.model_path << " (" << inference_config_.precision << ", "
+              << inference_config_.input_size << "x" << inference_config_.input_size << ", "
+              << inference_config_.device << ")" << std::endl;
+    std::cout << "  Model Cache: " << (inference_config_.cache_dir.empty() ? "disabled" : inference_config_.cache_dir)
+              << std::endl;
+    std::cout << "  Thresholds: conf=" << inference_config_.conf_threshold
+              << ", nms=" << inference_config_.nms_threshold << std::endl;
+    std::cout << "  Frame Interval: " << inference_config_.frame_interval << std::endl;
+    if (inference_config_.threads > 0) {
+        std::cout << "  Threads: " << inference_config_.threads << std::endl;
+    }
+    if (inference_config_.tiling_enabled) {
+        std::cout << "  Tiling: " << inference_config_.tile_schedule << ", " << inference_config_.tiles_per_frame
+                  << " tiles/frame, overlap " << inference_config_.tile_overlap
+                  << (inference_config_.tile_full_frame ? ", with full frame" : "") << std::endl;
+    }
+
+    std::cout << "Tracker Config:" << std::endl;
+    std::cout << "  Enabled: " << (tracker_config_.enabled ? "true" : "false") << std::endl;
+    std::cout << "  Max Tracks: " << tracker_config_.max_tracks << ", Max Age: " << tracker_config_.max_age
+              << " frames, Min Hits: " << tracker_config_.min_hits << std::endl;
+    std::cout << "  Thresholds: high=" << tracker_config_.high_threshold << ", low=" << tracker_config_.low_threshold
+              << ", iou=" << tracker_config_.match_iou << std::endl;
+
+    std::cout << "Metrics Config:" << std::endl;
+    std::cout << "  Enabled: " << (metrics_config_.enabled ? "true" : "false") << std::endl;
+    std::cout << "  Endpoint: " << metrics_config_.bind_address << ":" << metrics_config_.port << "/metrics" << std::endl;
+
+    std::cout << "Control Config:" << std::endl;
+    std::cout << "  Enabled: " << (control_config_.enabled ? "true" : "false");
+    if (control_config_.enabled) {
+        std::cout << ", Socket: " << control_config_.socket_path;
+    }
+    std::cout << std::endl;
+
+    std::cout << "Logging Config:" << std::endl;
+    std::cout << "  Level: " << logging_config_.level << ", Format: " << logging_config_.format
+              << ", Rate Limit: " << logging_config_.rate_limit_per_second << "/s per call site" << std::endl;
+
+    std::cout << "Tracing Config:" << std::endl;
+    std::cout << "  Enabled: " << (tracing_config_.enabled ? "true" : "false") << std::endl;
+    if (tracing_config_.enabled) {
+        std::cout << "  Buffer: " << tracing_config_.buffer_events << " events/thread, Window: "
+                  << tracing_config_.window_seconds << " s, Output: " << tracing_config_.output_dir
+                  << (tracing_config_.dump_on_drop ? ", dump on drop" : "") << std::endl;
+    }
+
+    std::cout << "Memory Config:" << std::endl;
+    std::cout << "  Prefault: " << (memory_config_.prefault ? "true" : "false")
+              << ", Lock: " << (memory_config_.lock ? "true" : "false")
+              << ", Hugepages: " << memory_config_.hugepages << ", Arena: " << memory_config_.arena_mb << " MB"
+              << ", Page Fault Report: " << (memory_config_.report_page_faults ? "true" : "false") << std::endl;
+
+    std::cout << "Watchdog Config:" << std::endl;
+    std::cout << "  Enabled: " << (watchdog_config_.enabled ? "true" : "false");
+    if (watchdog_config_.enabled) {
+        std::cout << ", Capture Timeout: " << watchdog_config_.capture_timeout_ms
+                  << " ms, Media Timeout: " << watchdog_config_.media_timeout_ms << " ms";
+    }
+    std::cout << std::endl;
+
+    std::cout << "Governor Config:" << std::endl;
+    std::cout << "  Enabled: " << (governor_config_.enabled ? "true" : "false") << std::endl;
+    if (governor_config_.enabled) {
+        std::cout << "  Temperature: " << governor_config_.temp_low_c << "-" << governor_config_.temp_high_c
+                  << " C, Load: " << governor_config_.load_low << "-" << governor_config_.load_high
+                  << ", Hold: " << governor_config_.hold_seconds << " s, Ladder: " << governor_config_.ladder << std::endl;
+    }
+    std::cout << "Graph Config:" << std::endl;
+    std::cout << "  Threads: " << (graph_config_.threads > 0 ? std::to_string(graph_config_.threads) : "auto") << std::endl;
+    for (const StageConfig& stage : graph_config_.stages) {
+        std::cout << "  " << stage.name << " (" << stage.type;
+        if (stage.type == "camera") {
+            std::cout << " " << stage.stream;
+        }
+        std::cout << ")";
+        if (!stage.input.empty()) {
+            std::cout << " <- " << stage.input;
+        }
+        std::cout << ", queue " << stage.queue_size << " " << stage.drop_policy << std::endl;
+    }
     std::cout << "===================================" << std::endl;
 }
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 struct VideoConfig {
     int width;
@@ -10,6 +11,12 @@ struct VideoConfig {
     int fps;
     std::string pixel_format;
     int buffer_count;
+
+    // 분석용 저해상도 보조 스트림 (ISP 가 함께 출력하므로 CPU 축소가 필요 없음)
+    bool analytics_enabled;
+    int analytics_width;
+    int analytics_height;
+    std::string analytics_pixel_format;
 };
 
 struct RtspConfig {
@@ -17,13 +24,200 @@ struct RtspConfig {
     std::string mount_point;
     int bitrate;
     std::string encoder;
-    std::string pipeline;
+    std::string pipeline;       // 인코딩된 AU 를 'ausrc' appsrc 로 받아 'pay0' 으로 내보내는 미디어 파이프라인
+
+    // RTP 멀티캐스트: 공유 미디어 하나를 그룹으로 보내므로 시청자가 늘어도 송신량이 일정
+    bool multicast_enabled;
+    bool multicast_only;                // true 면 유니캐스트(UDP/TCP) 전송을 제공하지 않음
+    std::string multicast_address_min;  // 그룹 주소 풀 범위
+    std::string multicast_address_max;
+    int multicast_port_min;             // RTP/RTCP 포트 쌍 범위 (RTP 는 짝수)
+    int multicast_port_max;
+    int multicast_ttl;
+    std::string multicast_iface;        // 보낼 인터페이스 (빈 문자열이면 라우팅 테이블 기본값)
+};
+
+// 모든 출력이 공유하는 단일 인코더
+struct EncoderConfig {
+    std::string pipeline;       // 'mysrc' appsrc 에서 원본 프레임을 받아 'encsink' appsink 로 H.264 AU 를 냄
+    int bus_size;               // 출력들이 나눠 읽는 AU 링 크기 (느린 출력은 이만큼 뒤처지면 다음 키프레임으로 건너뜀)
+};
+
+// 프라이버시 마스크 영역. 좌표는 프레임 크기에 대한 비율 (0~1) 이라 메인/보조 스트림에 같이 쓸 수 있음
+struct PrivacyRegion {
+    std::vector<float> points;  // x0, y0, x1, y1, ... (rect 는 네 꼭짓점으로 변환)
+};
+
+struct PrivacyConfig {
+    bool enabled;
+    std::string mode;           // fill, pixelate, blur
+    int block_size;             // pixelate: 블록 크기 (짝수, luma 픽셀)
+    int blur_radius;            // blur: 상자 필터 반경 (luma 픽셀)
+    std::vector<PrivacyRegion> regions;
+};
+
+// 캡처 지터를 흡수해 인코더에 일정한 간격으로 프레임을 넣는 pacer (그래프의 pacer 단계)
+struct PacingConfig {
+    bool enabled;
+    int fps;                    // 출력 주기 (0 이면 video.fps)
+    int jitter_frames;          // 내보내기 전에 쌓아 두는 프레임 수 (추가 지연 = jitter_frames / fps)
+};
+
+// 캡처 프레임 덤프 (그래프의 record 단계가 입력 프레임을 RawCapture 컨테이너로 기록)
+struct RecordingConfig {
+    bool enabled;
+    std::string path;
+    int buffers;                // 기록 스레드로 넘기는 복사 버퍼 수 (모두 쓰는 중이면 프레임을 버림)
+    int max_frames;             // 이만큼 기록하면 멈춤 (0 이면 무제한)
+};
+
+// 카메라 대신 기록된 컨테이너를 소스로 사용
+struct ReplayConfig {
+    bool enabled;
+    std::string path;
+    std::string mode;           // realtime (기록된 간격대로), fast (최대 속도)
+    bool loop;
+};
+
+struct MotionConfig {
+    bool enabled;
+    int downscale;          // luma 다운스케일 배율 (2, 4, 8, 16)
+    int block_size;         // SAD 블록 크기 (다운스케일된 픽셀 기준, 8의 배수)
+    int sad_threshold;      // 블록 평균 픽셀 차 임계값
+    int background_shift;   // 배경 갱신 속도 (1/2^n)
+    int min_blocks;         // 모션으로 판정할 최소 블록 수
+    int hold_frames;        // 모션 종료 후 활성 상태 유지 프레임 수
+    double keepalive_fps;   // 모션이 없을 때의 추론 주기
+};
+
+struct InferenceConfig {
+    bool enabled;
+    std::string model_path;     // FP32 IR 경로 (다른 precision 은 접미사로 찾음)
+    std::string precision;      // "FP32", "FP16", "INT8"
+    int input_size;             // 모델 입력 크기 (320/416/640, 0 이면 IR 그대로)
+    std::string device;
+    std::string cache_dir;      // 컴파일된 모델 캐시 디렉토리 (빈 문자열이면 캐시 안 함)
+    float conf_threshold;
+    float nms_threshold;
+    int frame_interval;     // N 프레임마다 한 번만 검출 (사이 프레임은 추적기가 보간)
+    int threads;            // 추론 스레드 수 (0 이면 OpenVINO 기본값, 검출기 여러 개가 코어를 나눠 쓸 때 지정)
+
+    // 타일 추론 (원본 해상도를 모델 입력 크기의 겹치는 타일로 분할)
+    bool tiling_enabled;
+    int tile_overlap;           // 인접 타일 간 최소 겹침 (픽셀)
+    std::string tile_schedule;  // "all", "round_robin", "motion"
+    int tiles_per_frame;        // 한 번의 검출에서 실행할 타일 수 (0 이면 전체)
+    bool tile_full_frame;       // 큰 객체를 위해 축소된 전체 프레임도 함께 추론
+};
+
+struct TrackerConfig {
+    bool enabled;
+    int max_tracks;         // 트랙 저장 공간 크기 (미리 할당)
+    int max_detections;     // 한 번에 받는 최대 검출 수
+    float high_threshold;   // 새 트랙 생성/1차 매칭 점수
+    float low_threshold;    // 2차 매칭 최소 점수
+    float match_iou;        // 매칭 최소 IoU
+    int max_age;            // 검출 없이 유지하는 최대 프레임 수
+    int min_hits;           // 확정 트랙이 되기 위한 매칭 횟수
+};
+
+struct MetricsConfig {
+    bool enabled;
+    int port;
+    std::string bind_address;
+};
+
+struct ControlConfig {
+    bool enabled;
+    std::string socket_path;    // 로컬 제어 소켓 (Unix domain, 한 줄 명령)
+};
+
+struct LoggingConfig {
+    std::string level;          // "debug", "info", "warn", "error"
+    std::string format;         // "text", "json"
+    int rate_limit_per_second;  // 호출 위치별 초당 최대 출력 수 (0 이면 제한 없음)
+    int ring_size;              // 스레드별 로그 링 크기 (레코드 수)
+};
+
+struct TracingConfig {
+    bool enabled;
+    int buffer_events;          // 스레드별 링 버퍼 크기 (이벤트 수)
+    int window_seconds;         // 덤프에 포함할 최근 구간 (자동 덤프 최소 간격이기도 함)
+    std::string output_dir;
+    bool dump_on_drop;          // 프레임 드롭이 감지되면 자동으로 덤프
+};
+
+struct MemoryConfig {
+    bool prefault;              // DMA 버퍼 매핑과 arena 를 시작 시 미리 페이지 폴트 (MAP_POPULATE)
+    bool lock;                  // mlockall 로 프로세스 메모리를 RAM 에 고정
+    std::string hugepages;      // arena 백킹: "off", "transparent" (THP madvise), "explicit" (MAP_HUGETLB)
+    int arena_mb;               // 텐서/변환 scratch 용 arena 크기 (0 이면 사용 안 함)
+    bool report_page_faults;    // 서브시스템별 minor/major 페이지 폴트 집계
+};
+
+struct WatchdogConfig {
+    bool enabled;
+    int capture_timeout_ms;     // 완료된 요청이 없으면 카메라를 다시 시작하는 시간
+    int media_timeout_ms;       // appsrc push 나 인코더 출력이 없으면 인코딩 체인을 초기화하는 시간
+};
+
+struct GovernorConfig {
+    bool enabled;
+    int interval_ms;                // 샘플링 주기
+    std::string temperature_path;   // 밀리도(m°C) 정수 (thermal zone)
+    std::string throttle_path;      // 16진수 throttle 비트 (Raspberry Pi get_throttled)
+    std::string stat_path;          // /proc/stat 형식 CPU 누적 시간
+    int throttle_mask;              // throttle 비트 중 부하로 볼 비트
+    double temp_high_c;             // 이 온도 이상이면 한 단계 낮춤
+    double temp_low_c;              // 이 온도 이하이고 부하도 낮으면 한 단계 회복
+    double load_high;               // CPU 사용률 (0~1)
+    double load_low;
+    int hold_seconds;               // 단계 전환 사이 최소 시간 (회복은 두 배 동안 조건 유지)
+    std::string ladder;             // 쉼표로 구분한 낮추는 순서: inference, fps, bitrate, resolution
+    int inference_interval_factor;  // inference 단계에서 frame_interval 에 곱하는 값
+    int degraded_fps;
+    int degraded_bitrate;           // bps
+    int degraded_width;             // 인코더 입력 크기 (변환기에서 축소)
+    int degraded_height;
+};
+
+// 처리 그래프 단계 하나. input 이 없는 단계는 소스 (camera)
+struct StageConfig {
+    std::string name;           // 메트릭 이름에 쓰이므로 영문자/숫자/_ 만
+    std::string type;           // camera, rtsp, privacy, pacer, record, motion, detector, tracker, scale
+    std::string input;          // 상류 단계 이름
+    std::string stream;         // camera: main 또는 analytics (보조 스트림이 없으면 main)
+    int queue_size;             // 입력 큐 용량 (2 의 거듭제곱으로 올림)
+    std::string drop_policy;    // drop_oldest, drop_newest, block
+    int width;                  // scale: 출력 크기
+    int height;
+};
+
+struct GraphConfig {
+    int threads;                // 작업 스레드 수 (0 이면 코어 수 - 1)
+    std::vector<StageConfig> stages;
 };
 
 class ConfigManager {
 private:
     VideoConfig video_config_;
     RtspConfig rtsp_config_;
+    EncoderConfig encoder_config_;
+    PrivacyConfig privacy_config_;
+    PacingConfig pacing_config_;
+    RecordingConfig recording_config_;
+    ReplayConfig replay_config_;
+    MotionConfig motion_config_;
+    InferenceConfig inference_config_;
+    TrackerConfig tracker_config_;
+    MetricsConfig metrics_config_;
+    ControlConfig control_config_;
+    LoggingConfig logging_config_;
+    TracingConfig tracing_config_;
+    MemoryConfig memory_config_;
+    WatchdogConfig watchdog_config_;
+    GovernorConfig governor_config_;
+    GraphConfig graph_config_;
     bool loaded_;
 
 public:
@@ -34,6 +228,22 @@ public:
     
     const VideoConfig& getVideoConfig() const { return video_config_; }
     const RtspConfig& getRtspConfig() const { return rtsp_config_; }
+    const EncoderConfig& getEncoderConfig() const { return encoder_config_; }
+    const PrivacyConfig& getPrivacyConfig() const { return privacy_config_; }
+    const PacingConfig& getPacingConfig() const { return pacing_config_; }
+    const RecordingConfig& getRecordingConfig() const { return recording_config_; }
+    const ReplayConfig& getReplayConfig() const { return replay_config_; }
+    const MotionConfig& getMotionConfig() const { return motion_config_; }
+    const InferenceConfig& getInferenceConfig() const { return inference_config_; }
+    const TrackerConfig& getTrackerConfig() const { return tracker_config_; }
+    const MetricsConfig& getMetricsConfig() const { return metrics_config_; }
+    const ControlConfig& getControlConfig() const { return control_config_; }
+    const LoggingConfig& getLoggingConfig() const { return logging_config_; }
+    const TracingConfig& getTracingConfig() const { return tracing_config_; }
+    const MemoryConfig& getMemoryConfig() const { return memory_config_; }
+    const WatchdogConfig& getWatchdogConfig() const { return watchdog_config_; }
+    const GovernorConfig& getGovernorConfig() const { return governor_config_; }
+    const GraphConfig& getGraphConfig() const { return graph_config_; }
     
     bool isLoaded() const { return loaded_; }
     
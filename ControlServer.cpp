@@ -0,0 +1,159 @@
+#include "ControlServer.h"
+#include <iostream>
+#include <cstring>
+#include <chrono>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// 해상도 변경은 카메라 재구성과 첫 인코딩 AU 대기까지 포함하므로 넉넉히 기다림
+constexpr auto kReplyTimeout = std::chrono::seconds(10);
+constexpr size_t kMaxCommand = 256;
+
+} // namespace
+
+ControlServer::ControlServer(const ControlConfig& config)
+    : config_(config), listen_fd_(-1), is_running_(false) {
+}
+
+ControlServer::~ControlServer() {
+    stop();
+}
+
+bool ControlServer::start() {
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    if (config_.socket_path.empty() || config_.socket_path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "[ERROR] Invalid control socket path: " << config_.socket_path << std::endl;
+        return false;
+    }
+    strncpy(addr.sun_path, config_.socket_path.c_str(), sizeof(addr.sun_path) - 1);
+
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        std::cerr << "[ERROR] Failed to create control socket: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // 이전 실행이 남긴 소켓 파일은 bind 를 막으므로 지움
+    unlink(config_.socket_path.c_str());
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(listen_fd_, 4) < 0) {
+        std::cerr << "[ERROR] Failed to listen on control socket " << config_.socket_path << ": " << strerror(errno)
+                  << std::endl;
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+    // 설정을 바꾸는 소켓이므로 소유자만 접근
+    chmod(config_.socket_path.c_str(), 0600);
+
+    is_running_.store(true);
+    server_thread_ = std::thread(&ControlServer::serverLoop, this);
+    std::cout << "[INFO] Control socket ready at: " << config_.socket_path << std::endl;
+    return true;
+}
+
+void ControlServer::stop() {
+    if (is_running_.exchange(false)) {
+        // 응답을 기다리는 서버 스레드를 바로 깨움
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            for (auto& pending : pending_) {
+                pending->reply.set_value("ERROR shutting down");
+            }
+            pending_.clear();
+        }
+        if (server_thread_.joinable()) {
+            server_thread_.join();
+        }
+    }
+    if (listen_fd_ >= 0) {
+        close(listen_fd_);
+        listen_fd_ = -1;
+        unlink(config_.socket_path.c_str());
+    }
+}
+
+void ControlServer::poll(const Handler& handler) {
+    std::deque<std::shared_ptr<Pending>> commands;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        commands.swap(pending_);
+    }
+    for (auto& pending : commands) {
+        pending->reply.set_value(handler(pending->command));
+    }
+}
+
+void ControlServer::serverLoop() {
+    pollfd pfd = {listen_fd_, POLLIN, 0};
+    while (is_running_.load()) {
+        // 종료 요청을 확인할 수 있도록 짧은 타임아웃으로 대기
+        int ready = ::poll(&pfd, 1, 200);
+        if (ready <= 0) {
+            continue;
+        }
+        int client_fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client_fd < 0) {
+            continue;
+        }
+        handleClient(client_fd);
+        close(client_fd);
+    }
+}
+
+void ControlServer::handleClient(int client_fd) {
+    // 느린 클라이언트가 서버를 붙잡지 않도록 수신 타임아웃 설정
+    timeval timeout = {1, 0};
+    setsockopt(client_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    // 줄바꿈까지 한 명령 (줄바꿈 없이 연결을 닫아도 받은 만큼 명령으로 봄)
+    std::string command;
+    char buffer[kMaxCommand];
+    while (command.size() < kMaxCommand && command.find('\n') == std::string::npos) {
+        ssize_t received = recv(client_fd, buffer, sizeof(buffer), 0);
+        if (received <= 0) {
+            break;
+        }
+        command.append(buffer, static_cast<size_t>(received));
+    }
+    size_t end = command.find_first_of("\r\n");
+    if (end != std::string::npos) {
+        command.resize(end);
+    }
+
+    std::string reply;
+    if (command.empty()) {
+        reply = "ERROR empty command";
+    } else if (command.size() >= kMaxCommand) {
+        reply = "ERROR command too long";
+    } else {
+        auto pending = std::make_shared<Pending>();
+        pending->command = command;
+        std::future<std::string> result = pending->reply.get_future();
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            if (!is_running_.load()) {
+                return;
+            }
+            pending_.push_back(pending);
+        }
+        // 시간을 넘겨도 명령은 주 루프에서 실행되고 응답만 버려짐
+        reply = result.wait_for(kReplyTimeout) == std::future_status::ready ? result.get()
+                                                                            : "ERROR timed out waiting for main loop";
+    }
+    reply += "\n";
+
+    size_t sent = 0;
+    while (sent < reply.size()) {
+        ssize_t n = send(client_fd, reply.data() + sent, reply.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            break;
+        }
+        sent += static_cast<size_t>(n);
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef CONTROL_SERVER_H
+#define CONTROL_SERVER_H
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "ConfigManager.h"
+
+// 로컬 Unix 소켓으로 한 줄 명령을 받아 한 줄로 응답하는 제어 서버
+// 카메라 재구성 같은 명령은 주 루프 스레드에서만 실행하므로, 서버 스레드는 명령을 넘기고 결과를 기다림
+// 예: echo "set bitrate 2000000" | socat - UNIX-CONNECT:/tmp/camstream.sock
+class ControlServer {
+public:
+    using Handler = std::function<std::string(const std::string& command)>;
+
+    explicit ControlServer(const ControlConfig& config);
+    ~ControlServer();
+
+    bool start();
+    void stop();
+
+    // 주 루프에서 호출: 대기 중인 명령을 handler 로 실행하고 반환값을 응답으로 보냄
+    void poll(const Handler& handler);
+
+private:
+    struct Pending {
+        std::string command;
+        std::promise<std::string> reply;
+    };
+
+    void serverLoop();
+    void handleClient(int client_fd);
+
+    ControlConfig config_;
+    int listen_fd_;
+    std::thread server_thread_;
+    std::atomic<bool> is_running_;
+
+    std::mutex mtx_;
+    std::deque<std::shared_ptr<Pending>> pending_;
+};
+
+#endif // CONTROL_SERVER_H
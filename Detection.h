@@ -0,0 +1,65 @@
+#ifndef DETECTION_H
+#define DETECTION_H
+
+#include <algorithm>
+#include <vector>
+
+// 원본 프레임 좌표 기준의 검출 결과
+struct Detection {
+    float x;
+    float y;
+    float width;
+    float height;
+    float score;
+    int class_id;
+};
+
+inline float computeIoU(const Detection& a, const Detection& b) {
+    float x1 = std::max(a.x, b.x);
+    float y1 = std::max(a.y, b.y);
+    float x2 = std::min(a.x + a.width, b.x + b.width);
+    float y2 = std::min(a.y + a.height, b.y + b.height);
+    float inter = std::max(0.0f, x2 - x1) * std::max(0.0f, y2 - y1);
+    float uni = a.width * a.height + b.width * b.height - inter;
+    return uni > 0.0f ? inter / uni : 0.0f;
+}
+
+// 교집합 / 작은 박스 면적. 타일 경계에서 잘린 박스가 온전한 박스에 포함되는 경우를 잡아냄
+inline float computeIoS(const Detection& a, const Detection& b) {
+    float x1 = std::max(a.x, b.x);
+    float y1 = std::max(a.y, b.y);
+    float x2 = std::min(a.x + a.width, b.x + b.width);
+    float y2 = std::min(a.y + a.height, b.y + b.height);
+    float inter = std::max(0.0f, x2 - x1) * std::max(0.0f, y2 - y1);
+    float smaller = std::min(a.width * a.height, b.width * b.height);
+    return smaller > 0.0f ? inter / smaller : 0.0f;
+}
+
+// 클래스별 NMS. detections 를 점수 내림차순으로 정렬한 뒤 제거된 항목을 지움
+// ios_threshold 가 0 보다 크면 IoS 기준으로도 제거함 (타일 병합용)
+inline void nonMaximumSuppression(std::vector<Detection>& detections, float iou_threshold,
+                                  float ios_threshold = 0.0f) {
+    std::sort(detections.begin(), detections.end(),
+              [](const Detection& a, const Detection& b) { return a.score > b.score; });
+
+    size_t kept = 0;
+    for (size_t i = 0; i < detections.size(); ++i) {
+        bool suppressed = false;
+        for (size_t j = 0; j < kept; ++j) {
+            if (detections[j].class_id != detections[i].class_id) {
+                continue;
+            }
+            if (computeIoU(detections[j], detections[i]) > iou_threshold ||
+                (ios_threshold > 0.0f && computeIoS(detections[j], detections[i]) > ios_threshold)) {
+                suppressed = true;
+                break;
+            }
+        }
+        if (!suppressed) {
+            detections[kept++] = detections[i];
+        }
+    }
+    detections.resize(kept);
+}
+
+#endif // DETECTION_H
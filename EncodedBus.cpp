@@ -0,0 +1,197 @@
+#include "EncodedBus.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+constexpr uint64_t kNoKeyframe = UINT64_MAX;
+
+} // namespace
+
+EncodedBus::EncodedBus(size_t capacity)
+    : slots_(capacity > 0 ? capacity : 1), head_(0), last_keyframe_(kNoKeyframe), closed_(false),
+      units_(MetricsRegistry::instance().counter("camstream_encoded_units_total",
+                                                 "H.264 access units published by the encoder")),
+      keyframes_(MetricsRegistry::instance().counter("camstream_encoded_keyframes_total",
+                                                     "IDR access units published by the encoder")),
+      bytes_(MetricsRegistry::instance().counter("camstream_encoder_output_bytes_total",
+                                                 "Encoded bytes published by the encoder (rate() gives bitrate)")),
+      subscribers_(MetricsRegistry::instance().gauge("camstream_encoded_subscribers",
+                                                     "Outputs reading the encoded access unit bus")) {
+}
+
+EncodedBus::~EncodedBus() {
+    close();
+}
+
+void EncodedBus::publish(const uint8_t* data, size_t size, uint64_t pts_ns, uint64_t duration_ns, bool keyframe) {
+    // 인코더 출력 버퍼를 링에 그대로 잡아 두면 인코더 capture 버퍼 풀이 바닥나므로 AU 만 복사
+    // (수십 KB/프레임이라 원본 프레임 복사에 비해 무시할 만함)
+    auto unit = std::make_shared<EncodedUnit>();
+    unit->pts_ns = pts_ns;
+    unit->duration_ns = duration_ns;
+    unit->keyframe = keyframe;
+    unit->data.assign(data, data + size);
+
+    std::shared_ptr<const std::vector<uint8_t>> parameter_sets;
+    if (keyframe) {
+        std::vector<uint8_t> found;
+        if (extractParameterSets(data, size, found)) {
+            parameter_sets = std::make_shared<const std::vector<uint8_t>>(std::move(found));
+        }
+    }
+
+    EncodedUnitPtr evicted;     // 락 밖에서 놓음
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (closed_) {
+            return;
+        }
+        if (parameter_sets && (!parameter_sets_ || *parameter_sets_ != *parameter_sets)) {
+            parameter_sets_ = std::move(parameter_sets);
+        }
+        unit->parameter_sets = parameter_sets_;
+        unit->sequence = head_;
+        evicted = std::move(slots_[head_ % slots_.size()]);
+        slots_[head_ % slots_.size()] = std::move(unit);
+        if (keyframe) {
+            last_keyframe_ = head_;
+        }
+        head_++;
+    }
+    cv_.notify_all();
+
+    units_.inc();
+    bytes_.inc(size);
+    if (keyframe) {
+        keyframes_.inc();
+    }
+}
+
+std::unique_ptr<EncodedSubscriber> EncodedBus::subscribe(const std::string& name) {
+    std::unique_ptr<EncodedSubscriber> subscriber(new EncodedSubscriber(this, name));
+    subscriber->rewindToKeyframe();
+    subscribers_.add(1);
+    return subscriber;
+}
+
+void EncodedBus::close() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        closed_ = true;
+    }
+    cv_.notify_all();
+}
+
+uint64_t EncodedBus::nextKeyframe(uint64_t from) const {
+    for (uint64_t sequence = std::max(from, oldest()); sequence < head_; ++sequence) {
+        if (slots_[sequence % slots_.size()]->keyframe) {
+            return sequence;
+        }
+    }
+    return head_;
+}
+
+EncodedSubscriber::EncodedSubscriber(EncodedBus* bus, const std::string& name)
+    : bus_(bus), cursor_(0), need_keyframe_(true), cancelled_(false),
+      skipped_(MetricsRegistry::instance().counter("camstream_encoded_" + name + "_skipped_total",
+                                                   "Access units the " + name + " output skipped after falling behind")) {
+}
+
+EncodedSubscriber::~EncodedSubscriber() {
+    bus_->subscribers_.add(-1);
+}
+
+bool EncodedSubscriber::next(EncodedUnitPtr& unit, int timeout_ms) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    std::unique_lock<std::mutex> lock(bus_->mtx_);
+    while (!bus_->closed_ && !cancelled_) {
+        // 발행이 커서를 따라잡아 덮어쓴 경우: 중간 AU 없이 디코딩할 수 있는 다음 키프레임으로 이동
+        uint64_t oldest = bus_->oldest();
+        if (cursor_ < oldest) {
+            uint64_t target = bus_->nextKeyframe(oldest);
+            skipped_.inc(target - cursor_);
+            cursor_ = target;
+            need_keyframe_ = target == bus_->head_;
+        }
+        while (cursor_ < bus_->head_) {
+            const EncodedUnitPtr& slot = bus_->slots_[cursor_ % bus_->slots_.size()];
+            cursor_++;
+            if (need_keyframe_ && !slot->keyframe) {
+                skipped_.inc();
+                continue;
+            }
+            need_keyframe_ = false;
+            unit = slot;
+            return true;
+        }
+        if (bus_->cv_.wait_until(lock, deadline) == std::cv_status::timeout && cursor_ >= bus_->head_) {
+            return false;
+        }
+    }
+    return false;
+}
+
+void EncodedSubscriber::waitForKeyframe() {
+    std::lock_guard<std::mutex> lock(bus_->mtx_);
+    need_keyframe_ = true;
+}
+
+void EncodedSubscriber::rewindToKeyframe() {
+    std::lock_guard<std::mutex> lock(bus_->mtx_);
+    if (bus_->last_keyframe_ != kNoKeyframe && bus_->last_keyframe_ >= bus_->oldest()) {
+        cursor_ = bus_->last_keyframe_;
+        need_keyframe_ = false;
+    } else {
+        cursor_ = bus_->head_;
+        need_keyframe_ = true;
+    }
+}
+
+void EncodedSubscriber::cancel() {
+    {
+        std::lock_guard<std::mutex> lock(bus_->mtx_);
+        cancelled_ = true;
+    }
+    bus_->cv_.notify_all();
+}
+
+uint64_t EncodedSubscriber::lag() const {
+    std::lock_guard<std::mutex> lock(bus_->mtx_);
+    return bus_->head_ > cursor_ ? bus_->head_ - cursor_ : 0;
+}
+
+bool extractParameterSets(const uint8_t* data, size_t size, std::vector<uint8_t>& out) {
+    static const uint8_t kStartCode[] = {0, 0, 0, 1};
+    out.clear();
+    // 00 00 01 start code 뒤 NAL 헤더의 하위 5 비트가 종류. NAL 끝은 다음 start code 앞 (00 00 00 01 의 선행 0 제외)
+    // 파라미터 셋은 슬라이스보다 앞에 오므로 첫 슬라이스(1, 5)에서 멈춤 (키프레임 데이터 전체를 훑지 않음)
+    size_t i = 0;
+    while (i + 3 < size) {
+        if (data[i] != 0 || data[i + 1] != 0 || data[i + 2] != 1) {
+            ++i;
+            continue;
+        }
+        size_t nal_begin = i + 3;
+        uint8_t type = data[nal_begin] & 0x1f;
+        if (type == 1 || type == 5) {
+            break;
+        }
+        size_t nal_end = nal_begin;
+        while (nal_end + 3 <= size && !(data[nal_end] == 0 && data[nal_end + 1] == 0 && data[nal_end + 2] == 1)) {
+            ++nal_end;
+        }
+        if (nal_end + 3 > size) {
+            nal_end = size;
+        }
+        i = nal_end;
+        while (nal_end > nal_begin && data[nal_end - 1] == 0) {
+            --nal_end;
+        }
+        if (type == 7 || type == 8) {
+            out.insert(out.end(), kStartCode, kStartCode + 4);
+            out.insert(out.end(), data + nal_begin, data + nal_end);
+        }
+    }
+    return !out.empty();
+}
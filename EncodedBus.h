@@ -0,0 +1,102 @@
+#ifndef ENCODED_BUS_H
+#define ENCODED_BUS_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "MetricsRegistry.h"
+
+// 인코더가 낸 H.264 access unit 하나 (Annex B byte-stream)
+struct EncodedUnit {
+    uint64_t sequence;              // 버스에 들어온 순서 (연속)
+    uint64_t pts_ns;                // 캡처 시각 (파이프라인 클럭 기준 절대 시각, realtime)
+    uint64_t duration_ns;
+    bool keyframe;                  // IDR
+    std::vector<uint8_t> data;
+    // 이 AU 를 해석하는 데 필요한 최신 SPS/PPS (start code 포함). 키프레임이 바뀌기 전까지 같은 객체를 공유
+    std::shared_ptr<const std::vector<uint8_t>> parameter_sets;
+};
+
+using EncodedUnitPtr = std::shared_ptr<const EncodedUnit>;
+
+class EncodedSubscriber;
+
+// 인코더 출력 하나를 여러 출력(RTSP, 녹화 등)이 나눠 읽는 고정 크기 링
+// - 발행은 막히지 않음: 가장 오래된 AU 를 덮어씀
+// - 구독자마다 독립 커서. 덮어써진 구간을 건너뛴 구독자는 다음 키프레임부터 다시 읽음
+// - AU 는 참조 계수로 공유되므로 링에서 밀려나도 읽고 있는 구독자의 데이터는 유지됨
+class EncodedBus {
+public:
+    explicit EncodedBus(size_t capacity);
+    ~EncodedBus();
+
+    // AU 를 복사해 링에 넣음 (키프레임이면 SPS/PPS 를 갱신)
+    void publish(const uint8_t* data, size_t size, uint64_t pts_ns, uint64_t duration_ns, bool keyframe);
+
+    // name 은 메트릭 이름에 쓰임. 가장 최근 키프레임부터 읽기 시작 (링에 없으면 다음 키프레임)
+    std::unique_ptr<EncodedSubscriber> subscribe(const std::string& name);
+
+    // 대기 중인 구독자를 모두 깨우고 이후 next() 는 false
+    void close();
+
+    size_t capacity() const { return slots_.size(); }
+
+private:
+    friend class EncodedSubscriber;
+
+    // [from, head_) 에서 첫 키프레임 위치 (없으면 head_). mtx_ 를 잡고 호출
+    uint64_t nextKeyframe(uint64_t from) const;
+    uint64_t oldest() const { return head_ > slots_.size() ? head_ - slots_.size() : 0; }
+
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;
+    std::vector<EncodedUnitPtr> slots_;
+    uint64_t head_;                 // 다음에 쓸 sequence
+    uint64_t last_keyframe_;        // 마지막 키프레임 sequence (없으면 UINT64_MAX)
+    bool closed_;
+    std::shared_ptr<const std::vector<uint8_t>> parameter_sets_;
+
+    Counter& units_;
+    Counter& keyframes_;
+    Counter& bytes_;
+    Gauge& subscribers_;
+};
+
+// 버스의 독립 읽기 커서. 한 스레드에서만 사용
+class EncodedSubscriber {
+public:
+    ~EncodedSubscriber();
+
+    // 다음 AU. timeout_ms 안에 새 AU 가 없거나 버스/구독이 닫히면 false
+    bool next(EncodedUnitPtr& unit, int timeout_ms);
+
+    // 다음 키프레임까지 건너뜀 (하류가 AU 를 버려서 디코딩이 끊긴 경우)
+    void waitForKeyframe();
+    // 링에 남은 가장 최근 키프레임으로 되돌림 (하류가 다시 시작할 때 GOP 를 기다리지 않음)
+    void rewindToKeyframe();
+
+    // 다른 스레드에서 next() 대기를 끝냄
+    void cancel();
+
+    // 아직 읽지 않은 AU 수
+    uint64_t lag() const;
+
+private:
+    friend class EncodedBus;
+    EncodedSubscriber(EncodedBus* bus, const std::string& name);
+
+    EncodedBus* bus_;
+    uint64_t cursor_;               // 다음에 읽을 sequence (bus_->mtx_ 로 보호)
+    bool need_keyframe_;
+    bool cancelled_;
+    Counter& skipped_;
+};
+
+// Annex B AU 에서 SPS(7)/PPS(8) NAL 을 start code 와 함께 모음 (없으면 false)
+bool extractParameterSets(const uint8_t* data, size_t size, std::vector<uint8_t>& out);
+
+#endif // ENCODED_BUS_H
@@ -0,0 +1,43 @@
+#ifndef FRAME_DATA_H
+#define FRAME_DATA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+constexpr int kMaxFramePlanes = 3;
+
+// 프레임 데이터를 담을 구조체
+// data/size 는 dmabuf 매핑 전체이고, 각 평면은 offsets/strides 로 찾음
+// (ISP 가 행을 정렬하므로 stride 가 width * bpp 보다 클 수 있음)
+struct FrameData {
+    void* data;
+    size_t size;
+    size_t buffer_index;
+    int width;
+    int height;
+    int num_planes;
+    size_t offsets[kMaxFramePlanes];
+    int strides[kMaxFramePlanes];
+    uint32_t sequence;      // 센서 프레임 번호 (같은 요청의 보조 스트림과 동일)
+    uint64_t timestamp_ns;  // 노출 시작 센서 타임스탬프 (CLOCK_BOOTTIME)
+    uint64_t duration_ns;   // 실제 프레임 간격 (센서가 보고하지 않으면 0)
+
+    uint8_t* plane(int index) const { return static_cast<uint8_t*>(data) + offsets[index]; }
+};
+
+// 처리 그래프 단계가 프레임에 남기는 표시
+constexpr uint32_t kFrameMotionChecked = 1u << 0;   // 모션 단계를 거침
+constexpr uint32_t kFrameMotion = 1u << 1;          // 모션 있음 (또는 hold 중)
+
+// 처리 그래프에서 전달되는 프레임. 픽셀은 복사하지 않고 owner 가 버퍼 수명을 잡고 있음
+// (카메라 프레임은 마지막 참조가 놓일 때 요청이 다시 큐에 들어감)
+struct FrameRef {
+    FrameData data;
+    std::shared_ptr<void> owner;
+    uint32_t flags;
+
+    bool valid() const { return owner != nullptr; }
+};
+
+#endif // FRAME_DATA_H
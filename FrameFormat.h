@@ -0,0 +1,26 @@
+#ifndef FRAME_FORMAT_H
+#define FRAME_FORMAT_H
+
+#include <string>
+
+// 설정 문자열(pixel_format)에 대응하는 메모리 배치
+// BGR888/RGB888 의 채널 순서는 RtspStreamer 의 caps 매핑(BGR888 → "BGR")과 동일하게 해석함
+enum class PixelLayout {
+    BGR24,
+    RGB24,
+    I420,
+    YUYV
+};
+
+inline PixelLayout pixelLayoutFromString(const std::string& format_str) {
+    if (format_str == "RGB888") {
+        return PixelLayout::RGB24;
+    } else if (format_str == "YUV420") {
+        return PixelLayout::I420;
+    } else if (format_str == "YUYV") {
+        return PixelLayout::YUYV;
+    }
+    return PixelLayout::BGR24;
+}
+
+#endif // FRAME_FORMAT_H
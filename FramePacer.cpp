@@ -0,0 +1,191 @@
+#include "FramePacer.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <time.h>
+
+using namespace std::chrono;
+
+namespace {
+
+const std::vector<double> kLatencyBuckets = {0.005, 0.01, 0.02, 0.033, 0.05, 0.1, 0.2, 0.5};
+const std::vector<double> kErrorBuckets = {0.0001, 0.0005, 0.001, 0.002, 0.005, 0.01, 0.02};
+
+// 센서 타임스탬프와 같은 클럭 (RtspStreamer 가 파이프라인 클럭으로 옮김)
+uint64_t bootNowNs() {
+    timespec now;
+    clock_gettime(CLOCK_BOOTTIME, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + now.tv_nsec;
+}
+
+int64_t periodFor(int fps) {
+    return 1000000000LL / std::max(fps, 1);
+}
+
+} // namespace
+
+FramePacer::FramePacer(const PacingConfig& config, const std::string& name, int fps)
+    : name_(name), jitter_frames_(static_cast<size_t>(std::max(config.jitter_frames, 1))),
+      capacity_(2 * jitter_frames_ + 1), period_ns_(periodFor(config.fps > 0 ? config.fps : fps)),
+      running_(false), repeats_(0), max_error_s_(0.0),
+      released_(MetricsRegistry::instance().counter("camstream_pacer_" + name + "_frames_total",
+                                                    "Captured frames released on cadence by the " + name + " pacer")),
+      duplicated_(MetricsRegistry::instance().counter("camstream_pacer_" + name + "_duplicated_total",
+                                                      "Ticks the " + name + " pacer filled by repeating the last frame")),
+      dropped_(MetricsRegistry::instance().counter("camstream_pacer_" + name + "_dropped_total",
+                                                   "Frames the " + name + " pacer dropped from a full jitter buffer")),
+      depth_(MetricsRegistry::instance().gauge("camstream_pacer_" + name + "_depth",
+                                               "Frames waiting in the " + name + " pacer jitter buffer")),
+      latency_seconds_(MetricsRegistry::instance().histogram(
+          "camstream_pacer_" + name + "_latency_seconds",
+          "Time a frame spent in the " + name + " pacer jitter buffer", kLatencyBuckets)),
+      error_seconds_(MetricsRegistry::instance().histogram(
+          "camstream_pacer_" + name + "_error_seconds",
+          "Distance between scheduled and actual release time in the " + name + " pacer", kErrorBuckets)) {
+}
+
+FramePacer::~FramePacer() {
+    stop();
+}
+
+bool FramePacer::start(Output output) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (running_) {
+        return true;
+    }
+    output_ = std::move(output);
+    running_ = true;
+    thread_ = std::thread(&FramePacer::run, this);
+    std::cout << "[INFO] Pacer '" << name_ << "': " << 1e9 / period_ns_.load() << " fps, jitter buffer "
+              << jitter_frames_ << " frames" << std::endl;
+    return true;
+}
+
+void FramePacer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    pending_.clear();
+    last_ = FrameRef();
+    depth_.set(0.0);
+
+    uint64_t released = released_.value();
+    std::cout << "[INFO] Pacer '" << name_ << "': " << released << " frames, " << duplicated_.value()
+              << " duplicated, " << dropped_.value() << " dropped, added latency "
+              << (released > 0 ? latency_seconds_.sum() / released * 1000.0 : 0.0) << " ms avg, pacing error "
+              << max_error_s_ * 1000.0 << " ms max" << std::endl;
+}
+
+void FramePacer::submit(const FrameRef& frame) {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!running_) {
+            return;
+        }
+        // 입력이 출력 주기보다 빠르면(또는 멈췄던 캡처가 몰아서 오면) 오래된 프레임부터 버려 지연을 제한
+        if (pending_.size() >= capacity_) {
+            pending_.pop_front();
+            dropped_.inc();
+        }
+        pending_.push_back({frame, steady_clock::now()});
+        depth_.set(static_cast<double>(pending_.size()));
+    }
+    cv_.notify_one();
+}
+
+void FramePacer::setFrameRate(int fps) {
+    period_ns_.store(periodFor(fps));
+}
+
+void FramePacer::run() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    bool ticking = false;
+    bool primed = false;
+    steady_clock::time_point deadline;
+    uint64_t timestamp_ns = 0;
+
+    while (running_) {
+        nanoseconds period(period_ns_.load());
+        if (!ticking) {
+            // 목표 깊이만큼 쌓이면 그 시각부터 주기를 셈
+            cv_.wait(lock, [this] { return !running_ || pending_.size() >= jitter_frames_; });
+            if (!running_) {
+                break;
+            }
+            ticking = true;
+            primed = true;
+            deadline = steady_clock::now();
+            timestamp_ns = bootNowNs();
+        } else {
+            // 이전 예정 시각에 주기를 더함 (깨어난 시각 기준이면 오차가 누적됨)
+            deadline += period;
+            timestamp_ns += period.count();
+            if (cv_.wait_until(lock, deadline, [this] { return !running_; })) {
+                break;
+            }
+        }
+
+        steady_clock::time_point woke = steady_clock::now();
+        double error = duration<double>(woke - deadline).count();
+        error_seconds_.observe(std::fabs(error));
+        max_error_s_ = std::max(max_error_s_, std::fabs(error));
+        if (woke - deadline > 2 * period) {
+            // 스레드가 주기 여러 개만큼 밀렸으면 몰아서 내보내지 않고 지금부터 다시 셈
+            LOG_WARN("pacer") << "Pacer '" << name_ << "' woke " << error * 1000.0 << " ms late, resyncing";
+            timestamp_ns += duration_cast<nanoseconds>(woke - deadline).count();
+            deadline = woke;
+        }
+
+        if (!primed && pending_.size() >= jitter_frames_) {
+            primed = true;
+        }
+        if (primed && !pending_.empty()) {
+            Pending next = std::move(pending_.front());
+            pending_.pop_front();
+            depth_.set(static_cast<double>(pending_.size()));
+            latency_seconds_.observe(duration<double>(woke - next.arrival).count());
+            released_.inc();
+            repeats_ = 0;
+            last_ = next.frame;
+            lock.unlock();
+            release(std::move(next.frame), timestamp_ns, period.count());
+            lock.lock();
+            continue;
+        }
+
+        // 비었음: 목표 깊이가 다시 찰 때까지 마지막 프레임을 반복해 주기를 유지
+        primed = false;
+        int max_repeats = static_cast<int>(1000000000LL / period.count());
+        if (last_.valid() && repeats_ < max_repeats) {
+            repeats_++;
+            duplicated_.inc();
+            FrameRef repeat = last_;
+            lock.unlock();
+            release(std::move(repeat), timestamp_ns, period.count());
+            lock.lock();
+        } else {
+            // 1 초 넘게 입력이 없으면 (캡처 정지) 카메라 버퍼를 놓고 다음 프레임이 쌓일 때까지 쉼
+            if (last_.valid()) {
+                LOG_WARN("pacer") << "Pacer '" << name_ << "' has no input, pausing output";
+            }
+            last_ = FrameRef();
+            ticking = false;
+        }
+    }
+}
+
+void FramePacer::release(FrameRef frame, uint64_t timestamp_ns, uint64_t period_ns) {
+    // 출력 시각을 캡처 시각 자리에 넣어 PTS 가 정확히 주기 간격이 되게 함 (반복 프레임도 새 PTS)
+    frame.data.timestamp_ns = timestamp_ns;
+    frame.data.duration_ns = period_ns;
+    output_(std::move(frame));
+}
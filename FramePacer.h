@@ -0,0 +1,73 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "ConfigManager.h"
+#include "FrameData.h"
+#include "MetricsRegistry.h"
+
+// 캡처 완료의 지터를 흡수해 일정한 간격으로 프레임을 내보내는 작은 jitter buffer
+// - jitter_frames 만큼 쌓인 뒤부터 fps 주기의 절대 시각마다 가장 오래된 프레임 하나를 내보냄
+// - 비어 있으면 마지막 프레임을 반복(최대 1 초), 넘치면(2 * jitter_frames + 1) 가장 오래된 프레임을 버림
+// - 내보내는 프레임의 타임스탬프/duration 을 출력 주기로 다시 써서 인코더와 RTP 시각이 등간격이 됨
+// - 추가 지연(도착 → 출력)과 pacing 오차(예정 시각 대비 실제 깨어난 시각)를 히스토그램으로 노출
+class FramePacer {
+public:
+    using Output = std::function<void(FrameRef&& frame)>;
+
+    // name 은 메트릭 이름(camstream_pacer_<name>_*)에 쓰임. fps 는 설정값이 0 일 때의 기본값
+    FramePacer(const PacingConfig& config, const std::string& name, int fps);
+    ~FramePacer();
+
+    bool start(Output output);
+    void stop();
+
+    // 도착한 프레임을 버퍼에 넣음 (그래프 작업 스레드)
+    void submit(const FrameRef& frame);
+
+    // 출력 주기 변경 (품질 조절로 카메라 fps 가 바뀔 때)
+    void setFrameRate(int fps);
+
+private:
+    struct Pending {
+        FrameRef frame;
+        std::chrono::steady_clock::time_point arrival;
+    };
+
+    void run();
+    void release(FrameRef frame, uint64_t timestamp_ns, uint64_t period_ns);
+
+    std::string name_;
+    size_t jitter_frames_;
+    size_t capacity_;
+    std::atomic<int64_t> period_ns_;
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::deque<Pending> pending_;
+    bool running_;
+    std::thread thread_;
+    Output output_;
+
+    // 출력 스레드만 사용
+    FrameRef last_;
+    int repeats_;
+    double max_error_s_;
+
+    Counter& released_;
+    Counter& duplicated_;
+    Counter& dropped_;
+    Gauge& depth_;
+    Histogram& latency_seconds_;
+    Histogram& error_seconds_;
+};
+
+#endif // FRAME_PACER_H
@@ -0,0 +1,193 @@
+#include "FrameTracer.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <ctime>
+#include <cstdio>
+#include <iomanip>
+#include <pthread.h>
+
+namespace {
+
+// 따옴표를 붙인 JSON 문자열 (제어 문자는 \u00XX)
+std::string jsonString(const std::string& text) {
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+    return out;
+}
+
+} // namespace
+
+FrameTracer& FrameTracer::instance() {
+    static FrameTracer tracer;
+    return tracer;
+}
+
+void FrameTracer::configure(const TracingConfig& config) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    config_ = config;
+    config_.buffer_events = std::max(config_.buffer_events, 64);
+    enabled_.store(config_.enabled);
+    if (config_.enabled) {
+        std::cout << "[INFO] Frame tracing enabled (" << config_.buffer_events << " events/thread, "
+                  << config_.window_seconds << " s window, dumps to " << config_.output_dir << ")" << std::endl;
+    }
+}
+
+FrameTracer::ThreadBuffer* FrameTracer::threadBuffer() {
+    // 스레드당 첫 이벤트에서만 등록 (버퍼는 프로세스 종료까지 유지)
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (buffer) {
+        return buffer;
+    }
+
+    auto created = std::make_unique<ThreadBuffer>();
+    char name[32] = {0};
+    pthread_getname_np(pthread_self(), name, sizeof(name));
+    created->thread_name = name;
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    created->events.resize(config_.buffer_events);
+    created->tid = static_cast<int>(buffers_.size()) + 1;
+    buffers_.push_back(std::move(created));
+    buffer = buffers_.back().get();
+    return buffer;
+}
+
+const char* FrameTracer::intern(const std::string& name) {
+    // set 의 원소는 삽입 후 주소가 바뀌지 않음
+    std::lock_guard<std::mutex> lock(mtx_);
+    return names_.insert(name).first->c_str();
+}
+
+void FrameTracer::setThreadName(const std::string& name) {
+    if (!enabled()) {
+        return;
+    }
+    ThreadBuffer* buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(mtx_);
+    buffer->thread_name = name;
+}
+
+void FrameTracer::record(const char* name, uint64_t begin_ns, uint64_t end_ns, uint32_t frame, uint64_t pts) {
+    if (!enabled()) {
+        return;
+    }
+    ThreadBuffer* buffer = threadBuffer();
+    uint64_t index = buffer->written.load(std::memory_order_relaxed);
+    buffer->events[index % buffer->events.size()] = {name, begin_ns, end_ns, pts, frame};
+    buffer->written.store(index + 1, std::memory_order_release);
+}
+
+void FrameTracer::instant(const char* name, uint32_t frame, uint64_t pts) {
+    if (!enabled()) {
+        return;
+    }
+    uint64_t t = now();
+    record(name, t, t, frame, pts);
+}
+
+void FrameTracer::requestDumpOnDrop() {
+    if (enabled() && config_.dump_on_drop) {
+        drop_dump_requested_.store(true, std::memory_order_relaxed);
+    }
+}
+
+void FrameTracer::pollDump() {
+    bool requested = dump_requested_.exchange(false);
+    if (drop_dump_requested_.exchange(false)) {
+        // 드롭이 연달아 생겨도 덤프 파일이 쏟아지지 않도록 최소 간격 유지
+        uint64_t t = now();
+        const uint64_t min_interval_ns = static_cast<uint64_t>(config_.window_seconds) * 1000000000ULL;
+        if (last_drop_dump_ns_ == 0 || t - last_drop_dump_ns_ >= min_interval_ns) {
+            last_drop_dump_ns_ = t;
+            requested = true;
+        }
+    }
+    if (!requested) {
+        return;
+    }
+
+    char stamp[32];
+    std::time_t wall = std::time(nullptr);
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", std::localtime(&wall));
+    dump(config_.output_dir + "/camstream-trace-" + stamp + ".json");
+}
+
+bool FrameTracer::dump(const std::string& path) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "[ERROR] Could not write trace file: " << path << std::endl;
+        return false;
+    }
+
+    const uint64_t window_start = now() - static_cast<uint64_t>(config_.window_seconds) * 1000000000ULL;
+    size_t event_count = 0;
+
+    // ts/dur 는 마이크로초. 기본 정밀도(유효 숫자 6 자리)면 단조 시계 값이 지수 표기로 뭉개지므로 ns 까지 고정 소수점
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"camstream\"}}";
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    for (const auto& buffer : buffers_) {
+        out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+            << ",\"args\":{\"name\":" << jsonString(buffer->thread_name) << "}}";
+
+        // 기록 중인 스레드와 겹칠 수 있으므로 읽기 전후의 written 으로 덮어쓰였을 수 있는 슬롯을 제외
+        const uint64_t capacity = buffer->events.size();
+        uint64_t end = buffer->written.load(std::memory_order_acquire);
+        uint64_t begin = end > capacity ? end - capacity : 0;
+        std::vector<Event> snapshot;
+        snapshot.reserve(end - begin);
+        for (uint64_t i = begin; i < end; ++i) {
+            snapshot.push_back(buffer->events[i % capacity]);
+        }
+        uint64_t after = buffer->written.load(std::memory_order_acquire);
+        // after 번 이벤트를 쓰는 중일 수 있으므로 그 슬롯(after - capacity 번)까지 제외
+        uint64_t first_intact = after + 1 > capacity ? after + 1 - capacity : 0;
+        size_t overwritten =
+            first_intact > begin ? static_cast<size_t>(std::min<uint64_t>(first_intact - begin, snapshot.size())) : 0;
+
+        for (size_t i = overwritten; i < snapshot.size(); ++i) {
+            const Event& event = snapshot[i];
+            if (event.begin_ns < window_start) {
+                continue;
+            }
+            out << ",\n{\"name\":" << jsonString(event.name) << ",\"pid\":1,\"tid\":" << buffer->tid
+                << ",\"ts\":" << event.begin_ns / 1000.0;
+            if (event.end_ns > event.begin_ns) {
+                out << ",\"ph\":\"X\",\"dur\":" << (event.end_ns - event.begin_ns) / 1000.0;
+            } else {
+                out << ",\"ph\":\"i\",\"s\":\"t\"";
+            }
+            out << ",\"args\":{";
+            bool has_arg = false;
+            if (event.frame != kNoFrame) {
+                out << "\"frame\":" << event.frame;
+                has_arg = true;
+            }
+            if (event.pts != UINT64_MAX) {
+                out << (has_arg ? "," : "") << "\"pts_ms\":" << event.pts / 1000000.0;
+            }
+            out << "}}";
+            event_count++;
+        }
+    }
+    out << "\n]}\n";
+
+    std::cout << "[INFO] Trace written: " << path << " (" << event_count << " events)" << std::endl;
+    return true;
+}
@@ -0,0 +1,103 @@
+#ifndef FRAME_TRACER_H
+#define FRAME_TRACER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ConfigManager.h"
+
+// 프레임 단위 구간 기록기 (Chrome trace JSON 으로 내보내며 Perfetto UI 에서도 열림)
+// 스레드마다 고정 크기 링 버퍼에 기록하므로 핫패스에 락이 없고, 오래된 이벤트는 덮어씀
+class FrameTracer {
+public:
+    static constexpr uint32_t kNoFrame = UINT32_MAX;
+
+    struct Event {
+        const char* name;       // 정적 문자열 또는 intern() 이 돌려준 문자열
+        uint64_t begin_ns;
+        uint64_t end_ns;        // begin_ns 와 같으면 순간 이벤트
+        uint64_t pts;           // GStreamer 버퍼 PTS (없으면 UINT64_MAX)
+        uint32_t frame;         // 센서 sequence (없으면 kNoFrame)
+    };
+
+    static FrameTracer& instance();
+
+    void configure(const TracingConfig& config);
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    static uint64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // 설정에서 온 이름처럼 수명이 짧은 문자열을 이벤트 이름으로 쓸 때: 프로세스 수명 동안 유지되는 사본을 돌려줌
+    // (덤프는 기록 후 한참 뒤에 이름을 읽으므로 그래프 재구성 등으로 원본이 해제돼도 안전해야 함)
+    const char* intern(const std::string& name);
+
+    void record(const char* name, uint64_t begin_ns, uint64_t end_ns, uint32_t frame, uint64_t pts = UINT64_MAX);
+    void instant(const char* name, uint32_t frame, uint64_t pts = UINT64_MAX);
+
+    // 현재 스레드의 trace 이름 (기본값은 pthread 이름)
+    void setThreadName(const std::string& name);
+
+    // 시그널 핸들러에서도 호출 가능 (원자 플래그만 설정). 실제 기록은 pollDump() 가 수행
+    void requestDump() { dump_requested_.store(true, std::memory_order_relaxed); }
+    // 프레임 드롭 감지 시 호출 (dump_on_drop 이 켜져 있을 때만, window_seconds 간격으로 제한)
+    void requestDumpOnDrop();
+
+    // 주 루프에서 주기적으로 호출: 요청된 덤프가 있으면 파일로 기록
+    void pollDump();
+
+    // 최근 window_seconds 동안의 이벤트를 Chrome trace JSON 으로 기록
+    bool dump(const std::string& path);
+
+private:
+    struct ThreadBuffer {
+        std::string thread_name;
+        int tid;
+        std::vector<Event> events;
+        std::atomic<uint64_t> written{0};   // 지금까지 기록한 이벤트 수 (링 인덱스 = written % capacity)
+    };
+
+    FrameTracer() = default;
+    ThreadBuffer* threadBuffer();
+
+    TracingConfig config_ = {false, 8192, 10, "/tmp", false};
+    std::atomic<bool> enabled_{false};
+    std::atomic<bool> dump_requested_{false};
+    std::atomic<bool> drop_dump_requested_{false};
+    uint64_t last_drop_dump_ns_ = 0;
+
+    std::mutex mtx_;    // 스레드 버퍼 등록/덤프 전용
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+    std::set<std::string> names_;   // intern() 한 이름 (해제하지 않음, mtx_ 로 보호)
+};
+
+// 생성부터 소멸까지를 하나의 구간으로 기록
+class TraceSpan {
+private:
+    const char* name_;
+    uint32_t frame_;
+    uint64_t pts_;
+    uint64_t begin_ns_;
+
+public:
+    TraceSpan(const char* name, uint32_t frame, uint64_t pts = UINT64_MAX)
+        : name_(name), frame_(frame), pts_(pts),
+          begin_ns_(FrameTracer::instance().enabled() ? FrameTracer::now() : 0) {}
+    ~TraceSpan() {
+        if (begin_ns_ != 0) {
+            FrameTracer::instance().record(name_, begin_ns_, FrameTracer::now(), frame_, pts_);
+        }
+    }
+
+    void setPts(uint64_t pts) { pts_ = pts; }
+};
+
+#endif // FRAME_TRACER_H
@@ -0,0 +1,295 @@
+#include "GraphStages.h"
+#include "FrameFormat.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+using namespace std::chrono;
+
+bool RtspSinkStage::process(FrameRef& frame) {
+    streamer_->pushFrame(frame.data, frame.owner);
+    return true;
+}
+
+PrivacyStage::PrivacyStage(const PrivacyConfig& config, bool copy)
+    : masker_(config), copy_(copy), planar_(false), row_bytes_(0),
+      pool_misses_(MetricsRegistry::instance().counter("camstream_privacy_copy_misses_total",
+                                                       "Frames dropped by privacy stages with no free copy buffer")) {
+}
+
+bool PrivacyStage::configure(const StreamFormat& input) {
+    if (!masker_.configure(input.width, input.height, input.stride, input.pixel_format)) {
+        return false;
+    }
+    if (!copy_) {
+        return true;
+    }
+
+    // 사본은 행 여백 없이 평면을 이어 붙임
+    planar_ = pixelLayoutFromString(input.pixel_format) == PixelLayout::I420;
+    row_bytes_ = planar_ ? input.width : input.width * 3;
+    size_t luma_size = static_cast<size_t>(row_bytes_) * input.height;
+    pool_ = std::make_shared<Pool>();
+    pool_->frame_size = planar_ ? luma_size + 2 * static_cast<size_t>(input.width / 2) * (input.height / 2) : luma_size;
+    pool_->memory.assign(pool_->frame_size * kCopyBuffers, 0, "privacy copy pool");
+    for (int i = 0; i < kCopyBuffers; ++i) {
+        pool_->free.tryPush(i);
+    }
+    return true;
+}
+
+bool PrivacyStage::copyFrame(FrameRef& frame) {
+    const FrameData& input = frame.data;
+    if (planar_ && input.num_planes < 3) {
+        return false;
+    }
+    int index;
+    if (!pool_->free.tryPop(index)) {
+        pool_misses_.inc();
+        return false;
+    }
+    uint8_t* out = pool_->memory.data() + static_cast<size_t>(index) * pool_->frame_size;
+
+    FrameRef copy = frame;
+    FrameData& data = copy.data;
+    data.data = out;
+    data.size = pool_->frame_size;
+    int planes = planar_ ? 3 : 1;
+    size_t offset = 0;
+    for (int plane = 0; plane < planes; ++plane) {
+        int width = plane == 0 ? row_bytes_ : input.width / 2;
+        int height = plane == 0 ? input.height : input.height / 2;
+        const uint8_t* src = input.plane(plane);
+        for (int y = 0; y < height; ++y) {
+            std::memcpy(out + offset + static_cast<size_t>(y) * width, src + static_cast<size_t>(y) * input.strides[plane],
+                        width);
+        }
+        data.offsets[plane] = offset;
+        data.strides[plane] = width;
+        offset += static_cast<size_t>(width) * height;
+    }
+    data.num_planes = planes;
+
+    std::shared_ptr<Pool> pool = pool_;
+    copy.owner = std::shared_ptr<void>(out, [pool, index](void*) { pool->free.tryPush(index); });
+    frame = std::move(copy);  // 원본 캡처 버퍼 참조는 여기서 놓이고, 다른 단계는 가리지 않은 원본을 계속 읽음
+    return true;
+}
+
+bool PrivacyStage::process(FrameRef& frame) {
+    if (copy_ && !copyFrame(frame)) {
+        return false;
+    }
+    return masker_.apply(frame.data);
+}
+
+bool PacerStage::process(FrameRef& frame) {
+    pacer_.submit(frame);
+    return false;
+}
+
+bool PacerStage::start() {
+    return pacer_.start([this](FrameRef&& frame) { emit(std::move(frame)); });
+}
+
+void PacerStage::stop() {
+    pacer_.stop();
+}
+
+bool RecordStage::process(FrameRef& frame) {
+    recorder_.record(frame.data);
+    return true;
+}
+
+bool RecordStage::start() {
+    return recorder_.start();
+}
+
+void RecordStage::stop() {
+    recorder_.stop();
+}
+
+MotionStage::MotionStage(MotionDetector* detector)
+    : detector_(detector), page_faults_(MemoryResidency::instance().subsystem("analytics")) {
+}
+
+bool MotionStage::process(FrameRef& frame) {
+    PageFaultScope fault_scope(page_faults_);
+    bool motion_active = detector_->process(frame.data);
+    frame.flags |= kFrameMotionChecked | (motion_active ? kFrameMotion : 0);
+    if (motion_active) {
+        const std::vector<MotionRegion>& regions = detector_->getRegions();
+        std::lock_guard<std::mutex> lock(regions_mtx_);
+        regions_.assign(regions.begin(), regions.end());
+    }
+    return true;
+}
+
+void MotionStage::copyRegions(std::vector<MotionRegion>& out) const {
+    std::lock_guard<std::mutex> lock(regions_mtx_);
+    out.assign(regions_.begin(), regions_.end());
+}
+
+DetectorStage::DetectorStage(ObjectDetector* detector, const MotionStage* motion, int frame_interval,
+                             const std::atomic<int>& interval_factor, steady_clock::duration keepalive_interval)
+    : detector_(detector), motion_(motion), frame_interval_(std::max(frame_interval, 1)),
+      interval_factor_(interval_factor), keepalive_interval_(keepalive_interval), frames_since_inference_(0),
+      page_faults_(MemoryResidency::instance().subsystem("analytics")) {
+}
+
+bool DetectorStage::process(FrameRef& frame) {
+    PageFaultScope fault_scope(page_faults_);
+
+    // 모션 단계를 거치지 않은 프레임은 항상 모션이 있는 것으로 봄
+    bool motion_checked = (frame.flags & kFrameMotionChecked) != 0;
+    bool motion_active = !motion_checked || (frame.flags & kFrameMotion) != 0;
+
+    // frame_interval 프레임마다 한 번만 검출하고, 사이 프레임은 추적기 예측으로 보간
+    auto now = steady_clock::now();
+    frames_since_inference_++;
+    int frame_interval = frame_interval_ * interval_factor_.load(std::memory_order_relaxed);
+    bool interval_due = frames_since_inference_ >= frame_interval;
+    if (interval_due && (motion_active || now - last_inference_ >= keepalive_interval_)) {
+        if (motion_ && motion_checked) {
+            motion_->copyRegions(regions_);
+            detector_->setMotionRegions(regions_);
+        }
+        if (detector_->submit(frame.data)) {
+            last_inference_ = now;
+            frames_since_inference_ = 0;
+        }
+    }
+    return true;
+}
+
+TrackerStage::TrackerStage(ObjectTracker* tracker)
+    : tracker_(tracker), last_track_count_(0), page_faults_(MemoryResidency::instance().subsystem("analytics")) {
+}
+
+bool TrackerStage::process(FrameRef&) {
+    PageFaultScope fault_scope(page_faults_);
+    const std::vector<TrackedObject>& tracks = tracker_->step();
+    size_t confirmed = std::count_if(tracks.begin(), tracks.end(),
+                                     [](const TrackedObject& t) { return t.confirmed; });
+    if (confirmed != last_track_count_) {
+        last_track_count_ = confirmed;
+        LOG_DEBUG("tracker") << confirmed << " objects tracked";
+    }
+    return true;
+}
+
+ScaleStage::ScaleStage(int width, int height)
+    : width_(width), height_(height), planar_(false), output_{0, 0, 0, ""}, pool_(std::make_shared<Pool>()),
+      pool_misses_(MetricsRegistry::instance().counter("camstream_scale_pool_misses_total",
+                                                       "Frames dropped by scale stages with no free output buffer")) {
+}
+
+bool ScaleStage::configure(const StreamFormat& input) {
+    if (input.width <= 0 || input.height <= 0 || width_ <= 0 || height_ <= 0) {
+        std::cerr << "[WARN] Scale stage needs input and output sizes" << std::endl;
+        return false;
+    }
+    PixelLayout layout = pixelLayoutFromString(input.pixel_format);
+    int bytes_per_pixel = 1;
+    if (layout == PixelLayout::I420) {
+        if (width_ % 2 != 0 || height_ % 2 != 0) {
+            std::cerr << "[WARN] Scale stage needs an even output size for YUV420" << std::endl;
+            return false;
+        }
+        planar_ = true;
+    } else if (layout == PixelLayout::BGR24 || layout == PixelLayout::RGB24) {
+        bytes_per_pixel = 3;
+    } else {
+        std::cerr << "[WARN] Scale stage does not support " << input.pixel_format << std::endl;
+        return false;
+    }
+
+    // 출력 픽셀 중심에 가장 가까운 입력 픽셀
+    auto nearest = [](int count, int source, std::vector<uint32_t>& table, int scale) {
+        table.resize(count);
+        for (int i = 0; i < count; ++i) {
+            table[i] = static_cast<uint32_t>((2 * static_cast<int64_t>(i) + 1) * source / (2 * count)) * scale;
+        }
+    };
+    nearest(width_, input.width, luma_x_, bytes_per_pixel);
+    nearest(height_, input.height, luma_y_, 1);
+    if (planar_) {
+        nearest(width_ / 2, (input.width + 1) / 2, chroma_x_, 1);
+        nearest(height_ / 2, (input.height + 1) / 2, chroma_y_, 1);
+    }
+
+    int stride = width_ * bytes_per_pixel;
+    pool_->frame_size = planar_ ? static_cast<size_t>(width_) * height_ * 3 / 2 : static_cast<size_t>(stride) * height_;
+    pool_->memory.assign(pool_->frame_size * kScaleBuffers, 0, "graph scale pool");
+    for (int i = 0; i < kScaleBuffers; ++i) {
+        pool_->free.tryPush(i);
+    }
+    output_ = {width_, height_, stride, input.pixel_format};
+    std::cout << "[INFO] Scale stage: " << input.width << "x" << input.height << " -> " << width_ << "x" << height_
+              << " " << input.pixel_format << std::endl;
+    return true;
+}
+
+void ScaleStage::scalePlane(const uint8_t* src, int src_stride, uint8_t* dst, int dst_stride, int width, int height,
+                            const std::vector<uint32_t>& xs, const std::vector<uint32_t>& ys,
+                            int bytes_per_pixel) const {
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* src_row = src + static_cast<size_t>(ys[y]) * src_stride;
+        uint8_t* dst_row = dst + static_cast<size_t>(y) * dst_stride;
+        if (bytes_per_pixel == 3) {
+            for (int x = 0; x < width; ++x) {
+                const uint8_t* pixel = src_row + xs[x];
+                dst_row[3 * x] = pixel[0];
+                dst_row[3 * x + 1] = pixel[1];
+                dst_row[3 * x + 2] = pixel[2];
+            }
+        } else {
+            for (int x = 0; x < width; ++x) {
+                dst_row[x] = src_row[xs[x]];
+            }
+        }
+    }
+}
+
+bool ScaleStage::process(FrameRef& frame) {
+    const FrameData& input = frame.data;
+    if (planar_ && input.num_planes < 3) {
+        return false;
+    }
+    int index;
+    if (!pool_->free.tryPop(index)) {
+        pool_misses_.inc();
+        return false;
+    }
+    uint8_t* out = pool_->memory.data() + static_cast<size_t>(index) * pool_->frame_size;
+
+    FrameRef scaled = frame;
+    FrameData& data = scaled.data;
+    data.data = out;
+    data.size = pool_->frame_size;
+    data.width = width_;
+    data.height = height_;
+    data.offsets[0] = 0;
+    data.strides[0] = output_.stride;
+    if (planar_) {
+        size_t luma_size = static_cast<size_t>(width_) * height_;
+        data.num_planes = 3;
+        data.strides[1] = data.strides[2] = width_ / 2;
+        data.offsets[1] = luma_size;
+        data.offsets[2] = luma_size + luma_size / 4;
+        scalePlane(input.plane(0), input.strides[0], out, width_, width_, height_, luma_x_, luma_y_, 1);
+        for (int plane = 1; plane < 3; ++plane) {
+            scalePlane(input.plane(plane), input.strides[plane], data.plane(plane), width_ / 2, width_ / 2, height_ / 2,
+                       chroma_x_, chroma_y_, 1);
+        }
+    } else {
+        data.num_planes = 1;
+        scalePlane(input.plane(0), input.strides[0], out, output_.stride, width_, height_, luma_x_, luma_y_, 3);
+    }
+
+    std::shared_ptr<Pool> pool = pool_;
+    scaled.owner = std::shared_ptr<void>(out, [pool, index](void*) { pool->free.tryPush(index); });
+    frame = std::move(scaled);  // 입력 프레임 참조는 여기서 놓임
+    return true;
+}
@@ -0,0 +1,197 @@
+#ifndef GRAPH_STAGES_H
+#define GRAPH_STAGES_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "ProcessingGraph.h"
+#include "RtspStreamer.h"
+#include "MotionDetector.h"
+#include "PrivacyMask.h"
+#include "FramePacer.h"
+#include "RawCapture.h"
+#include "ObjectDetector.h"
+#include "ObjectTracker.h"
+#include "MemoryResidency.h"
+#include "MetricsRegistry.h"
+
+// 카메라 소스: 캡처 콜백이 push 한 프레임을 그대로 하류로 넘김 (캡처 스레드에서 분배를 떼어냄)
+class CameraSourceStage : public GraphStage {
+private:
+    StreamFormat format_;
+
+public:
+    explicit CameraSourceStage(const StreamFormat& format) : format_(format) {}
+
+    StreamFormat outputFormat(const StreamFormat&) const override { return format_; }
+    bool process(FrameRef&) override { return true; }
+};
+
+// 인코더 입력: appsrc 에 넣고, 인코더가 읽을 때까지 버퍼 참조를 유지
+// (색 변환과 인코딩은 인코딩 파이프라인의 하드웨어 요소가 수행하고, RTSP 는 그 AU 버스를 구독)
+class RtspSinkStage : public GraphStage {
+private:
+    RtspStreamer* streamer_;
+
+public:
+    explicit RtspSinkStage(RtspStreamer* streamer) : streamer_(streamer) {}
+
+    bool process(FrameRef& frame) override;
+};
+
+// 프라이버시 마스크: 하류(인코더, 분석)가 읽기 전에 설정 영역을 캡처 버퍼에서 직접 가림
+// 같은 캡처 버퍼를 다른 단계도 읽으면(보조 스트림 없이 분석하는 경우 등) copy 모드로 사본을 가려 내보냄
+// 가릴 수 없는 프레임이나 빈 사본 버퍼가 없는 프레임은 내보내지 않음
+class PrivacyStage : public GraphStage {
+private:
+    static constexpr int kCopyBuffers = 4;
+
+    // 하류가 사본을 놓으면 슬롯이 free 목록으로 돌아옴 (ScaleStage 와 같은 방식)
+    struct Pool {
+        ResidentBuffer<uint8_t> memory;
+        MpmcQueue<int> free;
+        size_t frame_size;
+
+        Pool() : free(kCopyBuffers), frame_size(0) {}
+    };
+
+    PrivacyMasker masker_;
+    bool copy_;
+    bool planar_;
+    int row_bytes_;                 // 첫 평면 한 행의 픽셀 바이트 (사본의 stride)
+    std::shared_ptr<Pool> pool_;
+    Counter& pool_misses_;
+
+    bool copyFrame(FrameRef& frame);
+
+public:
+    PrivacyStage(const PrivacyConfig& config, bool copy);
+
+    bool configure(const StreamFormat& input);
+
+    bool process(FrameRef& frame) override;
+};
+
+// 출력 pacing: 프레임을 jitter buffer 에 넣고(process 는 하류로 보내지 않음) pacer 스레드가 일정 주기로 내보냄
+class PacerStage : public GraphStage {
+private:
+    FramePacer pacer_;
+
+public:
+    PacerStage(const PacingConfig& config, const std::string& name, int fps) : pacer_(config, name, fps) {}
+
+    bool process(FrameRef& frame) override;
+    bool start() override;
+    void stop() override;
+
+    void setFrameRate(int fps) { pacer_.setFrameRate(fps); }
+};
+
+// 캡처 덤프: 입력 프레임을 복사해 기록 스레드가 컨테이너 파일에 씀 (프레임은 그대로 하류로 넘김)
+class RecordStage : public GraphStage {
+private:
+    RawRecorder recorder_;
+
+public:
+    RecordStage(const RecordingConfig& config, const std::string& pixel_format, int fps)
+        : recorder_(config, pixel_format, fps) {}
+
+    bool process(FrameRef& frame) override;
+    bool start() override;
+    void stop() override;
+};
+
+// 모션 검출: 프레임에 모션 여부를 표시하고 하류 검출 단계가 쓸 영역을 보관
+class MotionStage : public GraphStage {
+private:
+    MotionDetector* detector_;
+    PageFaultCounters& page_faults_;
+    mutable std::mutex regions_mtx_;
+    std::vector<MotionRegion> regions_;     // 마지막으로 모션이 있던 프레임의 영역
+
+public:
+    explicit MotionStage(MotionDetector* detector);
+
+    bool process(FrameRef& frame) override;
+
+    // 다른 단계(스레드)에서 영역을 복사 (out 의 용량을 재사용)
+    void copyRegions(std::vector<MotionRegion>& out) const;
+};
+
+// 객체 검출: frame_interval 마다, 모션이 없으면 keep-alive 주기로만 검출기에 제출
+class DetectorStage : public GraphStage {
+private:
+    ObjectDetector* detector_;
+    const MotionStage* motion_;             // 상류 모션 단계 (없으면 nullptr)
+    int frame_interval_;
+    const std::atomic<int>& interval_factor_;
+    std::chrono::steady_clock::duration keepalive_interval_;
+    std::chrono::steady_clock::time_point last_inference_;
+    int frames_since_inference_;
+    std::vector<MotionRegion> regions_;
+    PageFaultCounters& page_faults_;
+
+public:
+    DetectorStage(ObjectDetector* detector, const MotionStage* motion, int frame_interval,
+                  const std::atomic<int>& interval_factor, std::chrono::steady_clock::duration keepalive_interval);
+
+    bool process(FrameRef& frame) override;
+};
+
+// 객체 추적: 프레임마다 예측하고 검출기에서 받은 결과로 보정
+class TrackerStage : public GraphStage {
+private:
+    ObjectTracker* tracker_;
+    size_t last_track_count_;
+    PageFaultCounters& page_faults_;
+
+public:
+    explicit TrackerStage(ObjectTracker* tracker);
+
+    bool process(FrameRef& frame) override;
+};
+
+// 최근접 축소/확대: 고정 버퍼 풀에 새 프레임을 만들어 하류로 넘김 (BGR888/RGB888, YUV420)
+// 열/행 위치 표는 configure 에서 미리 계산하므로 프레임마다 나눗셈이 없음
+class ScaleStage : public GraphStage {
+private:
+    static constexpr int kScaleBuffers = 4;
+
+    // 하류가 프레임을 놓으면 슬롯이 free 목록으로 돌아옴 (풀은 마지막 프레임이 놓일 때까지 유지)
+    struct Pool {
+        ResidentBuffer<uint8_t> memory;
+        MpmcQueue<int> free;
+        size_t frame_size;
+
+        Pool() : free(kScaleBuffers), frame_size(0) {}
+    };
+
+    int width_;
+    int height_;
+    bool planar_;                   // YUV420
+    StreamFormat output_;
+    std::vector<uint32_t> luma_x_;  // 출력 열 → 입력 행 안의 바이트 위치 (packed 는 픽셀 시작)
+    std::vector<uint32_t> luma_y_;  // 출력 행 → 입력 행
+    std::vector<uint32_t> chroma_x_;
+    std::vector<uint32_t> chroma_y_;
+    std::shared_ptr<Pool> pool_;
+    Counter& pool_misses_;
+
+    void scalePlane(const uint8_t* src, int src_stride, uint8_t* dst, int dst_stride, int width, int height,
+                    const std::vector<uint32_t>& xs, const std::vector<uint32_t>& ys, int bytes_per_pixel) const;
+
+public:
+    ScaleStage(int width, int height);
+
+    // 입력 형식이 지원되지 않거나 크기가 잘못되면 false
+    bool configure(const StreamFormat& input);
+
+    StreamFormat outputFormat(const StreamFormat&) const override { return output_; }
+    bool process(FrameRef& frame) override;
+};
+
+#endif // GRAPH_STAGES_H
@@ -0,0 +1,280 @@
+#include "Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <pthread.h>
+
+using namespace std::chrono;
+
+namespace {
+
+const char* levelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Info: return "INFO";
+        case LogLevel::Warn: return "WARN";
+        case LogLevel::Error: return "ERROR";
+    }
+    return "INFO";
+}
+
+uint64_t wallNowNs() {
+    return duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+std::string currentThreadName() {
+    char name[32] = {0};
+    pthread_getname_np(pthread_self(), name, sizeof(name));
+    return name;
+}
+
+// JSON 문자열 이스케이프 (제어 문자는 \u00XX)
+void appendJsonString(std::string& out, const char* text, size_t length) {
+    out += '"';
+    for (size_t i = 0; i < length; ++i) {
+        char c = text[i];
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+} // namespace
+
+Logger& Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger()
+    : dropped_total_(MetricsRegistry::instance().counter("camstream_log_dropped_total",
+                                                         "Log lines dropped because a thread's log ring was full")) {
+}
+
+LogLevel Logger::parseLevel(const std::string& name) {
+    if (name == "debug") return LogLevel::Debug;
+    if (name == "warn") return LogLevel::Warn;
+    if (name == "error") return LogLevel::Error;
+    return LogLevel::Info;
+}
+
+void Logger::start(const LoggingConfig& config) {
+    if (running_.load()) {
+        return;
+    }
+    min_level_.store(static_cast<int>(parseLevel(config.level)));
+    rate_limit_.store(config.rate_limit_per_second);
+    json_ = config.format == "json";
+    ring_size_ = std::max(config.ring_size, 16);
+
+    running_.store(true);
+    writer_ = std::thread(&Logger::writerLoop, this);
+}
+
+void Logger::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+}
+
+namespace {
+
+// 다른 thread_local 의 소멸자가 링 반납 뒤에 로그를 남길 수 있으므로 (이 플래그는 소멸되지 않음)
+thread_local bool ring_released = false;
+
+} // namespace
+
+Logger::RingHolder::~RingHolder() {
+    ring_released = true;
+    if (ring) {
+        // 이 스레드의 마지막 push 뒤에 표시하므로 출력 스레드는 표시를 본 뒤 남은 레코드를 모두 볼 수 있음
+        ring->retired.store(true, std::memory_order_release);
+    }
+}
+
+Logger::ThreadRing* Logger::threadRing() {
+    // 스레드당 첫 로그에서만 등록하고, 스레드가 끝나면 출력 스레드가 남은 로그를 비운 뒤 해제
+    if (ring_released) {
+        return nullptr;
+    }
+    thread_local RingHolder holder;
+    if (holder.ring) {
+        return holder.ring;
+    }
+
+    std::string name = currentThreadName();
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    rings_.push_back(std::make_unique<ThreadRing>(std::move(name), ring_size_));
+    holder.ring = rings_.back().get();
+    return holder.ring;
+}
+
+void Logger::submit(Record& record) {
+    ThreadRing* ring = running_.load(std::memory_order_relaxed) ? threadRing() : nullptr;
+    if (!ring) {
+        std::lock_guard<std::mutex> lock(write_mtx_);
+        write(currentThreadName(), record);
+        std::fflush(record.level >= LogLevel::Warn ? stderr : stdout);
+        return;
+    }
+
+    if (!ring->records.tryPush(record)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        dropped_total_.inc();
+    }
+}
+
+void Logger::drain(std::vector<std::pair<const ThreadRing*, Record>>& batch) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    Record record;
+    for (const auto& ring : rings_) {
+        while (ring->records.tryPop(record)) {
+            batch.emplace_back(ring.get(), record);
+        }
+    }
+}
+
+void Logger::reclaim() {
+    // batch 가 링의 thread_name 을 가리키므로 출력을 마친 뒤에만 해제
+    std::lock_guard<std::mutex> lock(mtx_);
+    rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                                [](const std::unique_ptr<ThreadRing>& ring) {
+                                    return ring->retired.load(std::memory_order_acquire) && ring->records.size() == 0;
+                                }),
+                 rings_.end());
+}
+
+void Logger::writerLoop() {
+    std::vector<std::pair<const ThreadRing*, Record>> batch;
+    batch.reserve(1024);
+
+    while (true) {
+        bool running = running_.load();
+        batch.clear();
+        drain(batch);
+
+        // 스레드별 링을 모았으므로 시각 순으로 정렬해서 출력
+        std::stable_sort(batch.begin(), batch.end(),
+                         [](const auto& a, const auto& b) { return a.second.wall_ns < b.second.wall_ns; });
+        for (const auto& entry : batch) {
+            write(entry.first->thread_name, entry.second);
+        }
+        reclaim();
+
+        uint64_t dropped = dropped_.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            Record record = {wallNowNs(), "logger", LogLevel::Warn, 0, {}};
+            record.length = static_cast<uint16_t>(std::snprintf(record.message, kMessageSize,
+                "%llu log lines dropped (ring full)", static_cast<unsigned long long>(dropped)));
+            write(currentThreadName(), record);
+        }
+
+        if (!batch.empty() || dropped > 0) {
+            std::fflush(stdout);
+            std::fflush(stderr);
+        }
+        if (!running) {
+            break;  // 정지 요청 후 마지막으로 한 번 더 비움
+        }
+        if (batch.empty()) {
+            std::this_thread::sleep_for(milliseconds(20));
+        }
+    }
+}
+
+void Logger::write(const std::string& thread_name, const Record& record) {
+    std::time_t seconds = static_cast<std::time_t>(record.wall_ns / 1000000000ULL);
+    int millis = static_cast<int>(record.wall_ns / 1000000ULL % 1000);
+    std::tm tm;
+    char stamp[32];
+
+    std::string line;
+    line.reserve(kMessageSize + 96);
+    if (json_) {
+        gmtime_r(&seconds, &tm);
+        std::strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%S", &tm);
+        char millis_text[8];
+        std::snprintf(millis_text, sizeof(millis_text), ".%03dZ", millis);
+        line += "{\"ts\":\"";
+        line += stamp;
+        line += millis_text;
+        line += "\",\"level\":\"";
+        line += levelName(record.level);
+        line += "\",\"component\":\"";
+        line += record.component;
+        line += "\",\"thread\":";
+        appendJsonString(line, thread_name.data(), thread_name.size());
+        line += ",\"msg\":";
+        appendJsonString(line, record.message, record.length);
+        line += "}\n";
+    } else {
+        localtime_r(&seconds, &tm);
+        std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &tm);
+        char prefix[96];
+        std::snprintf(prefix, sizeof(prefix), "%s.%03d [%s] [%s] ", stamp, millis, levelName(record.level),
+                      record.component);
+        line += prefix;
+        line.append(record.message, record.length);
+        line += '\n';
+    }
+
+    std::fwrite(line.data(), 1, line.size(), record.level >= LogLevel::Warn ? stderr : stdout);
+}
+
+bool LogSite::allow(LogLevel level) {
+    Logger& logger = Logger::instance();
+    if (!logger.enabled(level)) {
+        return false;
+    }
+    int limit = logger.rateLimit();
+    if (limit <= 0) {
+        return true;
+    }
+
+    uint64_t now = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    uint64_t window_start = window_start_ns_.load(std::memory_order_relaxed);
+    if (now - window_start >= 1000000000ULL &&
+        window_start_ns_.compare_exchange_strong(window_start, now, std::memory_order_relaxed)) {
+        count_.store(0, std::memory_order_relaxed);
+    }
+    if (count_.fetch_add(1, std::memory_order_relaxed) < limit) {
+        return true;
+    }
+    suppressed_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+LogLine::LogLine(LogLevel level, const char* component, LogSite& site)
+    : suppressed_(site.takeSuppressed()) {
+    record_.wall_ns = wallNowNs();
+    record_.component = component;
+    record_.level = level;
+    record_.length = 0;
+}
+
+LogLine::~LogLine() {
+    if (suppressed_ > 0) {
+        *this << " (" << suppressed_ << " similar suppressed)";
+    }
+    Logger::instance().submit(record_);
+}
+
+LogLine& LogLine::operator<<(double value) {
+    char buffer[32];
+    int length = std::snprintf(buffer, sizeof(buffer), "%g", value);
+    append(buffer, length > 0 ? static_cast<size_t>(length) : 0);
+    return *this;
+}
@@ -0,0 +1,152 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "BoundedQueue.h"
+#include "ConfigManager.h"
+#include "MetricsRegistry.h"
+
+enum class LogLevel : int {
+    Debug = 0,
+    Info = 1,
+    Warn = 2,
+    Error = 3
+};
+
+// 비동기 로거
+// 호출 스레드는 고정 크기 레코드를 스택에서 포맷해 자기 스레드의 SPSC 링에 넣기만 하고,
+// 출력(stdout/stderr, text 또는 JSON)은 백그라운드 스레드가 수행함. 링이 가득 차면 버리고 개수만 셈
+class Logger {
+public:
+    static constexpr size_t kMessageSize = 224;
+
+    struct Record {
+        uint64_t wall_ns;           // CLOCK_REALTIME
+        const char* component;      // 정적 문자열
+        LogLevel level;
+        uint16_t length;
+        char message[kMessageSize];
+    };
+
+    static Logger& instance();
+
+    // 설정 적용 후 출력 스레드 시작 (시작 전/정지 후의 로그는 호출 스레드에서 바로 출력)
+    void start(const LoggingConfig& config);
+    void stop();
+
+    bool enabled(LogLevel level) const {
+        return static_cast<int>(level) >= min_level_.load(std::memory_order_relaxed);
+    }
+    int rateLimit() const { return rate_limit_.load(std::memory_order_relaxed); }
+
+    void submit(Record& record);
+
+    static LogLevel parseLevel(const std::string& name);
+
+private:
+    struct ThreadRing {
+        std::string thread_name;
+        SpscQueue<Record> records;      // 호출 스레드 -> 출력 스레드
+        std::atomic<bool> retired{false};   // 스레드가 끝나 더 이상 넣지 않음 (비면 출력 스레드가 해제)
+
+        ThreadRing(std::string name, size_t size) : thread_name(std::move(name)), records(size) {}
+    };
+
+    // 스레드 종료 시 thread_local 소멸자에서 링을 반납
+    struct RingHolder {
+        ThreadRing* ring = nullptr;
+        ~RingHolder();
+    };
+
+    Logger();
+    ThreadRing* threadRing();
+    void writerLoop();
+    void drain(std::vector<std::pair<const ThreadRing*, Record>>& batch);
+    void reclaim();
+    void write(const std::string& thread_name, const Record& record);
+
+    std::atomic<int> min_level_{static_cast<int>(LogLevel::Info)};
+    std::atomic<int> rate_limit_{10};
+    bool json_ = false;
+    size_t ring_size_ = 256;
+
+    std::atomic<bool> running_{false};
+    std::thread writer_;
+    std::atomic<uint64_t> dropped_{0};
+    Counter& dropped_total_;
+    std::mutex write_mtx_;  // 출력 스레드가 없을 때 직접 출력하는 스레드 간 줄 섞임 방지
+
+    std::mutex mtx_;    // 링 등록/해제 전용
+    std::vector<std::unique_ptr<ThreadRing>> rings_;
+};
+
+// 호출 위치별 속도 제한: 1초에 rate_limit 개까지만 출력하고 나머지는 개수를 다음 출력에 붙임
+class LogSite {
+private:
+    std::atomic<uint64_t> window_start_ns_{0};
+    std::atomic<int> count_{0};
+    std::atomic<uint32_t> suppressed_{0};
+
+public:
+    bool allow(LogLevel level);
+    uint32_t takeSuppressed() { return suppressed_.exchange(0, std::memory_order_relaxed); }
+};
+
+// 한 줄의 로그. 스택의 Record 에 포맷하고 소멸 시 로거에 넘김 (힙 할당 없음)
+class LogLine {
+private:
+    Logger::Record record_;
+    uint32_t suppressed_;
+
+    void append(const char* text, size_t length) {
+        size_t room = Logger::kMessageSize - record_.length;
+        size_t n = length < room ? length : room;
+        std::memcpy(record_.message + record_.length, text, n);
+        record_.length += static_cast<uint16_t>(n);
+    }
+
+public:
+    LogLine(LogLevel level, const char* component, LogSite& site);
+    ~LogLine();
+
+    LogLine(const LogLine&) = delete;
+    LogLine& operator=(const LogLine&) = delete;
+
+    LogLine& operator<<(const char* text) { append(text, std::strlen(text)); return *this; }
+    LogLine& operator<<(const std::string& text) { append(text.data(), text.size()); return *this; }
+    LogLine& operator<<(char c) { append(&c, 1); return *this; }
+    LogLine& operator<<(bool value) { return *this << (value ? "true" : "false"); }
+    LogLine& operator<<(double value);
+    LogLine& operator<<(float value) { return *this << static_cast<double>(value); }
+
+    template <typename T, typename = std::enable_if_t<std::is_integral<T>::value>>
+    LogLine& operator<<(T value) {
+        char buffer[24];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        append(buffer, result.ptr - buffer);
+        return *this;
+    }
+};
+
+// 사용법: LOG_WARN("capture") << "Request failed with status " << status;
+// 레벨이 꺼져 있거나 속도 제한에 걸리면 인자를 평가하지 않음
+#define CAMSTREAM_LOG(level, component) \
+    if (static LogSite camstream_log_site_; !camstream_log_site_.allow(level)) {} \
+    else LogLine(level, component, camstream_log_site_)
+
+#define LOG_DEBUG(component) CAMSTREAM_LOG(LogLevel::Debug, component)
+#define LOG_INFO(component) CAMSTREAM_LOG(LogLevel::Info, component)
+#define LOG_WARN(component) CAMSTREAM_LOG(LogLevel::Warn, component)
+#define LOG_ERROR(component) CAMSTREAM_LOG(LogLevel::Error, component)
+
+#endif // LOGGER_H
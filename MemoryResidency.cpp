@@ -0,0 +1,258 @@
+#include "MemoryResidency.h"
+#include "Logger.h"
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+using namespace std::chrono;
+
+namespace {
+
+constexpr size_t kPageSize = 4096;
+constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+constexpr size_t kAllocationAlignment = 64;
+constexpr uint64_t kReportIntervalNs = 10ULL * 1000 * 1000 * 1000;
+
+thread_local PageFaultScope* t_current_scope = nullptr;
+
+bool readFaults(int who, uint64_t& minor, uint64_t& major) {
+    rusage usage;
+    if (getrusage(who, &usage) != 0) {
+        return false;
+    }
+    minor = static_cast<uint64_t>(usage.ru_minflt);
+    major = static_cast<uint64_t>(usage.ru_majflt);
+    return true;
+}
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// THP 가 "never" 면 madvise(MADV_HUGEPAGE) 가 성공해도 4K 페이지로 남음
+bool transparentHugepagesAvailable() {
+    std::ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+    std::string mode;
+    std::getline(file, mode);
+    return !mode.empty() && mode.find("[never]") == std::string::npos;
+}
+
+PageFaultCounters* makeCounters(const char* name) {
+    MetricsRegistry& registry = MetricsRegistry::instance();
+    std::string prefix = std::string("camstream_") + name + "_page_faults_";
+    std::string subject = std::string(name) == "process" ? "the whole process" : std::string(name) + " scopes";
+    return new PageFaultCounters{name,
+                                 registry.counter(prefix + "minor_total", "Minor page faults in " + subject),
+                                 registry.counter(prefix + "major_total", "Major page faults in " + subject),
+                                 0, 0};
+}
+
+} // namespace
+
+MemoryResidency& MemoryResidency::instance() {
+    static MemoryResidency residency;
+    return residency;
+}
+
+MemoryResidency::MemoryResidency() : process_(*makeCounters("process")) {
+}
+
+void MemoryResidency::configure(const MemoryConfig& config) {
+    prefault_ = config.prefault;
+    report_.store(config.report_page_faults);
+
+    if (config.lock) {
+        lockMemory();
+    }
+    if (config.arena_mb > 0 && (config.prefault || config.hugepages != "off")) {
+        reserveArena(static_cast<size_t>(config.arena_mb) * 1024 * 1024, config.hugepages);
+    }
+    if (config.report_page_faults) {
+        readFaults(RUSAGE_SELF, process_.reported_minor, process_.reported_major);
+        last_report_ns_ = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+void MemoryResidency::lockMemory() {
+    // MCL_ONFAULT: 이후 매핑(스레드 스택 등)을 통째로 폴트하지 않고, 실제로 건드린 페이지만 고정
+#ifdef MCL_ONFAULT
+    if (mlockall(MCL_CURRENT | MCL_FUTURE | MCL_ONFAULT) == 0) {
+        std::cout << "[INFO] Process memory locked (mlockall, on fault)" << std::endl;
+        return;
+    }
+#endif
+    if (mlockall(MCL_CURRENT) == 0) {
+        std::cout << "[INFO] Process memory locked (mlockall, current mappings only)" << std::endl;
+        return;
+    }
+    std::cerr << "[WARN] mlockall failed: " << std::strerror(errno)
+              << " (raise RLIMIT_MEMLOCK with 'ulimit -l' or grant CAP_IPC_LOCK)" << std::endl;
+}
+
+void MemoryResidency::reserveArena(size_t size, const std::string& hugepages) {
+    size = alignUp(size, kHugePageSize);
+    const char* backing = "4K pages";
+    void* memory = MAP_FAILED;
+
+    if (hugepages == "explicit") {
+        // hugetlbfs 풀(vm.nr_hugepages)에서 할당. 풀이 부족하면 THP 로 대체
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (prefault_ ? MAP_POPULATE : 0);
+        memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (memory != MAP_FAILED) {
+            backing = "explicit hugepages";
+        } else {
+            std::cerr << "[WARN] MAP_HUGETLB arena failed: " << std::strerror(errno)
+                      << " (reserve pages via vm.nr_hugepages), falling back to transparent hugepages" << std::endl;
+        }
+    }
+
+    if (memory == MAP_FAILED) {
+        // THP 는 2MB 정렬된 영역에서만 쓰이므로 여유를 두고 매핑한 뒤 앞뒤를 잘라냄
+        size_t reserve = size + kHugePageSize;
+        void* raw = mmap(nullptr, reserve, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) {
+            std::cerr << "[WARN] Memory arena reservation failed: " << std::strerror(errno) << std::endl;
+            return;
+        }
+        uintptr_t begin = reinterpret_cast<uintptr_t>(raw);
+        uintptr_t aligned = alignUp(begin, kHugePageSize);
+        if (aligned > begin) {
+            munmap(raw, aligned - begin);
+        }
+        size_t tail = begin + reserve - (aligned + size);
+        if (tail > 0) {
+            munmap(reinterpret_cast<void*>(aligned + size), tail);
+        }
+        memory = reinterpret_cast<void*>(aligned);
+
+        if (hugepages != "off") {
+            if (madvise(memory, size, MADV_HUGEPAGE) == 0 && transparentHugepagesAvailable()) {
+                backing = "transparent hugepages";
+            } else {
+                std::cerr << "[WARN] Transparent hugepages unavailable, arena uses 4K pages" << std::endl;
+            }
+        }
+        // MAP_POPULATE 는 madvise 전에 4K 페이지로 채우므로 여기서 직접 씀
+        if (prefault_) {
+            uint8_t* bytes = static_cast<uint8_t*>(memory);
+            for (size_t offset = 0; offset < size; offset += kPageSize) {
+                bytes[offset] = 0;
+            }
+        }
+    }
+
+    arena_ = static_cast<uint8_t*>(memory);
+    arena_size_ = size;
+    std::cout << "[INFO] Memory arena: " << size / (1024 * 1024) << " MB, " << backing
+              << (prefault_ ? ", prefaulted" : "") << std::endl;
+}
+
+void* MemoryResidency::allocate(size_t size, const char* owner) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!arena_) {
+        return nullptr;
+    }
+    size_t offset = alignUp(arena_used_, kAllocationAlignment);
+    if (offset + size > arena_size_) {
+        LOG_WARN("memory") << "Memory arena exhausted, " << owner << " uses heap for " << size / 1024
+                           << " KB (increase memory.arena_mb)";
+        return nullptr;
+    }
+    arena_used_ = offset + size;
+    LOG_INFO("memory") << "Arena: " << owner << " " << size / 1024 << " KB (" << arena_used_ / 1024 << "/"
+                       << arena_size_ / 1024 << " KB used)";
+    return arena_ + offset;
+}
+
+PageFaultCounters& MemoryResidency::subsystem(const char* name) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    for (const auto& counters : subsystems_) {
+        if (std::strcmp(counters->name, name) == 0) {
+            return *counters;
+        }
+    }
+    subsystems_.emplace_back(makeCounters(name));
+    return *subsystems_.back();
+}
+
+void MemoryResidency::reportPageFaults() {
+    if (!reportEnabled()) {
+        return;
+    }
+    uint64_t now = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    if (now - last_report_ns_ < kReportIntervalNs) {
+        return;
+    }
+    last_report_ns_ = now;
+
+    uint64_t process_minor = 0;
+    uint64_t process_major = 0;
+    if (!readFaults(RUSAGE_SELF, process_minor, process_major)) {
+        return;
+    }
+    process_.minor.inc(process_minor - process_.reported_minor);
+    process_.major.inc(process_major - process_.reported_major);
+
+    // 구간 밖(GStreamer 스트리밍 스레드, libcamera 내부 등)의 폴트는 other 로 표시
+    std::string summary;
+    uint64_t scoped_minor = 0;
+    uint64_t scoped_major = 0;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        for (const auto& counters : subsystems_) {
+            uint64_t minor = counters->minor.value() - counters->reported_minor;
+            uint64_t major = counters->major.value() - counters->reported_major;
+            counters->reported_minor += minor;
+            counters->reported_major += major;
+            scoped_minor += minor;
+            scoped_major += major;
+            summary += std::string(counters->name) + " " + std::to_string(minor) + "/" + std::to_string(major) + ", ";
+        }
+    }
+    uint64_t total_minor = process_minor - process_.reported_minor;
+    uint64_t total_major = process_major - process_.reported_major;
+    process_.reported_minor = process_minor;
+    process_.reported_major = process_major;
+    summary += "other " + std::to_string(total_minor > scoped_minor ? total_minor - scoped_minor : 0) + "/" +
+               std::to_string(total_major > scoped_major ? total_major - scoped_major : 0);
+
+    if (total_minor == 0 && total_major == 0) {
+        LOG_DEBUG("memory") << "No page faults in the last " << kReportIntervalNs / 1000000000ULL << " s";
+    } else {
+        LOG_INFO("memory") << "Page faults (minor/major) in the last " << kReportIntervalNs / 1000000000ULL
+                           << " s: " << summary;
+    }
+}
+
+PageFaultScope::PageFaultScope(PageFaultCounters& counters)
+    : counters_(nullptr), parent_(nullptr), begin_minor_(0), begin_major_(0), child_minor_(0), child_major_(0) {
+    if (!MemoryResidency::instance().reportEnabled() || !readFaults(RUSAGE_THREAD, begin_minor_, begin_major_)) {
+        return;
+    }
+    counters_ = &counters;
+    parent_ = t_current_scope;
+    t_current_scope = this;
+}
+
+PageFaultScope::~PageFaultScope() {
+    if (!counters_) {
+        return;
+    }
+    uint64_t end_minor = begin_minor_;
+    uint64_t end_major = begin_major_;
+    readFaults(RUSAGE_THREAD, end_minor, end_major);
+
+    uint64_t minor = end_minor - begin_minor_;
+    uint64_t major = end_major - begin_major_;
+    counters_->minor.inc(minor > child_minor_ ? minor - child_minor_ : 0);
+    counters_->major.inc(major > child_major_ ? major - child_major_ : 0);
+    if (parent_) {
+        parent_->child_minor_ += minor;
+        parent_->child_major_ += major;
+    }
+    t_current_scope = parent_;
+}
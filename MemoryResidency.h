@@ -0,0 +1,115 @@
+#ifndef MEMORY_RESIDENCY_H
+#define MEMORY_RESIDENCY_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ConfigManager.h"
+#include "MetricsRegistry.h"
+
+// 서브시스템 하나의 페이지 폴트 집계 (camstream_<name>_page_faults_{minor,major}_total)
+struct PageFaultCounters {
+    const char* name;
+    Counter& minor;
+    Counter& major;
+    uint64_t reported_minor;    // 마지막 보고 시점의 값 (보고하는 주 루프 전용)
+    uint64_t reported_major;
+};
+
+// 메모리 상주 모드
+// - 큰 중간 버퍼(추론 텐서, 변환 scratch)를 시작 시 예약한 arena 에서 할당 (hugepage, 미리 폴트 선택)
+// - mlockall 로 한 번 폴트된 페이지가 회수/스왑되지 않도록 고정
+// - PageFaultScope 구간별 minor/major 폴트를 메트릭과 주기 로그로 보고해 정상 상태에 폴트가 없는지 확인
+class MemoryResidency {
+public:
+    static MemoryResidency& instance();
+
+    // 다른 서브시스템 초기화 전에 한 번 호출
+    void configure(const MemoryConfig& config);
+
+    bool prefaultEnabled() const { return prefault_; }
+    bool reportEnabled() const { return report_.load(std::memory_order_relaxed); }
+
+    // arena 에서 할당 (초기화 경로 전용, 해제 없음). arena 가 없거나 공간이 부족하면 nullptr
+    void* allocate(size_t size, const char* owner);
+
+    // 같은 이름이면 같은 객체를 반환하며 프로세스 종료까지 유효
+    PageFaultCounters& subsystem(const char* name);
+
+    // 주 루프에서 주기적으로 호출: 직전 보고 이후의 서브시스템별 폴트를 로그로 남김
+    void reportPageFaults();
+
+private:
+    MemoryResidency();
+    void lockMemory();
+    void reserveArena(size_t size, const std::string& hugepages);
+
+    bool prefault_ = false;
+    std::atomic<bool> report_{false};
+
+    std::mutex mtx_;    // arena 할당, 서브시스템 등록 전용
+    uint8_t* arena_ = nullptr;
+    size_t arena_size_ = 0;
+    size_t arena_used_ = 0;
+    std::vector<std::unique_ptr<PageFaultCounters>> subsystems_;
+
+    PageFaultCounters& process_;    // 프로세스 전체 (RUSAGE_SELF, 보고 시점에 갱신)
+    uint64_t last_report_ns_ = 0;
+};
+
+// 현재 스레드에서 생성부터 소멸까지 발생한 페이지 폴트를 서브시스템에 더함
+// 중첩되면 안쪽 구간의 폴트는 바깥 구간에서 빠짐. report_page_faults 가 꺼져 있으면 아무것도 하지 않음
+class PageFaultScope {
+private:
+    PageFaultCounters* counters_;
+    PageFaultScope* parent_;
+    uint64_t begin_minor_;
+    uint64_t begin_major_;
+    uint64_t child_minor_;
+    uint64_t child_major_;
+
+public:
+    explicit PageFaultScope(PageFaultCounters& counters);
+    ~PageFaultScope();
+
+    PageFaultScope(const PageFaultScope&) = delete;
+    PageFaultScope& operator=(const PageFaultScope&) = delete;
+};
+
+// arena 에 잡는 고정 크기 버퍼 (arena 가 없거나 부족하면 힙)
+// 크기가 바뀔 때만 다시 할당하며 이전 arena 영역은 돌려받지 않으므로 configure 단계에서만 사용
+template <typename T>
+class ResidentBuffer {
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+    std::unique_ptr<T[]> heap_;
+
+public:
+    void assign(size_t count, T value, const char* owner) {
+        if (count != size_) {
+            heap_.reset();
+            data_ = static_cast<T*>(MemoryResidency::instance().allocate(count * sizeof(T), owner));
+            if (!data_) {
+                heap_.reset(new T[count]);
+                data_ = heap_.get();
+            }
+            size_ = count;
+        }
+        std::fill(data_, data_ + count, value);
+    }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    size_t size() const { return size_; }
+    T& operator[](size_t index) { return data_[index]; }
+    const T& operator[](size_t index) const { return data_[index]; }
+};
+
+#endif // MEMORY_RESIDENCY_H
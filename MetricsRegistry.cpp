@@ -0,0 +1,137 @@
+#include "MetricsRegistry.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace {
+
+void formatValue(std::ostringstream& out, double value) {
+    if (std::isinf(value)) {
+        out << (value > 0 ? "+Inf" : "-Inf");
+    } else {
+        out << value;
+    }
+}
+
+} // namespace
+
+Histogram::Histogram(const std::vector<double>& bounds)
+    : bounds_(bounds), buckets_(new std::atomic<uint64_t>[bounds.size() + 1]) {
+    std::sort(bounds_.begin(), bounds_.end());
+    for (size_t i = 0; i <= bounds_.size(); ++i) {
+        buckets_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void Histogram::observe(double value) {
+    // 버킷 수가 적으므로 선형 탐색
+    size_t index = 0;
+    while (index < bounds_.size() && value > bounds_[index]) {
+        ++index;
+    }
+    buckets_[index].fetch_add(1, std::memory_order_relaxed);
+
+    double current = sum_.load(std::memory_order_relaxed);
+    while (!sum_.compare_exchange_weak(current, current + value, std::memory_order_relaxed)) {
+    }
+}
+
+MetricsRegistry& MetricsRegistry::instance() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricsRegistry::Entry* MetricsRegistry::find(const std::string& name, Type type) {
+    for (auto& entry : entries_) {
+        if (entry->name == name && entry->type == type) {
+            return entry.get();
+        }
+    }
+    return nullptr;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (Entry* entry = find(name, Type::Counter)) {
+        return *entry->counter;
+    }
+    auto entry = std::make_unique<Entry>();
+    entry->name = name;
+    entry->help = help;
+    entry->type = Type::Counter;
+    entry->counter = std::make_unique<Counter>();
+    entries_.push_back(std::move(entry));
+    return *entries_.back()->counter;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (Entry* entry = find(name, Type::Gauge)) {
+        return *entry->gauge;
+    }
+    auto entry = std::make_unique<Entry>();
+    entry->name = name;
+    entry->help = help;
+    entry->type = Type::Gauge;
+    entry->gauge = std::make_unique<Gauge>();
+    entries_.push_back(std::move(entry));
+    return *entries_.back()->gauge;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help,
+                                      const std::vector<double>& bounds) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (Entry* entry = find(name, Type::Histogram)) {
+        return *entry->histogram;
+    }
+    auto entry = std::make_unique<Entry>();
+    entry->name = name;
+    entry->help = help;
+    entry->type = Type::Histogram;
+    entry->histogram = std::make_unique<Histogram>(bounds);
+    entries_.push_back(std::move(entry));
+    return *entries_.back()->histogram;
+}
+
+std::string MetricsRegistry::render() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+
+    std::ostringstream out;
+    out.precision(15);
+    for (const auto& entry : entries_) {
+        out << "# HELP " << entry->name << " " << entry->help << "\n";
+        switch (entry->type) {
+            case Type::Counter:
+                out << "# TYPE " << entry->name << " counter\n";
+                out << entry->name << " " << entry->counter->value() << "\n";
+                break;
+            case Type::Gauge:
+                out << "# TYPE " << entry->name << " gauge\n";
+                out << entry->name << " ";
+                formatValue(out, entry->gauge->value());
+                out << "\n";
+                break;
+            case Type::Histogram: {
+                const Histogram& histogram = *entry->histogram;
+                out << "# TYPE " << entry->name << " histogram\n";
+                // 버킷은 누적 개수로 출력
+                uint64_t cumulative = 0;
+                for (size_t i = 0; i < histogram.bounds().size(); ++i) {
+                    cumulative += histogram.bucketCount(i);
+                    out << entry->name << "_bucket{le=\"";
+                    formatValue(out, histogram.bounds()[i]);
+                    out << "\"} " << cumulative << "\n";
+                }
+                cumulative += histogram.bucketCount(histogram.bounds().size());
+                out << entry->name << "_bucket{le=\"+Inf\"} " << cumulative << "\n";
+                out << entry->name << "_sum ";
+                formatValue(out, histogram.sum());
+                out << "\n";
+                // +Inf 버킷과 _count 가 일치하도록 버킷 합계를 사용
+                out << entry->name << "_count " << cumulative << "\n";
+                break;
+            }
+        }
+    }
+    return out.str();
+}
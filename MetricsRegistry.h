@@ -0,0 +1,87 @@
+#ifndef METRICS_REGISTRY_H
+#define METRICS_REGISTRY_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 단조 증가 카운터 (핫패스에서 relaxed 원자 연산만 사용)
+class Counter {
+private:
+    std::atomic<uint64_t> value_{0};
+
+public:
+    void inc(uint64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+};
+
+// 현재 값을 나타내는 게이지
+class Gauge {
+private:
+    std::atomic<double> value_{0.0};
+
+public:
+    void set(double value) { value_.store(value, std::memory_order_relaxed); }
+    void add(double delta) {
+        double current = value_.load(std::memory_order_relaxed);
+        while (!value_.compare_exchange_weak(current, current + delta, std::memory_order_relaxed)) {
+        }
+    }
+    double value() const { return value_.load(std::memory_order_relaxed); }
+};
+
+// 고정 버킷 히스토그램 (버킷 경계는 등록 시 정해지고 이후 변경되지 않음)
+class Histogram {
+private:
+    std::vector<double> bounds_;
+    std::unique_ptr<std::atomic<uint64_t>[]> buckets_;     // bounds_.size() + 1 (+Inf)
+    std::atomic<double> sum_{0.0};
+
+public:
+    explicit Histogram(const std::vector<double>& bounds);
+
+    void observe(double value);
+
+    const std::vector<double>& bounds() const { return bounds_; }
+    uint64_t bucketCount(size_t index) const { return buckets_[index].load(std::memory_order_relaxed); }
+    double sum() const { return sum_.load(std::memory_order_relaxed); }
+};
+
+// 프로세스 전역 메트릭 레지스트리
+// 등록은 초기화 경로에서 mutex 로 보호하고, 반환된 참조는 프로세스 종료까지 유효하므로
+// 각 서브시스템은 참조를 보관해 두고 락 없이 갱신함
+class MetricsRegistry {
+private:
+    enum class Type { Counter, Gauge, Histogram };
+
+    struct Entry {
+        std::string name;
+        std::string help;
+        Type type;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+    };
+
+    mutable std::mutex mtx_;
+    std::vector<std::unique_ptr<Entry>> entries_;
+
+    MetricsRegistry() = default;
+    Entry* find(const std::string& name, Type type);
+
+public:
+    static MetricsRegistry& instance();
+
+    // 같은 이름으로 다시 등록하면 기존 메트릭을 반환
+    Counter& counter(const std::string& name, const std::string& help);
+    Gauge& gauge(const std::string& name, const std::string& help);
+    Histogram& histogram(const std::string& name, const std::string& help, const std::vector<double>& bounds);
+
+    // Prometheus text exposition format (0.0.4)
+    std::string render() const;
+};
+
+#endif // METRICS_REGISTRY_H
@@ -0,0 +1,116 @@
+#include "MetricsServer.h"
+#include "MetricsRegistry.h"
+#include <iostream>
+#include <cstring>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+MetricsServer::MetricsServer(const MetricsConfig& config)
+    : config_(config), listen_fd_(-1), is_running_(false) {
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+bool MetricsServer::start() {
+    listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        std::cerr << "[ERROR] Failed to create metrics socket: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(config_.port));
+    if (inet_pton(AF_INET, config_.bind_address.c_str(), &addr.sin_addr) != 1) {
+        std::cerr << "[ERROR] Invalid metrics bind address: " << config_.bind_address << std::endl;
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(listen_fd_, 4) < 0) {
+        std::cerr << "[ERROR] Failed to listen on metrics port " << config_.port << ": " << strerror(errno) << std::endl;
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    is_running_.store(true);
+    server_thread_ = std::thread(&MetricsServer::serverLoop, this);
+    std::cout << "[INFO] Metrics endpoint ready at: http://" << config_.bind_address << ":" << config_.port
+              << "/metrics" << std::endl;
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (is_running_.exchange(false)) {
+        if (server_thread_.joinable()) {
+            server_thread_.join();
+        }
+    }
+    if (listen_fd_ >= 0) {
+        close(listen_fd_);
+        listen_fd_ = -1;
+    }
+}
+
+void MetricsServer::serverLoop() {
+    pollfd pfd = {listen_fd_, POLLIN, 0};
+    while (is_running_.load()) {
+        // 종료 요청을 확인할 수 있도록 짧은 타임아웃으로 대기
+        int ready = poll(&pfd, 1, 200);
+        if (ready <= 0) {
+            continue;
+        }
+        int client_fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client_fd < 0) {
+            continue;
+        }
+        handleClient(client_fd);
+        close(client_fd);
+    }
+}
+
+void MetricsServer::handleClient(int client_fd) {
+    // 느린 클라이언트가 서버를 붙잡지 않도록 수신 타임아웃 설정
+    timeval timeout = {1, 0};
+    setsockopt(client_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    char request[1024];
+    ssize_t received = recv(client_fd, request, sizeof(request) - 1, 0);
+    if (received <= 0) {
+        return;
+    }
+    request[received] = '\0';
+
+    std::string status = "200 OK";
+    std::string body;
+    if (strncmp(request, "GET /metrics", 12) == 0) {
+        body = MetricsRegistry::instance().render();
+    } else {
+        status = "404 Not Found";
+        body = "not found\n";
+    }
+
+    std::string response = "HTTP/1.1 " + status + "\r\n"
+                           "Content-Type: text/plain; version=0.0.4\r\n"
+                           "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                           "Connection: close\r\n\r\n" + body;
+
+    size_t sent = 0;
+    while (sent < response.size()) {
+        ssize_t n = send(client_fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            break;
+        }
+        sent += static_cast<size_t>(n);
+    }
+}
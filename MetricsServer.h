@@ -0,0 +1,31 @@
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "ConfigManager.h"
+
+// GET /metrics 에 Prometheus 형식으로 응답하는 최소 HTTP 서버
+// 스크레이프는 수 초에 한 번이므로 단일 스레드에서 연결을 하나씩 처리함
+class MetricsServer {
+private:
+    MetricsConfig config_;
+    int listen_fd_;
+    std::thread server_thread_;
+    std::atomic<bool> is_running_;
+
+public:
+    explicit MetricsServer(const MetricsConfig& config);
+    ~MetricsServer();
+
+    bool start();
+    void stop();
+
+private:
+    void serverLoop();
+    void handleClient(int client_fd);
+};
+
+#endif // METRICS_SERVER_H
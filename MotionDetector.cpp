@@ -0,0 +1,263 @@
+#include "MotionDetector.h"
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define MOTION_USE_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define MOTION_USE_SSE2 1
+#endif
+
+namespace {
+
+// a, b 의 절대차를 8 바이트 그룹마다 합산해 out 에 누적 (count 는 16 의 배수)
+void accumulateSad8(const uint8_t* a, const uint8_t* b, int count, uint32_t* out) {
+#if defined(MOTION_USE_NEON)
+    for (int i = 0; i < count; i += 16) {
+        uint8x16_t diff = vabdq_u8(vld1q_u8(a + i), vld1q_u8(b + i));
+        uint64x2_t sums = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(diff)));
+        out[i / 8] += static_cast<uint32_t>(vgetq_lane_u64(sums, 0));
+        out[i / 8 + 1] += static_cast<uint32_t>(vgetq_lane_u64(sums, 1));
+    }
+#elif defined(MOTION_USE_SSE2)
+    for (int i = 0; i < count; i += 16) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        __m128i sums = _mm_sad_epu8(va, vb);
+        out[i / 8] += static_cast<uint32_t>(_mm_cvtsi128_si32(sums));
+        out[i / 8 + 1] += static_cast<uint32_t>(_mm_extract_epi16(sums, 4));
+    }
+#else
+    for (int i = 0; i < count; i += 8) {
+        uint32_t sum = 0;
+        for (int j = 0; j < 8; ++j) {
+            sum += static_cast<uint32_t>(std::abs(a[i + j] - b[i + j]));
+        }
+        out[i / 8] += sum;
+    }
+#endif
+}
+
+} // namespace
+
+MotionDetector::MotionDetector(const MotionConfig& config)
+    : config_(config), width_(0), height_(0), stride_(0), layout_(PixelLayout::BGR24),
+      small_width_(0), small_height_(0), blocks_x_(0), blocks_y_(0),
+      has_background_(false), hold_counter_(0) {
+}
+
+bool MotionDetector::configure(int width, int height, int stride, const std::string& pixel_format) {
+    if (config_.downscale < 1 || config_.block_size < 8 || config_.block_size % 8 != 0) {
+        std::cerr << "[ERROR] Invalid motion config: downscale=" << config_.downscale
+                  << ", block_size=" << config_.block_size << " (must be a multiple of 8)" << std::endl;
+        return false;
+    }
+
+    width_ = width;
+    height_ = height;
+    stride_ = stride;
+    layout_ = pixelLayoutFromString(pixel_format);
+
+    // SIMD 처리를 위해 축소 폭은 16 의 배수로 맞춤
+    small_width_ = (width_ / config_.downscale) & ~15;
+    small_height_ = height_ / config_.downscale;
+    blocks_x_ = small_width_ / config_.block_size;
+    blocks_y_ = small_height_ / config_.block_size;
+    if (blocks_x_ == 0 || blocks_y_ == 0) {
+        std::cerr << "[ERROR] Motion grid is empty for " << width_ << "x" << height_
+                  << " with downscale " << config_.downscale << std::endl;
+        return false;
+    }
+
+    row_accum_.assign(static_cast<size_t>(small_width_) * config_.downscale, 0);
+    luma_.assign(static_cast<size_t>(small_width_) * small_height_, 0);
+    background_.assign(luma_.size(), 0);
+    background8_.assign(luma_.size(), 0);
+    group_sad_.assign(small_width_ / 8, 0);
+    motion_mask_.assign(static_cast<size_t>(blocks_x_) * blocks_y_, 0);
+    fill_stack_.reserve(motion_mask_.size());
+    regions_.reserve(motion_mask_.size());
+    has_background_ = false;
+    hold_counter_ = 0;
+
+    std::cout << "[INFO] Motion detector configured: " << small_width_ << "x" << small_height_
+              << " luma, " << blocks_x_ << "x" << blocks_y_ << " blocks" << std::endl;
+    return true;
+}
+
+void MotionDetector::setMotionCallback(std::function<void(const std::vector<MotionRegion>&)> callback) {
+    motion_callback_ = callback;
+}
+
+bool MotionDetector::process(const FrameData& frame_data) {
+    if (luma_.empty()) {
+        return true;
+    }
+
+    downscaleLuma(frame_data.plane(0));
+
+    if (!has_background_) {
+        for (size_t i = 0; i < luma_.size(); ++i) {
+            background_[i] = static_cast<uint16_t>(luma_[i] << 8);
+        }
+        background8_ = luma_;
+        has_background_ = true;
+        return isMotionActive();
+    }
+
+    int motion_blocks = computeMotionBlocks();
+    updateBackground();
+
+    regions_.clear();
+    if (motion_blocks >= config_.min_blocks) {
+        hold_counter_ = config_.hold_frames + 1;
+        extractRegions();
+        if (motion_callback_) {
+            motion_callback_(regions_);
+        }
+    } else if (hold_counter_ > 0) {
+        hold_counter_--;
+    }
+
+    return isMotionActive();
+}
+
+void MotionDetector::downscaleLuma(const uint8_t* src) {
+    const int ds = config_.downscale;
+    const int src_cols = small_width_ * ds;
+    const int area = ds * ds;
+
+    for (int y = 0; y < small_height_; ++y) {
+        std::fill(row_accum_.begin(), row_accum_.end(), 0);
+        uint16_t* accum = row_accum_.data();
+
+        // ds 개의 원본 행을 열 단위로 누적 (컴파일러 자동 벡터화 대상)
+        for (int r = 0; r < ds; ++r) {
+            const uint8_t* row = src + static_cast<size_t>(y * ds + r) * stride_;
+            switch (layout_) {
+                case PixelLayout::I420:
+                    for (int x = 0; x < src_cols; ++x) {
+                        accum[x] += row[x];
+                    }
+                    break;
+                case PixelLayout::YUYV:
+                    for (int x = 0; x < src_cols; ++x) {
+                        accum[x] += row[x * 2];
+                    }
+                    break;
+                case PixelLayout::BGR24:
+                    // BT.601 근사 (B, G, R 가중치 29/150/77)
+                    for (int x = 0; x < src_cols; ++x) {
+                        const uint8_t* p = row + x * 3;
+                        accum[x] += static_cast<uint16_t>((29 * p[0] + 150 * p[1] + 77 * p[2]) >> 8);
+                    }
+                    break;
+                case PixelLayout::RGB24:
+                    for (int x = 0; x < src_cols; ++x) {
+                        const uint8_t* p = row + x * 3;
+                        accum[x] += static_cast<uint16_t>((77 * p[0] + 150 * p[1] + 29 * p[2]) >> 8);
+                    }
+                    break;
+            }
+        }
+
+        uint8_t* out = luma_.data() + static_cast<size_t>(y) * small_width_;
+        for (int x = 0; x < small_width_; ++x) {
+            uint32_t sum = 0;
+            for (int k = 0; k < ds; ++k) {
+                sum += accum[x * ds + k];
+            }
+            out[x] = static_cast<uint8_t>(sum / area);
+        }
+    }
+}
+
+int MotionDetector::computeMotionBlocks() {
+    const int bs = config_.block_size;
+    const int groups_per_block = bs / 8;
+    const uint32_t block_threshold = static_cast<uint32_t>(config_.sad_threshold) * bs * bs;
+    int motion_blocks = 0;
+
+    for (int by = 0; by < blocks_y_; ++by) {
+        std::fill(group_sad_.begin(), group_sad_.end(), 0);
+        for (int r = 0; r < bs; ++r) {
+            size_t offset = static_cast<size_t>(by * bs + r) * small_width_;
+            accumulateSad8(luma_.data() + offset, background8_.data() + offset, small_width_, group_sad_.data());
+        }
+
+        for (int bx = 0; bx < blocks_x_; ++bx) {
+            uint32_t sad = 0;
+            for (int g = 0; g < groups_per_block; ++g) {
+                sad += group_sad_[bx * groups_per_block + g];
+            }
+            bool moving = sad > block_threshold;
+            motion_mask_[by * blocks_x_ + bx] = moving ? 1 : 0;
+            motion_blocks += moving ? 1 : 0;
+        }
+    }
+    return motion_blocks;
+}
+
+void MotionDetector::updateBackground() {
+    const int shift = config_.background_shift;
+    for (size_t i = 0; i < luma_.size(); ++i) {
+        int32_t current = static_cast<int32_t>(luma_[i]) << 8;
+        int32_t bg = background_[i];
+        bg += (current - bg) >> shift;
+        background_[i] = static_cast<uint16_t>(bg);
+        background8_[i] = static_cast<uint8_t>(bg >> 8);
+    }
+}
+
+void MotionDetector::extractRegions() {
+    // 인접한(4 방향) 모션 블록을 하나의 사각형 영역으로 묶음
+    const int scale = config_.block_size * config_.downscale;
+
+    for (int start = 0; start < blocks_x_ * blocks_y_; ++start) {
+        if (motion_mask_[start] != 1) {
+            continue;
+        }
+
+        int min_x = blocks_x_, min_y = blocks_y_, max_x = 0, max_y = 0, count = 0;
+        fill_stack_.clear();
+        fill_stack_.push_back(start);
+        motion_mask_[start] = 2;
+
+        while (!fill_stack_.empty()) {
+            int index = fill_stack_.back();
+            fill_stack_.pop_back();
+            int bx = index % blocks_x_;
+            int by = index / blocks_x_;
+            min_x = std::min(min_x, bx);
+            min_y = std::min(min_y, by);
+            max_x = std::max(max_x, bx);
+            max_y = std::max(max_y, by);
+            count++;
+
+            const int neighbours[4] = {
+                bx > 0 ? index - 1 : -1,
+                bx < blocks_x_ - 1 ? index + 1 : -1,
+                by > 0 ? index - blocks_x_ : -1,
+                by < blocks_y_ - 1 ? index + blocks_x_ : -1
+            };
+            for (int n : neighbours) {
+                if (n >= 0 && motion_mask_[n] == 1) {
+                    motion_mask_[n] = 2;
+                    fill_stack_.push_back(n);
+                }
+            }
+        }
+
+        MotionRegion region;
+        region.x = min_x * scale;
+        region.y = min_y * scale;
+        region.width = std::min((max_x - min_x + 1) * scale, width_ - region.x);
+        region.height = std::min((max_y - min_y + 1) * scale, height_ - region.y);
+        region.blocks = count;
+        regions_.push_back(region);
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef MOTION_DETECTOR_H
+#define MOTION_DETECTOR_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "ConfigManager.h"
+#include "FrameFormat.h"
+#include "FrameData.h"
+
+// 원본 프레임 좌표 기준의 모션 영역
+struct MotionRegion {
+    int x;
+    int y;
+    int width;
+    int height;
+    int blocks;     // 영역에 포함된 모션 블록 수
+};
+
+// 다운스케일된 luma 평면에서 블록 단위 SAD 로 모션을 검출
+// 캡처 버퍼에서 직접 luma 를 축소하므로 별도의 프레임 복사가 없음
+class MotionDetector {
+private:
+    MotionConfig config_;
+
+    int width_;
+    int height_;
+    int stride_;
+    PixelLayout layout_;
+
+    int small_width_;
+    int small_height_;
+    int blocks_x_;
+    int blocks_y_;
+
+    std::vector<uint16_t> row_accum_;   // 세로 방향 누적 (원본 열 단위)
+    std::vector<uint8_t> luma_;         // 현재 프레임의 축소 luma
+    std::vector<uint16_t> background_;  // 배경 (8.8 고정소수점)
+    std::vector<uint8_t> background8_;  // SAD 비교용 배경
+    std::vector<uint32_t> group_sad_;   // 8 열 단위 SAD
+    std::vector<uint8_t> motion_mask_;  // 블록별 모션 여부
+    std::vector<int> fill_stack_;
+
+    std::vector<MotionRegion> regions_;
+    bool has_background_;
+    int hold_counter_;
+
+    std::function<void(const std::vector<MotionRegion>&)> motion_callback_;
+
+public:
+    explicit MotionDetector(const MotionConfig& config);
+
+    // 캡처 스트림의 실제 크기/stride 로 내부 버퍼를 준비
+    bool configure(int width, int height, int stride, const std::string& pixel_format);
+
+    // 프레임을 처리하고 모션 활성 여부(hold 포함)를 반환
+    bool process(const FrameData& frame_data);
+
+    bool isMotionActive() const { return hold_counter_ > 0; }
+    const std::vector<MotionRegion>& getRegions() const { return regions_; }
+
+    // 모션 영역이 검출된 프레임마다 호출됨 (캡처 스레드)
+    void setMotionCallback(std::function<void(const std::vector<MotionRegion>&)> callback);
+
+private:
+    void downscaleLuma(const uint8_t* src);
+    int computeMotionBlocks();
+    void updateBackground();
+    void extractRegions();
+};
+
+#endif // MOTION_DETECTOR_H
@@ -0,0 +1,595 @@
+#include "ObjectDetector.h"
+#include "StartupTimeline.h"
+#include "FrameTracer.h"
+#include "Logger.h"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+
+using namespace std::chrono;
+
+namespace {
+
+// YOLOv5 letterbox 패딩 값
+constexpr uint8_t kPadValue = 114;
+
+// 타일 경계에서 잘린 박스를 온전한 박스에 병합하기 위한 IoS 임계값
+constexpr float kTileMergeIoS = 0.6f;
+
+// 타일 우선순위 계산에 쓰는 모션 영역 최대 개수 (넘치면 버림; 추론 중 재할당하지 않도록 미리 잡아 둠)
+constexpr size_t kMaxMotionRegions = 256;
+
+inline uint8_t clampToByte(int value) {
+    return static_cast<uint8_t>(std::min(255, std::max(0, value)));
+}
+
+// length 를 tile 크기 조각으로 최소 overlap 만큼 겹치게 나눈 시작 위치 (양 끝은 프레임 경계에 맞춤)
+std::vector<int> tilePositions(int length, int tile, int overlap) {
+    if (length <= tile) {
+        return {0};
+    }
+    int step = std::max(1, tile - overlap);
+    int count = (length - overlap + step - 1) / step;
+    count = std::max(count, 2);
+    std::vector<int> positions(count);
+    for (int i = 0; i < count; ++i) {
+        positions[i] = static_cast<int>(static_cast<long>(i) * (length - tile) / (count - 1));
+    }
+    return positions;
+}
+
+} // namespace
+
+ObjectDetector::ObjectDetector(const InferenceConfig& config)
+    : config_(config), input_width_(0), input_height_(0),
+      frame_width_(0), frame_height_(0), frame_stride_(0), layout_(PixelLayout::BGR24),
+      tile_count_(0), full_frame_region_(-1), schedule_(TileSchedule::RoundRobin), next_tile_(0),
+      result_lifetime_(1),
+      requests_(2), busy_(false), stopping_(false),
+      inferences_(MetricsRegistry::instance().counter("camstream_inferences_total",
+                                                     "Completed detector runs (rate() gives inference fps)")),
+      inferences_skipped_(MetricsRegistry::instance().counter("camstream_inferences_skipped_total",
+                                                             "Frames offered while the detector was busy")),
+      inference_latency_(MetricsRegistry::instance().histogram("camstream_inference_latency_seconds",
+                                                              "Detector run time including decode and NMS",
+                                                              {0.01, 0.02, 0.05, 0.1, 0.2, 0.5, 1.0})),
+      page_faults_(MemoryResidency::instance().subsystem("detector")) {
+    if (config_.tile_schedule == "all") {
+        schedule_ = TileSchedule::All;
+    } else if (config_.tile_schedule == "motion") {
+        schedule_ = TileSchedule::Motion;
+    } else if (config_.tile_schedule != "round_robin") {
+        std::cout << "[WARN] Unknown tile schedule: " << config_.tile_schedule << ", using round_robin" << std::endl;
+    }
+}
+
+ObjectDetector::~ObjectDetector() {
+    stop();
+}
+
+std::string ObjectDetector::resolveModelPath(const InferenceConfig& config) {
+    std::string suffix;
+    if (config.precision == "FP16") {
+        suffix = "_fp16";
+    } else if (config.precision == "INT8") {
+        suffix = "_int8";
+    } else if (config.precision != "FP32") {
+        std::cout << "[WARN] Unknown model precision: " << config.precision << ", using FP32" << std::endl;
+    }
+
+    std::string path = config.model_path;
+    size_t ext = path.rfind(".xml");
+    if (!suffix.empty() && ext != std::string::npos) {
+        path.insert(ext, suffix);
+    }
+    return path;
+}
+
+bool ObjectDetector::initialize() {
+    std::string model_path = resolveModelPath(config_);
+    std::cout << "[INFO] Loading detection model: " << model_path << " (" << config_.precision
+              << ") on " << config_.device << std::endl;
+
+    // 타일 모드는 여러 요청을 동시에 실행하므로 처리량 우선으로 컴파일
+    ov::AnyMap properties = {
+        ov::hint::performance_mode(config_.tiling_enabled ? ov::hint::PerformanceMode::THROUGHPUT
+                                                          : ov::hint::PerformanceMode::LATENCY)
+    };
+    // INT8 IR 은 양자화 정보를 따르므로 연산 정밀도 힌트를 주지 않음
+    if (config_.precision == "FP16") {
+        properties.emplace(ov::hint::inference_precision(ov::element::f16));
+    } else if (config_.precision != "INT8") {
+        properties.emplace(ov::hint::inference_precision(ov::element::f32));
+    }
+    if (config_.threads > 0) {
+        properties.emplace(ov::inference_num_threads(config_.threads));
+    }
+
+    try {
+        // 컴파일 결과를 디스크에 캐시해 두면 다음 실행부터는 그래프 최적화 없이 blob 만 읽음
+        // (캐시 키에 모델, reshape 결과, 속성, 디바이스가 포함되므로 설정이 바뀌면 자동으로 다시 컴파일)
+        if (!config_.cache_dir.empty()) {
+            core_.set_property(ov::cache_dir(config_.cache_dir));
+        }
+
+        StartupTimeline::Scope scope("model_compile");
+        std::shared_ptr<ov::Model> model = core_.read_model(model_path);
+        // YOLOv5 는 완전 합성곱 구조라 입력 크기(32 의 배수)만 바꾸면 됨
+        if (config_.input_size > 0) {
+            model->reshape(ov::PartialShape({1, 3, static_cast<size_t>(config_.input_size),
+                                             static_cast<size_t>(config_.input_size)}));
+        }
+        compiled_model_ = core_.compile_model(model, config_.device, properties);
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] Failed to load detection model: " << e.what() << std::endl;
+        return false;
+    }
+
+    // 입력 레이아웃: NCHW [1, 3, H, W]
+    ov::Shape input_shape = compiled_model_.input().get_shape();
+    if (input_shape.size() != 4 || input_shape[1] != 3) {
+        std::cerr << "[ERROR] Unexpected model input shape" << std::endl;
+        return false;
+    }
+    input_height_ = static_cast<int>(input_shape[2]);
+    input_width_ = static_cast<int>(input_shape[3]);
+
+    std::cout << "[INFO] Detection model ready: input " << input_width_ << "x" << input_height_ << std::endl;
+    return true;
+}
+
+bool ObjectDetector::configure(int width, int height, int stride, const std::string& pixel_format) {
+    if (input_width_ == 0) {
+        std::cerr << "[ERROR] Detector must be initialized before configure" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(slots_mtx_);
+    frame_width_ = width;
+    frame_height_ = height;
+    frame_stride_ = stride;
+    layout_ = pixelLayoutFromString(pixel_format);
+
+    regions_.clear();
+    tile_count_ = 0;
+    full_frame_region_ = -1;
+    if (config_.tiling_enabled) {
+        buildTiles();
+    }
+    if (!config_.tiling_enabled || config_.tile_full_frame) {
+        full_frame_region_ = static_cast<int>(regions_.size());
+        regions_.emplace_back();
+        buildRegion(regions_.back(), 0, 0, width, height, false);
+    }
+
+    // 제출 한 번에 실행할 요청 수
+    size_t slot_count = 1;
+    if (config_.tiling_enabled) {
+        size_t budget = static_cast<size_t>(tile_count_);
+        if (schedule_ != TileSchedule::All && config_.tiles_per_frame > 0) {
+            budget = std::min(budget, static_cast<size_t>(config_.tiles_per_frame));
+        }
+        slot_count = budget + (full_frame_region_ >= 0 ? 1 : 0);
+    }
+
+    try {
+        slots_.clear();
+        slots_.resize(slot_count);
+        size_t input_size = static_cast<size_t>(3) * input_width_ * input_height_;
+        for (auto& slot : slots_) {
+            slot.request = compiled_model_.create_infer_request();
+            slot.staging.assign(input_size, kPadValue, "detector staging");
+            // 플러그인이 잡은 텐서 대신 미리 폴트된 메모리를 입력 텐서로 사용
+            slot.input.assign(input_size, 0.0f, "detector tensor");
+            slot.request.set_input_tensor(ov::Tensor(ov::element::f32, compiled_model_.input().get_shape(),
+                                                     slot.input.data()));
+            slot.region = -1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] Failed to create inference requests: " << e.what() << std::endl;
+        slots_.clear();
+        return false;
+    }
+    running_regions_.assign(slot_count, -1);
+    region_detections_.assign(regions_.size(), std::vector<Detection>());
+    region_age_.assign(regions_.size(), 0);
+    // 순환 스케줄이 모든 타일을 한 번씩 도는 데 걸리는 제출 수
+    size_t tile_budget = slot_count - (full_frame_region_ >= 0 ? 1 : 0);
+    result_lifetime_ = tile_budget > 0 ? static_cast<uint32_t>((tile_count_ + tile_budget - 1) / tile_budget) : 1;
+    tile_selected_.assign(tile_count_, 0);
+    tile_priority_.reserve(tile_count_);
+    motion_regions_.reserve(kMaxMotionRegions);
+    next_tile_ = 0;
+
+    if (config_.tiling_enabled) {
+        std::cout << "[INFO] Tiled inference: " << tile_count_ << " tiles of " << input_width_ << "x" << input_height_
+                  << ", " << slot_count << " requests per submission" << std::endl;
+    }
+    return true;
+}
+
+void ObjectDetector::buildTiles() {
+    std::vector<int> xs = tilePositions(frame_width_, input_width_, config_.tile_overlap);
+    std::vector<int> ys = tilePositions(frame_height_, input_height_, config_.tile_overlap);
+
+    for (int y : ys) {
+        for (int x : xs) {
+            regions_.emplace_back();
+            buildRegion(regions_.back(), x, y,
+                        std::min(input_width_, frame_width_ - x),
+                        std::min(input_height_, frame_height_ - y), true);
+        }
+    }
+    tile_count_ = static_cast<int>(regions_.size());
+}
+
+void ObjectDetector::buildRegion(SamplingRegion& region, int src_x, int src_y, int src_width, int src_height,
+                                 bool is_tile) {
+    region.src_x = src_x;
+    region.src_y = src_y;
+    region.src_width = src_width;
+    region.src_height = src_height;
+    // 타일은 원본 해상도 그대로 (크기가 모자라면 패딩), 전체 프레임은 letterbox 축소
+    region.scale = is_tile ? 1.0f : std::min(1.0f * input_width_ / src_width, 1.0f * input_height_ / src_height);
+
+    int scaled_width = std::min(input_width_, static_cast<int>(src_width * region.scale));
+    int scaled_height = std::min(input_height_, static_cast<int>(src_height * region.scale));
+    region.pad_x = (input_width_ - scaled_width) / 2;
+    region.pad_y = (input_height_ - scaled_height) / 2;
+
+    // 프레임마다 나눗셈을 하지 않도록 최근접 샘플링 좌표를 미리 계산
+    int bytes_per_pixel = (layout_ == PixelLayout::I420) ? 1 : (layout_ == PixelLayout::YUYV ? 2 : 3);
+    region.column_offsets.assign(input_width_, -1);
+    for (int x = 0; x < scaled_width; ++x) {
+        int src = src_x + std::min(src_width - 1, static_cast<int>((x + 0.5f) / region.scale));
+        if (layout_ == PixelLayout::YUYV) {
+            src &= ~1;    // 매크로픽셀(Y0 U Y1 V) 시작 위치
+        }
+        region.column_offsets[region.pad_x + x] = src * bytes_per_pixel;
+    }
+    region.row_indices.assign(input_height_, -1);
+    for (int y = 0; y < scaled_height; ++y) {
+        region.row_indices[region.pad_y + y] =
+            src_y + std::min(src_height - 1, static_cast<int>((y + 0.5f) / region.scale));
+    }
+}
+
+bool ObjectDetector::start() {
+    stopping_.store(false);
+    worker_ = std::thread(&ObjectDetector::workerLoop, this);
+    return true;
+}
+
+void ObjectDetector::stop() {
+    if (stopping_.exchange(true)) return;
+
+    requests_.close();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void ObjectDetector::setDetectionCallback(std::function<void(const std::vector<Detection>&)> callback) {
+    detection_callback_ = callback;
+}
+
+void ObjectDetector::setMotionRegions(const std::vector<MotionRegion>& regions) {
+    size_t count = std::min(regions.size(), kMaxMotionRegions);
+    if (count < regions.size()) {
+        LOG_WARN("detector") << "Dropped " << regions.size() - count << " of " << regions.size()
+                             << " motion regions (max " << kMaxMotionRegions << ")";
+    }
+    motion_regions_.assign(regions.begin(), regions.begin() + count);
+}
+
+bool ObjectDetector::submit(const FrameData& frame_data) {
+    if (stopping_.load() || slots_.empty()) {
+        return false;
+    }
+    if (busy_.exchange(true)) {
+        inferences_skipped_.inc();
+        return false;
+    }
+
+    {
+        TraceSpan sample_span("detector_sample", frame_data.sequence);
+        prepareSlots(frame_data);
+    }
+
+    // busy_ 로 한 번에 하나만 넘기므로 자리가 없을 수 없음
+    requests_.tryPush(frame_data.sequence);
+    return true;
+}
+
+bool ObjectDetector::detect(const FrameData& frame_data, std::vector<Detection>& detections) {
+    if (slots_.empty()) {
+        return false;
+    }
+
+    prepareSlots(frame_data);
+    if (!runSlots()) {
+        return false;
+    }
+    detections = detections_;
+    return true;
+}
+
+void ObjectDetector::reset() {
+    std::lock_guard<std::mutex> lock(slots_mtx_);
+    for (auto& region_result : region_detections_) {
+        region_result.clear();
+    }
+    std::fill(region_age_.begin(), region_age_.end(), 0);
+    detections_.clear();
+    motion_regions_.clear();
+    next_tile_ = 0;
+}
+
+void ObjectDetector::prepareSlots(const FrameData& frame) {
+    if (config_.tiling_enabled) {
+        scheduleTiles(slots_.size() - (full_frame_region_ >= 0 ? 1 : 0));
+    } else {
+        slots_[0].region = full_frame_region_;
+    }
+
+    for (auto& slot : slots_) {
+        if (slot.region >= 0) {
+            sampleRegion(regions_[slot.region], frame, slot.staging.data());
+        }
+    }
+}
+
+void ObjectDetector::scheduleTiles(size_t budget) {
+    std::fill(tile_selected_.begin(), tile_selected_.end(), 0);
+    size_t chosen = 0;
+
+    // 모션 영역과 많이 겹치는 타일부터 실행
+    if (schedule_ == TileSchedule::Motion && !motion_regions_.empty()) {
+        tile_priority_.clear();
+        for (int t = 0; t < tile_count_; ++t) {
+            const SamplingRegion& tile = regions_[t];
+            int overlap = 0;
+            for (const auto& motion : motion_regions_) {
+                int w = std::min(tile.src_x + tile.src_width, motion.x + motion.width) - std::max(tile.src_x, motion.x);
+                int h = std::min(tile.src_y + tile.src_height, motion.y + motion.height) - std::max(tile.src_y, motion.y);
+                if (w > 0 && h > 0) {
+                    overlap += w * h;
+                }
+            }
+            if (overlap > 0) {
+                tile_priority_.emplace_back(overlap, t);
+            }
+        }
+        std::sort(tile_priority_.begin(), tile_priority_.end(),
+                  [](const std::pair<int, int>& a, const std::pair<int, int>& b) { return a.first > b.first; });
+        for (const auto& entry : tile_priority_) {
+            if (chosen >= budget) break;
+            slots_[chosen++].region = entry.second;
+            tile_selected_[entry.second] = 1;
+        }
+    }
+
+    // 남은 예산은 순환 방식으로 채움
+    while (chosen < budget) {
+        int t = static_cast<int>(next_tile_++ % tile_count_);
+        if (tile_selected_[t]) continue;
+        slots_[chosen++].region = t;
+        tile_selected_[t] = 1;
+    }
+
+    if (full_frame_region_ >= 0) {
+        slots_[chosen].region = full_frame_region_;
+    }
+}
+
+void ObjectDetector::sampleRegion(const SamplingRegion& region, const FrameData& frame, uint8_t* staging) {
+    const size_t plane_size = static_cast<size_t>(input_width_) * input_height_;
+    uint8_t* r_plane = staging;
+    uint8_t* g_plane = r_plane + plane_size;
+    uint8_t* b_plane = g_plane + plane_size;
+
+    // 벤치마크처럼 평면 정보 없이 들어온 프레임은 configure 의 stride 로 처리
+    const uint8_t* src = frame.plane(0);
+    const int stride = frame.strides[0] > 0 ? frame.strides[0] : frame_stride_;
+    const bool has_chroma = layout_ == PixelLayout::I420 && frame.num_planes == 3;
+
+    for (int y = 0; y < input_height_; ++y) {
+        int src_y = region.row_indices[y];
+        size_t out = static_cast<size_t>(y) * input_width_;
+        if (src_y < 0) {
+            std::fill(r_plane + out, r_plane + out + input_width_, kPadValue);
+            std::fill(g_plane + out, g_plane + out + input_width_, kPadValue);
+            std::fill(b_plane + out, b_plane + out + input_width_, kPadValue);
+            continue;
+        }
+        const uint8_t* row = src + static_cast<size_t>(src_y) * stride;
+        const uint8_t* u_row = nullptr;
+        const uint8_t* v_row = nullptr;
+        if (has_chroma) {
+            u_row = frame.plane(1) + static_cast<size_t>(src_y / 2) * frame.strides[1];
+            v_row = frame.plane(2) + static_cast<size_t>(src_y / 2) * frame.strides[2];
+        }
+
+        for (int x = 0; x < input_width_; ++x, ++out) {
+            int offset = region.column_offsets[x];
+            if (offset < 0) {
+                r_plane[out] = g_plane[out] = b_plane[out] = kPadValue;
+                continue;
+            }
+            const uint8_t* p = row + offset;
+            switch (layout_) {
+                case PixelLayout::BGR24:
+                    r_plane[out] = p[2];
+                    g_plane[out] = p[1];
+                    b_plane[out] = p[0];
+                    break;
+                case PixelLayout::RGB24:
+                    r_plane[out] = p[0];
+                    g_plane[out] = p[1];
+                    b_plane[out] = p[2];
+                    break;
+                case PixelLayout::YUYV: {
+                    // BT.601 정수 근사
+                    int c = p[0] - 16;
+                    int d = p[1] - 128;
+                    int e = p[3] - 128;
+                    r_plane[out] = clampToByte((298 * c + 409 * e + 128) >> 8);
+                    g_plane[out] = clampToByte((298 * c - 100 * d - 208 * e + 128) >> 8);
+                    b_plane[out] = clampToByte((298 * c + 516 * d + 128) >> 8);
+                    break;
+                }
+                case PixelLayout::I420: {
+                    if (!has_chroma) {
+                        r_plane[out] = g_plane[out] = b_plane[out] = p[0];
+                        break;
+                    }
+                    // 크로마는 2x2 서브샘플링이므로 열 오프셋(= luma 열)의 절반
+                    int c = p[0] - 16;
+                    int d = u_row[offset >> 1] - 128;
+                    int e = v_row[offset >> 1] - 128;
+                    r_plane[out] = clampToByte((298 * c + 409 * e + 128) >> 8);
+                    g_plane[out] = clampToByte((298 * c - 100 * d - 208 * e + 128) >> 8);
+                    b_plane[out] = clampToByte((298 * c + 516 * d + 128) >> 8);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void ObjectDetector::workerLoop() {
+    LOG_INFO("detector") << "Detector worker started";
+    FrameTracer::instance().setThreadName("detector");
+    size_t inference_count = 0;
+
+    uint32_t sequence;
+    while (requests_.pop(sequence) && !stopping_.load()) {
+        auto start_time = steady_clock::now();
+        TraceSpan inference_span("inference", sequence);
+        PageFaultScope fault_scope(page_faults_);
+        std::lock_guard<std::mutex> lock(slots_mtx_);
+
+        if (!runSlots()) {
+            continue;
+        }
+        inferences_.inc();
+        inference_latency_.observe(duration<double>(steady_clock::now() - start_time).count());
+
+        if (detection_callback_) {
+            detection_callback_(detections_);
+        }
+
+        auto elapsed = duration_cast<milliseconds>(steady_clock::now() - start_time).count();
+        if (++inference_count % 50 == 0) {
+            LOG_DEBUG("detector") << "Inference #" << inference_count << ": " << detections_.size()
+                                  << " detections in " << elapsed << " ms";
+        }
+    }
+
+    LOG_INFO("detector") << "Detector worker finished";
+}
+
+bool ObjectDetector::runSlots() {
+    // staging 을 텐서로 옮긴 뒤에는 다음 프레임 샘플링을 허용
+    for (size_t i = 0; i < slots_.size(); ++i) {
+        running_regions_[i] = slots_[i].region;
+        if (running_regions_[i] < 0) {
+            continue;
+        }
+        ov::Tensor input = slots_[i].request.get_input_tensor();
+        float* tensor = input.data<float>();
+        const ResidentBuffer<uint8_t>& staging = slots_[i].staging;
+        for (size_t j = 0; j < staging.size(); ++j) {
+            tensor[j] = staging[j] * (1.0f / 255.0f);
+        }
+    }
+    busy_.store(false);
+
+    try {
+        for (size_t i = 0; i < slots_.size(); ++i) {
+            if (running_regions_[i] >= 0) {
+                slots_[i].request.start_async();
+            }
+        }
+        for (size_t i = 0; i < slots_.size(); ++i) {
+            if (running_regions_[i] >= 0) {
+                slots_[i].request.wait();
+            }
+        }
+    } catch (const std::exception& e) {
+        LOG_ERROR("detector") << "Inference failed: " << e.what();
+        return false;
+    }
+
+    for (size_t i = 0; i < slots_.size(); ++i) {
+        int region = running_regions_[i];
+        if (region < 0) {
+            continue;
+        }
+        ov::Tensor output = slots_[i].request.get_output_tensor();
+        ov::Shape shape = output.get_shape();
+        decodeOutput(output.data<const float>(), shape[1], shape[2], regions_[region], region_detections_[region]);
+    }
+
+    // 이번 제출 영역과 순환 한 바퀴 안에 실행된 영역의 결과만 합치고 타일 경계의 중복을 NMS 로 제거
+    for (auto& age : region_age_) {
+        age++;
+    }
+    for (int region : running_regions_) {
+        if (region >= 0) {
+            region_age_[region] = 0;
+        }
+    }
+    detections_.clear();
+    for (size_t r = 0; r < region_detections_.size(); ++r) {
+        if (region_age_[r] >= result_lifetime_) {
+            region_detections_[r].clear();
+            continue;
+        }
+        detections_.insert(detections_.end(), region_detections_[r].begin(), region_detections_[r].end());
+    }
+    nonMaximumSuppression(detections_, config_.nms_threshold, config_.tiling_enabled ? kTileMergeIoS : 0.0f);
+    return true;
+}
+
+void ObjectDetector::decodeOutput(const float* output, size_t rows, size_t cols,
+                                  const SamplingRegion& region, std::vector<Detection>& out) {
+    // YOLOv5 출력: [cx, cy, w, h, objectness, class scores...]
+    out.clear();
+    const size_t num_classes = cols - 5;
+
+    for (size_t i = 0; i < rows; ++i) {
+        const float* row = output + i * cols;
+        float objectness = row[4];
+        if (objectness < config_.conf_threshold) {
+            continue;
+        }
+
+        const float* class_scores = row + 5;
+        size_t best_class = std::max_element(class_scores, class_scores + num_classes) - class_scores;
+        float score = objectness * class_scores[best_class];
+        if (score < config_.conf_threshold) {
+            continue;
+        }
+
+        Detection det;
+        det.x = (row[0] - row[2] * 0.5f - region.pad_x) / region.scale + region.src_x;
+        det.y = (row[1] - row[3] * 0.5f - region.pad_y) / region.scale + region.src_y;
+        det.width = row[2] / region.scale;
+        det.height = row[3] / region.scale;
+        det.score = score;
+        det.class_id = static_cast<int>(best_class);
+
+        // 프레임 경계로 자름
+        float x2 = std::min(det.x + det.width, static_cast<float>(frame_width_));
+        float y2 = std::min(det.y + det.height, static_cast<float>(frame_height_));
+        det.x = std::max(0.0f, det.x);
+        det.y = std::max(0.0f, det.y);
+        det.width = x2 - det.x;
+        det.height = y2 - det.y;
+        if (det.width <= 0.0f || det.height <= 0.0f) {
+            continue;
+        }
+        out.push_back(det);
+    }
+}
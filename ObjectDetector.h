@@ -0,0 +1,149 @@
+#ifndef OBJECT_DETECTOR_H
+#define OBJECT_DETECTOR_H
+
+#include <openvino/openvino.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "BoundedQueue.h"
+#include "ConfigManager.h"
+#include "Detection.h"
+#include "FrameFormat.h"
+#include "MemoryResidency.h"
+#include "MetricsRegistry.h"
+#include "MotionDetector.h"
+#include "FrameData.h"
+
+// OpenVINO YOLOv5 검출기
+// 캡처 스레드에서는 letterbox 샘플링만 수행하고 추론은 전용 워커 스레드에서 실행
+// 타일 모드에서는 프레임을 모델 입력 크기의 겹치는 타일로 나누어 비동기 요청으로 병렬 추론
+class ObjectDetector {
+private:
+    // 원본 프레임의 한 영역을 모델 입력으로 letterbox 샘플링하기 위한 정보
+    struct SamplingRegion {
+        int src_x;
+        int src_y;
+        int src_width;
+        int src_height;
+        float scale;
+        int pad_x;
+        int pad_y;
+        std::vector<int> column_offsets;    // 입력 열 → 원본 행 내 바이트 오프셋 (-1: 패딩)
+        std::vector<int> row_indices;       // 입력 행 → 원본 행 번호 (-1: 패딩)
+    };
+
+    enum class TileSchedule {
+        All,            // 매번 모든 타일
+        RoundRobin,     // tiles_per_frame 개씩 순환
+        Motion          // 모션 영역과 겹치는 타일 우선, 남는 예산은 순환
+    };
+
+    // 비동기 추론 요청 하나와 그 입력 버퍼 (둘 다 상주 모드에서는 arena 에 잡힘)
+    struct InferSlot {
+        ov::InferRequest request;
+        ResidentBuffer<uint8_t> staging;    // RGB planar 입력 (캡처 스레드가 채움)
+        ResidentBuffer<float> input;        // 요청의 입력 텐서 메모리
+        int region;                         // 이번 제출에서 담당하는 영역 (-1: 미사용)
+    };
+
+    InferenceConfig config_;
+
+    ov::Core core_;
+    ov::CompiledModel compiled_model_;
+    int input_width_;
+    int input_height_;
+
+    int frame_width_;
+    int frame_height_;
+    int frame_stride_;
+    PixelLayout layout_;
+
+    std::vector<SamplingRegion> regions_;   // 타일들, 그 뒤에 전체 프레임 (있으면)
+    int tile_count_;
+    int full_frame_region_;
+    TileSchedule schedule_;
+    std::vector<InferSlot> slots_;
+    std::vector<int> running_regions_;      // 워커가 처리 중인 슬롯별 영역
+
+    // 타일 스케줄링 (캡처 스레드 전용)
+    size_t next_tile_;
+    std::vector<MotionRegion> motion_regions_;
+    std::vector<std::pair<int, int>> tile_priority_;
+    std::vector<uint8_t> tile_selected_;
+
+    // 영역별 최근 검출 결과와 병합 결과 (워커 스레드 전용)
+    // 결과는 순환 한 바퀴(result_lifetime_ 회 제출) 동안만 유지하고, 그 안에 다시 실행되지 않은 영역은 버림
+    std::vector<std::vector<Detection>> region_detections_;
+    std::vector<uint32_t> region_age_;      // 영역이 마지막으로 실행된 뒤 지난 제출 수
+    uint32_t result_lifetime_;
+    std::vector<Detection> detections_;
+
+    std::thread worker_;
+    SpscQueue<uint32_t> requests_;          // 캡처 스레드 -> 워커, 샘플링한 프레임 sequence
+    std::atomic<bool> busy_;
+    std::atomic<bool> stopping_;
+    std::mutex slots_mtx_;                  // 실행 중 configure(입력 크기 변경)가 워커의 추론과 겹치지 않게 함
+
+    std::function<void(const std::vector<Detection>&)> detection_callback_;
+
+    Counter& inferences_;
+    Counter& inferences_skipped_;
+    Histogram& inference_latency_;
+    PageFaultCounters& page_faults_;
+
+public:
+    explicit ObjectDetector(const InferenceConfig& config);
+    ~ObjectDetector();
+
+    // 모델 로드 및 컴파일
+    bool initialize();
+
+    // 캡처 스트림의 실제 크기/stride 로 샘플링 영역과 추론 요청을 준비
+    // 워커가 도는 중에도 다시 호출할 수 있음 (submit 은 호출하는 동안 멈춰 있어야 함)
+    bool configure(int width, int height, int stride, const std::string& pixel_format);
+
+    bool start();
+    void stop();
+
+    // 워커가 입력을 받을 수 있으면 프레임을 샘플링하고 true 를 반환
+    // 이전 프레임을 아직 처리 중이면 즉시 false 를 반환 (캡처 스레드를 막지 않음)
+    bool submit(const FrameData& frame_data);
+
+    // 호출한 스레드에서 동기적으로 검출 (start() 하지 않은 오프라인/벤치마크 용도)
+    bool detect(const FrameData& frame_data, std::vector<Detection>& detections);
+
+    // 이전 입력의 타일별 결과, 모션 영역, 순환 위치를 버림 (새 입력에 검출기를 재사용하거나 입력 크기가 바뀔 때)
+    void reset();
+
+    // "motion" 스케줄에서 우선 실행할 영역 (submit 전에 캡처 스레드에서 호출)
+    void setMotionRegions(const std::vector<MotionRegion>& regions);
+
+    // 추론이 끝날 때마다 워커 스레드에서 호출됨
+    void setDetectionCallback(std::function<void(const std::vector<Detection>&)> callback);
+
+    int getTileCount() const { return tile_count_; }
+    int getInputWidth() const { return input_width_; }
+    int getInputHeight() const { return input_height_; }
+
+    // precision 에 맞는 IR 경로 (FP32 는 model_path 그대로, 그 외는 yolov5n_fp16.xml 처럼 접미사를 붙임)
+    static std::string resolveModelPath(const InferenceConfig& config);
+
+private:
+    void buildRegion(SamplingRegion& region, int src_x, int src_y, int src_width, int src_height, bool is_tile);
+    void buildTiles();
+    void scheduleTiles(size_t budget);
+    void sampleRegion(const SamplingRegion& region, const FrameData& frame, uint8_t* staging);
+    void prepareSlots(const FrameData& frame);
+    bool runSlots();
+    void workerLoop();
+    void decodeOutput(const float* output, size_t rows, size_t cols,
+                      const SamplingRegion& region, std::vector<Detection>& out);
+};
+
+#endif // OBJECT_DETECTOR_H
@@ -0,0 +1,318 @@
+#include "ObjectTracker.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// 노이즈 표준편차 가중치 (박스 크기에 비례, DeepSORT 와 동일한 값)
+constexpr float kPositionWeight = 1.0f / 20.0f;
+constexpr float kVelocityWeight = 1.0f / 160.0f;
+
+// 4x4 행렬 역행렬 (Gauss-Jordan). 특이 행렬이면 false
+bool invert4x4(const float in[4][4], float out[4][4]) {
+    float a[4][8];
+    for (int r = 0; r < 4; ++r) {
+        for (int c = 0; c < 4; ++c) {
+            a[r][c] = in[r][c];
+            a[r][c + 4] = (r == c) ? 1.0f : 0.0f;
+        }
+    }
+    for (int col = 0; col < 4; ++col) {
+        int pivot = col;
+        for (int r = col + 1; r < 4; ++r) {
+            if (std::fabs(a[r][col]) > std::fabs(a[pivot][col])) pivot = r;
+        }
+        if (std::fabs(a[pivot][col]) < 1e-9f) return false;
+        if (pivot != col) {
+            for (int c = 0; c < 8; ++c) std::swap(a[col][c], a[pivot][c]);
+        }
+        float inv = 1.0f / a[col][col];
+        for (int c = 0; c < 8; ++c) a[col][c] *= inv;
+        for (int r = 0; r < 4; ++r) {
+            if (r == col) continue;
+            float factor = a[r][col];
+            for (int c = 0; c < 8; ++c) a[r][c] -= factor * a[col][c];
+        }
+    }
+    for (int r = 0; r < 4; ++r) {
+        for (int c = 0; c < 4; ++c) out[r][c] = a[r][c + 4];
+    }
+    return true;
+}
+
+} // namespace
+
+ObjectTracker::ObjectTracker(const TrackerConfig& config)
+    : config_(config), next_id_(1), has_pending_(false) {
+    tracks_.resize(config_.max_tracks);
+    for (auto& track : tracks_) {
+        track.active = false;
+    }
+    output_.reserve(config_.max_tracks);
+    pending_.reserve(config_.max_detections);
+    detections_.reserve(config_.max_detections);
+    candidates_.reserve(static_cast<size_t>(config_.max_tracks) * config_.max_detections);
+    track_matched_.resize(config_.max_tracks);
+    detection_matched_.resize(config_.max_detections);
+}
+
+void ObjectTracker::submitDetections(const std::vector<Detection>& detections) {
+    std::lock_guard<std::mutex> lock(pending_mtx_);
+    // capacity() 는 구현에 따라 요청보다 클 수 있으므로 detection_matched_ 크기와 같은 설정값으로 자름
+    size_t count = std::min(detections.size(), static_cast<size_t>(config_.max_detections));
+    pending_.assign(detections.begin(), detections.begin() + count);
+    has_pending_ = true;
+}
+
+void ObjectTracker::reset() {
+    for (auto& track : tracks_) {
+        track.active = false;
+    }
+    output_.clear();
+    std::lock_guard<std::mutex> lock(pending_mtx_);
+    pending_.clear();
+    has_pending_ = false;
+}
+
+const std::vector<TrackedObject>& ObjectTracker::step() {
+    for (auto& track : tracks_) {
+        if (track.active) {
+            predict(track);
+        }
+    }
+
+    bool has_detections = false;
+    {
+        std::lock_guard<std::mutex> lock(pending_mtx_);
+        if (has_pending_) {
+            detections_.assign(pending_.begin(), pending_.end());
+            has_pending_ = false;
+            has_detections = true;
+        }
+    }
+
+    if (has_detections) {
+        std::fill(track_matched_.begin(), track_matched_.end(), 0);
+        std::fill(detection_matched_.begin(), detection_matched_.end(), 0);
+
+        // ByteTrack: 높은 점수의 검출을 먼저 매칭하고, 남은 트랙은 낮은 점수의 검출로 이어붙임
+        associate(config_.high_threshold, 1.0f + 1e-3f, true);
+        associate(config_.low_threshold, config_.high_threshold, false);
+    }
+
+    // 오래 갱신되지 않은 트랙 제거
+    for (auto& track : tracks_) {
+        if (track.active && track.frames_since_update > config_.max_age) {
+            track.active = false;
+        }
+    }
+
+    buildOutput();
+    return output_;
+}
+
+void ObjectTracker::associate(float min_score, float max_score, bool create_tracks) {
+    candidates_.clear();
+    for (size_t d = 0; d < detections_.size(); ++d) {
+        const Detection& det = detections_[d];
+        if (detection_matched_[d] || det.score < min_score || det.score >= max_score) {
+            continue;
+        }
+        for (size_t t = 0; t < tracks_.size(); ++t) {
+            const Track& track = tracks_[t];
+            if (!track.active || track_matched_[t] || track.class_id != det.class_id) {
+                continue;
+            }
+            Detection predicted;
+            predicted.width = track.x[2];
+            predicted.height = track.x[3];
+            predicted.x = track.x[0] - predicted.width * 0.5f;
+            predicted.y = track.x[1] - predicted.height * 0.5f;
+            float iou = computeIoU(predicted, det);
+            if (iou >= config_.match_iou) {
+                candidates_.push_back({iou, static_cast<int>(t), static_cast<int>(d)});
+            }
+        }
+    }
+
+    // IoU 가 큰 쌍부터 탐욕적으로 매칭
+    std::sort(candidates_.begin(), candidates_.end(),
+              [](const MatchCandidate& a, const MatchCandidate& b) { return a.iou > b.iou; });
+    for (const auto& candidate : candidates_) {
+        if (track_matched_[candidate.track] || detection_matched_[candidate.detection]) {
+            continue;
+        }
+        track_matched_[candidate.track] = 1;
+        detection_matched_[candidate.detection] = 1;
+        correct(tracks_[candidate.track], detections_[candidate.detection]);
+    }
+
+    if (!create_tracks) {
+        return;
+    }
+
+    for (size_t d = 0; d < detections_.size(); ++d) {
+        const Detection& det = detections_[d];
+        if (detection_matched_[d] || det.score < min_score || det.score >= max_score) {
+            continue;
+        }
+        auto slot = std::find_if(tracks_.begin(), tracks_.end(), [](const Track& t) { return !t.active; });
+        if (slot == tracks_.end()) {
+            break;  // 트랙 저장 공간이 가득 참
+        }
+        initiate(*slot, det);
+        track_matched_[slot - tracks_.begin()] = 1;
+        detection_matched_[d] = 1;
+    }
+}
+
+void ObjectTracker::initiate(Track& track, const Detection& detection) {
+    track.active = true;
+    track.id = next_id_++;
+    track.class_id = detection.class_id;
+    track.score = detection.score;
+    track.hits = 1;
+    track.frames_since_update = 0;
+
+    track.x[0] = detection.x + detection.width * 0.5f;
+    track.x[1] = detection.y + detection.height * 0.5f;
+    track.x[2] = detection.width;
+    track.x[3] = detection.height;
+    track.x[4] = track.x[5] = track.x[6] = track.x[7] = 0.0f;
+
+    const float std_pos[4] = {
+        2.0f * kPositionWeight * detection.width, 2.0f * kPositionWeight * detection.height,
+        2.0f * kPositionWeight * detection.width, 2.0f * kPositionWeight * detection.height
+    };
+    const float std_vel[4] = {
+        10.0f * kVelocityWeight * detection.width, 10.0f * kVelocityWeight * detection.height,
+        10.0f * kVelocityWeight * detection.width, 10.0f * kVelocityWeight * detection.height
+    };
+    std::memset(track.P, 0, sizeof(track.P));
+    for (int i = 0; i < 4; ++i) {
+        track.P[i][i] = std_pos[i] * std_pos[i];
+        track.P[i + 4][i + 4] = std_vel[i] * std_vel[i];
+    }
+}
+
+void ObjectTracker::predict(Track& track) {
+    // x = F x (dt = 1 프레임)
+    for (int i = 0; i < 4; ++i) {
+        track.x[i] += track.x[i + 4];
+    }
+    track.x[2] = std::max(track.x[2], 1.0f);
+    track.x[3] = std::max(track.x[3], 1.0f);
+
+    // P = F P F^T + Q, F = [I I; 0 I]
+    float FP[kStateSize][kStateSize];
+    for (int r = 0; r < kStateSize; ++r) {
+        for (int c = 0; c < kStateSize; ++c) {
+            FP[r][c] = track.P[r][c] + (r < 4 ? track.P[r + 4][c] : 0.0f);
+        }
+    }
+    for (int r = 0; r < kStateSize; ++r) {
+        for (int c = 0; c < kStateSize; ++c) {
+            track.P[r][c] = FP[r][c] + (c < 4 ? FP[r][c + 4] : 0.0f);
+        }
+    }
+
+    const float w = track.x[2];
+    const float h = track.x[3];
+    const float std_pos[4] = {kPositionWeight * w, kPositionWeight * h, kPositionWeight * w, kPositionWeight * h};
+    const float std_vel[4] = {kVelocityWeight * w, kVelocityWeight * h, kVelocityWeight * w, kVelocityWeight * h};
+    for (int i = 0; i < 4; ++i) {
+        track.P[i][i] += std_pos[i] * std_pos[i];
+        track.P[i + 4][i + 4] += std_vel[i] * std_vel[i];
+    }
+
+    track.frames_since_update++;
+}
+
+void ObjectTracker::correct(Track& track, const Detection& detection) {
+    const float z[kMeasureSize] = {
+        detection.x + detection.width * 0.5f,
+        detection.y + detection.height * 0.5f,
+        detection.width,
+        detection.height
+    };
+
+    // S = H P H^T + R, H = [I 0]
+    float S[4][4];
+    const float std_pos[4] = {
+        kPositionWeight * track.x[2], kPositionWeight * track.x[3],
+        kPositionWeight * track.x[2], kPositionWeight * track.x[3]
+    };
+    for (int r = 0; r < 4; ++r) {
+        for (int c = 0; c < 4; ++c) {
+            S[r][c] = track.P[r][c] + (r == c ? std_pos[r] * std_pos[r] : 0.0f);
+        }
+    }
+    float S_inv[4][4];
+    if (!invert4x4(S, S_inv)) {
+        return;
+    }
+
+    // K = P H^T S^-1
+    float K[kStateSize][kMeasureSize];
+    for (int r = 0; r < kStateSize; ++r) {
+        for (int c = 0; c < kMeasureSize; ++c) {
+            float sum = 0.0f;
+            for (int k = 0; k < kMeasureSize; ++k) {
+                sum += track.P[r][k] * S_inv[k][c];
+            }
+            K[r][c] = sum;
+        }
+    }
+
+    float innovation[kMeasureSize];
+    for (int i = 0; i < kMeasureSize; ++i) {
+        innovation[i] = z[i] - track.x[i];
+    }
+    for (int r = 0; r < kStateSize; ++r) {
+        for (int c = 0; c < kMeasureSize; ++c) {
+            track.x[r] += K[r][c] * innovation[c];
+        }
+    }
+
+    // P = P - K H P
+    float KHP[kStateSize][kStateSize];
+    for (int r = 0; r < kStateSize; ++r) {
+        for (int c = 0; c < kStateSize; ++c) {
+            float sum = 0.0f;
+            for (int k = 0; k < kMeasureSize; ++k) {
+                sum += K[r][k] * track.P[k][c];
+            }
+            KHP[r][c] = sum;
+        }
+    }
+    for (int r = 0; r < kStateSize; ++r) {
+        for (int c = 0; c < kStateSize; ++c) {
+            track.P[r][c] -= KHP[r][c];
+        }
+    }
+
+    track.score = detection.score;
+    track.hits++;
+    track.frames_since_update = 0;
+}
+
+void ObjectTracker::buildOutput() {
+    output_.clear();
+    for (const auto& track : tracks_) {
+        if (!track.active) {
+            continue;
+        }
+        TrackedObject object;
+        object.id = track.id;
+        object.class_id = track.class_id;
+        object.width = track.x[2];
+        object.height = track.x[3];
+        object.x = track.x[0] - object.width * 0.5f;
+        object.y = track.x[1] - object.height * 0.5f;
+        object.score = track.score;
+        object.confirmed = track.hits >= config_.min_hits;
+        output_.push_back(object);
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef OBJECT_TRACKER_H
+#define OBJECT_TRACKER_H
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "ConfigManager.h"
+#include "Detection.h"
+
+// 프레임마다 출력되는 추적 결과
+struct TrackedObject {
+    int id;
+    int class_id;
+    float x;
+    float y;
+    float width;
+    float height;
+    float score;
+    bool confirmed;     // min_hits 이상 매칭된 트랙
+};
+
+// SORT/ByteTrack 방식의 다중 객체 추적기
+// 트랙별 등속 칼만 필터로 매 프레임 예측하고, 검출 결과가 도착하면 IoU 매칭으로 보정함
+// 모든 저장 공간은 생성 시 할당하며 프레임 처리 중에는 할당하지 않음
+class ObjectTracker {
+private:
+    static constexpr int kStateSize = 8;    // cx, cy, w, h, vcx, vcy, vw, vh
+    static constexpr int kMeasureSize = 4;  // cx, cy, w, h
+
+    struct Track {
+        bool active;
+        int id;
+        int class_id;
+        float score;
+        int hits;
+        int frames_since_update;
+        float x[kStateSize];
+        float P[kStateSize][kStateSize];
+    };
+
+    struct MatchCandidate {
+        float iou;
+        int track;
+        int detection;
+    };
+
+    TrackerConfig config_;
+    std::vector<Track> tracks_;
+    std::vector<TrackedObject> output_;
+    int next_id_;
+
+    // 검출기 스레드 → 캡처 스레드 전달용 (용량 고정)
+    std::mutex pending_mtx_;
+    std::vector<Detection> pending_;
+    bool has_pending_;
+
+    // 매칭 작업 공간
+    std::vector<Detection> detections_;
+    std::vector<MatchCandidate> candidates_;
+    std::vector<uint8_t> track_matched_;
+    std::vector<uint8_t> detection_matched_;
+
+public:
+    explicit ObjectTracker(const TrackerConfig& config);
+
+    // 검출 결과를 보관 (검출기 워커 스레드에서 호출, 용량을 넘는 검출은 버림)
+    void submitDetections(const std::vector<Detection>& detections);
+
+    // 모든 트랙과 보관된 검출을 버림 (입력 크기가 바뀌어 이전 좌표가 의미 없을 때, step() 과 동시에 호출하지 않음)
+    void reset();
+
+    // 캡처된 프레임마다 호출: 예측 후 보관된 검출이 있으면 보정
+    const std::vector<TrackedObject>& step();
+
+    const std::vector<TrackedObject>& getTracks() const { return output_; }
+
+private:
+    void predict(Track& track);
+    void correct(Track& track, const Detection& detection);
+    void initiate(Track& track, const Detection& detection);
+    void associate(float min_score, float max_score, bool create_tracks);
+    void buildOutput();
+};
+
+#endif // OBJECT_TRACKER_H
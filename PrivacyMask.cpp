@@ -0,0 +1,445 @@
+#include "PrivacyMask.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PRIVACY_USE_NEON 1
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define PRIVACY_USE_AVX2 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define PRIVACY_USE_SSE2 1
+#endif
+
+namespace {
+
+constexpr int kMaxBlockSize = 128;  // 블록 합이 uint16 에 들어가는 범위 (128 * 255)
+constexpr int kMaxBlurRadius = 64;  // (2r+1) 행 합이 uint16 에 들어가는 범위
+
+// acc[i] += add[i]
+void accumulateRow(uint16_t* acc, const uint8_t* add, int count) {
+    int i = 0;
+#if defined(PRIVACY_USE_NEON)
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t a = vld1q_u8(add + i);
+        vst1q_u16(acc + i, vaddw_u8(vld1q_u16(acc + i), vget_low_u8(a)));
+        vst1q_u16(acc + i + 8, vaddw_u8(vld1q_u16(acc + i + 8), vget_high_u8(a)));
+    }
+#elif defined(PRIVACY_USE_AVX2)
+    for (; i + 16 <= count; i += 16) {
+        __m256i a = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(add + i)));
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + i), _mm256_add_epi16(v, a));
+    }
+#elif defined(PRIVACY_USE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= count; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(add + i));
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i + 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + i), _mm_add_epi16(lo, _mm_unpacklo_epi8(a, zero)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + i + 8), _mm_add_epi16(hi, _mm_unpackhi_epi8(a, zero)));
+    }
+#endif
+    for (; i < count; ++i) {
+        acc[i] += add[i];
+    }
+}
+
+// acc[i] += add[i] - sub[i] (세로 상자 창을 한 행 내림. 중간값이 음수여도 mod 2^16 로 맞음)
+void slideRow(uint16_t* acc, const uint8_t* add, const uint8_t* sub, int count) {
+    int i = 0;
+#if defined(PRIVACY_USE_NEON)
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t a = vld1q_u8(add + i);
+        uint8x16_t s = vld1q_u8(sub + i);
+        vst1q_u16(acc + i, vsubw_u8(vaddw_u8(vld1q_u16(acc + i), vget_low_u8(a)), vget_low_u8(s)));
+        vst1q_u16(acc + i + 8, vsubw_u8(vaddw_u8(vld1q_u16(acc + i + 8), vget_high_u8(a)), vget_high_u8(s)));
+    }
+#elif defined(PRIVACY_USE_AVX2)
+    for (; i + 16 <= count; i += 16) {
+        __m256i a = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(add + i)));
+        __m256i s = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(sub + i)));
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + i), _mm256_sub_epi16(_mm256_add_epi16(v, a), s));
+    }
+#elif defined(PRIVACY_USE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= count; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(add + i));
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sub + i));
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i + 8));
+        lo = _mm_sub_epi16(_mm_add_epi16(lo, _mm_unpacklo_epi8(a, zero)), _mm_unpacklo_epi8(s, zero));
+        hi = _mm_sub_epi16(_mm_add_epi16(hi, _mm_unpackhi_epi8(a, zero)), _mm_unpackhi_epi8(s, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + i), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + i + 8), hi);
+    }
+#endif
+    for (; i < count; ++i) {
+        acc[i] = static_cast<uint16_t>(acc[i] + add[i] - sub[i]);
+    }
+}
+
+// 다각형(비율 좌표)을 픽셀 중심 기준 even-odd 규칙으로 행별 구간에 추가
+template <typename SpanT>
+void rasterize(const std::vector<float>& points, int width, int height, std::vector<std::vector<SpanT>>& rows) {
+    size_t count = points.size() / 2;
+    float min_y = height, max_y = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        min_y = std::min(min_y, points[2 * i + 1] * height);
+        max_y = std::max(max_y, points[2 * i + 1] * height);
+    }
+    int y_begin = std::max(0, static_cast<int>(std::floor(min_y)));
+    int y_end = std::min(height, static_cast<int>(std::ceil(max_y)) + 1);
+    std::vector<float> crossings;
+    for (int y = y_begin; y < y_end; ++y) {
+        float yc = y + 0.5f;
+        crossings.clear();
+        for (size_t i = 0; i < count; ++i) {
+            size_t j = (i + 1) % count;
+            float ax = points[2 * i] * width, ay = points[2 * i + 1] * height;
+            float bx = points[2 * j] * width, by = points[2 * j + 1] * height;
+            // 꼭짓점을 두 번 세지 않도록 위쪽 끝은 포함, 아래쪽 끝은 제외
+            if ((ay <= yc) != (by <= yc)) {
+                crossings.push_back(ax + (yc - ay) * (bx - ax) / (by - ay));
+            }
+        }
+        std::sort(crossings.begin(), crossings.end());
+        for (size_t k = 0; k + 1 < crossings.size(); k += 2) {
+            int x0 = std::max(0, static_cast<int>(std::ceil(crossings[k] - 0.5f)));
+            int x1 = std::min(width, static_cast<int>(std::ceil(crossings[k + 1] - 0.5f)));
+            if (x0 < x1) {
+                rows[y].push_back({y, x0, x1});
+            }
+        }
+    }
+}
+
+// 한 행의 구간을 x 순서로 정렬하고 겹치거나 붙은 구간을 합침
+template <typename SpanT>
+void mergeRow(std::vector<SpanT>& row) {
+    std::sort(row.begin(), row.end(), [](const SpanT& a, const SpanT& b) { return a.x0 < b.x0; });
+    size_t out = 0;
+    for (size_t i = 0; i < row.size(); ++i) {
+        if (out > 0 && row[i].x0 <= row[out - 1].x1) {
+            row[out - 1].x1 = std::max(row[out - 1].x1, row[i].x1);
+        } else {
+            row[out++] = row[i];
+        }
+    }
+    row.resize(out);
+}
+
+} // namespace
+
+PrivacyMasker::PrivacyMasker(const PrivacyConfig& config)
+    : config_(config), mode_(Mode::Fill) {
+}
+
+bool PrivacyMasker::configure(int width, int height, int stride, const std::string& pixel_format) {
+    if (config_.mode == "fill") {
+        mode_ = Mode::Fill;
+    } else if (config_.mode == "pixelate") {
+        mode_ = Mode::Pixelate;
+        if (config_.block_size < 2 || config_.block_size > kMaxBlockSize || config_.block_size % 2 != 0) {
+            std::cerr << "[ERROR] Invalid privacy block_size " << config_.block_size
+                      << " (even, 2-" << kMaxBlockSize << ")" << std::endl;
+            return false;
+        }
+    } else if (config_.mode == "blur") {
+        mode_ = Mode::Blur;
+        if (config_.blur_radius < 1 || config_.blur_radius > kMaxBlurRadius) {
+            std::cerr << "[ERROR] Invalid privacy blur_radius " << config_.blur_radius
+                      << " (1-" << kMaxBlurRadius << ")" << std::endl;
+            return false;
+        }
+    } else {
+        std::cerr << "[ERROR] Unknown privacy mode: " << config_.mode << std::endl;
+        return false;
+    }
+
+    PixelLayout layout = pixelLayoutFromString(pixel_format);
+    int channels = 1;
+    if (layout == PixelLayout::BGR24 || layout == PixelLayout::RGB24) {
+        channels = 3;
+    } else if (layout != PixelLayout::I420) {
+        std::cerr << "[ERROR] Privacy mask does not support " << pixel_format << std::endl;
+        return false;
+    }
+    if (stride < width * channels) {
+        std::cerr << "[ERROR] Privacy mask stride " << stride << " is smaller than the row" << std::endl;
+        return false;
+    }
+
+    // 첫 평면(luma 또는 packed) 구간: 영역들을 래스터화해 행마다 합침
+    std::vector<std::vector<Span>> rows(height);
+    for (const PrivacyRegion& region : config_.regions) {
+        rasterize(region.points, width, height, rows);
+    }
+    for (auto& row : rows) {
+        mergeRow(row);
+    }
+
+    // pixelate 는 가린 부분이 걸친 블록 전체를 덮음 (블록 경계에서 원본 픽셀이 남지 않음)
+    int block = config_.block_size;
+    if (mode_ == Mode::Pixelate) {
+        int cells_x = (width + block - 1) / block;
+        int cells_y = (height + block - 1) / block;
+        std::vector<uint8_t> cells(static_cast<size_t>(cells_x) * cells_y, 0);
+        for (const auto& row : rows) {
+            for (const Span& span : row) {
+                for (int cx = span.x0 / block; cx <= (span.x1 - 1) / block; ++cx) {
+                    cells[static_cast<size_t>(span.y / block) * cells_x + cx] = 1;
+                }
+            }
+        }
+        for (int cy = 0; cy < cells_y; ++cy) {
+            std::vector<Span> cell_row;
+            for (int cx = 0; cx < cells_x; ++cx) {
+                if (!cells[static_cast<size_t>(cy) * cells_x + cx]) {
+                    continue;
+                }
+                int x1 = std::min(width, (cx + 1) * block);
+                if (!cell_row.empty() && cell_row.back().x1 == cx * block) {
+                    cell_row.back().x1 = x1;
+                } else {
+                    cell_row.push_back({0, cx * block, x1});
+                }
+            }
+            for (int y = cy * block; y < std::min(height, (cy + 1) * block); ++y) {
+                rows[y] = cell_row;
+                for (Span& span : rows[y]) {
+                    span.y = y;
+                }
+            }
+        }
+    }
+
+    planes_.clear();
+    Plane first = {0, width, height, channels, static_cast<uint8_t>(channels == 3 ? 0 : 16),
+                   block, config_.blur_radius, {}, {}, 0};
+    buildPlane(first, rows);
+    planes_.push_back(std::move(first));
+
+    if (layout == PixelLayout::I420) {
+        // 색차 픽셀은 대응하는 2x2 luma 중 하나라도 가려지면 가림
+        int chroma_width = (width + 1) / 2;
+        int chroma_height = (height + 1) / 2;
+        std::vector<std::vector<Span>> chroma_rows(chroma_height);
+        for (int y = 0; y < height; ++y) {
+            for (const Span& span : rows[y]) {
+                chroma_rows[y / 2].push_back({y / 2, span.x0 / 2, (span.x1 + 1) / 2});
+            }
+        }
+        for (auto& row : chroma_rows) {
+            mergeRow(row);
+        }
+        for (int index = 1; index < 3; ++index) {
+            Plane chroma = {index, chroma_width, chroma_height, 1, 128, block / 2,
+                            std::max(1, config_.blur_radius / 2), {}, {}, 0};
+            buildPlane(chroma, chroma_rows);
+            planes_.push_back(std::move(chroma));
+        }
+    }
+
+    // 작업 버퍼는 여기서 한 번만 잡음
+    size_t accum_size = 0;
+    size_t scratch_size = 0;
+    for (const Plane& plane : planes_) {
+        size_t masked_bytes = 0;
+        for (const Span& span : plane.spans) {
+            size_t bytes = static_cast<size_t>(span.x1 - span.x0) * plane.channels;
+            masked_bytes += bytes;
+            accum_size = std::max(accum_size, bytes);
+            scratch_size = std::max(scratch_size, bytes);
+        }
+        if (mode_ == Mode::Blur) {
+            for (const Band& band : plane.bands) {
+                accum_size = std::max(accum_size, static_cast<size_t>(band.x1 - band.x0) * plane.channels);
+            }
+            scratch_size = std::max(scratch_size, masked_bytes);
+        }
+    }
+    accum_.assign(accum_size, 0);
+    scratch_.assign(scratch_size, 0);
+
+    std::cout << "[INFO] Privacy mask configured: " << config_.regions.size() << " regions, " << config_.mode
+              << ", " << planes_[0].masked_pixels << " pixels (" << coverage() * 100.0 << "% of "
+              << width << "x" << height << ")" << std::endl;
+    return true;
+}
+
+void PrivacyMasker::buildPlane(Plane& plane, const std::vector<std::vector<Span>>& rows) const {
+    for (const auto& row : rows) {
+        for (const Span& span : row) {
+            plane.masked_pixels += span.x1 - span.x0;
+        }
+    }
+
+    if (mode_ == Mode::Pixelate) {
+        // 블록 한 줄의 행들은 구간이 같으므로 첫 행 구간만 둠
+        for (int y0 = 0; y0 < plane.height; y0 += plane.block) {
+            if (rows[y0].empty()) {
+                continue;
+            }
+            Band band = {y0, std::min(plane.height, y0 + plane.block), rows[y0].front().x0, rows[y0].back().x1,
+                         plane.spans.size(), 0};
+            plane.spans.insert(plane.spans.end(), rows[y0].begin(), rows[y0].end());
+            band.end_span = plane.spans.size();
+            plane.bands.push_back(band);
+        }
+        return;
+    }
+
+    for (int y = 0; y < plane.height; ++y) {
+        if (rows[y].empty()) {
+            continue;
+        }
+        if (mode_ == Mode::Blur) {
+            // 구간이 이어지는 행들을 한 band 로 묶고, 가로 범위는 창이 읽는 여백까지 넓힘
+            // (마지막 갱신이 x1 + r 열을 읽으므로 한 열 더)
+            int x0 = std::max(0, rows[y].front().x0 - plane.radius);
+            int x1 = std::min(plane.width, rows[y].back().x1 + plane.radius + 1);
+            if (!plane.bands.empty() && plane.bands.back().y1 == y) {
+                Band& band = plane.bands.back();
+                band.y1 = y + 1;
+                band.x0 = std::min(band.x0, x0);
+                band.x1 = std::max(band.x1, x1);
+            } else {
+                plane.bands.push_back({y, y + 1, x0, x1, plane.spans.size(), 0});
+            }
+        }
+        plane.spans.insert(plane.spans.end(), rows[y].begin(), rows[y].end());
+        if (mode_ == Mode::Blur) {
+            plane.bands.back().end_span = plane.spans.size();
+        }
+    }
+}
+
+bool PrivacyMasker::apply(FrameData& frame_data) {
+    if (frame_data.num_planes < static_cast<int>(planes_.size())) {
+        return false;
+    }
+    for (const Plane& plane : planes_) {
+        uint8_t* base = frame_data.plane(plane.index);
+        int stride = frame_data.strides[plane.index];
+        if (mode_ == Mode::Fill) {
+            fillPlane(plane, base, stride);
+        } else if (mode_ == Mode::Pixelate) {
+            pixelatePlane(plane, base, stride);
+        } else {
+            blurPlane(plane, base, stride);
+        }
+    }
+    return true;
+}
+
+void PrivacyMasker::fillPlane(const Plane& plane, uint8_t* base, int stride) const {
+    for (const Span& span : plane.spans) {
+        std::memset(base + static_cast<size_t>(span.y) * stride + span.x0 * plane.channels, plane.fill,
+                    static_cast<size_t>(span.x1 - span.x0) * plane.channels);
+    }
+}
+
+void PrivacyMasker::pixelatePlane(const Plane& plane, uint8_t* base, int stride) {
+    int channels = plane.channels;
+    for (const Band& band : plane.bands) {
+        int rows = band.y1 - band.y0;
+        for (size_t s = band.first_span; s < band.end_span; ++s) {
+            const Span& span = plane.spans[s];
+            int count = (span.x1 - span.x0) * channels;
+            uint16_t* acc = accum_.data();
+            std::fill(acc, acc + count, 0);
+            for (int y = band.y0; y < band.y1; ++y) {
+                accumulateRow(acc, base + static_cast<size_t>(y) * stride + span.x0 * channels, count);
+            }
+
+            // 블록마다 채널 평균을 구해 한 행 패턴을 만들고 블록 줄의 모든 행에 복사
+            uint8_t* pattern = scratch_.data();
+            for (int cx = span.x0; cx < span.x1; cx += plane.block) {
+                int cx1 = std::min(cx + plane.block, span.x1);
+                uint32_t pixels = static_cast<uint32_t>(cx1 - cx) * rows;
+                for (int c = 0; c < channels; ++c) {
+                    uint32_t sum = 0;
+                    for (int x = cx; x < cx1; ++x) {
+                        sum += acc[(x - span.x0) * channels + c];
+                    }
+                    uint8_t average = static_cast<uint8_t>((sum + pixels / 2) / pixels);
+                    for (int x = cx; x < cx1; ++x) {
+                        pattern[(x - span.x0) * channels + c] = average;
+                    }
+                }
+            }
+            for (int y = band.y0; y < band.y1; ++y) {
+                std::memcpy(base + static_cast<size_t>(y) * stride + span.x0 * channels, pattern, count);
+            }
+        }
+    }
+}
+
+void PrivacyMasker::blurPlane(const Plane& plane, uint8_t* base, int stride) {
+    int channels = plane.channels;
+    int radius = plane.radius;
+    uint32_t taps = static_cast<uint32_t>(2 * radius + 1) * (2 * radius + 1);
+    // 나눗셈 대신 32.32 고정소수점 역수 (합은 255 * taps 이하)
+    uint64_t reciprocal = ((1ull << 32) + taps / 2) / taps;
+
+    // 가장자리는 행/열을 복제. 결과는 scratch 에 모아 두었다가 모든 band 를 계산한 뒤에 씀
+    // (이웃 band 의 창이 아직 가리기 전 원본 행을 읽어야 함)
+    auto clampRow = [&](int y) { return std::min(std::max(y, 0), plane.height - 1); };
+    uint8_t* out = scratch_.data();
+    for (const Band& band : plane.bands) {
+        int count = (band.x1 - band.x0) * channels;
+        uint16_t* acc = accum_.data();
+        const uint8_t* origin = base + band.x0 * channels;
+        std::fill(acc, acc + count, 0);
+        for (int k = -radius; k <= radius; ++k) {
+            accumulateRow(acc, origin + static_cast<size_t>(clampRow(band.y0 + k)) * stride, count);
+        }
+
+        size_t s = band.first_span;
+        for (int y = band.y0; y < band.y1; ++y) {
+            for (; s < band.end_span && plane.spans[s].y == y; ++s) {
+                const Span& span = plane.spans[s];
+                for (int c = 0; c < channels; ++c) {
+                    auto column = [&](int x) {
+                        return acc[(std::min(std::max(x, 0), plane.width - 1) - band.x0) * channels + c];
+                    };
+                    uint32_t sum = 0;
+                    for (int k = -radius; k <= radius; ++k) {
+                        sum += column(span.x0 + k);
+                    }
+                    for (int x = span.x0; x < span.x1; ++x) {
+                        out[(x - span.x0) * channels + c] =
+                            static_cast<uint8_t>((sum * reciprocal + (1ull << 31)) >> 32);
+                        sum += column(x + radius + 1) - column(x - radius);
+                    }
+                }
+                out += (span.x1 - span.x0) * channels;
+            }
+            if (y + 1 < band.y1) {
+                slideRow(acc, origin + static_cast<size_t>(clampRow(y + radius + 1)) * stride,
+                         origin + static_cast<size_t>(clampRow(y - radius)) * stride, count);
+            }
+        }
+    }
+
+    out = scratch_.data();
+    for (const Span& span : plane.spans) {
+        size_t bytes = static_cast<size_t>(span.x1 - span.x0) * channels;
+        std::memcpy(base + static_cast<size_t>(span.y) * stride + span.x0 * channels, out, bytes);
+        out += bytes;
+    }
+}
+
+double PrivacyMasker::coverage() const {
+    if (planes_.empty() || planes_[0].width == 0 || planes_[0].height == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(planes_[0].masked_pixels) / (static_cast<double>(planes_[0].width) * planes_[0].height);
+}
@@ -0,0 +1,265 @@
+#include "ProcessingGraph.h"
+#include "FrameTracer.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+using namespace std::chrono;
+
+namespace {
+
+// 한 번 예약에 처리할 최대 프레임 수 (한 단계가 작업 스레드를 오래 붙잡지 않도록)
+constexpr int kDrainBatch = 8;
+
+const std::vector<double> kStageBuckets = {0.0001, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1};
+
+bool validStageName(const std::string& name) {
+    return !name.empty() && std::all_of(name.begin(), name.end(), [](unsigned char c) {
+        return std::isalnum(c) || c == '_';
+    });
+}
+
+} // namespace
+
+ProcessingGraph::Node::Node(ProcessingGraph* owner, const StageConfig& stage_config, DropPolicy drop_policy)
+    : graph(owner), config(stage_config), trace_name(FrameTracer::instance().intern(stage_config.name)),
+      queue(static_cast<size_t>(std::max(stage_config.queue_size, 1))),
+      policy(drop_policy), scheduled(false),
+      frames(MetricsRegistry::instance().counter("camstream_stage_" + stage_config.name + "_frames_total",
+                                                 "Frames processed by the " + stage_config.name + " stage")),
+      dropped(MetricsRegistry::instance().counter("camstream_stage_" + stage_config.name + "_dropped_total",
+                                                  "Frames dropped at the " + stage_config.name + " stage input queue")),
+      queue_depth(MetricsRegistry::instance().gauge("camstream_stage_" + stage_config.name + "_queue_depth",
+                                                    "Frames waiting in the " + stage_config.name + " stage input queue")),
+      process_seconds(MetricsRegistry::instance().histogram(
+          "camstream_stage_" + stage_config.name + "_process_seconds",
+          "Time spent processing one frame in the " + stage_config.name + " stage", kStageBuckets)) {
+}
+
+ProcessingGraph::ProcessingGraph(const GraphConfig& config) : config_(config), running_(false) {
+}
+
+ProcessingGraph::~ProcessingGraph() {
+    stop();
+}
+
+void ProcessingGraph::registerType(const std::string& type, StageFactory factory) {
+    factories_[type] = std::move(factory);
+}
+
+bool ProcessingGraph::build() {
+    std::map<std::string, const StageConfig*> by_name;
+    for (const StageConfig& stage : config_.stages) {
+        if (!validStageName(stage.name)) {
+            std::cerr << "[ERROR] Graph stage name '" << stage.name << "' must use letters, digits or '_'" << std::endl;
+            return false;
+        }
+        if (!by_name.emplace(stage.name, &stage).second) {
+            std::cerr << "[ERROR] Duplicate graph stage '" << stage.name << "'" << std::endl;
+            return false;
+        }
+        if (factories_.find(stage.type) == factories_.end()) {
+            std::cerr << "[ERROR] Unknown type '" << stage.type << "' for graph stage '" << stage.name << "'" << std::endl;
+            return false;
+        }
+        if (stage.drop_policy != "drop_oldest" && stage.drop_policy != "drop_newest" && stage.drop_policy != "block") {
+            std::cerr << "[ERROR] Unknown drop policy '" << stage.drop_policy << "' for graph stage '" << stage.name
+                      << "'" << std::endl;
+            return false;
+        }
+    }
+    for (const StageConfig& stage : config_.stages) {
+        if (!stage.input.empty() && by_name.find(stage.input) == by_name.end()) {
+            std::cerr << "[ERROR] Graph stage '" << stage.name << "' reads unknown stage '" << stage.input << "'"
+                      << std::endl;
+            return false;
+        }
+    }
+
+    // 입력이 이미 만들어진 단계부터 차례로 만듦 (한 바퀴 돌아도 진전이 없으면 순환)
+    std::map<std::string, Node*> built;
+    std::map<std::string, StreamFormat> formats;
+    while (built.size() < config_.stages.size()) {
+        size_t before = built.size();
+        for (const StageConfig& stage : config_.stages) {
+            if (built.count(stage.name) || (!stage.input.empty() && !built.count(stage.input))) {
+                continue;
+            }
+            DropPolicy policy = stage.drop_policy == "block"         ? DropPolicy::Block
+                                : stage.drop_policy == "drop_newest" ? DropPolicy::DropNewest
+                                                                     : DropPolicy::DropOldest;
+            std::unique_ptr<Node> node(new Node(this, stage, policy));
+            StreamFormat input = stage.input.empty() ? StreamFormat{0, 0, 0, ""} : formats[stage.input];
+            node->stage = factories_[stage.type](stage, input);
+            formats[stage.name] = node->stage ? node->stage->outputFormat(input) : input;
+            if (!node->stage) {
+                std::cout << "[WARN] Graph stage '" << stage.name << "' (" << stage.type << ") bypassed" << std::endl;
+            } else {
+                Node* raw = node.get();
+                node->stage->emitter_ = [this, raw](FrameRef&& frame) {
+                    if (running_.load(std::memory_order_relaxed)) {
+                        forward(*raw, std::move(frame));
+                    }
+                };
+            }
+            if (!stage.input.empty()) {
+                built[stage.input]->outputs.push_back(node.get());
+            }
+            built[stage.name] = node.get();
+            nodes_.push_back(std::move(node));
+        }
+        if (built.size() == before) {
+            std::cerr << "[ERROR] Graph stages form a cycle" << std::endl;
+            nodes_.clear();
+            return false;
+        }
+    }
+
+    pool_ = std::make_unique<WorkStealingPool>(config_.threads);
+    std::cout << "[INFO] Processing graph built with " << nodes_.size() << " stages" << std::endl;
+    return true;
+}
+
+bool ProcessingGraph::start() {
+    if (!pool_) {
+        std::cerr << "[ERROR] Cannot start processing graph before build" << std::endl;
+        return false;
+    }
+    running_.store(true);
+    if (!pool_->start()) {
+        running_.store(false);
+        return false;
+    }
+    for (auto& node : nodes_) {
+        if (node->stage && !node->stage->start()) {
+            std::cerr << "[ERROR] Failed to start graph stage '" << node->config.name << "'" << std::endl;
+            stop();
+            return false;
+        }
+    }
+    return true;
+}
+
+void ProcessingGraph::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    // 자체 스레드가 내보내기를 멈춘 뒤 풀을 멈춤
+    for (auto& node : nodes_) {
+        if (node->stage) {
+            node->stage->stop();
+        }
+    }
+    pool_->stop();
+
+    // 캡처 버퍼를 잡고 있는 프레임을 모두 놓음
+    FrameRef frame;
+    for (auto& node : nodes_) {
+        while (node->queue.tryPop(frame)) {
+        }
+        node->queue_depth.set(0.0);
+        node->scheduled.store(false);
+    }
+}
+
+int ProcessingGraph::find(const std::string& name) const {
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        if (nodes_[i]->config.name == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool ProcessingGraph::push(int stage, FrameRef frame) {
+    if (!running_.load(std::memory_order_relaxed) || stage < 0 || stage >= static_cast<int>(nodes_.size())) {
+        return false;
+    }
+    enqueue(*nodes_[stage], std::move(frame));
+    return true;
+}
+
+void ProcessingGraph::enqueue(Node& node, FrameRef&& frame) {
+    switch (node.policy) {
+    case DropPolicy::DropOldest: {
+        // 생산자는 상류 단계 하나뿐이라 앞뒤 차이가 이번 push 로 버린 수
+        uint64_t overwritten = node.queue.overwritten();
+        node.queue.pushOverwrite(std::move(frame));
+        if (node.queue.overwritten() != overwritten) {
+            node.dropped.inc(node.queue.overwritten() - overwritten);
+        }
+        break;
+    }
+    case DropPolicy::DropNewest:
+        if (!node.queue.tryPush(std::move(frame))) {
+            node.dropped.inc();
+            return;
+        }
+        break;
+    case DropPolicy::Block:
+        // 기다리는 동안 대기 작업을 대신 실행 (작업 스레드가 모두 막혀 하류가 실행되지 못하는 일이 없음)
+        while (!node.queue.tryPush(frame)) {
+            if (!running_.load(std::memory_order_relaxed)) {
+                node.dropped.inc();
+                return;
+            }
+            if (!pool_->runOne()) {
+                std::this_thread::yield();
+            }
+        }
+        break;
+    }
+    node.queue_depth.set(static_cast<double>(node.queue.size()));
+    schedule(node);
+}
+
+void ProcessingGraph::forward(Node& node, FrameRef&& frame) {
+    for (size_t j = 0; j < node.outputs.size(); ++j) {
+        enqueue(*node.outputs[j], j + 1 < node.outputs.size() ? FrameRef(frame) : std::move(frame));
+    }
+}
+
+void ProcessingGraph::schedule(Node& node) {
+    if (!node.scheduled.exchange(true, std::memory_order_seq_cst)) {
+        pool_->submit({&ProcessingGraph::runNode, &node});
+    }
+}
+
+void ProcessingGraph::runNode(void* arg) {
+    Node* node = static_cast<Node*>(arg);
+    node->graph->drain(*node);
+}
+
+void ProcessingGraph::drain(Node& node) {
+    FrameRef frame;
+    for (int i = 0; i < kDrainBatch && node.queue.tryPop(frame); ++i) {
+        bool pass = true;
+        if (node.stage) {
+            TraceSpan stage_span(node.trace_name, frame.data.sequence);
+            auto begin = steady_clock::now();
+            pass = node.stage->process(frame);
+            node.process_seconds.observe(duration<double>(steady_clock::now() - begin).count());
+        }
+        node.frames.inc();
+        if (pass) {
+            forward(node, std::move(frame));
+        }
+        frame = FrameRef();     // 하류로 넘기지 않은 참조는 여기서 놓음
+    }
+    node.queue_depth.set(static_cast<double>(node.queue.size()));
+
+    // 예약을 푼 뒤 큐를 다시 확인 (그 사이 들어온 프레임의 생산자는 예약을 보고 건너뛰었을 수 있음)
+    node.scheduled.store(false, std::memory_order_seq_cst);
+    if (node.queue.size() > 0 && running_.load(std::memory_order_relaxed)) {
+        schedule(node);
+    }
+}
+
+void ProcessingGraph::printStats() const {
+    for (const auto& node : nodes_) {
+        std::cout << "[INFO] Graph stage '" << node->config.name << "': " << node->frames.value() << " frames, "
+                  << node->dropped.value() << " dropped" << (node->stage ? "" : " (bypassed)") << std::endl;
+    }
+}
@@ -0,0 +1,121 @@
+#ifndef PROCESSING_GRAPH_H
+#define PROCESSING_GRAPH_H
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BoundedQueue.h"
+#include "ConfigManager.h"
+#include "FrameData.h"
+#include "MetricsRegistry.h"
+#include "WorkStealingPool.h"
+
+// 단계 사이를 흐르는 프레임의 크기와 배치
+struct StreamFormat {
+    int width;
+    int height;
+    int stride;
+    std::string pixel_format;
+};
+
+// 그래프 단계. 한 단계의 process 는 항상 한 번에 하나씩 (직렬로) 호출되지만 스레드는 바뀔 수 있음
+class GraphStage {
+public:
+    virtual ~GraphStage() = default;
+
+    // 하류 단계가 받을 형식 (기본은 입력 그대로)
+    virtual StreamFormat outputFormat(const StreamFormat& input) const { return input; }
+
+    // 프레임 하나 처리. frame 을 바꿔 내보낼 수 있고, false 면 하류로 보내지 않음
+    virtual bool process(FrameRef& frame) = 0;
+
+    // 자체 스레드가 있는 단계용. 그래프 start() 끝과 stop() 처음에 호출됨
+    virtual bool start() { return true; }
+    virtual void stop() {}
+
+protected:
+    // process 밖에서(자체 스레드 등) 하류로 프레임을 보냄. 그래프가 실행 중이 아니면 버림
+    void emit(FrameRef frame) {
+        if (emitter_) {
+            emitter_(std::move(frame));
+        }
+    }
+
+private:
+    friend class ProcessingGraph;
+    std::function<void(FrameRef&&)> emitter_;
+};
+
+// 설정으로 정의하는 처리 그래프 (DAG, 단계마다 입력은 하나이고 출력은 여러 단계로 갈 수 있음)
+// - 단계마다 고정 용량 입력 큐와 drop 정책 (drop_oldest, drop_newest, block)
+// - 큐가 비어 있다가 프레임이 들어오면 단계를 작업 훔치기 풀에 한 번만 예약하고, 실행된 작업이 큐를 비움
+// - 프레임은 FrameRef 로 참조만 늘려 전달 (픽셀 복사 없음)
+// - 단계별 처리 프레임 수, 버린 프레임 수, 큐 점유, 처리 시간을 메트릭으로 노출
+class ProcessingGraph {
+public:
+    // 입력 형식을 보고 단계를 만듦 (소스 단계는 빈 형식). nullptr 이면 그 단계는 통과(bypass)로 남음
+    using StageFactory = std::function<std::unique_ptr<GraphStage>(const StageConfig& config,
+                                                                   const StreamFormat& input)>;
+
+    explicit ProcessingGraph(const GraphConfig& config);
+    ~ProcessingGraph();
+
+    // build() 전에 단계 종류별 생성 함수 등록
+    void registerType(const std::string& type, StageFactory factory);
+
+    // 이름/입력/정책 검증 후 상류부터 단계를 만들고 연결 (순환이나 알 수 없는 종류면 false)
+    bool build();
+    bool start();
+    // 작업 스레드를 멈추고 큐에 남은 프레임을 놓음
+    void stop();
+
+    // 단계 번호 (없으면 -1)
+    int find(const std::string& name) const;
+    // 외부(캡처 콜백 등)에서 단계 입력 큐에 프레임을 넣음
+    bool push(int stage, FrameRef frame);
+
+    void printStats() const;
+
+private:
+    enum class DropPolicy {
+        DropOldest,
+        DropNewest,
+        Block
+    };
+
+    struct Node {
+        ProcessingGraph* graph;
+        StageConfig config;
+        const char* trace_name;             // FrameTracer 가 intern 한 단계 이름 (그래프보다 오래 유지)
+        std::unique_ptr<GraphStage> stage;  // nullptr 이면 통과
+        std::vector<Node*> outputs;
+        MpmcQueue<FrameRef> queue;
+        DropPolicy policy;
+        std::atomic<bool> scheduled;        // 풀에 예약됐거나 실행 중
+
+        Counter& frames;
+        Counter& dropped;
+        Gauge& queue_depth;
+        Histogram& process_seconds;
+
+        Node(ProcessingGraph* owner, const StageConfig& stage_config, DropPolicy drop_policy);
+    };
+
+    static void runNode(void* arg);
+    void enqueue(Node& node, FrameRef&& frame);
+    void forward(Node& node, FrameRef&& frame);     // node 의 모든 하류 큐에 넣음
+    void schedule(Node& node);
+    void drain(Node& node);
+
+    GraphConfig config_;
+    std::map<std::string, StageFactory> factories_;
+    std::vector<std::unique_ptr<Node>> nodes_;      // 상류부터 (위상 순서)
+    std::unique_ptr<WorkStealingPool> pool_;
+    std::atomic<bool> running_;
+};
+
+#endif // PROCESSING_GRAPH_H
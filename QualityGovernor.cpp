@@ -0,0 +1,213 @@
+#include "QualityGovernor.h"
+#include "Logger.h"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace std::chrono;
+
+namespace {
+
+uint64_t nowNs() {
+    return static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+bool readFirstLine(const std::string& path, std::string& line) {
+    if (path.empty()) {
+        return false;
+    }
+    std::ifstream file(path);
+    return static_cast<bool>(std::getline(file, line)) && !line.empty();
+}
+
+} // namespace
+
+QualityGovernor::QualityGovernor(const GovernorConfig& config)
+    : config_(config), level_(0), last_sample_ns_(0), last_transition_ns_(0), relaxed_since_ns_(0),
+      prev_busy_(0), prev_total_(0),
+      temperature_(MetricsRegistry::instance().gauge("camstream_soc_temperature_celsius", "SoC temperature")),
+      load_(MetricsRegistry::instance().gauge("camstream_cpu_load_ratio", "CPU busy fraction over the last sample")),
+      throttled_(MetricsRegistry::instance().gauge("camstream_soc_throttled", "1 while the SoC reports throttling")),
+      quality_level_(MetricsRegistry::instance().gauge("camstream_quality_level",
+                                                       "Degradation steps currently applied (0 = full quality)")),
+      transitions_(MetricsRegistry::instance().counter("camstream_quality_transitions_total",
+                                                       "Quality governor steps taken in either direction")) {
+}
+
+void QualityGovernor::setAction(const std::string& step, Action action) {
+    actions_.emplace_back(step, std::move(action));
+}
+
+bool QualityGovernor::start() {
+    std::stringstream steps(config_.ladder);
+    std::string name;
+    while (std::getline(steps, name, ',')) {
+        name.erase(0, name.find_first_not_of(' '));
+        name.erase(name.find_last_not_of(' ') + 1);
+        auto it = actions_.begin();
+        while (it != actions_.end() && it->first != name) {
+            ++it;
+        }
+        if (it == actions_.end()) {
+            std::cerr << "[WARN] Quality governor: no action for ladder step '" << name << "', skipped" << std::endl;
+            continue;
+        }
+        ladder_.push_back(*it);
+    }
+
+    // CPU 사용률은 두 샘플의 차이이므로 첫 샘플에서는 누적값만 읽힘
+    Sample sample = readSample();
+    bool has_load = prev_total_ != 0;
+    std::cout << "[INFO] Quality governor: temperature " << (sample.has_temperature ? config_.temperature_path : "unavailable")
+              << ", throttle " << (sample.has_throttle ? config_.throttle_path : "unavailable")
+              << ", load " << (has_load ? config_.stat_path : "unavailable") << ", " << ladder_.size()
+              << " ladder steps" << std::endl;
+    if (ladder_.empty() || (!sample.has_temperature && !sample.has_throttle && !has_load)) {
+        return false;
+    }
+    last_sample_ns_ = nowNs();
+    return true;
+}
+
+void QualityGovernor::poll() {
+    uint64_t now = nowNs();
+    if (now - last_sample_ns_ < static_cast<uint64_t>(config_.interval_ms) * 1000000ULL) {
+        return;
+    }
+    last_sample_ns_ = now;
+
+    Sample sample = readSample();
+    uint64_t hold_ns = static_cast<uint64_t>(config_.hold_seconds) * 1000000000ULL;
+    bool hold_elapsed = now - last_transition_ns_ >= hold_ns;
+
+    // 회복은 낮은 임계값 아래에서 hold 의 두 배 동안 머물러야 하므로 경계에서 오르내리지 않음
+    if (relaxed(sample)) {
+        if (relaxed_since_ns_ == 0) {
+            relaxed_since_ns_ = now;
+        }
+    } else {
+        relaxed_since_ns_ = 0;
+    }
+
+    if (overloaded(sample)) {
+        if (level_ < ladder_.size() && hold_elapsed) {
+            transition(level_, true, sample);
+            level_++;
+            last_transition_ns_ = now;
+        }
+    } else if (level_ > 0 && hold_elapsed && relaxed_since_ns_ != 0 && now - relaxed_since_ns_ >= 2 * hold_ns) {
+        level_--;
+        transition(level_, false, sample);
+        last_transition_ns_ = now;
+        relaxed_since_ns_ = now;
+    }
+    quality_level_.set(static_cast<double>(level_));
+}
+
+QualityGovernor::Sample QualityGovernor::readSample() {
+    Sample sample = {0.0, 0.0, false, false, false, false};
+    sample.has_temperature = readTemperature(sample.temperature_c);
+    sample.has_throttle = readThrottled(sample.throttled);
+    sample.has_load = readLoad(sample.load);
+    if (sample.has_temperature) {
+        temperature_.set(sample.temperature_c);
+    }
+    if (sample.has_load) {
+        load_.set(sample.load);
+    }
+    throttled_.set(sample.throttled ? 1.0 : 0.0);
+    return sample;
+}
+
+bool QualityGovernor::readTemperature(double& celsius) const {
+    std::string line;
+    if (!readFirstLine(config_.temperature_path, line)) {
+        return false;
+    }
+    char* end = nullptr;
+    double millidegrees = std::strtod(line.c_str(), &end);
+    if (end == line.c_str()) {
+        return false;
+    }
+    celsius = millidegrees / 1000.0;
+    return true;
+}
+
+bool QualityGovernor::readThrottled(bool& throttled) const {
+    // get_throttled 는 "0x" 없는 16진수 (bit1: 주파수 제한, bit2: throttle 중, bit3: 온도 소프트 제한)
+    std::string line;
+    if (!readFirstLine(config_.throttle_path, line)) {
+        return false;
+    }
+    if (line.compare(0, 10, "throttled=") == 0) {
+        line.erase(0, 10);      // vcgencmd get_throttled 출력을 저장한 파일
+    }
+    char* end = nullptr;
+    unsigned long bits = std::strtoul(line.c_str(), &end, 16);
+    if (end == line.c_str()) {
+        return false;
+    }
+    throttled = (bits & static_cast<unsigned long>(config_.throttle_mask)) != 0;
+    return true;
+}
+
+bool QualityGovernor::readLoad(double& load) {
+    // 첫 줄 "cpu user nice system idle iowait irq softirq steal ..." 의 직전 샘플 대비 변화량
+    std::string line;
+    if (!readFirstLine(config_.stat_path, line) || line.compare(0, 4, "cpu ") != 0) {
+        return false;
+    }
+    std::istringstream fields(line.substr(4));
+    uint64_t value = 0;
+    uint64_t total = 0;
+    uint64_t idle = 0;
+    for (int i = 0; i < 8 && fields >> value; ++i) {
+        total += value;
+        if (i == 3 || i == 4) {
+            idle += value;
+        }
+    }
+    uint64_t busy = total - idle;
+    bool has_previous = prev_total_ != 0 && total > prev_total_;
+    if (has_previous) {
+        load = static_cast<double>(busy - prev_busy_) / static_cast<double>(total - prev_total_);
+    }
+    prev_busy_ = busy;
+    prev_total_ = total;
+    return has_previous;
+}
+
+bool QualityGovernor::overloaded(const Sample& sample) const {
+    return (sample.has_temperature && sample.temperature_c >= config_.temp_high_c) ||
+           (sample.has_load && sample.load >= config_.load_high) || sample.throttled;
+}
+
+bool QualityGovernor::relaxed(const Sample& sample) const {
+    return (!sample.has_temperature || sample.temperature_c <= config_.temp_low_c) &&
+           (!sample.has_load || sample.load <= config_.load_low) && !sample.throttled;
+}
+
+std::string QualityGovernor::describe(const Sample& sample) const {
+    std::ostringstream out;
+    out.precision(3);
+    if (sample.has_temperature) {
+        out << "temp " << sample.temperature_c << " C, ";
+    }
+    if (sample.has_load) {
+        out << "load " << sample.load << ", ";
+    }
+    out << "throttled " << (sample.throttled ? "yes" : "no");
+    return out.str();
+}
+
+void QualityGovernor::transition(size_t step, bool degraded, const Sample& sample) {
+    const std::string& name = ladder_[step].first;
+    transitions_.inc();
+    LOG_INFO("governor") << (degraded ? "Degrading" : "Restoring") << " '" << name << "' (level "
+                         << (degraded ? step + 1 : step) << "/" << ladder_.size() << "): " << describe(sample);
+    if (!ladder_[step].second(degraded)) {
+        LOG_WARN("governor") << "Quality step '" << name << "' could not be applied";
+    }
+}
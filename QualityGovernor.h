@@ -0,0 +1,71 @@
+#ifndef QUALITY_GOVERNOR_H
+#define QUALITY_GOVERNOR_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ConfigManager.h"
+#include "MetricsRegistry.h"
+
+// 온도/부하 기반 품질 조절
+// - sysfs/procfs 에서 SoC 온도, throttle 비트, CPU 사용률을 주기적으로 읽음 (경로는 설정으로 바꿀 수 있음)
+// - 임계값을 넘으면 ladder 순서대로 한 단계씩 낮추고, 낮은 임계값 아래로 충분히 머무르면 역순으로 회복
+// - 단계마다 등록된 동작(degraded=true/false)을 주 루프 스레드에서 호출
+class QualityGovernor {
+public:
+    using Action = std::function<bool(bool degraded)>;
+
+    explicit QualityGovernor(const GovernorConfig& config);
+
+    // start() 전에 ladder 단계 이름별 동작 등록 (동작이 없는 단계는 ladder 에서 빠짐)
+    void setAction(const std::string& step, Action action);
+
+    // ladder 확정, 센서 확인 및 첫 샘플 (읽을 수 있는 센서가 없으면 false)
+    bool start();
+
+    // 주 루프에서 주기적으로 호출 (interval_ms 마다 샘플링)
+    void poll();
+
+    size_t level() const { return level_; }
+
+private:
+    struct Sample {
+        double temperature_c;
+        double load;
+        bool throttled;
+        bool has_temperature;
+        bool has_load;
+        bool has_throttle;
+    };
+
+    Sample readSample();
+    bool readTemperature(double& celsius) const;
+    bool readThrottled(bool& throttled) const;
+    bool readLoad(double& load);
+    bool overloaded(const Sample& sample) const;
+    bool relaxed(const Sample& sample) const;
+    std::string describe(const Sample& sample) const;
+    void transition(size_t step, bool degraded, const Sample& sample);
+
+    GovernorConfig config_;
+    std::vector<std::pair<std::string, Action>> actions_;
+    std::vector<std::pair<std::string, Action>> ladder_;
+    size_t level_;                  // 적용된 단계 수 (0 이면 원래 품질)
+
+    uint64_t last_sample_ns_;
+    uint64_t last_transition_ns_;
+    uint64_t relaxed_since_ns_;     // 회복 조건이 연속으로 유지된 시작 시각 (0 이면 아님)
+    uint64_t prev_busy_;            // /proc/stat 직전 누적값
+    uint64_t prev_total_;
+
+    Gauge& temperature_;
+    Gauge& load_;
+    Gauge& throttled_;
+    Gauge& quality_level_;
+    Counter& transitions_;
+};
+
+#endif // QUALITY_GOVERNOR_H
@@ -0,0 +1,481 @@
+#include "RawCapture.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace std::chrono;
+
+namespace {
+
+const char kRawMagic[8] = {'C', 'A', 'M', 'R', 'A', 'W', '\0', '\1'};
+constexpr size_t kSlotAlignment = 4096;
+constexpr int kReplayInFlight = 4;          // fast 모드에서 하류에 동시에 내보내는 최대 프레임 수
+constexpr uint64_t kPrefetchFrames = 4;     // 내보내기 전에 미리 읽어 두는 프레임 수
+
+uint64_t bootNowNs() {
+    timespec now;
+    clock_gettime(CLOCK_BOOTTIME, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + now.tv_nsec;
+}
+
+size_t pageSize() {
+    static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return page;
+}
+
+} // namespace
+
+RawCaptureFile::RawCaptureFile() : map_(nullptr), map_size_(0), header_(), frame_count_(0) {
+}
+
+RawCaptureFile::~RawCaptureFile() {
+    if (map_) {
+        munmap(map_, map_size_);
+    }
+}
+
+bool RawCaptureFile::isRawCapture(const std::string& path) {
+    char magic[sizeof(kRawMagic)] = {};
+    std::ifstream file(path, std::ios::binary);
+    return file.read(magic, sizeof(magic)) && memcmp(magic, kRawMagic, sizeof(magic)) == 0;
+}
+
+bool RawCaptureFile::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "[ERROR] Cannot open capture file " << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < kRawHeaderSize) {
+        std::cerr << "[ERROR] Capture file " << path << " is too short" << std::endl;
+        ::close(fd);
+        return false;
+    }
+    // 제자리 단계(프라이버시 마스크)가 쓰는 페이지만 복사되고 파일은 바뀌지 않음
+    map_size_ = static_cast<size_t>(st.st_size);
+    void* map = mmap(nullptr, map_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        std::cerr << "[ERROR] Cannot map capture file " << path << ": " << strerror(errno) << std::endl;
+        map_size_ = 0;
+        return false;
+    }
+    map_ = static_cast<uint8_t*>(map);
+
+    memcpy(&header_, map_, sizeof(header_));
+    if (memcmp(header_.magic, kRawMagic, sizeof(kRawMagic)) != 0 || header_.version != kRawVersion) {
+        std::cerr << "[ERROR] " << path << " is not a capture file (or has an unsupported version)" << std::endl;
+        return false;
+    }
+    if (header_.header_size < sizeof(RawFileHeader) || header_.frame_size == 0 ||
+        header_.slot_size < kRawFrameHeaderSize + header_.frame_size || header_.width <= 0 || header_.height <= 0 ||
+        header_.num_planes < 1 || header_.num_planes > kMaxFramePlanes) {
+        std::cerr << "[ERROR] Capture file " << path << " has an invalid header" << std::endl;
+        return false;
+    }
+    for (int plane = 0; plane < header_.num_planes; ++plane) {
+        if (header_.offsets[plane] >= header_.frame_size || header_.strides[plane] <= 0) {
+            std::cerr << "[ERROR] Capture file " << path << " has an invalid plane layout" << std::endl;
+            return false;
+        }
+    }
+    pixel_format_.assign(header_.pixel_format, strnlen(header_.pixel_format, sizeof(header_.pixel_format)));
+
+    // 기록이 중간에 끊긴 파일은 완전한 슬롯까지만 사용
+    frame_count_ = map_size_ > header_.header_size ? (map_size_ - header_.header_size) / header_.slot_size : 0;
+    if (frame_count_ == 0) {
+        std::cerr << "[ERROR] Capture file " << path << " holds no complete frame" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+const RawFrameHeader& RawCaptureFile::frameHeader(uint64_t index) const {
+    return *reinterpret_cast<const RawFrameHeader*>(map_ + header_.header_size + index * header_.slot_size);
+}
+
+void RawCaptureFile::frame(uint64_t index, FrameData& frame) const {
+    const RawFrameHeader& frame_header = frameHeader(index);
+    frame.data = map_ + header_.header_size + index * header_.slot_size + kRawFrameHeaderSize;
+    frame.size = header_.frame_size;
+    frame.buffer_index = index;
+    frame.width = header_.width;
+    frame.height = header_.height;
+    frame.num_planes = header_.num_planes;
+    for (int plane = 0; plane < kMaxFramePlanes; ++plane) {
+        frame.offsets[plane] = header_.offsets[plane];
+        frame.strides[plane] = header_.strides[plane];
+    }
+    frame.sequence = frame_header.sequence;
+    frame.timestamp_ns = frame_header.timestamp_ns;
+    frame.duration_ns = frame_header.duration_ns;
+}
+
+void RawCaptureFile::prefetch(uint64_t first, uint64_t count) const {
+    if (first >= frame_count_) {
+        return;
+    }
+    count = std::min(count, frame_count_ - first);
+    uintptr_t begin = reinterpret_cast<uintptr_t>(map_ + header_.header_size + first * header_.slot_size);
+    uintptr_t end = begin + count * header_.slot_size;
+    begin &= ~(pageSize() - 1);
+    madvise(reinterpret_cast<void*>(begin), end - begin, MADV_WILLNEED);
+}
+
+void RawCaptureFile::release(uint64_t index) const {
+    // 이웃 슬롯과 겹치는 페이지는 건드리지 않음 (페이지가 4 KB 보다 큰 커널)
+    uintptr_t begin = reinterpret_cast<uintptr_t>(map_ + header_.header_size + index * header_.slot_size);
+    uintptr_t end = begin + header_.slot_size;
+    begin = (begin + pageSize() - 1) & ~(pageSize() - 1);
+    end &= ~(pageSize() - 1);
+    if (end > begin) {
+        madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED);
+    }
+}
+
+RawRecorder::RawRecorder(const RecordingConfig& config, const std::string& pixel_format, int fps)
+    : config_(config), pixel_format_(pixel_format), fps_(fps), fd_(-1), running_(false), accepting_(false),
+      header_(), header_written_(false), accepted_(0), written_(0),
+      frames_(MetricsRegistry::instance().counter("camstream_recorder_frames_total",
+                                                  "Frames written to the raw capture file")),
+      dropped_(MetricsRegistry::instance().counter("camstream_recorder_dropped_total",
+                                                   "Frames the raw recorder dropped with no free copy buffer")),
+      bytes_(MetricsRegistry::instance().counter("camstream_recorder_bytes_total",
+                                                 "Bytes written to the raw capture file")) {
+}
+
+RawRecorder::~RawRecorder() {
+    stop();
+}
+
+bool RawRecorder::start() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (running_) {
+        return true;
+    }
+    if (pixel_format_.size() >= sizeof(header_.pixel_format)) {
+        std::cerr << "[ERROR] Recorder cannot store pixel format " << pixel_format_ << std::endl;
+        return false;
+    }
+    fd_ = ::open(config_.path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        std::cerr << "[ERROR] Cannot create capture file " << config_.path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    running_ = true;
+    accepting_ = true;
+    thread_ = std::thread(&RawRecorder::run, this);
+    std::cout << "[INFO] Recording " << pixel_format_ << " frames to " << config_.path << std::endl;
+    return true;
+}
+
+void RawRecorder::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+        accepting_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    ::close(fd_);
+    fd_ = -1;
+    std::cout << "[INFO] Recorded " << written_ << " frames ("
+              << written_ * header_.slot_size / (1024.0 * 1024.0) << " MB) to " << config_.path << ", "
+              << dropped_.value() << " dropped" << std::endl;
+}
+
+bool RawRecorder::record(const FrameData& frame) {
+    std::unique_lock<std::mutex> lock(mtx_);
+    if (!accepting_) {
+        return false;
+    }
+    if (buffers_.empty()) {
+        // 첫 프레임으로 크기와 평면 배치를 정함
+        memcpy(header_.magic, kRawMagic, sizeof(kRawMagic));
+        header_.version = kRawVersion;
+        header_.header_size = kRawHeaderSize;
+        header_.frame_size = frame.size;
+        header_.slot_size = (kRawFrameHeaderSize + frame.size + kSlotAlignment - 1) / kSlotAlignment * kSlotAlignment;
+        header_.width = frame.width;
+        header_.height = frame.height;
+        header_.num_planes = frame.num_planes;
+        header_.fps = fps_;
+        for (int plane = 0; plane < kMaxFramePlanes; ++plane) {
+            header_.offsets[plane] = plane < frame.num_planes ? frame.offsets[plane] : 0;
+            header_.strides[plane] = plane < frame.num_planes ? frame.strides[plane] : 0;
+        }
+        strncpy(header_.pixel_format, pixel_format_.c_str(), sizeof(header_.pixel_format) - 1);
+        buffers_.resize(static_cast<size_t>(std::max(config_.buffers, 1)));
+        for (size_t i = 0; i < buffers_.size(); ++i) {
+            buffers_[i].assign(header_.slot_size, 0);
+            free_.push_back(i);
+        }
+    } else if (frame.size != header_.frame_size || frame.width != header_.width || frame.height != header_.height) {
+        // 슬롯 크기가 고정이므로 형식이 바뀐 프레임(카메라 재구성 등)은 담을 수 없음
+        dropped_.inc();
+        return false;
+    }
+    if (free_.empty()) {
+        dropped_.inc();
+        return false;
+    }
+    size_t index = free_.back();
+    free_.pop_back();
+    accepted_++;
+    if (config_.max_frames > 0 && accepted_ >= static_cast<uint64_t>(config_.max_frames)) {
+        accepting_ = false;
+        LOG_INFO("recorder") << "Recorded " << accepted_ << " frames, stopping at max_frames";
+    }
+    lock.unlock();
+
+    // 복사는 락 밖에서 (기록 스레드는 대기열에 들어간 버퍼만 읽음)
+    uint8_t* slot = buffers_[index].data();
+    RawFrameHeader frame_header = {};
+    frame_header.timestamp_ns = frame.timestamp_ns;
+    frame_header.duration_ns = frame.duration_ns;
+    frame_header.sequence = frame.sequence;
+    memcpy(slot, &frame_header, sizeof(frame_header));
+    memcpy(slot + kRawFrameHeaderSize, frame.data, frame.size);
+
+    lock.lock();
+    pending_.push_back(index);
+    lock.unlock();
+    cv_.notify_one();
+    return true;
+}
+
+bool RawRecorder::writeAll(const uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd_, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+void RawRecorder::run() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (true) {
+        // 정지 후에도 대기열에 남은 프레임은 모두 씀
+        cv_.wait(lock, [this] { return !running_ || !pending_.empty(); });
+        if (pending_.empty()) {
+            break;
+        }
+        size_t index = pending_.front();
+        pending_.pop_front();
+        bool write_header = !header_written_;
+        RawFileHeader header = header_;
+        lock.unlock();
+
+        bool ok = true;
+        if (write_header) {
+            std::vector<uint8_t> page(kRawHeaderSize, 0);
+            memcpy(page.data(), &header, sizeof(header));
+            ok = writeAll(page.data(), page.size());
+        }
+        ok = ok && writeAll(buffers_[index].data(), header.slot_size);
+
+        lock.lock();
+        free_.push_back(index);
+        if (!ok) {
+            LOG_ERROR("recorder") << "Writing " << config_.path << " failed: " << strerror(errno)
+                                  << ", recording stopped";
+            accepting_ = false;
+            for (size_t pending : pending_) {
+                free_.push_back(pending);
+            }
+            pending_.clear();
+            continue;
+        }
+        header_written_ = true;
+        written_++;
+        frames_.inc();
+        bytes_.inc(header.slot_size);
+    }
+}
+
+RawReplay::RawReplay(const ReplayConfig& config)
+    : config_(config), fast_(config.mode == "fast"), file_(std::make_shared<RawCaptureFile>()), running_(false),
+      finished_(false), in_flight_(std::make_shared<InFlight>()),
+      frames_(MetricsRegistry::instance().counter("camstream_replay_frames_total",
+                                                  "Frames fed into the pipeline from the capture file")),
+      late_(MetricsRegistry::instance().counter("camstream_replay_late_total",
+                                                "Replayed frames released more than one frame period late")),
+      stalls_(MetricsRegistry::instance().counter("camstream_replay_stalls_total",
+                                                  "Times fast replay waited for the pipeline to release frames")) {
+}
+
+RawReplay::~RawReplay() {
+    stop();
+}
+
+bool RawReplay::initialize() {
+    if (config_.mode != "realtime" && config_.mode != "fast") {
+        std::cerr << "[ERROR] Unknown replay mode '" << config_.mode << "' (expected realtime or fast)" << std::endl;
+        return false;
+    }
+    if (!file_->open(config_.path)) {
+        return false;
+    }
+    const RawFileHeader& header = file_->header();
+    std::cout << "[INFO] Replaying " << config_.path << ": " << file_->frameCount() << " frames, " << header.width
+              << "x" << header.height << " " << file_->pixelFormat() << ", stride " << header.strides[0] << ", "
+              << config_.mode << (config_.loop ? ", looping" : "") << std::endl;
+    return true;
+}
+
+int RawReplay::getFrameRate() const {
+    if (file_->header().fps > 0) {
+        return file_->header().fps;
+    }
+    // 기록 fps 가 없으면 첫 두 프레임 간격으로 추정
+    if (file_->frameCount() > 1) {
+        uint64_t first = file_->frameHeader(0).timestamp_ns;
+        uint64_t second = file_->frameHeader(1).timestamp_ns;
+        if (second > first) {
+            return std::max(static_cast<int>(1000000000ULL / (second - first)), 1);
+        }
+    }
+    return 30;
+}
+
+void RawReplay::setFrameSink(FrameSink sink) {
+    sink_ = std::move(sink);
+}
+
+bool RawReplay::start() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (running_) {
+        return true;
+    }
+    running_ = true;
+    finished_ = false;
+    thread_ = std::thread(&RawReplay::run, this);
+    return true;
+}
+
+void RawReplay::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    cv_.notify_all();
+    in_flight_->cv.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool RawReplay::waitUntil(steady_clock::time_point deadline) {
+    std::unique_lock<std::mutex> lock(mtx_);
+    return !cv_.wait_until(lock, deadline, [this] { return !running_; });
+}
+
+void RawReplay::run() {
+    uint64_t count = file_->frameCount();
+    uint64_t first_ts = file_->frameHeader(0).timestamp_ns;
+    uint64_t last_ts = std::max(file_->frameHeader(count - 1).timestamp_ns, first_ts);
+    uint64_t period_ns = 1000000000ULL / static_cast<uint64_t>(getFrameRate());
+    // 반복할 때마다 기록 길이 + 한 주기만큼 시각을 밀어 타임스탬프가 계속 증가하게 함
+    uint64_t loop_length_ns = last_ts - first_ts + period_ns;
+
+    steady_clock::time_point steady_start = steady_clock::now();
+    uint64_t boot_start = bootNowNs();
+    uint64_t loop_offset_ns = 0;
+    uint64_t previous_ns = 0;
+    uint64_t released = 0;
+    file_->prefetch(0, kPrefetchFrames);
+
+    for (uint64_t index = 0;; ++index) {
+        if (index == count) {
+            if (!config_.loop) {
+                break;
+            }
+            index = 0;
+            loop_offset_ns += loop_length_ns;
+            file_->prefetch(0, kPrefetchFrames);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            if (!running_) {
+                break;
+            }
+        }
+
+        // 기록 시각이 뒤로 가는 프레임(센서 재시작)은 직전 프레임 시각에 붙임
+        uint64_t frame_ts = std::max(file_->frameHeader(index).timestamp_ns, first_ts);
+        uint64_t offset_ns = std::max(frame_ts - first_ts + loop_offset_ns, previous_ns);
+        previous_ns = offset_ns;
+
+        FrameRef frame;
+        file_->frame(index, frame.data);
+        frame.flags = 0;
+        if (fast_) {
+            // 하류가 프레임을 놓을 때까지 기다려 큐에서 버려지지 않게 함 (pacer 처럼 프레임을 쌓는 단계는 시간 제한으로 풀림)
+            std::unique_lock<std::mutex> lock(in_flight_->mtx);
+            if (in_flight_->count >= kReplayInFlight) {
+                stalls_.inc();
+                in_flight_->cv.wait_for(lock, milliseconds(100), [this] { return in_flight_->count < kReplayInFlight; });
+            }
+            frame.data.timestamp_ns = bootNowNs();
+        } else {
+            steady_clock::time_point deadline = steady_start + nanoseconds(offset_ns);
+            if (!waitUntil(deadline)) {
+                break;
+            }
+            if (steady_clock::now() - deadline > nanoseconds(period_ns)) {
+                late_.inc();
+            }
+            frame.data.timestamp_ns = boot_start + offset_ns;
+        }
+
+        // 마지막 참조가 놓이면 슬롯 페이지를 놓아 다음 반복 때 파일 내용을 다시 읽게 함
+        std::shared_ptr<RawCaptureFile> file = file_;
+        std::shared_ptr<InFlight> in_flight = in_flight_;
+        {
+            std::lock_guard<std::mutex> lock(in_flight->mtx);
+            in_flight->count++;
+        }
+        frame.owner = std::shared_ptr<void>(frame.data.data, [file, in_flight, index](void*) {
+            file->release(index);
+            {
+                std::lock_guard<std::mutex> lock(in_flight->mtx);
+                in_flight->count--;
+            }
+            in_flight->cv.notify_one();
+        });
+        file_->prefetch(index + kPrefetchFrames, 1);
+
+        if (sink_) {
+            sink_(frame, FrameRef());
+        }
+        frames_.inc();
+        released++;
+    }
+
+    finished_ = true;
+    LOG_INFO("replay") << "Replay finished after " << released << " frames";
+}
@@ -0,0 +1,185 @@
+#ifndef RAW_CAPTURE_H
+#define RAW_CAPTURE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ConfigManager.h"
+#include "FrameData.h"
+#include "MetricsRegistry.h"
+
+// 캡처 프레임 덤프 컨테이너 (.craw)
+// - 4 KB 파일 헤더 뒤에 프레임마다 같은 크기의 페이지 정렬 슬롯 (64 바이트 프레임 헤더 + 캡처 버퍼 그대로)
+// - 슬롯 크기가 고정이라 N 번째 프레임 위치를 바로 계산하고, 기록이 중간에 끊겨도 파일 크기로 완전한 슬롯 수를 셈
+// - 평면 offset/stride 는 캡처 버퍼 배치 그대로 (패딩 stride 관련 문제도 재현됨)
+constexpr size_t kRawHeaderSize = 4096;
+constexpr size_t kRawFrameHeaderSize = 64;
+constexpr uint32_t kRawVersion = 1;
+
+struct RawFileHeader {
+    char magic[8];              // "CAMRAW" 0 1
+    uint32_t version;
+    uint32_t header_size;       // 첫 슬롯 위치
+    uint64_t slot_size;         // 프레임 헤더 + 캡처 버퍼, 페이지 크기 배수
+    uint64_t frame_size;        // 캡처 버퍼 크기
+    int32_t width;
+    int32_t height;
+    int32_t num_planes;
+    int32_t fps;                // 기록 당시 설정 fps (참고용, 재생 간격은 타임스탬프로 계산)
+    uint64_t offsets[kMaxFramePlanes];
+    int32_t strides[kMaxFramePlanes];
+    char pixel_format[16];
+};
+
+struct RawFrameHeader {
+    uint64_t timestamp_ns;      // 센서 타임스탬프 (CLOCK_BOOTTIME)
+    uint64_t duration_ns;
+    uint32_t sequence;          // 센서 프레임 번호 (빠진 번호로 기록 중 버린 프레임을 알 수 있음)
+    uint32_t flags;
+    uint8_t reserved[40];
+};
+static_assert(sizeof(RawFrameHeader) == kRawFrameHeaderSize, "RawFrameHeader must fill its 64-byte slot prefix");
+static_assert(sizeof(RawFileHeader) <= kRawHeaderSize, "RawFileHeader must fit in the file header page");
+
+// 기록된 컨테이너를 MAP_PRIVATE 로 매핑 (읽기 전용 파일이어도 제자리 단계가 쓸 수 있고, 쓴 페이지만 복사됨)
+class RawCaptureFile {
+private:
+    uint8_t* map_;
+    size_t map_size_;
+    RawFileHeader header_;
+    uint64_t frame_count_;
+    std::string pixel_format_;
+
+public:
+    RawCaptureFile();
+    ~RawCaptureFile();
+
+    RawCaptureFile(const RawCaptureFile&) = delete;
+    RawCaptureFile& operator=(const RawCaptureFile&) = delete;
+
+    // 헤더를 검증하고 파일 전체를 매핑 (컨테이너가 아니거나 손상됐으면 false)
+    bool open(const std::string& path);
+
+    // 파일 첫 부분이 컨테이너 magic 인지 (열지 않고 확인)
+    static bool isRawCapture(const std::string& path);
+
+    const RawFileHeader& header() const { return header_; }
+    const std::string& pixelFormat() const { return pixel_format_; }
+    uint64_t frameCount() const { return frame_count_; }
+    const RawFrameHeader& frameHeader(uint64_t index) const;
+
+    // index 번째 프레임. data 는 매핑 안을 가리키고 sequence/timestamp 는 기록된 값
+    void frame(uint64_t index, FrameData& frame) const;
+
+    // 구간을 미리 읽게 하거나(순차 재생), 다 쓴 슬롯의 페이지를 놓음 (제자리 단계가 바꾼 복사본도 버려짐)
+    void prefetch(uint64_t first, uint64_t count) const;
+    void release(uint64_t index) const;
+};
+
+// 입력 프레임을 복사 버퍼에 담아 기록 스레드가 컨테이너 파일에 순서대로 씀
+// - 그래프 작업 스레드는 memcpy 만 하고 캡처 버퍼를 바로 놓음 (디스크가 느려도 카메라 요청이 묶이지 않음)
+// - 복사 버퍼가 모두 쓰는 중이면 그 프레임은 버림 (기록 파일의 sequence 에 빈 번호가 생김)
+class RawRecorder {
+private:
+    RecordingConfig config_;
+    std::string pixel_format_;
+    int fps_;
+    int fd_;
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    bool running_;
+    bool accepting_;
+    std::vector<std::vector<uint8_t>> buffers_;     // 슬롯 크기, 첫 프레임에서 할당
+    std::vector<size_t> free_;
+    std::deque<size_t> pending_;
+    RawFileHeader header_;
+    bool header_written_;
+    uint64_t accepted_;
+    uint64_t written_;
+    std::thread thread_;
+
+    Counter& frames_;
+    Counter& dropped_;
+    Counter& bytes_;
+
+    void run();
+    bool writeAll(const uint8_t* data, size_t size);
+
+public:
+    // pixel_format 과 fps 는 파일 헤더에 기록됨 (크기와 평면 배치는 첫 프레임에서 정함)
+    RawRecorder(const RecordingConfig& config, const std::string& pixel_format, int fps);
+    ~RawRecorder();
+
+    // 파일을 만들고 기록 스레드 시작 (경로를 열 수 없으면 false)
+    bool start();
+    // 대기 중인 프레임을 모두 쓰고 닫음
+    void stop();
+
+    // 프레임을 복사해 기록 대기열에 넣음 (버린 경우 false)
+    bool record(const FrameData& frame);
+};
+
+// 기록된 컨테이너를 카메라 대신 소스로 재생
+// - realtime: 기록된 타임스탬프 간격대로 내보내고 타임스탬프를 지금 기준으로 옮김 (PTS 가 라이브와 같은 흐름)
+// - fast: 기다리지 않고 내보내되, 하류가 잡고 있는 프레임이 많으면 놓일 때까지 기다림 (큐 drop 대신 역압)
+// - 프레임은 매핑된 슬롯을 그대로 가리키고, 마지막 참조가 놓이면 그 슬롯의 페이지를 놓음
+class RawReplay {
+public:
+    using FrameSink = std::function<void(const FrameRef& frame, const FrameRef& analytics)>;
+
+    explicit RawReplay(const ReplayConfig& config);
+    ~RawReplay();
+
+    // 파일을 열고 형식을 읽음
+    bool initialize();
+    bool start();
+    void stop();
+
+    void setFrameSink(FrameSink sink);
+
+    int getWidth() const { return file_->header().width; }
+    int getHeight() const { return file_->header().height; }
+    int getStride() const { return file_->header().strides[0]; }
+    int getFrameRate() const;
+    const std::string& getPixelFormat() const { return file_->pixelFormat(); }
+    bool isFinished() const { return finished_.load(); }
+
+private:
+    void run();
+    bool waitUntil(std::chrono::steady_clock::time_point deadline);
+
+    ReplayConfig config_;
+    bool fast_;
+    std::shared_ptr<RawCaptureFile> file_;
+    FrameSink sink_;
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    bool running_;
+    std::atomic<bool> finished_;
+    std::thread thread_;
+
+    // 하류에 나가 있는 프레임 수 (fast 모드 역압). 프레임 소멸자가 재생기보다 늦게 불릴 수 있어 따로 소유
+    struct InFlight {
+        std::mutex mtx;
+        std::condition_variable cv;
+        int count = 0;
+    };
+    std::shared_ptr<InFlight> in_flight_;
+
+    Counter& frames_;
+    Counter& late_;
+    Counter& stalls_;
+};
+
+#endif // RAW_CAPTURE_H
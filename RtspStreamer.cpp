@@ -1,10 +1,135 @@
 #include "RtspStreamer.h"
+#include "StartupTimeline.h"
+#include "FrameTracer.h"
+#include "Logger.h"
+#include <algorithm>
 #include <iostream>
+#include <vector>
+#include <time.h>
 
-RtspStreamer::RtspStreamer(const VideoConfig& video_config, const RtspConfig& rtsp_config)
-    : loop_(nullptr), server_(nullptr), mounts_(nullptr), factory_(nullptr), appsrc_(nullptr),
-      is_running_(false), video_config_(video_config), rtsp_config_(rtsp_config), timestamp_(0) {
+namespace {
+
+GstVideoFormat videoFormatFromString(const std::string& pixel_format) {
+    if (pixel_format == "RGB888") {
+        return GST_VIDEO_FORMAT_RGB;
+    } else if (pixel_format == "YUV420") {
+        return GST_VIDEO_FORMAT_I420;
+    } else if (pixel_format == "YUYV") {
+        return GST_VIDEO_FORMAT_YUY2;
+    }
+    return GST_VIDEO_FORMAT_BGR;    // BGR888 및 기본값
+}
+
+// appsrc 에서 last 직전까지 src→peer 를 따라가며 요소를 모음 (참조를 잡아 반환)
+std::vector<GstElement*> collectChain(GstElement* appsrc, GstElement* last) {
+    std::vector<GstElement*> chain;
+    GstPad* src_pad = gst_element_get_static_pad(appsrc, "src");
+    GstPad* peer = src_pad ? gst_pad_get_peer(src_pad) : nullptr;
+    if (src_pad) {
+        gst_object_unref(src_pad);
+    }
+    while (peer) {
+        GstElement* element = gst_pad_get_parent_element(peer);
+        gst_object_unref(peer);
+        peer = nullptr;
+        if (!element || element == last) {
+            if (element) {
+                gst_object_unref(element);
+            }
+            break;
+        }
+        chain.push_back(element);
+        GstPad* element_src = gst_element_get_static_pad(element, "src");
+        if (element_src) {
+            peer = gst_pad_get_peer(element_src);
+            gst_object_unref(element_src);
+        }
+    }
+    return chain;
+}
+
+bool isFactory(GstElement* element, const char* name) {
+    GstElementFactory* factory = gst_element_get_factory(element);
+    return factory && g_strcmp0(GST_OBJECT_NAME(factory), name) == 0;
+}
+
+bool hasProperty(GstElement* element, const char* name) {
+    return g_object_class_find_property(G_OBJECT_GET_CLASS(element), name) != nullptr;
+}
+
+void applyBitrate(GstElement* encoder, int bitrate) {
+    if (hasProperty(encoder, "extra-controls")) {
+        // v4l2 M2M 인코더: 파이프라인에 적힌 다른 컨트롤은 유지하고 V4L2_CID_MPEG_VIDEO_BITRATE 만 바꿈
+        GstStructure* controls = nullptr;
+        g_object_get(encoder, "extra-controls", &controls, NULL);
+        if (!controls) {
+            controls = gst_structure_new_empty("controls");
+        }
+        gst_structure_set(controls, "video_bitrate", G_TYPE_INT, bitrate, NULL);
+        g_object_set(encoder, "extra-controls", controls, NULL);
+        gst_structure_free(controls);
+    } else if (hasProperty(encoder, "bitrate")) {
+        g_object_set(encoder, "bitrate", static_cast<guint>(bitrate / 1000), NULL);
+    }
+}
+
+// 원래 caps 는 처음 바꿀 때 요소에 보관해 두고 복원과 다음 변경의 기준으로 사용
+constexpr const char* kOriginalCapsKey = "camstream-original-caps";
+
+bool applyOutputSize(GstElement* capsfilter, int width, int height) {
+    GstCaps* original = static_cast<GstCaps*>(g_object_get_data(G_OBJECT(capsfilter), kOriginalCapsKey));
+    if (!original) {
+        GstCaps* current = nullptr;
+        g_object_get(capsfilter, "caps", &current, NULL);
+        if (!current || gst_caps_is_any(current) || gst_caps_get_size(current) == 0 ||
+            !gst_structure_has_name(gst_caps_get_structure(current, 0), "video/x-raw")) {
+            if (current) {
+                gst_caps_unref(current);
+            }
+            return false;
+        }
+        original = current;
+        g_object_set_data_full(G_OBJECT(capsfilter), kOriginalCapsKey, original, (GDestroyNotify)gst_caps_unref);
+    }
+
+    GstCaps* caps = gst_caps_copy(original);
+    if (width > 0 && height > 0) {
+        gst_caps_set_simple(caps, "width", G_TYPE_INT, width, "height", G_TYPE_INT, height, NULL);
+    }
+    g_object_set(capsfilter, "caps", caps, NULL);
+    gst_caps_unref(caps);
+    return true;
+}
+
+} // namespace
+
+RtspStreamer::RtspStreamer(const VideoConfig& video_config, const RtspConfig& rtsp_config,
+                           const EncoderConfig& encoder_config)
+    : loop_(nullptr), server_(nullptr), mounts_(nullptr), factory_(nullptr), encode_pipeline_(nullptr),
+      appsrc_(nullptr), is_running_(false), video_config_(video_config), rtsp_config_(rtsp_config),
+      encoder_config_(encoder_config), bus_(static_cast<size_t>(std::max(encoder_config.bus_size, 1))),
+      clock_(nullptr),
+      last_pts_(GST_CLOCK_TIME_NONE),
+      first_frame_pushed_(false), video_meta_supported_(false), repack_warned_(false), repack_free_(kRepackBuffers),
+      frames_pushed_(MetricsRegistry::instance().counter("camstream_frames_pushed_total",
+                                                        "Frames accepted by appsrc")),
+      push_errors_(MetricsRegistry::instance().counter("camstream_push_errors_total",
+                                                      "Frames rejected by appsrc")),
+      appsrc_queue_bytes_(MetricsRegistry::instance().gauge("camstream_appsrc_queue_bytes",
+                                                           "Bytes queued inside appsrc")),
+      rtsp_clients_(MetricsRegistry::instance().gauge("camstream_rtsp_clients", "Connected RTSP clients")),
+      repack_pool_misses_(MetricsRegistry::instance().counter("camstream_repack_pool_misses_total",
+                                                              "Repacked frames allocated outside the buffer pool")),
+      page_faults_(MemoryResidency::instance().subsystem("rtsp")),
+      chain_resets_(MetricsRegistry::instance().counter("camstream_media_chain_resets_total",
+                                                        "Encode chain resets (stall recovery or input size change)")),
+      max_wrapped_frames_(std::max(video_config.buffer_count / 2, 2)), wrapped_frames_(0),
+      backpressure_drops_(MetricsRegistry::instance().counter("camstream_rtsp_backpressure_drops_total",
+                                                              "Frames skipped while the encode chain held too many capture buffers")),
+      bitrate_override_(0), output_width_(0), output_height_(0) {
+    gst_video_info_init(&video_info_);
     std::cout << "[INFO] Initializing GStreamer..." << std::endl;
+    StartupTimeline::Scope scope("gstreamer_init");
     gst_init(nullptr, nullptr);
 }
 
@@ -14,8 +139,73 @@ RtspStreamer::~RtspStreamer() {
     gst_deinit();
 }
 
+void RtspStreamer::setStreamSize(int width, int height) {
+    video_config_.width = width;
+    video_config_.height = height;
+}
+
+bool RtspStreamer::setInputSize(int width, int height) {
+    setStreamSize(width, height);
+    // 인코딩 파이프라인이 아직 없으면 만들어질 때(configureAppsrc) 새 크기가 적용됨
+    GstAppSrc* appsrc = appsrc_;
+    if (!appsrc) {
+        return true;
+    }
+
+    // 재배치 풀은 다음 재배치 때 새 프레임 크기로 다시 잡힘
+    gst_video_info_set_format(&video_info_, videoFormatFromString(video_config_.pixel_format), width, height);
+    GST_VIDEO_INFO_FPS_N(&video_info_) = video_config_.fps;
+    GST_VIDEO_INFO_FPS_D(&video_info_) = 1;
+    GstCaps* caps = gst_video_info_to_caps(&video_info_);
+    gchar* caps_string = gst_caps_to_string(caps);
+    LOG_INFO("rtsp") << "Changing appsrc caps to: " << caps_string;
+    g_free(caps_string);
+    g_object_set(G_OBJECT(appsrc), "caps", caps, NULL);
+    gst_caps_unref(caps);
+
+    // NULL 로 내렸다 올린 변환기/인코더는 다음 push 때 새 caps 이벤트로 다시 협상함
+    return resetMediaChain();
+}
+
+bool RtspStreamer::preloadPipeline() {
+    // 파이프라인을 미리 한 번 파싱해서 인코더/페이로더 플러그인 라이브러리 로드와
+    // 레지스트리 조회 비용을 시작 단계로 옮김 (RTSP 미디어는 첫 클라이언트가 접속할 때 만들어짐)
+    StartupTimeline::Scope scope("pipeline_preload");
+    bool ok = true;
+    for (const std::string* description : {&encoder_config_.pipeline, &rtsp_config_.pipeline}) {
+        GError* error = nullptr;
+        GstElement* pipeline = gst_parse_launch(description->c_str(), &error);
+        if (error) {
+            std::cerr << "[WARN] Failed to preload pipeline: " << error->message << std::endl;
+            g_error_free(error);
+        }
+        if (!pipeline) {
+            ok = false;
+            continue;
+        }
+        gst_object_unref(pipeline);
+    }
+    return ok;
+}
+
 bool RtspStreamer::start() {
+    if (rtsp_config_.pipeline.find("name=ausrc") == std::string::npos) {
+        // 예전 mysrc + rtph264pay 형식은 ConfigManager 가 옮겨 주므로 여기 오는 것은 옮길 수 없는 형식
+        std::cerr << "[ERROR] rtsp.pipeline must read encoded access units from 'appsrc name=ausrc' and contain only the "
+                  << "payloader, e.g. \"appsrc name=ausrc ! rtph264pay name=pay0 pt=96\". Move the encoder elements to "
+                  << "encoder.pipeline, which starts with 'appsrc name=mysrc' and ends with "
+                  << "'h264parse config-interval=-1 ! video/x-h264,stream-format=byte-stream,alignment=au ! appsink name=encsink'"
+                  << std::endl;
+        return false;
+    }
+    if (!clock_) {
+        clock_ = GST_CLOCK(g_object_new(GST_TYPE_SYSTEM_CLOCK, "clock-type", GST_CLOCK_TYPE_REALTIME, NULL));
+    }
     loop_ = g_main_loop_new(NULL, FALSE);
+    if (!startEncoder()) {
+        return false;
+    }
+
     server_ = gst_rtsp_server_new();
     g_object_set(server_, "service", std::to_string(rtsp_config_.port).c_str(), NULL);
     mounts_ = gst_rtsp_server_get_mount_points(server_);
@@ -25,13 +215,31 @@ bool RtspStreamer::start() {
     gst_rtsp_media_factory_set_launch(factory_, rtsp_config_.pipeline.c_str());
     gst_rtsp_media_factory_set_shared(factory_, TRUE);
 
+    // 인코더와 같은 클럭이라 AU 의 절대 캡처 시각을 미디어 running time 으로 바로 옮길 수 있음
+    gst_rtsp_media_factory_set_clock(factory_, clock_);
+
+    if (rtsp_config_.multicast_enabled && !configureMulticast()) {
+        g_object_unref(factory_);
+        g_object_unref(mounts_);
+        g_object_unref(server_);
+        factory_ = nullptr;
+        mounts_ = nullptr;
+        server_ = nullptr;
+        stopEncoder();
+        return false;
+    }
+
     g_signal_connect(factory_, "media-configure", (GCallback)media_configure_callback, this);
     
     gst_rtsp_mount_points_add_factory(mounts_, rtsp_config_.mount_point.c_str(), factory_);
     g_object_unref(mounts_);
 
+    rtsp_clients_.set(0);
+    g_signal_connect(server_, "client-connected", (GCallback)client_connected_callback, this);
+
     if (gst_rtsp_server_attach(server_, NULL) == 0) {
         std::cerr << "[ERROR] Failed to attach RTSP server. Ensure the port is not in use." << std::endl;
+        stopEncoder();
         return false;
     }
 
@@ -46,6 +254,49 @@ bool RtspStreamer::start() {
     return true;
 }
 
+bool RtspStreamer::configureMulticast() {
+    const RtspConfig& config = rtsp_config_;
+    // rtsp-server 는 스트림마다 RTP(짝수)/RTCP(다음 홀수) 포트 쌍을 풀에서 할당
+    if (config.multicast_port_min <= 0 || config.multicast_port_min % 2 != 0 ||
+        config.multicast_port_max <= config.multicast_port_min || config.multicast_port_max > 65535 ||
+        config.multicast_ttl < 1 || config.multicast_ttl > 255) {
+        std::cerr << "[ERROR] Invalid RTSP multicast settings: ports " << config.multicast_port_min << "-"
+                  << config.multicast_port_max << " (even start), TTL " << config.multicast_ttl << " (1-255)"
+                  << std::endl;
+        return false;
+    }
+
+    GstRTSPAddressPool* pool = gst_rtsp_address_pool_new();
+    bool ok = gst_rtsp_address_pool_add_range(pool, config.multicast_address_min.c_str(),
+                                              config.multicast_address_max.c_str(), config.multicast_port_min,
+                                              config.multicast_port_max, config.multicast_ttl);
+    if (!ok) {
+        std::cerr << "[ERROR] Invalid RTSP multicast address range " << config.multicast_address_min << "-"
+                  << config.multicast_address_max << std::endl;
+        g_object_unref(pool);
+        return false;
+    }
+    gst_rtsp_media_factory_set_address_pool(factory_, pool);
+    g_object_unref(pool);
+
+    // 공유 미디어라 같은 그룹을 모든 시청자가 받음. only 가 아니면 멀티캐스트를 요청하지 않는 클라이언트는 유니캐스트
+    GstRTSPLowerTrans protocols = config.multicast_only
+        ? GST_RTSP_LOWER_TRANS_UDP_MCAST
+        : static_cast<GstRTSPLowerTrans>(GST_RTSP_LOWER_TRANS_UDP | GST_RTSP_LOWER_TRANS_UDP_MCAST |
+                                         GST_RTSP_LOWER_TRANS_TCP);
+    gst_rtsp_media_factory_set_protocols(factory_, protocols);
+    gst_rtsp_media_factory_set_max_mcast_ttl(factory_, static_cast<guint>(config.multicast_ttl));
+    if (!config.multicast_iface.empty()) {
+        gst_rtsp_media_factory_set_multicast_iface(factory_, config.multicast_iface.c_str());
+    }
+
+    std::cout << "[INFO] RTSP multicast enabled: " << config.multicast_address_min << "-"
+              << config.multicast_address_max << ", ports " << config.multicast_port_min << "-"
+              << config.multicast_port_max << ", TTL " << config.multicast_ttl
+              << (config.multicast_only ? " (multicast only)" : "") << std::endl;
+    return true;
+}
+
 void RtspStreamer::stop() {
     if (is_running_.exchange(false)) {
         std::cout << "[INFO] Stopping RTSP server..." << std::endl;
@@ -55,19 +306,26 @@ void RtspStreamer::stop() {
         if (server_thread_.joinable()) {
             server_thread_.join();
         }
+        stopOutputs();
         if (server_) {
             g_object_unref(server_);
             server_ = nullptr;
         }
+        stopEncoder();
+        appsrc_ = nullptr;
         if (loop_) {
             g_main_loop_unref(loop_);
             loop_ = nullptr;
         }
+        if (clock_) {
+            gst_object_unref(clock_);
+            clock_ = nullptr;
+        }
         std::cout << "[INFO] RTSP server stopped." << std::endl;
     }
 }
 
-void RtspStreamer::pushFrame(const FrameData& frame_data) {
+void RtspStreamer::pushFrame(const FrameData& frame_data, std::shared_ptr<void> owner) {
     if (!is_running_.load() || !appsrc_) {
         return;
     }
@@ -78,17 +336,403 @@ void RtspStreamer::pushFrame(const FrameData& frame_data) {
         return;
     }
 
+    TraceSpan push_span("push_frame", frame_data.sequence);
+    PageFaultScope fault_scope(page_faults_);
+    GstMemory* memory = nullptr;
+    if (owner) {
+        if (wrapped_frames_.load() >= max_wrapped_frames_) {
+            backpressure_drops_.inc();
+            return;
+        }
+        wrapped_frames_.fetch_add(1);
+        memory = gst_memory_new_wrapped(GST_MEMORY_FLAG_READONLY, frame_data.data, frame_data.size, 0, frame_data.size,
+                                        new WrappedFrame{this, std::move(owner)}, wrapped_frame_released);
+    } else {
+        memory = gst_memory_new_wrapped(GST_MEMORY_FLAG_READONLY, frame_data.data, frame_data.size, 0, frame_data.size,
+                                        nullptr, nullptr);
+    }
     GstBuffer* buffer = gst_buffer_new();
-    GstMemory* memory = gst_memory_new_wrapped(GST_MEMORY_FLAG_READONLY, frame_data.data, frame_data.size, 0, frame_data.size, nullptr, nullptr);
     gst_buffer_append_memory(buffer, memory);
 
+    // 실제 평면 배치를 메타로 붙여서 하류가 행 정렬된 버퍼를 복사 없이 읽도록 함
+    if (frame_data.num_planes > 0) {
+        gsize offsets[GST_VIDEO_MAX_PLANES] = {0};
+        gint strides[GST_VIDEO_MAX_PLANES] = {0};
+        for (int i = 0; i < frame_data.num_planes; ++i) {
+            offsets[i] = frame_data.offsets[i];
+            strides[i] = frame_data.strides[i];
+        }
+        gst_buffer_add_video_meta_full(buffer, GST_VIDEO_FRAME_FLAG_NONE, GST_VIDEO_INFO_FORMAT(&video_info_),
+                                       frame_data.width, frame_data.height, frame_data.num_planes, offsets, strides);
+
+        // 메타를 모르는 하류는 caps 의 packed 배치로 해석하므로 그때만 재배치
+        if (!video_meta_supported_.load() && !hasPackedLayout(frame_data)) {
+            if (!repack_warned_) {
+                repack_warned_ = true;
+                LOG_WARN("rtsp") << "Downstream does not accept GstVideoMeta, repacking padded frames";
+            }
+            GstBuffer* packed = repackFrame(buffer);
+            gst_buffer_unref(buffer);
+            if (!packed) {
+                return;
+            }
+            buffer = packed;
+        }
+    }
+
+    // PTS 는 appsrc 도착 시각이 아니라 센서 노출 시각 (콜백 지연 지터가 스트림에 들어가지 않음)
+    GstClockTime pts = sensorToRunningTime(frame_data.timestamp_ns);
+    if (pts == GST_CLOCK_TIME_NONE) {
+        gst_buffer_unref(buffer);
+        return;
+    }
+    GST_BUFFER_PTS(buffer) = pts;
+    push_span.setPts(pts);
+    GST_BUFFER_DURATION(buffer) = frame_data.duration_ns ? frame_data.duration_ns
+                                                         : gst_util_uint64_scale_int(GST_SECOND, 1, video_config_.fps);
+
     GstFlowReturn ret;
     g_signal_emit_by_name(appsrc_, "push-buffer", buffer, &ret);
     gst_buffer_unref(buffer);
 
+    appsrc_queue_bytes_.set(static_cast<double>(gst_app_src_get_current_level_bytes(appsrc_)));
     if (ret != GST_FLOW_OK) {
-        std::cerr << "[WARN] Error pushing buffer to appsrc, flow return: " << gst_flow_get_name(ret) << std::endl;
+        LOG_WARN("rtsp") << "Error pushing buffer to appsrc, flow return: " << gst_flow_get_name(ret);
+        push_errors_.inc();
+        return;
+    }
+    frames_pushed_.inc();
+    push_heartbeat_.beat();
+
+    if (!first_frame_pushed_) {
+        first_frame_pushed_ = true;
+        StartupTimeline::instance().markOnce("first_encoder_input");
+        LOG_INFO("rtsp") << "First frame pushed to encoder " << StartupTimeline::instance().elapsedMs()
+                         << " ms after process start";
+    }
+}
+
+bool RtspStreamer::isMediaPlaying() const {
+    GstAppSrc* appsrc = appsrc_;
+    if (!is_running_.load() || !appsrc) {
+        return false;
+    }
+    // 현재 상태가 아니라 목표 상태를 봄 (PLAYING 전환이 끝나지 않고 멈춘 경우도 정지로 감지)
+    GST_OBJECT_LOCK(appsrc);
+    GstState target = GST_STATE_TARGET(appsrc);
+    GST_OBJECT_UNLOCK(appsrc);
+    return target == GST_STATE_PLAYING;
+}
+
+bool RtspStreamer::resetMediaChain() {
+    GstAppSrc* appsrc = appsrc_;
+    if (!appsrc) {
+        return false;
+    }
+    GstObject* pipeline = gst_object_get_parent(GST_OBJECT(appsrc));
+    GstElement* sink = pipeline ? gst_bin_get_by_name(GST_BIN(pipeline), "encsink") : nullptr;
+    if (pipeline) {
+        gst_object_unref(pipeline);
+    }
+    if (!sink) {
+        LOG_ERROR("rtsp") << "Cannot reset media chain: appsink 'encsink' not found";
+        return false;
+    }
+
+    std::vector<GstElement*> chain = collectChain(GST_ELEMENT(appsrc), sink);
+    GstPad* src_pad = gst_element_get_static_pad(GST_ELEMENT(appsrc), "src");
+    GstPad* first_sink = src_pad ? gst_pad_get_peer(src_pad) : nullptr;
+
+    bool ok = !chain.empty() && src_pad && first_sink;
+    if (ok) {
+        LOG_WARN("rtsp") << "Resetting " << chain.size() << " elements between appsrc and encsink";
+        chain_resets_.inc();
+
+        // appsink 는 flush 없이 그대로 두고 다시 시작한 인코더의 첫 AU(키프레임)부터 이어서 발행
+        GstPad* sink_pad = gst_element_get_static_pad(sink, "sink");
+        gulong probe = gst_pad_add_probe(sink_pad, GST_PAD_PROBE_TYPE_EVENT_FLUSH, drop_flush_probe, nullptr, nullptr);
+
+        // flush 로 대기 중인 버퍼를 버리고 스트리밍 스레드를 깨운 뒤 하류부터 NULL 로 내림
+        gst_element_send_event(GST_ELEMENT(appsrc), gst_event_new_flush_start());
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+            gst_element_set_state(*it, GST_STATE_NULL);
+        }
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+            if (!gst_element_sync_state_with_parent(*it)) {
+                ok = false;
+            }
+        }
+
+        // NULL 로 내려간 요소는 stream-start/caps 등 sticky 이벤트를 잃었으므로
+        // 다시 링크해서 다음 push 때 appsrc 가 sticky 이벤트를 다시 보내도록 함
+        gst_pad_unlink(src_pad, first_sink);
+        if (gst_pad_link(src_pad, first_sink) != GST_PAD_LINK_OK) {
+            ok = false;
+        }
+        // running time 을 유지해야 PTS 와 RTP 타임스탬프가 이어짐
+        gst_element_send_event(GST_ELEMENT(appsrc), gst_event_new_flush_stop(FALSE));
+
+        gst_pad_remove_probe(sink_pad, probe);
+        gst_object_unref(sink_pad);
+    }
+
+    for (GstElement* element : chain) {
+        gst_object_unref(element);
+    }
+    if (first_sink) {
+        gst_object_unref(first_sink);
+    }
+    if (src_pad) {
+        gst_object_unref(src_pad);
+    }
+    gst_object_unref(sink);
+
+    if (!ok) {
+        LOG_ERROR("rtsp") << "Media chain reset failed";
+    }
+    return ok;
+}
+
+bool RtspStreamer::setBitrate(int bitrate) {
+    bitrate_override_.store(bitrate);
+    return applyToEncoder();
+}
+
+bool RtspStreamer::setOutputResolution(int width, int height) {
+    output_width_.store(width);
+    output_height_.store(height);
+    return applyToEncoder();
+}
+
+bool RtspStreamer::applyToEncoder() {
+    // 인코딩 파이프라인이 아직 없으면 만들어질 때(configureAppsrc) 적용됨
+    GstAppSrc* appsrc = appsrc_;
+    GstObject* pipeline = appsrc ? gst_object_get_parent(GST_OBJECT(appsrc)) : nullptr;
+    if (!pipeline) {
+        return true;
+    }
+    bool ok = applyEncodeSettings(GST_ELEMENT(pipeline));
+    gst_object_unref(pipeline);
+    return ok;
+}
+
+bool RtspStreamer::applyEncodeSettings(GstElement* pipeline) {
+    int bitrate = bitrate_override_.load();
+    int width = output_width_.load();
+    int height = output_height_.load();
+    GstElement* appsrc = gst_bin_get_by_name(GST_BIN(pipeline), "mysrc");
+    GstElement* sink = gst_bin_get_by_name(GST_BIN(pipeline), "encsink");
+    if (!appsrc || !sink) {
+        if (appsrc) {
+            gst_object_unref(appsrc);
+        }
+        if (sink) {
+            gst_object_unref(sink);
+        }
+        return false;
+    }
+
+    bool encoder_found = false;
+    bool scaler_found = false;
+    for (GstElement* element : collectChain(appsrc, sink)) {
+        GstElementFactory* factory = gst_element_get_factory(element);
+        if (factory && gst_element_factory_list_is_type(factory, GST_ELEMENT_FACTORY_TYPE_VIDEO_ENCODER)) {
+            encoder_found = true;
+            if (bitrate > 0) {
+                applyBitrate(element, bitrate);
+            }
+        } else if (!scaler_found && !encoder_found && isFactory(element, "capsfilter")) {
+            scaler_found = applyOutputSize(element, width, height);
+        }
+        gst_object_unref(element);
+    }
+    gst_object_unref(appsrc);
+    gst_object_unref(sink);
+
+    if (bitrate > 0 && !encoder_found) {
+        LOG_WARN("rtsp") << "No video encoder between appsrc and encsink, bitrate unchanged";
+    }
+    if (width > 0 && !scaler_found) {
+        LOG_WARN("rtsp") << "No video/x-raw capsfilter before the encoder, output resolution unchanged";
+    }
+    return (bitrate <= 0 || encoder_found) && (width <= 0 || scaler_found);
+}
+
+GstClockTime RtspStreamer::sensorToRunningTime(uint64_t sensor_timestamp_ns) {
+    GstClockTime base_time = gst_element_get_base_time(GST_ELEMENT(appsrc_));
+    GstClockTime clock_now = gst_clock_get_time(clock_);
+
+    // 센서 시각은 CLOCK_BOOTTIME 이므로 두 클럭을 연달아 읽어 경과 시간만큼 파이프라인 클럭에서 뺌
+    GstClockTime capture_time = clock_now;
+    if (sensor_timestamp_ns > 0) {
+        timespec boot_now;
+        clock_gettime(CLOCK_BOOTTIME, &boot_now);
+        uint64_t boot_now_ns = static_cast<uint64_t>(boot_now.tv_sec) * GST_SECOND + boot_now.tv_nsec;
+        uint64_t age = boot_now_ns > sensor_timestamp_ns ? boot_now_ns - sensor_timestamp_ns : 0;
+        capture_time = clock_now > age ? clock_now - age : 0;
+    }
+
+    // PLAYING 이전에 노출된 프레임은 running time 이 음수이므로 버림
+    if (capture_time < base_time) {
+        return GST_CLOCK_TIME_NONE;
+    }
+    GstClockTime pts = capture_time - base_time;
+
+    // 클럭 보정 중에도 PTS 가 역행하지 않도록 함
+    if (last_pts_ != GST_CLOCK_TIME_NONE && pts <= last_pts_) {
+        pts = last_pts_ + 1;
+    }
+    last_pts_ = pts;
+    return pts;
+}
+
+bool RtspStreamer::hasPackedLayout(const FrameData& frame_data) const {
+    for (int i = 0; i < frame_data.num_planes; ++i) {
+        if (frame_data.offsets[i] != GST_VIDEO_INFO_PLANE_OFFSET(&video_info_, i) ||
+            frame_data.strides[i] != GST_VIDEO_INFO_PLANE_STRIDE(&video_info_, i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+GstBuffer* RtspStreamer::acquireRepackBuffer() {
+    size_t frame_size = GST_VIDEO_INFO_SIZE(&video_info_);
+    if (repack_memory_.size() != frame_size * kRepackBuffers) {
+        // 첫 재배치 때 한 번만 준비 (크기가 같으면 하류가 잡고 있는 버퍼를 건드리지 않음)
+        repack_memory_.assign(frame_size * kRepackBuffers, 0, "rtsp repack pool");
+        int index;
+        while (repack_free_.tryPop(index)) {
+        }
+        for (int i = 0; i < kRepackBuffers; ++i) {
+            repack_slots_[i] = {this, i};
+            repack_free_.tryPush(i);
+        }
+    }
+
+    int index;
+    if (!repack_free_.tryPop(index)) {
+        repack_pool_misses_.inc();
+        return gst_buffer_new_allocate(nullptr, frame_size, nullptr);
+    }
+    return gst_buffer_new_wrapped_full(static_cast<GstMemoryFlags>(0), repack_memory_.data() + index * frame_size,
+                                       frame_size, 0, frame_size, &repack_slots_[index], repack_buffer_released);
+}
+
+void RtspStreamer::repack_buffer_released(gpointer user_data) {
+    RepackSlot* slot = static_cast<RepackSlot*>(user_data);
+    slot->owner->repack_free_.tryPush(slot->index);
+}
+
+void RtspStreamer::wrapped_frame_released(gpointer user_data) {
+    // 변환기가 읽고 놓은 시점 (캡처 요청은 다른 참조도 모두 놓이면 다시 큐에 들어감)
+    WrappedFrame* wrapped = static_cast<WrappedFrame*>(user_data);
+    wrapped->owner->wrapped_frames_.fetch_sub(1);
+    delete wrapped;
+}
+
+GstBuffer* RtspStreamer::repackFrame(GstBuffer* buffer) {
+    GstBuffer* packed = acquireRepackBuffer();
+    GstVideoFrame src_frame;
+    GstVideoFrame dst_frame;
+
+    // 원본 매핑은 버퍼의 GstVideoMeta 를 따라 실제 stride/offset 을 사용함
+    if (!gst_video_frame_map(&src_frame, &video_info_, buffer, GST_MAP_READ)) {
+        gst_buffer_unref(packed);
+        return nullptr;
+    }
+    if (!gst_video_frame_map(&dst_frame, &video_info_, packed, GST_MAP_WRITE)) {
+        gst_video_frame_unmap(&src_frame);
+        gst_buffer_unref(packed);
+        return nullptr;
+    }
+    gst_video_frame_copy(&dst_frame, &src_frame);
+    gst_video_frame_unmap(&dst_frame);
+    gst_video_frame_unmap(&src_frame);
+    return packed;
+}
+
+GstPadProbeReturn RtspStreamer::allocation_query_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+    RtspStreamer* self = static_cast<RtspStreamer*>(user_data);
+
+    // 질의는 전달 전(PUSH)과 응답 후(PULL)에 두 번 호출되므로 응답 후의 결과만 확인
+    GstQuery* query = GST_PAD_PROBE_INFO_QUERY(info);
+    if ((GST_PAD_PROBE_INFO_TYPE(info) & GST_PAD_PROBE_TYPE_PULL) && GST_QUERY_TYPE(query) == GST_QUERY_ALLOCATION) {
+        bool supported = gst_query_find_allocation_meta(query, GST_VIDEO_META_API_TYPE, nullptr);
+        self->video_meta_supported_.store(supported);
+        LOG_DEBUG("rtsp") << "Downstream GstVideoMeta support: " << (supported ? "yes" : "no");
+    }
+    return GST_PAD_PROBE_OK;
+}
+
+void RtspStreamer::client_connected_callback(GstRTSPServer* server, GstRTSPClient* client, gpointer user_data) {
+    RtspStreamer* self = static_cast<RtspStreamer*>(user_data);
+    self->rtsp_clients_.add(1);
+    g_signal_connect(client, "closed", (GCallback)client_closed_callback, self);
+}
+
+void RtspStreamer::client_closed_callback(GstRTSPClient* client, gpointer user_data) {
+    RtspStreamer* self = static_cast<RtspStreamer*>(user_data);
+    self->rtsp_clients_.add(-1);
+}
+
+GstPadProbeReturn RtspStreamer::drop_flush_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+    return GST_PAD_PROBE_DROP;
+}
+
+GstPadProbeReturn RtspStreamer::trace_buffer_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+    // 프레임 sequence 는 GStreamer 버퍼에 실리지 않으므로 PTS 로 push_frame 구간과 연결
+    if (GstBuffer* buffer = GST_PAD_PROBE_INFO_BUFFER(info)) {
+        GstClockTime pts = GST_BUFFER_PTS(buffer);
+        FrameTracer::instance().instant(static_cast<const char*>(user_data), FrameTracer::kNoFrame,
+                                        GST_CLOCK_TIME_IS_VALID(pts) ? pts : UINT64_MAX);
+    }
+    return GST_PAD_PROBE_OK;
+}
+
+void RtspStreamer::addTraceProbes(GstElement* pipeline) {
+    // 각 요소의 sink 패드에 버퍼가 도착한 시각 (페이로더 src 는 RTP 패킷 단위라 sink 만 사용)
+    GstIterator* it = gst_bin_iterate_recurse(GST_BIN(pipeline));
+    GValue item = G_VALUE_INIT;
+    while (gst_iterator_next(it, &item) == GST_ITERATOR_OK) {
+        GstElement* element = GST_ELEMENT(g_value_get_object(&item));
+        GstPad* sink_pad = gst_element_get_static_pad(element, "sink");
+        if (sink_pad) {
+            // 이벤트 이름은 프로세스 수명 동안 유지되어야 하므로 GLib 인턴 문자열 사용
+            gchar* name = gst_element_get_name(element);
+            gst_pad_add_probe(sink_pad, GST_PAD_PROBE_TYPE_BUFFER, trace_buffer_probe,
+                              const_cast<gchar*>(g_intern_string(name)), nullptr);
+            g_free(name);
+            gst_object_unref(sink_pad);
+        }
+        g_value_reset(&item);
     }
+    g_value_unset(&item);
+    gst_iterator_free(it);
+}
+
+void RtspStreamer::media_prepared_callback(GstRTSPMedia* media, gpointer user_data) {
+    // rtpbin 은 prepare 단계에서 추가되므로 여기서 설정
+    // RTCP SR 의 NTP/RTP 쌍을 전송 시각이 아닌 버퍼의 캡처 시각(파이프라인 클럭) 기준으로 생성
+    GstElement* element = gst_rtsp_media_get_element(media);
+    GstObject* pipeline = gst_object_get_parent(GST_OBJECT(element));
+    gst_object_unref(element);
+    if (!pipeline) {
+        return;
+    }
+
+    GstIterator* it = gst_bin_iterate_all_by_element_factory_name(GST_BIN(pipeline), "rtpbin");
+    GValue item = G_VALUE_INIT;
+    while (gst_iterator_next(it, &item) == GST_ITERATOR_OK) {
+        GObject* rtpbin = G_OBJECT(g_value_get_object(&item));
+        gst_util_set_object_arg(rtpbin, "ntp-time-source", "clock-time");
+        gst_util_set_object_arg(rtpbin, "rtcp-sync-send-time", "false");
+        LOG_DEBUG("rtsp") << "rtpbin configured for capture-time NTP mapping";
+        g_value_reset(&item);
+    }
+    g_value_unset(&item);
+    gst_iterator_free(it);
+    gst_object_unref(pipeline);
 }
 
 void RtspStreamer::media_configure_callback(GstRTSPMediaFactory* factory, GstRTSPMedia* media, gpointer user_data) {
@@ -97,44 +741,326 @@ void RtspStreamer::media_configure_callback(GstRTSPMediaFactory* factory, GstRTS
 }
 
 void RtspStreamer::on_media_configure(GstRTSPMedia* media) {
-    std::cout << "[DEBUG] Media configure callback triggered." << std::endl;
-    GstElement* pipeline = gst_rtsp_media_get_element(media);
-    GstElement* appsrc_element = gst_bin_get_by_name(GST_BIN(pipeline), "mysrc");
+    LOG_DEBUG("rtsp") << "Media configure callback triggered.";
+    if (!startOutput(media)) {
+        return;
+    }
+    g_signal_connect(media, "prepared", (GCallback)media_prepared_callback, this);
+    g_signal_connect(media, "unprepared", (GCallback)media_unprepared_callback, this);
+}
 
-    if (!appsrc_element) {
-        std::cerr << "[ERROR] Could not find appsrc element 'mysrc' in pipeline" << std::endl;
+void RtspStreamer::media_unprepared_callback(GstRTSPMedia* media, gpointer user_data) {
+    RtspStreamer* self = static_cast<RtspStreamer*>(user_data);
+    self->stopOutput(media);
+}
+
+bool RtspStreamer::startOutput(GstRTSPMedia* media) {
+    GstElement* element = gst_rtsp_media_get_element(media);
+    GstElement* appsrc = gst_bin_get_by_name(GST_BIN(element), "ausrc");
+    if (!appsrc) {
+        LOG_ERROR("rtsp") << "Could not find appsrc element 'ausrc' in RTSP pipeline";
+        gst_object_unref(element);
+        return false;
+    }
+
+    GstCaps* caps = gst_caps_new_simple("video/x-h264", "stream-format", G_TYPE_STRING, "byte-stream",
+                                        "alignment", G_TYPE_STRING, "au", NULL);
+    g_object_set(G_OBJECT(appsrc),
+                 "caps", caps,
+                 "format", GST_FORMAT_TIME,
+                 "is-live", TRUE,
+                 "do-timestamp", FALSE,
+                 "min-latency", static_cast<gint64>(gst_util_uint64_scale_int(GST_SECOND, 1, video_config_.fps)),
+                 NULL);
+    gst_caps_unref(caps);
+
+    if (FrameTracer::instance().enabled()) {
+        addTraceProbes(element);
+    }
+    gst_object_unref(element);
+
+    std::unique_ptr<RtspOutput> output(new RtspOutput());
+    output->appsrc = GST_APP_SRC(appsrc);
+    output->subscriber = bus_.subscribe("rtsp");
+    output->running.store(true);
+    output->thread = std::thread(&RtspStreamer::feedOutput, this, output.get());
+
+    std::lock_guard<std::mutex> lock(outputs_mtx_);
+    outputs_[media] = std::move(output);
+    return true;
+}
+
+void RtspStreamer::stopOutput(GstRTSPMedia* media) {
+    std::unique_ptr<RtspOutput> output;
+    {
+        std::lock_guard<std::mutex> lock(outputs_mtx_);
+        auto it = outputs_.find(media);
+        if (it == outputs_.end()) {
+            return;
+        }
+        output = std::move(it->second);
+        outputs_.erase(it);
+    }
+    output->running.store(false);
+    output->subscriber->cancel();
+    if (output->thread.joinable()) {
+        output->thread.join();
+    }
+    gst_object_unref(output->appsrc);
+    LOG_DEBUG("rtsp") << "RTSP output stopped";
+}
+
+void RtspStreamer::stopOutputs() {
+    std::vector<GstRTSPMedia*> medias;
+    {
+        std::lock_guard<std::mutex> lock(outputs_mtx_);
+        for (const auto& entry : outputs_) {
+            medias.push_back(entry.first);
+        }
+    }
+    for (GstRTSPMedia* media : medias) {
+        stopOutput(media);
+    }
+}
+
+void RtspStreamer::feedOutput(RtspOutput* output) {
+    GstElement* appsrc = GST_ELEMENT(output->appsrc);
+    GstClockTime last_pts = GST_CLOCK_TIME_NONE;
+    bool playing = false;
+    bool delivered = false;
+    EncodedUnitPtr unit;
+    while (output->running.load()) {
+        if (!output->subscriber->next(unit, 100)) {
+            continue;
+        }
+
+        // PLAYING 전의 AU 는 버리고, PLAYING 이 되면 가장 최근 키프레임부터 보냄 (GOP 를 기다리지 않고 바로 재생)
+        GstState state = GST_STATE_NULL;
+        gst_element_get_state(appsrc, &state, nullptr, 0);
+        if (state != GST_STATE_PLAYING) {
+            playing = false;
+            continue;
+        }
+        if (!playing) {
+            playing = true;
+            output->subscriber->rewindToKeyframe();
+            continue;
+        }
+
+        // AU 시각은 클럭 절대 시각이므로 이 미디어의 base time 을 빼서 running time 으로 옮김
+        GstClockTime base_time = gst_element_get_base_time(appsrc);
+        GstClockTime pts = unit->pts_ns > base_time ? unit->pts_ns - base_time : 0;
+        if (last_pts != GST_CLOCK_TIME_NONE && pts <= last_pts) {
+            pts = last_pts + 1;
+        }
+        last_pts = pts;
+
+        // AU 는 공유 참조로 감싸 복사 없이 넘김 (페이로더가 놓으면 참조도 놓임)
+        const EncodedUnit& data = *unit;
+        GstBuffer* buffer = gst_buffer_new();
+        gst_buffer_append_memory(buffer, gst_memory_new_wrapped(GST_MEMORY_FLAG_READONLY,
+                                                                const_cast<uint8_t*>(data.data.data()),
+                                                                data.data.size(), 0, data.data.size(),
+                                                                new EncodedUnitPtr(unit), encoded_unit_released));
+        GST_BUFFER_PTS(buffer) = pts;
+        GST_BUFFER_DURATION(buffer) = data.duration_ns;
+        if (!data.keyframe) {
+            GST_BUFFER_FLAG_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+        }
+
+        GstFlowReturn ret;
+        g_signal_emit_by_name(output->appsrc, "push-buffer", buffer, &ret);
+        gst_buffer_unref(buffer);
+        if (ret != GST_FLOW_OK) {
+            // 중간 AU 가 빠지면 다음 키프레임까지 디코딩이 깨지므로 키프레임부터 다시 보냄
+            LOG_WARN("rtsp") << "Error pushing access unit to RTSP media, flow return: " << gst_flow_get_name(ret);
+            output->subscriber->waitForKeyframe();
+        } else if (!delivered) {
+            // 프로세스 전체에서 첫 클라이언트에게 나간 AU 만 기록됨
+            delivered = true;
+            if (StartupTimeline::instance().markOnce("first_rtsp_frame")) {
+                LOG_INFO("rtsp") << "First RTSP frame pushed " << StartupTimeline::instance().elapsedMs()
+                                 << " ms after process start";
+            }
+        }
+    }
+}
+
+void RtspStreamer::encoded_unit_released(gpointer user_data) {
+    delete static_cast<EncodedUnitPtr*>(user_data);
+}
+
+bool RtspStreamer::startEncoder() {
+    StartupTimeline::Scope scope("encoder_start");
+    GError* error = nullptr;
+    GstElement* pipeline = gst_parse_launch(encoder_config_.pipeline.c_str(), &error);
+    if (error) {
+        std::cerr << "[ERROR] Failed to parse encoder pipeline: " << error->message << std::endl;
+        g_error_free(error);
+    }
+    if (!pipeline || !GST_IS_PIPELINE(pipeline)) {
+        if (pipeline) {
+            gst_object_unref(pipeline);
+        }
+        return false;
+    }
+    LOG_DEBUG("rtsp") << "Encoder pipeline: " << encoder_config_.pipeline;
+
+    gst_pipeline_use_clock(GST_PIPELINE(pipeline), clock_);
+    if (!configureAppsrc(pipeline) || !configureEncodedSink(pipeline)) {
+        appsrc_ = nullptr;
+        gst_object_unref(pipeline);
+        return false;
+    }
+    GstBus* bus = gst_element_get_bus(pipeline);
+    gst_bus_add_watch(bus, encode_bus_callback, this);
+    gst_object_unref(bus);
+
+    encode_pipeline_ = pipeline;
+    if (gst_element_set_state(pipeline, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+        std::cerr << "[ERROR] Failed to start encoder pipeline" << std::endl;
+        stopEncoder();
+        return false;
+    }
+    std::cout << "[INFO] Encoder started, publishing to a " << bus_.capacity() << " access unit bus" << std::endl;
+    return true;
+}
+
+void RtspStreamer::stopEncoder() {
+    if (!encode_pipeline_) {
         return;
     }
-    
-    // Appsrc Caps 설정 - BGR888과 RGB888 구분
-    std::string format_str;
-    if (video_config_.pixel_format == "BGR888") {
-        format_str = "BGR";  // BGR888 데이터는 BGR 포맷으로 설정
-    } else if (video_config_.pixel_format == "RGB888") {
-        format_str = "RGB";
-    } else {
-        format_str = "BGR";  // 기본값을 BGR로 변경
+    appsrc_ = nullptr;
+    gst_element_set_state(encode_pipeline_, GST_STATE_NULL);
+    GstBus* bus = gst_element_get_bus(encode_pipeline_);
+    gst_bus_remove_watch(bus);
+    gst_object_unref(bus);
+    gst_object_unref(encode_pipeline_);
+    encode_pipeline_ = nullptr;
+}
+
+gboolean RtspStreamer::encode_bus_callback(GstBus* bus, GstMessage* message, gpointer user_data) {
+    if (GST_MESSAGE_TYPE(message) == GST_MESSAGE_ERROR) {
+        GError* error = nullptr;
+        gchar* debug = nullptr;
+        gst_message_parse_error(message, &error, &debug);
+        LOG_ERROR("rtsp") << "Encoder pipeline error from " << GST_OBJECT_NAME(GST_MESSAGE_SRC(message)) << ": "
+                          << (error ? error->message : "unknown");
+        g_clear_error(&error);
+        g_free(debug);
+    } else if (GST_MESSAGE_TYPE(message) == GST_MESSAGE_WARNING) {
+        GError* error = nullptr;
+        gst_message_parse_warning(message, &error, nullptr);
+        LOG_WARN("rtsp") << "Encoder pipeline warning: " << (error ? error->message : "unknown");
+        g_clear_error(&error);
+    }
+    return TRUE;
+}
+
+bool RtspStreamer::configureEncodedSink(GstElement* pipeline) {
+    GstElement* sink = gst_bin_get_by_name(GST_BIN(pipeline), "encsink");
+    if (!sink || !GST_IS_APP_SINK(sink)) {
+        LOG_ERROR("rtsp") << "Could not find appsink element 'encsink' in encoder pipeline";
+        if (sink) {
+            gst_object_unref(sink);
+        }
+        return false;
+    }
+    // 스트리밍 스레드에서 바로 버스로 발행 (appsink 큐에 쌓지 않음)
+    g_object_set(G_OBJECT(sink), "sync", FALSE, "max-buffers", 2, "drop", FALSE, NULL);
+    GstAppSinkCallbacks callbacks = {};
+    callbacks.new_sample = encoded_sample_callback;
+    gst_app_sink_set_callbacks(GST_APP_SINK(sink), &callbacks, this, nullptr);
+    gst_object_unref(sink);
+    return true;
+}
+
+GstFlowReturn RtspStreamer::encoded_sample_callback(GstAppSink* sink, gpointer user_data) {
+    RtspStreamer* self = static_cast<RtspStreamer*>(user_data);
+    GstSample* sample = gst_app_sink_pull_sample(sink);
+    if (!sample) {
+        return GST_FLOW_FLUSHING;
+    }
+    GstBuffer* buffer = gst_sample_get_buffer(sample);
+    GstMapInfo map;
+    if (buffer && gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+        // 출력 파이프라인마다 base time 이 다르므로 running time 이 아닌 클럭 절대 시각으로 발행
+        GstClockTime running_time = gst_segment_to_running_time(gst_sample_get_segment(sample), GST_FORMAT_TIME,
+                                                                 GST_BUFFER_PTS(buffer));
+        GstClockTime pts = GST_CLOCK_TIME_IS_VALID(running_time)
+                               ? running_time + gst_element_get_base_time(GST_ELEMENT(sink))
+                               : gst_clock_get_time(self->clock_);
+        GstClockTime duration = GST_BUFFER_DURATION_IS_VALID(buffer)
+                                    ? GST_BUFFER_DURATION(buffer)
+                                    : gst_util_uint64_scale_int(GST_SECOND, 1, self->video_config_.fps);
+        self->bus_.publish(map.data, map.size, pts, duration,
+                           !GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT));
+        gst_buffer_unmap(buffer, &map);
+        self->encode_heartbeat_.beat();
+    }
+    gst_sample_unref(sample);
+    return GST_FLOW_OK;
+}
+
+bool RtspStreamer::attachPipeline(GstElement* pipeline) {
+    if (is_running_.load()) {
+        return false;
+    }
+    if (!clock_) {
+        clock_ = GST_CLOCK(g_object_new(GST_TYPE_SYSTEM_CLOCK, "clock-type", GST_CLOCK_TYPE_REALTIME, NULL));
+    }
+    gst_pipeline_use_clock(GST_PIPELINE(pipeline), clock_);
+    if (!configureAppsrc(pipeline)) {
+        return false;
+    }
+    is_running_.store(true);
+    return true;
+}
+
+bool RtspStreamer::configureAppsrc(GstElement* pipeline) {
+    GstElement* appsrc_element = gst_bin_get_by_name(GST_BIN(pipeline), "mysrc");
+    if (!appsrc_element) {
+        LOG_ERROR("rtsp") << "Could not find appsrc element 'mysrc' in pipeline";
+        return false;
     }
     
-    GstCaps* caps = gst_caps_new_simple("video/x-raw",
-                                        "format", G_TYPE_STRING, format_str.c_str(),
-                                        "width", G_TYPE_INT, video_config_.width,
-                                        "height", G_TYPE_INT, video_config_.height,
-                                        "framerate", GST_TYPE_FRACTION, video_config_.fps, 1,
-                                        "interlace-mode", G_TYPE_STRING, "progressive",
-                                        "colorimetry", G_TYPE_STRING, "srgb",
-                                        NULL);
+    // Appsrc Caps 설정: packed 배치 기준 (패딩은 버퍼별 GstVideoMeta 로 전달)
+    gst_video_info_set_format(&video_info_, videoFormatFromString(video_config_.pixel_format),
+                              video_config_.width, video_config_.height);
+    GST_VIDEO_INFO_FPS_N(&video_info_) = video_config_.fps;
+    GST_VIDEO_INFO_FPS_D(&video_info_) = 1;
+    GstCaps* caps = gst_video_info_to_caps(&video_info_);
     
-    std::cout << "[DEBUG] Setting appsrc caps to: " << gst_caps_to_string(caps) << std::endl;
+    gchar* caps_string = gst_caps_to_string(caps);
+    LOG_DEBUG("rtsp") << "Setting appsrc caps to: " << caps_string;
+    g_free(caps_string);
 
     g_object_set(G_OBJECT(appsrc_element),
                  "caps", caps,
                  "format", GST_FORMAT_TIME,
                  "is-live", TRUE,
-                 "do-timestamp", TRUE,
+                 "do-timestamp", FALSE,
+                 "min-latency", static_cast<gint64>(gst_util_uint64_scale_int(GST_SECOND, 1, video_config_.fps)),
                  NULL);
     gst_caps_unref(caps);
 
+    // 하류가 GstVideoMeta 를 수락하는지 allocation 질의 결과로 확인
+    video_meta_supported_.store(false);
+    GstPad* src_pad = gst_element_get_static_pad(appsrc_element, "src");
+    gst_pad_add_probe(src_pad, GST_PAD_PROBE_TYPE_QUERY_DOWNSTREAM, allocation_query_probe, this, nullptr);
+    gst_object_unref(src_pad);
+
+    if (FrameTracer::instance().enabled()) {
+        addTraceProbes(pipeline);
+    }
+
+    // start() 전에 품질 조절 값이 정해졌으면 같은 비트레이트/크기로 시작
+    if (bitrate_override_.load() > 0 || output_width_.load() > 0) {
+        applyEncodeSettings(pipeline);
+    }
+
+    last_pts_ = GST_CLOCK_TIME_NONE;
     appsrc_ = GST_APP_SRC(appsrc_element);
     g_object_unref(appsrc_element);
+    return true;
 }
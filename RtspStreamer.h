@@ -4,45 +4,175 @@
 #include <gst/gst.h>
 #include <gst/rtsp-server/rtsp-server.h>
 #include <gst/app/gstappsrc.h>
+#include <gst/app/gstappsink.h>
+#include <gst/video/video.h>
 
 #include <string>
 #include <thread>
 #include <atomic>
+#include <map>
 #include <memory>
+#include <mutex>
 
+#include "BoundedQueue.h"
 #include "ConfigManager.h"
-#include "ZeroCopyCapture.h"
+#include "EncodedBus.h"
+#include "MemoryResidency.h"
+#include "MetricsRegistry.h"
+#include "FrameData.h"
+#include "StallWatchdog.h"
 
+// 원본 프레임을 인코더 파이프라인 하나로 인코딩해 AU 버스에 발행하고,
+// RTSP 미디어는 그 버스의 구독자 중 하나로 AU 를 페이로드만 함 (클라이언트가 없어도 인코더는 계속 동작)
 class RtspStreamer {
 private:
     GMainLoop* loop_;
     GstRTSPServer* server_;
     GstRTSPMountPoints* mounts_;
     GstRTSPMediaFactory* factory_;
-    GstAppSrc* appsrc_;
+    GstElement* encode_pipeline_;   // mysrc ~ encsink (start() 부터 stop() 까지 PLAYING)
+    GstAppSrc* appsrc_;             // 인코더 입력 'mysrc'
     
     std::thread server_thread_;
     std::atomic<bool> is_running_;
     
     VideoConfig video_config_;
     RtspConfig rtsp_config_;
+    EncoderConfig encoder_config_;
+    EncodedBus bus_;
+
+    // RTSP 미디어마다 버스 구독자 하나와 그 AU 를 'ausrc' 에 넣는 스레드
+    struct RtspOutput {
+        GstAppSrc* appsrc;          // 참조를 잡고 있음
+        std::unique_ptr<EncodedSubscriber> subscriber;
+        std::atomic<bool> running;
+        std::thread thread;
+    };
+    std::mutex outputs_mtx_;
+    std::map<GstRTSPMedia*, std::unique_ptr<RtspOutput>> outputs_;
     
-    GstClockTime timestamp_;
+    // 파이프라인 클럭 (RTCP SR 의 NTP 시각이 벽시계와 맞도록 realtime 시스템 클럭 사용)
+    GstClock* clock_;
+    GstClockTime last_pts_;
+    bool first_frame_pushed_;   // 캡처 스레드 전용
+
+    // caps 에 해당하는 빈틈 없는(packed) 배치. 실제 stride/offset 은 버퍼마다 GstVideoMeta 로 전달
+    GstVideoInfo video_info_;
+    std::atomic<bool> video_meta_supported_;    // 하류가 allocation 질의에서 GstVideoMeta 를 수락했는지
+    bool repack_warned_;
+
+    // 재배치용 packed 버퍼 풀 (상주 모드에서는 arena). 프레임마다 새로 할당하면 큰 버퍼가
+    // mmap/munmap 되어 매 프레임 페이지 폴트가 나므로 재사용하고, 하류가 놓으면 free 목록으로 돌아옴
+    struct RepackSlot {
+        RtspStreamer* owner;
+        int index;
+    };
+    static constexpr int kRepackBuffers = 6;
+    ResidentBuffer<uint8_t> repack_memory_;     // kRepackBuffers 개의 packed 프레임 (캡처 스레드가 준비)
+    RepackSlot repack_slots_[kRepackBuffers];
+    MpmcQueue<int> repack_free_;                // GStreamer 스레드가 반납, 캡처 스레드가 꺼냄
+
+    Counter& frames_pushed_;
+    Counter& push_errors_;
+    Gauge& appsrc_queue_bytes_;
+    Gauge& rtsp_clients_;
+    Counter& repack_pool_misses_;
+    PageFaultCounters& page_faults_;
+    Counter& chain_resets_;
+    // 그래프 프레임을 감싼 버퍼가 놓일 때 참조를 돌려주기 위한 정보
+    struct WrappedFrame {
+        RtspStreamer* owner;
+        std::shared_ptr<void> frame;
+    };
+    // GStreamer 큐가 잡고 있는 캡처 버퍼 수 상한 (넘으면 카메라 요청이 모자라므로 새 프레임을 버림)
+    int max_wrapped_frames_;
+    std::atomic<int> wrapped_frames_;
+    Counter& backpressure_drops_;
+    Heartbeat push_heartbeat_;      // appsrc 가 마지막으로 버퍼를 받은 시각
+    Heartbeat encode_heartbeat_;    // encsink 에 마지막 인코딩 AU 가 도착한 시각
+
+    // 품질 조절 값 (0 이면 파이프라인 설정 그대로). start() 전에 정하면 인코딩 파이프라인을 만들 때 적용
+    std::atomic<int> bitrate_override_;
+    std::atomic<int> output_width_;
+    std::atomic<int> output_height_;
 
 public:
-    RtspStreamer(const VideoConfig& video_config, const RtspConfig& rtsp_config);
+    RtspStreamer(const VideoConfig& video_config, const RtspConfig& rtsp_config, const EncoderConfig& encoder_config);
     ~RtspStreamer();
 
+    // 캡처 스트림의 실제 크기 (ISP 가 요청 크기를 조정할 수 있으므로 caps 에 이 값을 사용)
+    void setStreamSize(int width, int height);
+    // 실행 중 캡처 크기 변경: appsrc caps 를 바꾸고 인코딩 체인을 다시 시작해 새 caps 로 협상
+    // 체인이 잡고 있던 캡처 버퍼도 놓음. 호출하는 동안 pushFrame 이 없어야 함 (카메라와 그래프를 먼저 멈춤)
+    // RTSP 세션은 유지되고 새 크기의 첫 AU 는 SPS/PPS 가 붙은 키프레임
+    bool setInputSize(int width, int height);
+
+    // 파이프라인 플러그인을 미리 로드 (start() 전에 다른 초기화와 병렬로 호출 가능)
+    bool preloadPipeline();
+
+    // 인코딩된 AU 버스 (녹화 등 다른 출력은 여기서 subscribe)
+    EncodedBus& encodedBus() { return bus_; }
+
     bool start();
     void stop();
     
-    void pushFrame(const FrameData& frame_data);
+    // owner 가 있으면 버퍼가 하류에서 놓일 때까지 참조를 잡음 (없으면 호출 직후 메모리가 재사용되지 않아야 함)
+    void pushFrame(const FrameData& frame_data, std::shared_ptr<void> owner = nullptr);
+
+    // 인코더/RTSP 서버 없이 'mysrc' appsrc 가 있는 파이프라인에 직접 연결 (벤치마크/오프라인 용도)
+    // 파이프라인 상태 전환과 해제는 호출한 쪽에서 관리
+    bool attachPipeline(GstElement* pipeline);
     
     bool isRunning() const { return is_running_.load(); }
 
+    // 인코딩 파이프라인이 PLAYING 을 목표로 하는 동안만 push/인코딩 heartbeat 가 의미 있음
+    bool isMediaPlaying() const;
+    const Heartbeat& pushHeartbeat() const { return push_heartbeat_; }
+    const Heartbeat& encodeHeartbeat() const { return encode_heartbeat_; }
+
+    // 워치독 복구: appsrc 와 encsink 사이 요소(변환, 인코더)만 flush 후 NULL→PLAYING 으로 다시 시작
+    // RTSP 미디어는 별도 파이프라인이라 그대로 두므로 클라이언트 연결이 유지됨 (다음 키프레임부터 이어짐)
+    bool resetMediaChain();
+
+    // 인코더 비트레이트 변경 (bps). v4l2 인코더는 extra-controls 의 video_bitrate, 그 외는 bitrate 속성(kbit/s)
+    bool setBitrate(int bitrate);
+    // 인코더 입력 크기 변경: appsrc 뒤 첫 video/x-raw capsfilter 에 크기를 넣어 변환기가 축소하도록 함
+    // 0 이면 원래 caps 로 복원. 캡처 버퍼와 분석 입력 크기는 바뀌지 않음
+    bool setOutputResolution(int width, int height);
+
 private:
     static void media_configure_callback(GstRTSPMediaFactory* factory, GstRTSPMedia* media, gpointer user_data);
     void on_media_configure(GstRTSPMedia* media);
+    static void media_unprepared_callback(GstRTSPMedia* media, gpointer user_data);
+    bool startOutput(GstRTSPMedia* media);
+    void stopOutput(GstRTSPMedia* media);
+    void stopOutputs();
+    void feedOutput(RtspOutput* output);
+    static void encoded_unit_released(gpointer user_data);
+
+    bool configureMulticast();
+    bool startEncoder();
+    void stopEncoder();
+    bool configureAppsrc(GstElement* pipeline);
+    bool configureEncodedSink(GstElement* pipeline);
+    static GstFlowReturn encoded_sample_callback(GstAppSink* sink, gpointer user_data);
+    static gboolean encode_bus_callback(GstBus* bus, GstMessage* message, gpointer user_data);
+    static void client_connected_callback(GstRTSPServer* server, GstRTSPClient* client, gpointer user_data);
+    static void client_closed_callback(GstRTSPClient* client, gpointer user_data);
+    static void media_prepared_callback(GstRTSPMedia* media, gpointer user_data);
+    static GstPadProbeReturn allocation_query_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+    static GstPadProbeReturn trace_buffer_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+    static GstPadProbeReturn drop_flush_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+    static void addTraceProbes(GstElement* pipeline);
+    bool applyEncodeSettings(GstElement* pipeline);
+    bool applyToEncoder();
+
+    GstClockTime sensorToRunningTime(uint64_t sensor_timestamp_ns);
+    bool hasPackedLayout(const FrameData& frame_data) const;
+    GstBuffer* repackFrame(GstBuffer* buffer);
+    GstBuffer* acquireRepackBuffer();
+    static void repack_buffer_released(gpointer user_data);
+    static void wrapped_frame_released(gpointer user_data);
 };
 
 #endif // RTSP_STREAMER_H
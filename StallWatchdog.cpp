@@ -0,0 +1,89 @@
+#include "StallWatchdog.h"
+#include "Logger.h"
+#include <algorithm>
+
+namespace {
+
+const std::vector<double> kStallBuckets = {0.1, 0.25, 0.5, 1, 2, 5, 10, 30, 60};
+
+double toMs(uint64_t ns) {
+    return static_cast<double>(ns) / 1e6;
+}
+
+} // namespace
+
+StallWatchdog::StallWatchdog()
+    : detection_seconds_(MetricsRegistry::instance().histogram(
+          "camstream_stall_detection_seconds", "Time from the last heartbeat of a stalled stage to detection",
+          kStallBuckets)),
+      recovery_seconds_(MetricsRegistry::instance().histogram(
+          "camstream_stall_recovery_seconds", "Time from stall detection to the first heartbeat after recovery",
+          kStallBuckets)) {
+}
+
+void StallWatchdog::addStage(const std::string& name, const Heartbeat& heartbeat, int timeout_ms, ArmedFn armed,
+                             RecoverFn recover) {
+    MetricsRegistry& registry = MetricsRegistry::instance();
+    stages_.emplace_back(new Stage{
+        name, heartbeat, static_cast<uint64_t>(std::max(timeout_ms, 1)) * 1000000ULL, std::move(armed),
+        std::move(recover),
+        registry.counter("camstream_" + name + "_stalls_total", "Stalls detected in the " + name + " stage"),
+        registry.counter("camstream_" + name + "_recovery_attempts_total",
+                         "Recovery actions run for the " + name + " stage"),
+        false, 0, false, 0, 0, 0});
+}
+
+void StallWatchdog::poll() {
+    uint64_t now = Heartbeat::nowNs();
+    for (auto& entry : stages_) {
+        Stage& stage = *entry;
+        uint64_t last = stage.heartbeat.lastNs();
+
+        if (stage.stalled) {
+            if (last > stage.detected_ns) {
+                recovery_seconds_.observe(static_cast<double>(last - stage.detected_ns) / 1e9);
+                LOG_INFO("watchdog") << "Stage '" << stage.name << "' recovered " << toMs(last - stage.detected_ns)
+                                     << " ms after detection (" << stage.attempts << " attempt(s))";
+                stage.stalled = false;
+                stage.attempts = 0;
+            } else if (now - stage.last_attempt_ns >= stage.timeout_ns) {
+                attemptRecovery(stage, now);
+            }
+            continue;
+        }
+
+        bool armed = stage.armed();
+        if (armed && !stage.was_armed) {
+            stage.armed_since_ns = now;
+        }
+        stage.was_armed = armed;
+        if (!armed) {
+            continue;
+        }
+
+        uint64_t reference = std::max(last, stage.armed_since_ns);
+        if (now - reference < stage.timeout_ns) {
+            continue;
+        }
+
+        stage.stalls.inc();
+        detection_seconds_.observe(static_cast<double>(now - reference) / 1e9);
+        LOG_WARN("watchdog") << "Stage '" << stage.name << "' stalled: no heartbeat for " << toMs(now - reference)
+                             << " ms";
+        stage.stalled = true;
+        stage.detected_ns = now;
+        attemptRecovery(stage, now);
+    }
+}
+
+void StallWatchdog::attemptRecovery(Stage& stage, uint64_t now) {
+    stage.attempts++;
+    stage.recovery_attempts.inc();
+    LOG_WARN("watchdog") << "Recovering stage '" << stage.name << "' (attempt " << stage.attempts << ")";
+    if (!stage.recover(stage.attempts)) {
+        LOG_ERROR("watchdog") << "Recovery of stage '" << stage.name << "' failed, retrying in "
+                              << toMs(stage.timeout_ns) << " ms";
+    }
+    // 복구 동작 자체가 오래 걸릴 수 있으므로 다음 시도 간격은 동작이 끝난 시점부터 잼
+    stage.last_attempt_ns = std::max(now, Heartbeat::nowNs());
+}
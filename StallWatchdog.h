@@ -0,0 +1,74 @@
+#ifndef STALL_WATCHDOG_H
+#define STALL_WATCHDOG_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "MetricsRegistry.h"
+
+// 단계가 마지막으로 진행한 시각 (steady_clock ns). 핫패스에서는 relaxed 저장 한 번만 수행
+class Heartbeat {
+private:
+    std::atomic<uint64_t> last_ns_{0};
+
+public:
+    static uint64_t nowNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    void beat() { last_ns_.store(nowNs(), std::memory_order_relaxed); }
+    uint64_t lastNs() const { return last_ns_.load(std::memory_order_relaxed); }
+    bool beatWithin(uint64_t ns) const { return nowNs() - lastNs() < ns; }
+};
+
+// 단계별 heartbeat 를 주 루프에서 검사해 멈춘 단계만 복구
+// - 감지: 단계가 활성(armed)인 동안 timeout 이상 heartbeat 가 없으면 정지로 판단
+// - 복구: 해당 단계의 recover(attempt) 만 호출하고, timeout 안에 회복하지 않으면 attempt 를 올려 다시 호출
+// - 정지~감지, 감지~회복(첫 heartbeat) 시간을 히스토그램으로 기록
+class StallWatchdog {
+public:
+    using ArmedFn = std::function<bool()>;
+    using RecoverFn = std::function<bool(int attempt)>;
+
+    StallWatchdog();
+
+    // 초기화 경로에서만 호출. name 은 메트릭 이름(camstream_<name>_stalls_total)에 쓰임
+    void addStage(const std::string& name, const Heartbeat& heartbeat, int timeout_ms, ArmedFn armed,
+                  RecoverFn recover);
+
+    // 주 루프에서 주기적으로 호출 (복구 동작도 이 스레드에서 실행)
+    void poll();
+
+private:
+    struct Stage {
+        std::string name;
+        const Heartbeat& heartbeat;
+        uint64_t timeout_ns;
+        ArmedFn armed;
+        RecoverFn recover;
+        Counter& stalls;
+        Counter& recovery_attempts;
+
+        bool was_armed;
+        uint64_t armed_since_ns;    // 활성화 직후에는 이전 heartbeat 가 오래됐어도 정지로 보지 않음
+        bool stalled;
+        uint64_t detected_ns;
+        uint64_t last_attempt_ns;
+        int attempts;
+    };
+
+    void attemptRecovery(Stage& stage, uint64_t now);
+
+    std::vector<std::unique_ptr<Stage>> stages_;
+
+    Histogram& detection_seconds_;
+    Histogram& recovery_seconds_;
+};
+
+#endif // STALL_WATCHDOG_H
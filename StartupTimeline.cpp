@@ -0,0 +1,101 @@
+#include "StartupTimeline.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <map>
+#include <unistd.h>
+
+using namespace std::chrono;
+
+namespace {
+
+// exec 이후 경과 시간: /proc/self/stat 의 starttime 과 /proc/uptime 비교
+// 읽을 수 없으면 0 (정적 초기화 시점을 시작으로 봄)
+double secondsSinceExec() {
+    std::ifstream stat_file("/proc/self/stat");
+    std::ifstream uptime_file("/proc/uptime");
+    std::string stat;
+    double uptime = 0.0;
+    if (!std::getline(stat_file, stat) || !(uptime_file >> uptime)) {
+        return 0.0;
+    }
+
+    // comm 필드에 공백이 있을 수 있으므로 마지막 ')' 이후부터 셈 (starttime 은 22 번째 필드)
+    size_t pos = stat.rfind(')');
+    if (pos == std::string::npos) {
+        return 0.0;
+    }
+    std::istringstream fields(stat.substr(pos + 2));
+    std::string field;
+    for (int i = 3; i <= 22 && fields >> field; ++i) {
+        if (i == 22) {
+            double start_seconds = std::stod(field) / sysconf(_SC_CLK_TCK);
+            return std::max(0.0, uptime - start_seconds);
+        }
+    }
+    return 0.0;
+}
+
+} // namespace
+
+StartupTimeline& StartupTimeline::instance() {
+    static StartupTimeline timeline;
+    return timeline;
+}
+
+StartupTimeline::StartupTimeline() {
+    process_start_ = Clock::now() - duration_cast<Clock::duration>(duration<double>(secondsSinceExec()));
+}
+
+void StartupTimeline::record(const std::string& phase, Clock::time_point begin, Clock::time_point end) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    entries_.push_back({phase, begin, end, std::this_thread::get_id()});
+}
+
+bool StartupTimeline::markOnce(const std::string& event) {
+    auto now = Clock::now();
+    std::lock_guard<std::mutex> lock(mtx_);
+    for (const auto& entry : entries_) {
+        if (entry.phase == event) {
+            return false;
+        }
+    }
+    entries_.push_back({event, now, now, std::this_thread::get_id()});
+    return true;
+}
+
+double StartupTimeline::elapsedMs() const {
+    return duration<double, std::milli>(Clock::now() - process_start_).count();
+}
+
+void StartupTimeline::print() const {
+    std::vector<Entry> entries;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        entries = entries_;
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.begin < b.begin; });
+
+    // 스레드 ID 를 짧은 번호로 표시
+    std::map<std::thread::id, int> thread_numbers;
+    for (const auto& entry : entries) {
+        thread_numbers.emplace(entry.thread, static_cast<int>(thread_numbers.size()));
+    }
+
+    std::cout << "========== Startup Timeline ==========" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto& entry : entries) {
+        double start_ms = duration<double, std::milli>(entry.begin - process_start_).count();
+        double length_ms = duration<double, std::milli>(entry.end - entry.begin).count();
+        std::cout << "  [T" << thread_numbers[entry.thread] << "] " << std::setw(8) << start_ms << " ms  "
+                  << std::left << std::setw(24) << entry.phase << std::right;
+        if (entry.end != entry.begin) {
+            std::cout << std::setw(8) << length_ms << " ms";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "======================================" << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+}
@@ -0,0 +1,54 @@
+#ifndef STARTUP_TIMELINE_H
+#define STARTUP_TIMELINE_H
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 프로세스 시작부터 첫 RTSP 프레임까지의 단계별 소요 시간 기록
+// 초기화 경로에서만 사용하므로 단순히 mutex 로 보호함
+class StartupTimeline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // 구간을 자동으로 기록하는 RAII 헬퍼
+    class Scope {
+    private:
+        std::string phase_;
+        Clock::time_point begin_;
+
+    public:
+        explicit Scope(const std::string& phase) : phase_(phase), begin_(Clock::now()) {}
+        ~Scope() { StartupTimeline::instance().record(phase_, begin_, Clock::now()); }
+    };
+
+    static StartupTimeline& instance();
+
+    void record(const std::string& phase, Clock::time_point begin, Clock::time_point end);
+
+    // 시점 이벤트 (첫 프레임 등). 같은 이름은 처음 한 번만 기록하고 true 를 반환
+    bool markOnce(const std::string& event);
+
+    // 프로세스 시작(exec) 기준 경과 시간
+    double elapsedMs() const;
+
+    void print() const;
+
+private:
+    struct Entry {
+        std::string phase;
+        Clock::time_point begin;
+        Clock::time_point end;
+        std::thread::id thread;
+    };
+
+    StartupTimeline();
+
+    Clock::time_point process_start_;
+    mutable std::mutex mtx_;
+    std::vector<Entry> entries_;
+};
+
+#endif // STARTUP_TIMELINE_H
@@ -0,0 +1,134 @@
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+// 현재 스레드가 어느 풀의 몇 번째 작업 스레드인지 (작업 스레드가 아니면 nullptr)
+thread_local const WorkStealingPool* tls_pool = nullptr;
+thread_local size_t tls_index = 0;
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(int threads)
+    : running_(false), pending_(0), next_worker_(0), idle_(0),
+      tasks_run_(MetricsRegistry::instance().counter("camstream_graph_tasks_total",
+                                                     "Stage drain tasks run by the graph thread pool")),
+      steals_(MetricsRegistry::instance().counter("camstream_graph_steals_total",
+                                                  "Tasks taken from another worker's deque")) {
+    if (threads <= 0) {
+        threads = std::max(static_cast<int>(std::thread::hardware_concurrency()) - 1, 1);
+    }
+    for (int i = 0; i < threads; ++i) {
+        workers_.emplace_back(new Worker());
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    stop();
+}
+
+bool WorkStealingPool::start() {
+    if (running_.exchange(true)) {
+        return true;
+    }
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        threads_.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+    std::cout << "[INFO] Graph thread pool started with " << workers_.size() << " workers" << std::endl;
+    return true;
+}
+
+void WorkStealingPool::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleep_mtx_);
+        sleep_cv_.notify_all();
+    }
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threads_.clear();
+    for (auto& worker : workers_) {
+        std::lock_guard<std::mutex> lock(worker->mtx);
+        worker->tasks.clear();
+    }
+    pending_.store(0);
+}
+
+void WorkStealingPool::submit(Task task) {
+    // 작업 스레드가 넣은 작업은 자기 deque 로 (하류 단계가 같은 스레드에서 바로 이어짐)
+    size_t index = tls_pool == this ? tls_index
+                                    : next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+    {
+        Worker& worker = *workers_[index];
+        std::lock_guard<std::mutex> lock(worker.mtx);
+        worker.tasks.push_back(task);
+    }
+    // pending_ 증가 후 idle_ 확인, 작업 스레드는 idle_ 증가 후 pending_ 확인 (둘 다 seq_cst 라 깨움을 놓치지 않음)
+    pending_.fetch_add(1, std::memory_order_seq_cst);
+    if (idle_.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard<std::mutex> lock(sleep_mtx_);
+        sleep_cv_.notify_one();
+    }
+}
+
+bool WorkStealingPool::runOne() {
+    size_t self = tls_pool == this ? tls_index : next_worker_.load(std::memory_order_relaxed) % workers_.size();
+    Task task;
+    if (!takeTask(self, task)) {
+        return false;
+    }
+    task.run(task.arg);
+    tasks_run_.inc();
+    return true;
+}
+
+bool WorkStealingPool::takeTask(size_t self, Task& task) {
+    {
+        Worker& own = *workers_[self];
+        std::lock_guard<std::mutex> lock(own.mtx);
+        if (!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            pending_.fetch_sub(1, std::memory_order_seq_cst);
+            return true;
+        }
+    }
+    for (size_t offset = 1; offset < workers_.size(); ++offset) {
+        Worker& victim = *workers_[(self + offset) % workers_.size()];
+        std::lock_guard<std::mutex> lock(victim.mtx);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            pending_.fetch_sub(1, std::memory_order_seq_cst);
+            steals_.inc();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(size_t index) {
+    tls_pool = this;
+    tls_index = index;
+    Task task;
+    while (running_.load()) {
+        if (takeTask(index, task)) {
+            task.run(task.arg);
+            tasks_run_.inc();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleep_mtx_);
+        idle_.fetch_add(1, std::memory_order_seq_cst);
+        sleep_cv_.wait(lock, [this]() {
+            return !running_.load() || pending_.load(std::memory_order_seq_cst) > 0;
+        });
+        idle_.fetch_sub(1, std::memory_order_seq_cst);
+    }
+    tls_pool = nullptr;
+}
@@ -0,0 +1,64 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "BoundedQueue.h"
+#include "MetricsRegistry.h"
+
+// 작업 훔치기(work-stealing) 스레드 풀
+// - 작업 스레드마다 자기 deque 를 가지고, 자기 작업은 뒤에서(LIFO) 꺼내 캐시에 남은 프레임을 바로 이어 처리
+// - 자기 deque 가 비면 다른 스레드 deque 의 앞(가장 오래된 작업)을 훔침
+// - 작업 스레드가 아닌 곳(캡처 콜백 등)에서 넣은 작업은 스레드들에 돌아가며 분배
+// - 작업은 함수 포인터 + 인자라서 submit 에 할당이 없음
+class WorkStealingPool {
+public:
+    struct Task {
+        void (*run)(void* arg);
+        void* arg;
+    };
+
+    explicit WorkStealingPool(int threads);
+    ~WorkStealingPool();
+
+    bool start();
+    // 스레드를 멈추고 실행되지 않은 작업은 버림
+    void stop();
+
+    void submit(Task task);
+
+    // 호출 스레드에서 대기 중인 작업 하나를 실행 (block 정책 생산자가 자리를 기다리는 동안 사용)
+    bool runOne();
+
+    size_t threadCount() const { return workers_.size(); }
+
+private:
+    struct alignas(kCacheLineSize) Worker {
+        std::mutex mtx;
+        std::deque<Task> tasks;
+    };
+
+    bool takeTask(size_t self, Task& task);
+    void workerLoop(size_t index);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+    std::atomic<bool> running_;
+    std::atomic<size_t> pending_;       // 모든 deque 의 작업 수
+    std::atomic<size_t> next_worker_;   // 외부 submit 분배 위치
+    std::atomic<int> idle_;             // 잠든 작업 스레드 수 (있을 때만 깨움)
+    std::mutex sleep_mtx_;
+    std::condition_variable sleep_cv_;
+
+    Counter& tasks_run_;
+    Counter& steals_;
+};
+
+#endif // WORK_STEALING_POOL_H
@@ -1,14 +1,26 @@
 #include "ZeroCopyCapture.h"
+#include "StartupTimeline.h"
+#include "FrameTracer.h"
+#include "Logger.h"
 #include <iostream>
 #include <sys/mman.h>
+#include <algorithm>
 #include <chrono>
+#include <thread>
 
 using namespace libcamera;
 using namespace std::chrono;
 using namespace std::literals::chrono_literals;
 
 ZeroCopyCapture::ZeroCopyCapture(const VideoConfig& config) 
-    : stream_(nullptr), stopping_(false), video_config_(config) {
+    : stream_(nullptr), analytics_stream_(nullptr), stopping_(false), generation_(0), frames_in_flight_(0),
+      frame_duration_us_(1000000 / std::max(config.fps, 1)), frame_duration_pending_(false), video_config_(config),
+      frames_captured_(MetricsRegistry::instance().counter("camstream_frames_captured_total",
+                                                          "Frames delivered by the camera")),
+      frames_dropped_(MetricsRegistry::instance().counter("camstream_frames_dropped_total",
+                                                         "Frames lost to failed requests or sensor sequence gaps")),
+      page_faults_(MemoryResidency::instance().subsystem("capture")),
+      last_sequence_(-1) {
 }
 
 ZeroCopyCapture::~ZeroCopyCapture() {
@@ -18,10 +30,13 @@ ZeroCopyCapture::~ZeroCopyCapture() {
 bool ZeroCopyCapture::initialize() {
     std::cout << "[INFO] Initializing ZeroCopyCapture..." << std::endl;
     
-    camera_manager_ = std::make_unique<CameraManager>();
-    if (camera_manager_->start()) {
-        std::cerr << "[ERROR] Failed to start camera manager" << std::endl;
-        return false;
+    {
+        StartupTimeline::Scope scope("camera_manager_start");
+        camera_manager_ = std::make_unique<CameraManager>();
+        if (camera_manager_->start()) {
+            std::cerr << "[ERROR] Failed to start camera manager" << std::endl;
+            return false;
+        }
     }
     
     if (camera_manager_->cameras().empty()) {
@@ -29,80 +44,188 @@ bool ZeroCopyCapture::initialize() {
         return false;
     }
     
-    std::string cameraId = camera_manager_->cameras()[0]->id();
-    camera_ = camera_manager_->get(cameraId);
-    std::cout << "[INFO] Using camera: " << cameraId << std::endl;
+    {
+        StartupTimeline::Scope scope("camera_configure");
+        std::string cameraId = camera_manager_->cameras()[0]->id();
+        camera_ = camera_manager_->get(cameraId);
+        std::cout << "[INFO] Using camera: " << cameraId << std::endl;
 
-    if (camera_->acquire()) {
-        std::cerr << "[ERROR] Failed to acquire camera" << std::endl;
-        return false;
-    }
+        if (camera_->acquire()) {
+            std::cerr << "[ERROR] Failed to acquire camera" << std::endl;
+            return false;
+        }
 
-    config_ = camera_->generateConfiguration({StreamRole::Viewfinder});
-    StreamConfiguration& streamConfig = config_->at(0);
-    streamConfig.size = Size(video_config_.width, video_config_.height);
-    streamConfig.pixelFormat = getPixelFormat(video_config_.pixel_format);
-    streamConfig.bufferCount = video_config_.buffer_count;
-    config_->validate();
-    
-    if (camera_->configure(config_.get()) < 0) {
-        std::cerr << "[ERROR] Failed to configure camera" << std::endl;
-        return false;
-    }
-    stream_ = streamConfig.stream();
+        // 보조 스트림은 ISP 의 두 번째 출력(저해상도)으로 요청
+        std::vector<StreamRole> roles = {StreamRole::Viewfinder};
+        if (video_config_.analytics_enabled) {
+            roles.push_back(StreamRole::Viewfinder);
+        }
+        config_ = camera_->generateConfiguration(roles);
+        if (!config_ && roles.size() > 1) {
+            std::cout << "[WARN] Camera does not provide a second stream, analytics will use the main stream" << std::endl;
+            roles.pop_back();
+            config_ = camera_->generateConfiguration(roles);
+        }
+        if (!config_) {
+            std::cerr << "[ERROR] Failed to generate camera configuration" << std::endl;
+            return false;
+        }
+        StreamConfiguration& streamConfig = config_->at(0);
+        streamConfig.size = Size(video_config_.width, video_config_.height);
+        streamConfig.pixelFormat = getPixelFormat(video_config_.pixel_format);
+        streamConfig.bufferCount = video_config_.buffer_count;
+        if (config_->size() > 1) {
+            StreamConfiguration& analyticsConfig = config_->at(1);
+            analyticsConfig.size = Size(video_config_.analytics_width, video_config_.analytics_height);
+            analyticsConfig.pixelFormat = getPixelFormat(video_config_.analytics_pixel_format);
+            analyticsConfig.bufferCount = video_config_.buffer_count;
+        }
+        if (config_->validate() == CameraConfiguration::Invalid) {
+            std::cerr << "[ERROR] Invalid camera configuration" << std::endl;
+            return false;
+        }
+
+        if (camera_->configure(config_.get()) < 0) {
+            std::cerr << "[ERROR] Failed to configure camera" << std::endl;
+            return false;
+        }
+        stream_ = streamConfig.stream();
+
+        std::cout << "[INFO] Stream configured: " << streamConfig.size.width << "x" << streamConfig.size.height
+                  << " " << streamConfig.pixelFormat.toString() << " with " << streamConfig.bufferCount << " buffers." << std::endl;
 
-    std::cout << "[INFO] Stream configured: " << streamConfig.size.width << "x" << streamConfig.size.height
-              << " " << streamConfig.pixelFormat.toString() << " with " << streamConfig.bufferCount << " buffers." << std::endl;
+        if (config_->size() > 1) {
+            const StreamConfiguration& analyticsConfig = config_->at(1);
+            analytics_stream_ = analyticsConfig.stream();
+            std::cout << "[INFO] Analytics stream configured: " << analyticsConfig.size.width << "x"
+                      << analyticsConfig.size.height << " " << analyticsConfig.pixelFormat.toString() << std::endl;
+        }
+    }
 
     return setupBuffers();
 }
 
 bool ZeroCopyCapture::setupBuffers() {
     std::cout << "[INFO] Setting up DMA buffers..." << std::endl;
+    StartupTimeline::Scope scope("buffer_mmap");
     allocator_ = std::make_shared<FrameBufferAllocator>(camera_);
-    if (allocator_->allocate(stream_) < 0) {
-        std::cerr << "[ERROR] Failed to allocate buffers" << std::endl;
+    if (!mapStreamBuffers(stream_, buffer_frames_)) {
+        return false;
+    }
+    if (analytics_stream_ && !mapStreamBuffers(analytics_stream_, analytics_frames_)) {
         return false;
     }
     
-    for (const auto& buffer : allocator_->buffers(stream_)) {
-        std::vector<void*> planeMappings;
-        for (const auto& plane : buffer->planes()) {
-            void* memory = mmap(nullptr, plane.length, PROT_READ | PROT_WRITE, MAP_SHARED, plane.fd.get(), 0);
-            if (memory == MAP_FAILED) {
-                std::cerr << "[ERROR] Failed to mmap buffer plane" << std::endl;
+    std::cout << "[INFO] " << buffer_mappings_.size() << " DMA buffers mapped successfully (stride "
+              << buffer_frames_[0].strides[0] << ")." << std::endl;
+    return true;
+}
+
+bool ZeroCopyCapture::mapStreamBuffers(Stream* stream, std::vector<FrameData>& frames) {
+    if (allocator_->allocate(stream) < 0) {
+        std::cerr << "[ERROR] Failed to allocate buffers" << std::endl;
+        return false;
+    }
+
+    const auto& buffers = allocator_->buffers(stream);
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        FrameBuffer* buffer = buffers[i].get();
+        const auto& planes = buffer->planes();
+
+        // 평면들은 같은 dmabuf 안의 서로 다른 오프셋에 있으므로 끝까지 한 번만 매핑
+        int fd = planes[0].fd.get();
+        size_t map_length = 0;
+        for (const auto& plane : planes) {
+            if (plane.fd.get() != fd) {
+                std::cerr << "[ERROR] Planes in separate dmabufs are not supported" << std::endl;
                 return false;
             }
-            planeMappings.push_back(memory);
+            map_length = std::max<size_t>(map_length, plane.offset + plane.length);
         }
-        buffer_plane_mappings_.push_back(planeMappings);
+
+        // 상주 모드에서는 매핑 시점에 페이지 테이블을 채워 첫 프레임들의 폴트를 없앰
+        int flags = MAP_SHARED | (MemoryResidency::instance().prefaultEnabled() ? MAP_POPULATE : 0);
+        void* memory = mmap(nullptr, map_length, PROT_READ | PROT_WRITE, flags, fd, 0);
+        if (memory == MAP_FAILED) {
+            std::cerr << "[ERROR] Failed to mmap buffer" << std::endl;
+            return false;
+        }
+        buffer_mappings_.emplace_back(memory, map_length);
+
+        // 완료된 요청에서 버퍼 인덱스를 바로 찾을 수 있도록 cookie 에 저장
+        buffer->setCookie(i);
+
+        FrameData frame = {};
+        frame.data = memory;
+        frame.size = map_length;
+        frame.buffer_index = i;
+        fillPlaneLayout(frame, *buffer, stream);
+        frames.push_back(frame);
     }
-    
-    std::cout << "[INFO] " << buffer_plane_mappings_.size() << " DMA buffers mapped successfully." << std::endl;
     return true;
 }
 
+void ZeroCopyCapture::fillPlaneLayout(FrameData& frame, const FrameBuffer& buffer, const Stream* stream) const {
+    const StreamConfiguration& stream_config = stream->configuration();
+    const auto& planes = buffer.planes();
+    int stride = static_cast<int>(stream_config.stride);
+
+    frame.width = static_cast<int>(stream_config.size.width);
+    frame.height = static_cast<int>(stream_config.size.height);
+    frame.num_planes = 1;
+    frame.offsets[0] = planes[0].offset;
+    frame.strides[0] = stride;
+
+    if (stream_config.pixelFormat == formats::YUV420) {
+        // 크로마 평면 stride 는 luma 의 절반. 평면이 하나로만 보고되면 연속 배치로 계산
+        int chroma_stride = stride / 2;
+        size_t chroma_size = static_cast<size_t>(chroma_stride) * ((frame.height + 1) / 2);
+        frame.num_planes = 3;
+        frame.strides[1] = frame.strides[2] = chroma_stride;
+        frame.offsets[1] = planes.size() > 1 ? planes[1].offset
+                                             : frame.offsets[0] + static_cast<size_t>(stride) * frame.height;
+        frame.offsets[2] = planes.size() > 2 ? planes[2].offset : frame.offsets[1] + chroma_size;
+    }
+}
+
 bool ZeroCopyCapture::start() {
-    if (!camera_) {
+    // 재구성이 실패하면 버퍼가 없는 상태로 남음
+    if (!camera_ || !allocator_) {
         std::cerr << "[ERROR] Cannot start, camera not initialized." << std::endl;
         return false;
     }
 
-    stopping_.store(false);
+    {
+        std::lock_guard<std::mutex> lock(requeue_mtx_);
+        generation_++;
+        stopping_.store(false);
+    }
     camera_->requestCompleted.connect(this, &ZeroCopyCapture::onRequestCompleted);
 
-    std::vector<std::unique_ptr<Request>> requests;
-    for (const auto& buffer : allocator_->buffers(stream_)) {
+    // 보조 스트림 버퍼를 같은 요청에 넣어 두 출력이 같은 센서 프레임에서 나오도록 함
+    const auto& buffers = allocator_->buffers(stream_);
+    size_t request_count = buffers.size();
+    if (analytics_stream_) {
+        request_count = std::min(request_count, allocator_->buffers(analytics_stream_).size());
+    }
+
+    requests_.clear();
+    for (size_t i = 0; i < request_count; ++i) {
         auto request = camera_->createRequest();
-        if (!request || request->addBuffer(stream_, buffer.get()) < 0) {
+        if (!request || request->addBuffer(stream_, buffers[i].get()) < 0) {
             std::cerr << "[ERROR] Failed to create request or add buffer" << std::endl;
             return false;
         }
-        requests.push_back(std::move(request));
+        if (analytics_stream_ && request->addBuffer(analytics_stream_, allocator_->buffers(analytics_stream_)[i].get()) < 0) {
+            std::cerr << "[ERROR] Failed to add analytics buffer to request" << std::endl;
+            return false;
+        }
+        requests_.push_back(std::move(request));
     }
 
     ControlList controls;
-    int64_t frame_time = 1000000 / video_config_.fps;
+    int64_t frame_time = frame_duration_us_.load();
+    frame_duration_pending_.store(false);
     controls.set(controls::FrameDurationLimits, Span<const int64_t, 2>({frame_time, frame_time}));
 
     std::cout << "[INFO] Starting camera..." << std::endl;
@@ -111,8 +234,10 @@ bool ZeroCopyCapture::start() {
         return false;
     }
     
-    for (auto& request : requests) {
-        camera_->queueRequest(request.release());
+    last_sequence_ = -1;
+    heartbeat_.beat();
+    for (auto& request : requests_) {
+        camera_->queueRequest(request.get());
     }
     
     std::cout << "[INFO] Camera started and initial requests queued." << std::endl;
@@ -120,32 +245,121 @@ bool ZeroCopyCapture::start() {
 }
 
 void ZeroCopyCapture::stop() {
-    if (stopping_.exchange(true)) return;
+    {
+        // 다른 스레드에서 진행 중인 재사용이 끝난 뒤에 멈춤 (이후 놓이는 참조는 다시 넣지 않음)
+        std::lock_guard<std::mutex> lock(requeue_mtx_);
+        if (stopping_.exchange(true)) return;
+    }
     
     std::cout << "[INFO] Stopping ZeroCopyCapture..." << std::endl;
     
-    frame_queue_.stop();
-    
     if (camera_) {
         camera_->stop();
         camera_->requestCompleted.disconnect(this, &ZeroCopyCapture::onRequestCompleted);
     }
 }
 
-void ZeroCopyCapture::cleanup() {
-    std::cout << "[INFO] Cleaning up ZeroCopyCapture resources..." << std::endl;
+bool ZeroCopyCapture::restart() {
+    if (!camera_) {
+        return false;
+    }
+    LOG_WARN("capture") << "Restarting camera and requeueing " << requests_.size() << " requests";
     stop();
-    
-    if (allocator_) {
-        const auto& buffers = allocator_->buffers(stream_);
-        for (size_t i = 0; i < buffer_plane_mappings_.size(); ++i) {
-            for (size_t j = 0; j < buffer_plane_mappings_[i].size(); ++j) {
-                if (buffer_plane_mappings_[i][j] != MAP_FAILED) {
-                    munmap(buffer_plane_mappings_[i][j], buffers[i]->planes()[j].length);
-                }
-            }
+    if (!waitForReleasedFrames()) {
+        return false;
+    }
+    return start();
+}
+
+bool ZeroCopyCapture::reconfigure() {
+    if (!camera_ || !config_) {
+        return false;
+    }
+    LOG_WARN("capture") << "Reconfiguring camera with fresh buffers";
+    stop();
+    if (!waitForReleasedFrames() || !configureStreams()) {
+        return false;
+    }
+    return start();
+}
+
+bool ZeroCopyCapture::setResolution(int width, int height) {
+    if (!camera_ || !config_) {
+        return false;
+    }
+    stop();
+    if (!waitForReleasedFrames()) {
+        return false;
+    }
+
+    StreamConfiguration& stream_config = config_->at(0);
+    Size previous = stream_config.size;
+    stream_config.size = Size(width, height);
+    if (config_->validate() == CameraConfiguration::Invalid) {
+        LOG_ERROR("capture") << "Camera rejected " << width << "x" << height << ", keeping "
+                             << previous.toString();
+        stream_config.size = previous;
+        config_->validate();
+        return false;
+    }
+    LOG_INFO("capture") << "Reconfiguring camera from " << previous.toString() << " to "
+                        << stream_config.size.toString();
+    if (configureStreams()) {
+        video_config_.width = static_cast<int>(stream_config.size.width);
+        video_config_.height = static_cast<int>(stream_config.size.height);
+        return true;
+    }
+
+    // 새 크기로 버퍼를 잡지 못하면 이전 크기로 스트리밍을 이어감
+    stream_config.size = previous;
+    config_->validate();
+    if (!configureStreams()) {
+        LOG_ERROR("capture") << "Failed to restore previous camera configuration";
+    }
+    return false;
+}
+
+bool ZeroCopyCapture::configureStreams() {
+    requests_.clear();
+    unmapBuffers();
+    allocator_.reset();
+
+    if (camera_->configure(config_.get()) < 0) {
+        LOG_ERROR("capture") << "Failed to reconfigure camera";
+        return false;
+    }
+    stream_ = config_->at(0).stream();
+    analytics_stream_ = config_->size() > 1 ? config_->at(1).stream() : nullptr;
+    return setupBuffers();
+}
+
+bool ZeroCopyCapture::waitForReleasedFrames() {
+    // 하류가 잡고 있는 버퍼에 카메라가 다시 쓰거나 매핑이 풀리지 않도록 모든 참조가 놓일 때까지 대기
+    auto deadline = steady_clock::now() + 1s;
+    while (frames_in_flight_.load() > 0) {
+        if (steady_clock::now() >= deadline) {
+            LOG_WARN("capture") << frames_in_flight_.load() << " frames still held downstream, camera not restarted";
+            return false;
         }
+        std::this_thread::sleep_for(5ms);
     }
+    return true;
+}
+
+void ZeroCopyCapture::unmapBuffers() {
+    for (const auto& mapping : buffer_mappings_) {
+        munmap(mapping.first, mapping.second);
+    }
+    buffer_mappings_.clear();
+    buffer_frames_.clear();
+    analytics_frames_.clear();
+}
+
+void ZeroCopyCapture::cleanup() {
+    std::cout << "[INFO] Cleaning up ZeroCopyCapture resources..." << std::endl;
+    stop();
+    requests_.clear();
+    unmapBuffers();
     
     if (camera_) {
         camera_->release();
@@ -158,47 +372,120 @@ void ZeroCopyCapture::setFrameCallback(std::function<void(const FrameData&)> cal
     frame_callback_ = callback;
 }
 
+void ZeroCopyCapture::setAnalyticsCallback(std::function<void(const FrameData&)> callback) {
+    analytics_callback_ = callback;
+}
+
+void ZeroCopyCapture::setFrameSink(std::function<void(const FrameRef&, const FrameRef&)> sink) {
+    frame_sink_ = sink;
+}
+
 void ZeroCopyCapture::onRequestCompleted(Request* request) {
+    // stop 중에 취소되어 돌아오는 요청은 멈춘 카메라에 다시 넣을 수 없으므로 그대로 둠
     if (stopping_.load()) {
-        request->reuse(Request::ReuseBuffers);
-        camera_->queueRequest(request);
         return;
     }
 
     if (request->status() != Request::RequestComplete) {
         if (request->status() != Request::RequestCancelled) {
-             std::cerr << "[WARN] Request failed with status " << request->status() << std::endl;
+             LOG_WARN("capture") << "Request failed with status " << static_cast<int>(request->status());
+             frames_dropped_.inc();
+             FrameTracer::instance().requestDumpOnDrop();
         }
-        request->reuse(Request::ReuseBuffers);
-        camera_->queueRequest(request);
+        requeue(request, generation_.load());
         return;
     }
 
-    FrameBuffer* buffer = request->buffers().begin()->second;
-    size_t bufferIndex = 0;
-    const auto& buffers = allocator_->buffers(stream_);
-    for (size_t i = 0; i < buffers.size(); ++i) {
-        if (buffers[i].get() == buffer) {
-            bufferIndex = i;
-            break;
+    FrameBuffer* buffer = request->findBuffer(stream_);
+    FrameData frame_data = buffer_frames_[buffer->cookie()];
+    frame_data.sequence = buffer->metadata().sequence;
+    TraceSpan request_span("request_completed", frame_data.sequence);
+    PageFaultScope fault_scope(page_faults_);
+    heartbeat_.beat();
+
+    frames_captured_.inc();
+    if (last_sequence_ >= 0 && frame_data.sequence > last_sequence_ + 1) {
+        frames_dropped_.inc(frame_data.sequence - last_sequence_ - 1);
+        FrameTracer::instance().requestDumpOnDrop();
+    }
+    last_sequence_ = frame_data.sequence;
+
+    // 요청 메타데이터의 SensorTimestamp 가 노출 시작 시각 (없으면 버퍼 완료 시각)
+    const ControlList& metadata = request->metadata();
+    auto sensor_timestamp = metadata.get(controls::SensorTimestamp);
+    auto frame_duration = metadata.get(controls::FrameDuration);
+    frame_data.timestamp_ns = sensor_timestamp ? static_cast<uint64_t>(*sensor_timestamp) : buffer->metadata().timestamp;
+    frame_data.duration_ns = frame_duration ? static_cast<uint64_t>(*frame_duration) * 1000 : 0;
+
+    if (frame_sink_) {
+        // 메인/보조 프레임이 같은 요청을 공유하므로 둘 다 놓여야 요청이 다시 큐에 들어감
+        uint64_t generation = generation_.load();
+        frames_in_flight_.fetch_add(1);
+        std::shared_ptr<void> owner(request, [this, generation](void* released) {
+            frames_in_flight_.fetch_sub(1);
+            requeue(static_cast<Request*>(released), generation);
+        });
+        FrameRef frame = {frame_data, owner, 0};
+        FrameRef analytics = {FrameData{}, nullptr, 0};
+        FrameBuffer* analytics_buffer = analytics_stream_ ? request->findBuffer(analytics_stream_) : nullptr;
+        if (analytics_buffer) {
+            analytics.data = analytics_frames_[analytics_buffer->cookie()];
+            analytics.data.sequence = analytics_buffer->metadata().sequence;
+            analytics.data.timestamp_ns = frame_data.timestamp_ns;
+            analytics.data.duration_ns = frame_data.duration_ns;
+            analytics.owner = owner;
         }
+        owner.reset();
+        TraceSpan dispatch_span("dispatch", frame_data.sequence);
+        frame_sink_(frame, analytics);
+        return;
     }
     
-    FrameData frame_data = {
-        buffer_plane_mappings_[bufferIndex][0], 
-        buffer->planes()[0].length, 
-        bufferIndex
-    };
-    
     // 콜백이 설정되어 있으면 호출
     if (frame_callback_) {
+        TraceSpan dispatch_span("dispatch", frame_data.sequence);
         frame_callback_(frame_data);
     }
+
+    if (analytics_stream_ && analytics_callback_) {
+        FrameBuffer* analytics_buffer = request->findBuffer(analytics_stream_);
+        if (analytics_buffer) {
+            FrameData analytics_data = analytics_frames_[analytics_buffer->cookie()];
+            analytics_data.sequence = analytics_buffer->metadata().sequence;
+            analytics_data.timestamp_ns = frame_data.timestamp_ns;
+            analytics_data.duration_ns = frame_data.duration_ns;
+            TraceSpan dispatch_span("analytics_dispatch", frame_data.sequence);
+            analytics_callback_(analytics_data);
+        }
+    }
     
+    requeue(request, generation_.load());
+}
+
+void ZeroCopyCapture::requeue(Request* request, uint64_t generation) {
+    // 그래프에서 참조가 늦게 놓이면 다른 스레드에서 호출됨. 멈췄거나 이전 start 의 요청이면 버림
+    std::lock_guard<std::mutex> lock(requeue_mtx_);
+    if (stopping_.load() || generation != generation_.load()) {
+        return;
+    }
+    // reuse 가 컨트롤을 비우므로 그 뒤에 새 프레임 길이를 넣음
     request->reuse(Request::ReuseBuffers);
+    if (frame_duration_pending_.exchange(false)) {
+        int64_t frame_time = frame_duration_us_.load();
+        request->controls().set(controls::FrameDurationLimits, Span<const int64_t, 2>({frame_time, frame_time}));
+    }
     camera_->queueRequest(request);
 }
 
+void ZeroCopyCapture::setFrameRate(int fps) {
+    if (fps <= 0) {
+        return;
+    }
+    frame_duration_us_.store(1000000 / fps);
+    frame_duration_pending_.store(true);
+    LOG_INFO("capture") << "Frame rate set to " << fps << " fps";
+}
+
 PixelFormat ZeroCopyCapture::getPixelFormat(const std::string& format_str) {
     if (format_str == "BGR888") {
         return formats::BGR888;
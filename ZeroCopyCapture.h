@@ -8,58 +8,20 @@
 #include <libcamera/controls.h>
 #include <libcamera/stream.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include <atomic>
 #include <functional>
-#include <thread>
 #include <mutex>
-#include <condition_variable>
-#include <queue>
+#include <thread>
 
 #include "ConfigManager.h"
-
-// 프레임 데이터를 담을 구조체
-struct FrameData {
-    void* data;
-    size_t size;
-    size_t buffer_index;
-};
-
-// 스레드 안전 큐 (Blocking Pop 기능 추가)
-template <typename T>
-class ThreadSafeQueue {
-private:
-    mutable std::mutex mtx;
-    std::queue<T> data_queue;
-    std::condition_variable cv;
-    std::atomic<bool> stopped{false};
-
-public:
-    void push(T new_value) {
-        if (stopped) return;
-        std::lock_guard<std::mutex> lock(mtx);
-        data_queue.push(std::move(new_value));
-        cv.notify_one();
-    }
-
-    // 대기하며 pop 하는 함수
-    bool wait_and_pop(T& value) {
-        std::unique_lock<std::mutex> lock(mtx);
-        cv.wait(lock, [this] { return !data_queue.empty() || stopped.load(); });
-        if (stopped.load() && data_queue.empty()) {
-            return false;
-        }
-        value = std::move(data_queue.front());
-        data_queue.pop();
-        return true;
-    }
-    
-    void stop() {
-        stopped.store(true);
-        cv.notify_all(); // 모든 대기 중인 스레드를 깨움
-    }
-};
+#include "FrameData.h"
+#include "MemoryResidency.h"
+#include "MetricsRegistry.h"
+#include "StallWatchdog.h"
 
 class ZeroCopyCapture {
 private:
@@ -67,16 +29,36 @@ private:
     std::unique_ptr<libcamera::CameraManager> camera_manager_;
     std::unique_ptr<libcamera::CameraConfiguration> config_;
     libcamera::Stream* stream_;
+    libcamera::Stream* analytics_stream_;   // 보조 저해상도 스트림 (없으면 nullptr)
     std::shared_ptr<libcamera::FrameBufferAllocator> allocator_;
-    std::vector<std::vector<void*>> buffer_plane_mappings_;
+    // 버퍼별 dmabuf 매핑 (평면 전체를 한 번에 매핑)과 미리 채워 둔 프레임 정보
+    std::vector<std::pair<void*, size_t>> buffer_mappings_;
+    std::vector<FrameData> buffer_frames_;
+    std::vector<FrameData> analytics_frames_;
+    // 요청 객체는 여기서 소유 (stop 에서 취소된 요청을 다시 큐에 넣지 않고 restart 때 새로 만듦)
+    std::vector<std::unique_ptr<libcamera::Request>> requests_;
     
     std::atomic<bool> stopping_;
-    ThreadSafeQueue<FrameData> frame_queue_;
+    // 프레임 참조가 늦게 놓일 때 이전 start 의 요청을 다시 넣지 않도록 start 마다 증가 (requeue_mtx_ 아래에서 변경)
+    std::atomic<uint64_t> generation_;
+    std::mutex requeue_mtx_;                // 요청 재사용과 stop/요청 목록 교체 사이
+    std::atomic<int> frames_in_flight_;     // 하류가 아직 놓지 않은 요청 수 (frame sink 모드)
+    // FrameDurationLimits (us). 바뀌면 다음으로 다시 큐에 넣는 요청의 컨트롤에 실음
+    std::atomic<int64_t> frame_duration_us_;
+    std::atomic<bool> frame_duration_pending_;
     
     VideoConfig video_config_;
     
     // 프레임 처리 콜백
     std::function<void(const FrameData&)> frame_callback_;
+    std::function<void(const FrameData&)> analytics_callback_;
+    std::function<void(const FrameRef&, const FrameRef&)> frame_sink_;
+
+    Counter& frames_captured_;
+    Counter& frames_dropped_;
+    PageFaultCounters& page_faults_;
+    Heartbeat heartbeat_;       // 마지막으로 완료된 요청
+    int64_t last_sequence_;     // 센서 sequence 공백으로 ISP/요청 단계의 드롭을 셈
 
 public:
     ZeroCopyCapture(const VideoConfig& config);
@@ -85,15 +67,55 @@ public:
     bool initialize();
     bool start();
     void stop();
+
+    // 워치독 복구: 카메라를 멈췄다가 모든 요청을 다시 큐에 넣음 (설정과 버퍼 매핑은 유지)
+    bool restart();
+    // restart 로 회복하지 않을 때: 버퍼를 해제하고 같은 설정으로 다시 configure 한 뒤 시작
+    // 버퍼 매핑이 바뀌므로 호출 전에 하류가 이전 프레임을 놓도록 해야 함
+    bool reconfigure();
+    // 실행 중 해상도 변경: 멈추고 버퍼를 해제한 뒤 새 크기로 configure 하고 멈춘 상태로 둠
+    // (하류를 새 stride/크기로 바꾼 뒤 start). 센서가 받지 않으면 이전 크기로 되돌리고 false
+    // 센서 정렬로 크기가 조정될 수 있으므로 결과는 getWidth/getHeight 로 확인
+    bool setResolution(int width, int height);
+
+    const Heartbeat& heartbeat() const { return heartbeat_; }
+
+    // 실행 중 프레임 레이트 변경 (재시작 없이 다음 요청부터 적용, 센서가 지원하는 범위로 제한됨)
+    void setFrameRate(int fps);
     
     void setFrameCallback(std::function<void(const FrameData&)> callback);
+
+    // 보조 스트림 프레임 콜백. 같은 요청의 메인 프레임 콜백 직후 같은 sequence/timestamp 로 호출됨
+    void setAnalyticsCallback(std::function<void(const FrameData&)> callback);
+
+    // 처리 그래프용: 요청을 공유 소유 프레임(메인, 보조)으로 넘기고 마지막 참조가 놓일 때 다시 큐에 넣음
+    // 보조 스트림이 없으면 두 번째 인자는 valid() 가 false. 설정하면 위 콜백들은 쓰이지 않음
+    // 참조가 남아 있는 동안 이 객체가 살아 있어야 하고, restart/reconfigure 는 모든 참조가 놓일 때까지 기다림
+    void setFrameSink(std::function<void(const FrameRef& frame, const FrameRef& analytics)> sink);
     
     bool isRunning() const { return !stopping_.load(); }
 
+    // configure 이후의 실제 스트림 정보 (ISP 정렬로 width 와 stride 가 다를 수 있음)
+    int getWidth() const { return stream_ ? static_cast<int>(stream_->configuration().size.width) : 0; }
+    int getHeight() const { return stream_ ? static_cast<int>(stream_->configuration().size.height) : 0; }
+    int getStride() const { return stream_ ? static_cast<int>(stream_->configuration().stride) : 0; }
+
+    bool hasAnalyticsStream() const { return analytics_stream_ != nullptr; }
+    int getAnalyticsWidth() const { return analytics_stream_ ? static_cast<int>(analytics_stream_->configuration().size.width) : 0; }
+    int getAnalyticsHeight() const { return analytics_stream_ ? static_cast<int>(analytics_stream_->configuration().size.height) : 0; }
+    int getAnalyticsStride() const { return analytics_stream_ ? static_cast<int>(analytics_stream_->configuration().stride) : 0; }
+
 private:
     bool setupBuffers();
+    void unmapBuffers();
+    bool mapStreamBuffers(libcamera::Stream* stream, std::vector<FrameData>& frames);
+    void fillPlaneLayout(FrameData& frame, const libcamera::FrameBuffer& buffer, const libcamera::Stream* stream) const;
     void cleanup();
     void onRequestCompleted(libcamera::Request* request);
+    void requeue(libcamera::Request* request, uint64_t generation);
+    bool waitForReleasedFrames();
+    // 멈춘 상태에서 버퍼를 해제하고 config_ 로 다시 configure 해 버퍼를 새로 매핑
+    bool configureStreams();
     
     libcamera::PixelFormat getPixelFormat(const std::string& format_str);
 };
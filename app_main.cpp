@@ -16,6 +16,8 @@ int main() {
     // 시그널 핸들러 등록
     signal(SIGINT, globalSignalHandler);
     signal(SIGTERM, globalSignalHandler);
+    signal(SIGUSR1, traceSignalHandler);
+    signal(SIGHUP, reloadSignalHandler);
 
     std::cout << "========================================================" << std::endl;
     std::cout << "   Zero-Copy Camera to RTSP Streamer (Refactored)" << std::endl;
@@ -0,0 +1,99 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Google Benchmark 와 같은 사용 방식/JSON 형식의 최소 하네스 (외부 의존성 없음)
+//
+//   static void queuePushPop(bench::State& state) {
+//       for (auto _ : state) { ... }
+//       state.setItemsProcessed(state.iterations());
+//   }
+//   BENCHMARK(queuePushPop);
+namespace bench {
+
+class State {
+private:
+    uint64_t max_iterations_;
+    uint64_t iterations_;
+    int64_t bytes_processed_;
+    int64_t items_processed_;
+    std::string label_;
+    bool skipped_;
+    std::string skip_reason_;
+
+public:
+    explicit State(uint64_t max_iterations)
+        : max_iterations_(max_iterations), iterations_(0), bytes_processed_(0), items_processed_(0),
+          skipped_(false) {}
+
+    // range-for 용 반복자: for (auto _ : state)
+    struct __attribute__((unused)) Value {};
+    struct Iterator {
+        State* state;
+        uint64_t remaining;
+        bool operator!=(const Iterator&) const { return remaining != 0; }
+        void operator++() { --remaining; ++state->iterations_; }
+        Value operator*() const { return Value(); }
+    };
+    Iterator begin() { return {this, max_iterations_}; }
+    Iterator end() { return {this, 0}; }
+
+    uint64_t maxIterations() const { return max_iterations_; }
+    uint64_t iterations() const { return iterations_; }
+
+    void setBytesProcessed(int64_t bytes) { bytes_processed_ = bytes; }
+    void setItemsProcessed(int64_t items) { items_processed_ = items; }
+    void setLabel(const std::string& label) { label_ = label; }
+
+    // 환경 때문에 실행할 수 없는 경우 (예: GStreamer 플러그인 없음)
+    void skipWithError(const std::string& reason) { skipped_ = true; skip_reason_ = reason; }
+
+    int64_t bytesProcessed() const { return bytes_processed_; }
+    int64_t itemsProcessed() const { return items_processed_; }
+    const std::string& label() const { return label_; }
+    bool skipped() const { return skipped_; }
+    const std::string& skipReason() const { return skip_reason_; }
+};
+
+using Function = std::function<void(State&)>;
+
+// 등록은 정적 초기화 시점에 수행되므로 반환값은 더미
+int registerBenchmark(const std::string& name, Function function);
+
+// 최적화로 결과 계산이 사라지지 않도록 함
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void clobberMemory() {
+    asm volatile("" : : : "memory");
+}
+
+// 측정 대상이 초기화/정리 중 출력하는 [INFO] 로그를 숨김
+class QuietStdout {
+private:
+    std::ostringstream sink_;
+    std::streambuf* saved_;
+
+public:
+    QuietStdout() : saved_(std::cout.rdbuf(sink_.rdbuf())) {}
+    ~QuietStdout() { std::cout.rdbuf(saved_); }
+};
+
+} // namespace bench
+
+#define BENCHMARK_CONCAT_INNER(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_INNER(a, b)
+#define BENCHMARK(function) \
+    static int BENCHMARK_CONCAT(benchmark_registration_, __LINE__) = bench::registerBenchmark(#function, function)
+#define BENCHMARK_NAMED(name, ...) \
+    static int BENCHMARK_CONCAT(benchmark_registration_, __LINE__) = bench::registerBenchmark(name, __VA_ARGS__)
+
+#endif // BENCHMARK_H
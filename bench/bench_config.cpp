@@ -0,0 +1,39 @@
+#include "Benchmark.h"
+#include "ConfigManager.h"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+
+// 저장소의 config.json 을 임시 파일로 복사해서 반복 파싱 (설정 재적용 경로의 비용)
+static void configLoadFromFile(bench::State& state) {
+    std::ifstream source("config.json");
+    if (!source.is_open()) {
+        state.skipWithError("config.json not found (run from the repository root)");
+        return;
+    }
+    std::string content((std::istreambuf_iterator<char>(source)), std::istreambuf_iterator<char>());
+
+    char path[] = "/tmp/camstream_bench_config_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        state.skipWithError("could not create temporary file");
+        return;
+    }
+    close(fd);
+    std::ofstream(path) << content;
+
+    {
+        bench::QuietStdout quiet;
+        for (auto _ : state) {
+            ConfigManager config_manager;
+            bench::doNotOptimize(config_manager.loadFromFile(path));
+        }
+    }
+    std::remove(path);
+    state.setBytesProcessed(static_cast<int64_t>(state.iterations() * content.size()));
+}
+BENCHMARK(configLoadFromFile);
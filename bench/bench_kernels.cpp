@@ -0,0 +1,164 @@
+#include "Benchmark.h"
+#include "ConfigManager.h"
+#include "Detection.h"
+#include "FrameData.h"
+#include "MotionDetector.h"
+#include "ObjectTracker.h"
+#include "PrivacyMask.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// ISP 처럼 행을 64 바이트로 정렬한 합성 프레임 (두 장을 번갈아 넣어 모션 경로도 실행)
+struct SyntheticFrames {
+    std::vector<uint8_t> buffers[2];
+    FrameData frames[2];
+
+    SyntheticFrames(int width, int height, const std::string& pixel_format) {
+        bool yuv = pixel_format == "YUV420";
+        int stride = yuv ? (width + 63) / 64 * 64 : (width * 3 + 63) / 64 * 64;
+        size_t luma_size = static_cast<size_t>(stride) * height;
+        size_t size = yuv ? luma_size + luma_size / 2 : luma_size;
+
+        std::mt19937 rng(42);
+        for (int i = 0; i < 2; ++i) {
+            buffers[i].resize(size);
+            for (auto& byte : buffers[i]) {
+                byte = static_cast<uint8_t>(rng());
+            }
+            // 두 번째 프레임은 가운데 사각형만 밝게 바꿈
+            if (i == 1) {
+                int bpp = yuv ? 1 : 3;
+                for (int y = height / 3; y < height * 2 / 3; ++y) {
+                    for (int x = width / 3 * bpp; x < width * 2 / 3 * bpp; ++x) {
+                        buffers[i][static_cast<size_t>(y) * stride + x] = 250;
+                    }
+                }
+            }
+
+            FrameData& frame = frames[i];
+            frame = {};
+            frame.data = buffers[i].data();
+            frame.size = size;
+            frame.width = width;
+            frame.height = height;
+            frame.strides[0] = stride;
+            frame.num_planes = 1;
+            if (yuv) {
+                frame.num_planes = 3;
+                frame.offsets[1] = luma_size;
+                frame.offsets[2] = luma_size + luma_size / 4;
+                frame.strides[1] = frame.strides[2] = stride / 2;
+            }
+        }
+    }
+};
+
+void motionProcess(bench::State& state, int width, int height, const std::string& pixel_format) {
+    MotionConfig config = {true, 8, 8, 12, 5, 2, 15, 0.5};
+    SyntheticFrames frames(width, height, pixel_format);
+    MotionDetector detector(config);
+    {
+        bench::QuietStdout quiet;
+        if (!detector.configure(width, height, frames.frames[0].strides[0], pixel_format)) {
+            state.skipWithError("motion detector configure failed");
+            return;
+        }
+    }
+
+    uint64_t i = 0;
+    for (auto _ : state) {
+        bench::doNotOptimize(detector.process(frames.frames[i++ & 1]));
+    }
+    size_t frame_bytes = static_cast<size_t>(frames.frames[0].strides[0]) * height;
+    state.setBytesProcessed(static_cast<int64_t>(state.iterations() * frame_bytes));
+    state.setItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+// 프레임의 약 1/8 을 가리는 창문 두 개 (사각형 + 사다리꼴)
+void privacyMask(bench::State& state, const std::string& mode, const std::string& pixel_format) {
+    PrivacyConfig config = {true, mode, 16, 12, {}};
+    config.regions.push_back({{0.05f, 0.10f, 0.30f, 0.10f, 0.30f, 0.40f, 0.05f, 0.40f}});
+    config.regions.push_back({{0.60f, 0.55f, 0.90f, 0.50f, 0.95f, 0.85f, 0.65f, 0.90f}});
+    SyntheticFrames frames(1920, 1080, pixel_format);
+    PrivacyMasker masker(config);
+    {
+        bench::QuietStdout quiet;
+        if (!masker.configure(1920, 1080, frames.frames[0].strides[0], pixel_format)) {
+            state.skipWithError("privacy mask configure failed");
+            return;
+        }
+    }
+
+    for (auto _ : state) {
+        bench::doNotOptimize(masker.apply(frames.frames[0]));
+    }
+    state.setItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+std::vector<Detection> randomDetections(size_t count, int classes, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(0.0f, 1800.0f);
+    std::uniform_real_distribution<float> size(20.0f, 200.0f);
+    std::uniform_real_distribution<float> score(0.1f, 1.0f);
+    std::vector<Detection> detections(count);
+    for (auto& det : detections) {
+        det = {position(rng), position(rng) * 0.5f, size(rng), size(rng), score(rng),
+               static_cast<int>(rng() % classes)};
+    }
+    return detections;
+}
+
+} // namespace
+
+// 캡처 버퍼에서 바로 luma 변환 + 축소 + 블록 SAD (색 변환/리사이즈 커널)
+BENCHMARK_NAMED("motionProcess/BGR888/1920x1080", [](bench::State& s) { motionProcess(s, 1920, 1080, "BGR888"); });
+BENCHMARK_NAMED("motionProcess/BGR888/1280x720", [](bench::State& s) { motionProcess(s, 1280, 720, "BGR888"); });
+BENCHMARK_NAMED("motionProcess/YUV420/1920x1080", [](bench::State& s) { motionProcess(s, 1920, 1080, "YUV420"); });
+BENCHMARK_NAMED("motionProcess/YUV420/640x480", [](bench::State& s) { motionProcess(s, 640, 480, "YUV420"); });
+
+// 인코딩 전 프라이버시 마스크 (구간 목록만 순회하므로 가린 면적에 비례)
+BENCHMARK_NAMED("privacyMask/fill/BGR888", [](bench::State& s) { privacyMask(s, "fill", "BGR888"); });
+BENCHMARK_NAMED("privacyMask/pixelate/BGR888", [](bench::State& s) { privacyMask(s, "pixelate", "BGR888"); });
+BENCHMARK_NAMED("privacyMask/blur/BGR888", [](bench::State& s) { privacyMask(s, "blur", "BGR888"); });
+BENCHMARK_NAMED("privacyMask/pixelate/YUV420", [](bench::State& s) { privacyMask(s, "pixelate", "YUV420"); });
+BENCHMARK_NAMED("privacyMask/blur/YUV420", [](bench::State& s) { privacyMask(s, "blur", "YUV420"); });
+
+// 모델 출력 후처리 (NMS, 타일 병합 시 IoS 포함)
+static void nonMaximumSuppression(bench::State& state, size_t count, float ios_threshold) {
+    const std::vector<Detection> input = randomDetections(count, 8, 7);
+    std::vector<Detection> detections;
+    detections.reserve(count);
+    for (auto _ : state) {
+        detections.assign(input.begin(), input.end());
+        ::nonMaximumSuppression(detections, 0.45f, ios_threshold);
+        bench::doNotOptimize(detections.data());
+    }
+    state.setItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+BENCHMARK_NAMED("nonMaximumSuppression/300", [](bench::State& s) { nonMaximumSuppression(s, 300, 0.0f); });
+BENCHMARK_NAMED("nonMaximumSuppression/300/ios", [](bench::State& s) { nonMaximumSuppression(s, 300, 0.8f); });
+
+// 프레임마다 실행되는 추적기 예측 + 3 프레임마다 검출 보정
+static void trackerStep(bench::State& state) {
+    TrackerConfig config = {true, 64, 128, 0.5f, 0.1f, 0.3f, 90, 3};
+    ObjectTracker tracker(config);
+    std::vector<std::vector<Detection>> batches;
+    for (uint32_t i = 0; i < 16; ++i) {
+        batches.push_back(randomDetections(32, 4, 100 + i));
+    }
+
+    uint64_t frame = 0;
+    for (auto _ : state) {
+        if (frame % 3 == 0) {
+            tracker.submitDetections(batches[(frame / 3) % batches.size()]);
+        }
+        bench::doNotOptimize(tracker.step().size());
+        frame++;
+    }
+    state.setItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(trackerStep);
@@ -0,0 +1,257 @@
+/*
+
+※ How to Compile / Run
+
+make bench                              # 빌드 후 전체 실행, 결과는 bench_results.json
+./camstream_bench --benchmark_filter=motion --benchmark_min_time=0.5
+
+※ Options
+
+--benchmark_filter=<substring>   이름에 부분 문자열이 포함된 벤치마크만 실행
+--benchmark_min_time=<seconds>   벤치마크당 최소 측정 시간 (기본 0.5)
+--benchmark_out=<file>           Google Benchmark 호환 JSON 결과 파일
+--benchmark_list_tests           등록된 이름만 출력
+
+*/
+
+#include "Benchmark.h"
+
+#include <unistd.h>
+#include <time.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#ifndef BENCH_GIT_REVISION
+#define BENCH_GIT_REVISION "unknown"
+#endif
+
+namespace bench {
+
+namespace {
+
+struct Entry {
+    std::string name;
+    Function function;
+};
+
+struct Result {
+    std::string name;
+    uint64_t iterations;
+    double real_ns;         // 반복당
+    double cpu_ns;          // 반복당 (프로세스 CPU 시간, 벤치마크가 띄운 스레드 포함)
+    double bytes_per_second;
+    double items_per_second;
+    std::string label;
+    std::string error;
+};
+
+std::vector<Entry>& registry() {
+    static std::vector<Entry> entries;
+    return entries;
+}
+
+double processCpuSeconds() {
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+std::string jsonEscape(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out += ' ';
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+// 측정 시간이 min_time 을 넘을 때까지 반복 횟수를 늘려가며 실행
+Result run(const Entry& entry, double min_time) {
+    Result result = {entry.name, 0, 0.0, 0.0, 0.0, 0.0, "", ""};
+    uint64_t iterations = 1;
+    while (true) {
+        State state(iterations);
+        double cpu_start = processCpuSeconds();
+        auto wall_start = std::chrono::steady_clock::now();
+        entry.function(state);
+        double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+        double cpu = processCpuSeconds() - cpu_start;
+
+        if (state.skipped()) {
+            result.error = state.skipReason();
+            return result;
+        }
+        if (wall >= min_time || iterations >= 1000000000ULL) {
+            uint64_t done = std::max<uint64_t>(state.iterations(), 1);
+            result.iterations = done;
+            result.real_ns = wall * 1e9 / done;
+            result.cpu_ns = cpu * 1e9 / done;
+            result.bytes_per_second = state.bytesProcessed() / wall;
+            result.items_per_second = state.itemsProcessed() / wall;
+            result.label = state.label();
+            return result;
+        }
+        // 목표 시간의 1.4 배를 예상하도록 늘리되 한 번에 10 배까지만
+        double scale = wall > 0.0 ? min_time * 1.4 / wall : 10.0;
+        iterations = static_cast<uint64_t>(iterations * std::min(std::max(scale, 2.0), 10.0));
+    }
+}
+
+std::string hostName() {
+    char name[256] = {0};
+    gethostname(name, sizeof(name) - 1);
+    return name;
+}
+
+void writeJson(std::ostream& out, const char* executable, const std::vector<Result>& results) {
+    char date[64];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+
+    out << "{\n  \"context\": {\n"
+        << "    \"date\": \"" << date << "\",\n"
+        << "    \"host_name\": \"" << jsonEscape(hostName()) << "\",\n"
+        << "    \"executable\": \"" << jsonEscape(executable) << "\",\n"
+        << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#if defined(__aarch64__)
+        << "    \"arch\": \"aarch64\",\n"
+#elif defined(__x86_64__)
+        << "    \"arch\": \"x86_64\",\n"
+#else
+        << "    \"arch\": \"other\",\n"
+#endif
+        << "    \"git_revision\": \"" << BENCH_GIT_REVISION << "\",\n"
+        << "    \"library_build_type\": \"release\"\n"
+        << "  },\n  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << (i ? "," : "") << "\n    {\n"
+            << "      \"name\": \"" << jsonEscape(r.name) << "\",\n"
+            << "      \"run_name\": \"" << jsonEscape(r.name) << "\",\n"
+            << "      \"run_type\": \"iteration\",\n";
+        if (!r.error.empty()) {
+            out << "      \"error_occurred\": true,\n"
+                << "      \"error_message\": \"" << jsonEscape(r.error) << "\"\n    }";
+            continue;
+        }
+        out << std::setprecision(10)
+            << "      \"iterations\": " << r.iterations << ",\n"
+            << "      \"real_time\": " << r.real_ns << ",\n"
+            << "      \"cpu_time\": " << r.cpu_ns << ",\n"
+            << "      \"time_unit\": \"ns\"";
+        if (r.bytes_per_second > 0.0) {
+            out << ",\n      \"bytes_per_second\": " << r.bytes_per_second;
+        }
+        if (r.items_per_second > 0.0) {
+            out << ",\n      \"items_per_second\": " << r.items_per_second;
+        }
+        if (!r.label.empty()) {
+            out << ",\n      \"label\": \"" << jsonEscape(r.label) << "\"";
+        }
+        out << "\n    }";
+    }
+    out << "\n  ]\n}\n";
+}
+
+std::string humanRate(double value, const char* unit) {
+    const char* prefixes[] = {"", "k", "M", "G", "T"};
+    int index = 0;
+    while (value >= 1000.0 && index < 4) {
+        value /= 1000.0;
+        index++;
+    }
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2) << value << prefixes[index] << unit;
+    return out.str();
+}
+
+} // namespace
+
+int registerBenchmark(const std::string& name, Function function) {
+    registry().push_back({name, std::move(function)});
+    return 0;
+}
+
+} // namespace bench
+
+int main(int argc, char* argv[]) {
+    std::string filter;
+    std::string out_file;
+    double min_time = 0.5;
+    bool list_only = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--benchmark_filter=", 0) == 0) {
+            filter = arg.substr(19);
+        } else if (arg.rfind("--benchmark_min_time=", 0) == 0) {
+            min_time = std::stod(arg.substr(21));
+        } else if (arg.rfind("--benchmark_out=", 0) == 0) {
+            out_file = arg.substr(16);
+        } else if (arg == "--benchmark_list_tests") {
+            list_only = true;
+        } else {
+            std::cerr << "[ERROR] Unknown option: " << arg << std::endl;
+            return -1;
+        }
+    }
+
+    std::vector<bench::Result> results;
+    std::cout << std::left << std::setw(44) << "Benchmark" << std::right << std::setw(14) << "Time(ns)"
+              << std::setw(14) << "CPU(ns)" << std::setw(12) << "Iterations" << "  Rate" << std::endl;
+    for (const auto& entry : bench::registry()) {
+        if (!filter.empty() && entry.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        if (list_only) {
+            std::cout << entry.name << std::endl;
+            continue;
+        }
+
+        bench::Result result = bench::run(entry, min_time);
+        results.push_back(result);
+
+        std::cout << std::left << std::setw(44) << result.name << std::right;
+        if (!result.error.empty()) {
+            std::cout << "  SKIPPED: " << result.error << std::endl;
+            continue;
+        }
+        std::cout << std::fixed << std::setprecision(1) << std::setw(14) << result.real_ns << std::setw(14)
+                  << result.cpu_ns << std::setw(12) << result.iterations;
+        if (result.bytes_per_second > 0.0) {
+            std::cout << "  " << bench::humanRate(result.bytes_per_second, "B/s");
+        }
+        if (result.items_per_second > 0.0) {
+            std::cout << "  " << bench::humanRate(result.items_per_second, " items/s");
+        }
+        if (!result.label.empty()) {
+            std::cout << "  " << result.label;
+        }
+        std::cout << std::endl;
+    }
+
+    if (!out_file.empty() && !list_only) {
+        std::ofstream out(out_file);
+        if (!out.is_open()) {
+            std::cerr << "[ERROR] Could not write " << out_file << std::endl;
+            return -1;
+        }
+        bench::writeJson(out, argv[0], results);
+        std::cout << "[INFO] Results written to " << out_file << std::endl;
+    }
+    return 0;
+}
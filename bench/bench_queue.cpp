@@ -0,0 +1,179 @@
+#include "Benchmark.h"
+#include "BoundedQueue.h"
+#include "FrameData.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// 캡처 → 처리 스레드 간 프레임 전달 경로 (FrameData 값 복사 포함)
+// mutex: 이전 ThreadSafeQueue (비교 기준), spsc/mpmc: BoundedQueue.h
+
+namespace {
+
+// 이전 ThreadSafeQueue 와 같은 구현 (무제한, push 마다 lock + notify_one)
+template <typename T>
+class MutexQueue {
+private:
+    std::mutex mtx;
+    std::queue<T> data_queue;
+    std::condition_variable cv;
+
+public:
+    void push(T new_value) {
+        std::lock_guard<std::mutex> lock(mtx);
+        data_queue.push(std::move(new_value));
+        cv.notify_one();
+    }
+
+    bool pop(T& value) {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [this] { return !data_queue.empty(); });
+        value = std::move(data_queue.front());
+        data_queue.pop();
+        return true;
+    }
+};
+
+constexpr size_t kQueueCapacity = 1024;
+constexpr size_t kBatchSize = 16;
+
+uint64_t shareOf(uint64_t total, int producers, int p) {
+    return total / producers + (static_cast<uint64_t>(p) < total % producers ? 1 : 0);
+}
+
+// producers 개의 스레드가 나누어 push 하고 한 소비자가 모두 pop 할 때까지의 시간
+template <typename Queue>
+void runContended(bench::State& state, Queue& queue, int producers) {
+    const uint64_t total = state.maxIterations();
+
+    std::thread consumer([&queue, total]() {
+        FrameData out;
+        for (uint64_t i = 0; i < total; ++i) {
+            queue.pop(out);
+        }
+    });
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        uint64_t count = shareOf(total, producers, p);
+        threads.emplace_back([&queue, count, p]() {
+            FrameData frame = {};
+            for (uint64_t i = 0; i < count; ++i) {
+                frame.sequence = static_cast<uint32_t>(i * 8 + p);
+                queue.push(frame);
+            }
+        });
+    }
+
+    for (auto _ : state) {
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    consumer.join();
+    state.setItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+static void queuePushPopSingleThreadMutex(bench::State& state) {
+    MutexQueue<FrameData> queue;
+    FrameData frame = {};
+    FrameData out;
+    for (auto _ : state) {
+        queue.push(frame);
+        queue.pop(out);
+        bench::doNotOptimize(out);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK_NAMED("queuePushPopSingleThread/mutex", queuePushPopSingleThreadMutex);
+
+static void queuePushPopSingleThreadSpsc(bench::State& state) {
+    SpscQueue<FrameData> queue(kQueueCapacity);
+    FrameData frame = {};
+    FrameData out;
+    for (auto _ : state) {
+        queue.tryPush(frame);
+        queue.tryPop(out);
+        bench::doNotOptimize(out);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK_NAMED("queuePushPopSingleThread/spsc", queuePushPopSingleThreadSpsc);
+
+static void queuePushPopSingleThreadMpmc(bench::State& state) {
+    MpmcQueue<FrameData> queue(kQueueCapacity);
+    FrameData frame = {};
+    FrameData out;
+    for (auto _ : state) {
+        queue.tryPush(frame);
+        queue.tryPop(out);
+        bench::doNotOptimize(out);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK_NAMED("queuePushPopSingleThread/mpmc", queuePushPopSingleThreadMpmc);
+
+BENCHMARK_NAMED("queueContended/mutex/producers:1", [](bench::State& state) {
+    MutexQueue<FrameData> queue;
+    runContended(state, queue, 1);
+});
+BENCHMARK_NAMED("queueContended/mutex/producers:4", [](bench::State& state) {
+    MutexQueue<FrameData> queue;
+    runContended(state, queue, 4);
+});
+BENCHMARK_NAMED("queueContended/spsc/producers:1", [](bench::State& state) {
+    SpscQueue<FrameData> queue(kQueueCapacity);
+    runContended(state, queue, 1);
+});
+BENCHMARK_NAMED("queueContended/mpmc/producers:1", [](bench::State& state) {
+    MpmcQueue<FrameData> queue(kQueueCapacity);
+    runContended(state, queue, 1);
+});
+BENCHMARK_NAMED("queueContended/mpmc/producers:4", [](bench::State& state) {
+    MpmcQueue<FrameData> queue(kQueueCapacity);
+    runContended(state, queue, 4);
+});
+
+// 생산자/소비자 모두 kBatchSize 개씩 주고받음 (인덱스 갱신과 알림이 묶음당 한 번)
+static void queueContendedSpscBatch(bench::State& state) {
+    SpscQueue<FrameData> queue(kQueueCapacity);
+    const uint64_t total = state.maxIterations();
+
+    std::thread consumer([&queue, total]() {
+        FrameData out[kBatchSize];
+        uint64_t received = 0;
+        while (received < total) {
+            size_t n = queue.tryPopBatch(out, kBatchSize);
+            if (n == 0 && queue.pop(out[0])) {
+                n = 1;
+            }
+            received += n;
+        }
+    });
+
+    std::thread producer([&queue, total]() {
+        FrameData frames[kBatchSize] = {};
+        uint64_t sent = 0;
+        while (sent < total) {
+            size_t want = static_cast<size_t>(std::min<uint64_t>(kBatchSize, total - sent));
+            size_t n = queue.tryPushBatch(frames, want);
+            if (n == 0) {
+                queue.push(frames[0]);
+                n = 1;
+            }
+            sent += n;
+        }
+    });
+
+    for (auto _ : state) {
+    }
+    producer.join();
+    consumer.join();
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK_NAMED("queueContended/spsc_batch16/producers:1", queueContendedSpscBatch);
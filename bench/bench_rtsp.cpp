@@ -0,0 +1,83 @@
+#include "Benchmark.h"
+#include "ConfigManager.h"
+#include "FrameData.h"
+#include "RtspStreamer.h"
+
+#include <time.h>
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+// gst_deinit 후에는 다시 초기화할 수 없으므로 스트리머는 프로세스 끝까지 유지
+RtspStreamer& streamer() {
+    static RtspStreamer* instance = []() {
+        bench::QuietStdout quiet;
+        VideoConfig video = {1920, 1080, 30, "BGR888", 8, false, 640, 480, "YUV420"};
+        RtspConfig rtsp = {8554, "/stream", 2000000, "", "", false, false, "", "", 0, 0, 1, ""};
+        EncoderConfig encoder = {"", 64};
+        return new RtspStreamer(video, rtsp, encoder);
+    }();
+    return *instance;
+}
+
+uint64_t bootTimeNs() {
+    timespec ts;
+    clock_gettime(CLOCK_BOOTTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+// appsrc ! fakesink 파이프라인에 pushFrame 을 반복 (인코더 없이 래핑/메타/PTS/push 비용만 측정)
+// fakesink 는 GstVideoMeta 를 제안하지 않으므로 stride 가 패딩된 경우 재배치 경로를 탐
+void pushFrame(bench::State& state, int width, int height, int stride) {
+    RtspStreamer& rtsp = streamer();
+    rtsp.setStreamSize(width, height);
+
+    GError* error = nullptr;
+    GstElement* pipeline = gst_parse_launch("appsrc name=mysrc ! fakesink sync=false", &error);
+    if (error) {
+        g_error_free(error);
+    }
+    if (!pipeline) {
+        state.skipWithError("could not create appsrc ! fakesink pipeline");
+        return;
+    }
+
+    bench::QuietStdout quiet;
+    if (!rtsp.attachPipeline(pipeline)) {
+        gst_object_unref(pipeline);
+        state.skipWithError("attachPipeline failed");
+        return;
+    }
+    gst_element_set_state(pipeline, GST_STATE_PLAYING);
+    gst_element_get_state(pipeline, nullptr, nullptr, GST_CLOCK_TIME_NONE);
+
+    std::vector<uint8_t> pixels(static_cast<size_t>(stride) * height, 128);
+    FrameData frame = {};
+    frame.data = pixels.data();
+    frame.size = pixels.size();
+    frame.width = width;
+    frame.height = height;
+    frame.num_planes = 1;
+    frame.strides[0] = stride;
+    frame.duration_ns = 33333333;
+
+    for (auto _ : state) {
+        frame.sequence++;
+        frame.timestamp_ns = bootTimeNs();
+        rtsp.pushFrame(frame);
+    }
+
+    rtsp.stop();
+    gst_element_set_state(pipeline, GST_STATE_NULL);
+    gst_object_unref(pipeline);
+    state.setBytesProcessed(static_cast<int64_t>(state.iterations() * pixels.size()));
+    state.setItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+} // namespace
+
+BENCHMARK_NAMED("pushFrame/BGR888/1920x1080/packed", [](bench::State& s) { pushFrame(s, 1920, 1080, 1920 * 3); });
+BENCHMARK_NAMED("pushFrame/BGR888/1920x1080/padded", [](bench::State& s) { pushFrame(s, 1920, 1080, 5824); });
+BENCHMARK_NAMED("pushFrame/BGR888/1280x720/packed", [](bench::State& s) { pushFrame(s, 1280, 720, 1280 * 3); });
@@ -1,24 +1,67 @@
 #include "main.h"
+#include "StartupTimeline.h"
+#include "FrameTracer.h"
+#include "Logger.h"
 #include <iostream>
+#include <future>
 #include <thread>
 #include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
 
 using namespace std::chrono;
 using namespace std::literals::chrono_literals;
 
+namespace {
+
+// 해상도 변경으로 영상이 끊긴 시간 (초)
+const std::vector<double> kReconfigureBuckets = {0.1, 0.25, 0.5, 1.0, 2.0, 5.0};
+
+bool parsePositive(const std::string& text, int& value) {
+    char extra;
+    return sscanf(text.c_str(), "%d%c", &value, &extra) == 1 && value > 0;
+}
+
+bool parseSize(const std::string& text, int& width, int& height) {
+    char extra;
+    return sscanf(text.c_str(), "%dx%d%c", &width, &height, &extra) == 2 && width > 0 && height > 0;
+}
+
+} // namespace
+
 // 전역 변수 정의
 std::atomic<bool> g_should_exit{false};
+std::atomic<int> g_exit_signal{0};
+std::atomic<bool> g_reload_requested{false};
 CameraStreamerApp* g_app_instance = nullptr;
 
 void globalSignalHandler(int signal) {
-    std::cout << "\n[INFO] Signal " << signal << " received. Exiting gracefully..." << std::endl;
+    // async-signal-safe 한 원자 변수 저장만 수행하고, 출력과 정지는 주 루프(run)에서 처리
+    g_exit_signal.store(signal);
     g_should_exit.store(true);
-    if (g_app_instance) {
-        g_app_instance->signalHandler(signal);
-    }
 }
 
-CameraStreamerApp::CameraStreamerApp() : should_exit_(false), frame_count_(0) {
+void traceSignalHandler(int signal) {
+    // 시그널 핸들러에서는 플래그만 세우고 파일 기록은 주 루프에서 수행
+    FrameTracer::instance().requestDump();
+}
+
+void reloadSignalHandler(int signal) {
+    // 설정 파일 읽기와 재구성은 주 루프에서 수행
+    g_reload_requested.store(true);
+}
+
+CameraStreamerApp::CameraStreamerApp()
+    : motion_stage_(nullptr), inference_interval_factor_(1), last_track_count_(0),
+      live_width_(0), live_height_(0), live_fps_(0), live_bitrate_(0), fps_degraded_(false), bitrate_degraded_(false),
+      reconfigure_gap_(MetricsRegistry::instance().histogram(
+          "camstream_reconfigure_gap_seconds",
+          "Time between the last encoded unit before a resolution change and the first one after",
+          kReconfigureBuckets)),
+      reconfigurations_(MetricsRegistry::instance().counter("camstream_reconfigurations_total",
+                                                            "Runtime resolution changes")),
+      pending_reconfigure_{false, 0, 0, 0, ""}, should_exit_(false), frame_count_(0) {
 }
 
 CameraStreamerApp::~CameraStreamerApp() {
@@ -29,53 +72,364 @@ bool CameraStreamerApp::initialize(const std::string& config_file) {
     std::cout << "[INFO] Initializing CameraStreamerApp..." << std::endl;
     
     // 설정 로드
-    config_manager_ = std::make_unique<ConfigManager>();
-    if (!config_manager_->loadFromFile(config_file)) {
-        std::cerr << "[WARN] Failed to load config file, using default settings" << std::endl;
+    {
+        StartupTimeline::Scope scope("config_load");
+        config_manager_ = std::make_unique<ConfigManager>();
+        if (!config_manager_->loadFromFile(config_file)) {
+            std::cerr << "[WARN] Failed to load config file, using default settings" << std::endl;
+        }
     }
     config_manager_->printConfig();
+    Logger::instance().start(config_manager_->getLoggingConfig());
+    FrameTracer::instance().configure(config_manager_->getTracingConfig());
+    // 캡처 버퍼 매핑과 검출기 텐서 할당보다 먼저 arena 예약과 mlockall 을 수행
+    MemoryResidency::instance().configure(config_manager_->getMemoryConfig());
     
-    // 카메라 캡처 초기화
-    camera_capture_ = std::make_unique<ZeroCopyCapture>(config_manager_->getVideoConfig());
-    if (!camera_capture_->initialize()) {
+    // 카메라, GStreamer/RTSP, 모델 컴파일은 서로 의존하지 않으므로 병렬로 초기화하고
+    // 캡처 스트림 크기가 필요한 단계(모션/검출기 configure)만 합류 후에 진행
+    InferenceConfig inference_config = config_manager_->getInferenceConfig();
+    const TrackerConfig& tracker_config = config_manager_->getTrackerConfig();
+    if (inference_config.enabled && tracker_config.enabled) {
+        // 추적기의 2차 매칭에 낮은 점수 검출도 필요함
+        inference_config.conf_threshold = std::min(inference_config.conf_threshold, tracker_config.low_threshold);
+    }
+
+    // 재생 모드: 기록된 파일이 카메라를 대신하고 인코더 입력 caps 는 기록된 형식을 따름
+    VideoConfig stream_video_config = config_manager_->getVideoConfig();
+    if (config_manager_->getReplayConfig().enabled) {
+        replay_ = std::make_unique<RawReplay>(config_manager_->getReplayConfig());
+        if (!replay_->initialize()) {
+            std::cerr << "[ERROR] Failed to open replay file" << std::endl;
+            return false;
+        }
+        stream_video_config.width = replay_->getWidth();
+        stream_video_config.height = replay_->getHeight();
+        stream_video_config.pixel_format = replay_->getPixelFormat();
+        stream_video_config.fps = replay_->getFrameRate();
+    }
+    config_file_ = config_file;
+    live_width_ = stream_video_config.width;
+    live_height_ = stream_video_config.height;
+    live_fps_ = stream_video_config.fps;
+    live_bitrate_ = config_manager_->getRtspConfig().bitrate;
+
+    std::future<bool> camera_init;
+    if (!replay_) {
+        camera_init = std::async(std::launch::async, [this]() {
+            camera_capture_ = std::make_unique<ZeroCopyCapture>(config_manager_->getVideoConfig());
+            return camera_capture_->initialize();
+        });
+    }
+    auto streamer_init = std::async(std::launch::async, [this, stream_video_config]() {
+        rtsp_streamer_ = std::make_unique<RtspStreamer>(
+            stream_video_config,
+            config_manager_->getRtspConfig(),
+            config_manager_->getEncoderConfig()
+        );
+        return rtsp_streamer_->preloadPipeline();
+    });
+    std::future<bool> detector_init;
+    if (inference_config.enabled) {
+        detector_init = std::async(std::launch::async, [this, inference_config]() {
+            object_detector_ = std::make_unique<ObjectDetector>(inference_config);
+            return object_detector_->initialize();
+        });
+    }
+
+    // std::async 의 future 는 소멸 시 작업 완료를 기다리므로 get() 에서 예외가 나도 작업 스레드가 남지 않음
+    bool camera_ok = !camera_init.valid() || camera_init.get();
+    if (!streamer_init.get()) {
+        std::cerr << "[WARN] Pipeline preload failed, plugins will load on first client" << std::endl;
+    }
+    bool detector_ok = detector_init.valid() && detector_init.get();
+
+    if (!camera_ok) {
         std::cerr << "[ERROR] Failed to initialize camera capture" << std::endl;
         return false;
     }
     
-    // RTSP 스트리머 초기화
-    rtsp_streamer_ = std::make_unique<RtspStreamer>(
-        config_manager_->getVideoConfig(), 
-        config_manager_->getRtspConfig()
-    );
+    if (replay_) {
+        rtsp_streamer_->setStreamSize(replay_->getWidth(), replay_->getHeight());
+    } else {
+        rtsp_streamer_->setStreamSize(camera_capture_->getWidth(), camera_capture_->getHeight());
+    }
     
-    // 프레임 콜백 설정
-    camera_capture_->setFrameCallback(
-        [this](const FrameData& frame_data) {
-            onFrameReceived(frame_data);
+    // 모션 검출기와 객체 검출기는 그래프 단계가 만들어질 때 입력 형식으로 configure 됨
+    if (config_manager_->getMotionConfig().enabled) {
+        motion_detector_ = std::make_unique<MotionDetector>(config_manager_->getMotionConfig());
+    }
+    if (object_detector_ && !detector_ok) {
+        std::cerr << "[WARN] Object detector disabled" << std::endl;
+        object_detector_.reset();
+    }
+    if (object_detector_) {
+        if (tracker_config.enabled) {
+            object_tracker_ = std::make_unique<ObjectTracker>(tracker_config);
         }
-    );
+        object_detector_->setDetectionCallback(
+            [this](const std::vector<Detection>& detections) {
+                onDetections(detections);
+            }
+        );
+    }
+    
+    if (!buildGraph()) {
+        std::cerr << "[ERROR] Failed to build processing graph" << std::endl;
+        return false;
+    }
+    
+    if (config_manager_->getMetricsConfig().enabled) {
+        metrics_server_ = std::make_unique<MetricsServer>(config_manager_->getMetricsConfig());
+    }
+    if (config_manager_->getControlConfig().enabled) {
+        control_server_ = std::make_unique<ControlServer>(config_manager_->getControlConfig());
+    }
+    
+    // 캡처 요청은 그래프의 마지막 참조가 놓일 때 다시 큐에 들어감
+    auto frame_sink = [this](const FrameRef& frame, const FrameRef& analytics) {
+        onFrameReceived(frame, analytics);
+    };
+    if (replay_) {
+        replay_->setFrameSink(frame_sink);
+    } else {
+        camera_capture_->setFrameSink(frame_sink);
+    }
     
     std::cout << "[INFO] CameraStreamerApp initialized successfully" << std::endl;
     return true;
 }
 
+bool CameraStreamerApp::buildGraph() {
+    graph_ = std::make_unique<ProcessingGraph>(config_manager_->getGraphConfig());
+    const VideoConfig& video_config = config_manager_->getVideoConfig();
+    
+    // 분석 소스는 보조 스트림이 있으면 그 작은 버퍼를, 없으면 메인 프레임을 그대로 읽음
+    // (재생 파일에는 기록한 스트림 하나만 있으므로 분석 소스도 같은 프레임을 읽음)
+    StreamFormat main_format = replay_
+        ? StreamFormat{replay_->getWidth(), replay_->getHeight(), replay_->getStride(), replay_->getPixelFormat()}
+        : StreamFormat{camera_capture_->getWidth(), camera_capture_->getHeight(), camera_capture_->getStride(),
+                       video_config.pixel_format};
+    StreamFormat analytics_format = main_format;
+    if (camera_capture_ && camera_capture_->hasAnalyticsStream()) {
+        analytics_format = {camera_capture_->getAnalyticsWidth(), camera_capture_->getAnalyticsHeight(),
+                            camera_capture_->getAnalyticsStride(), video_config.analytics_pixel_format};
+    }
+    
+    // 단계 생성 함수는 build() 안에서 상류부터 순서대로 호출됨
+    std::vector<std::string> main_names;
+    std::vector<std::string> analytics_names;
+    bool detector_configured = false;
+    bool tracker_attached = false;
+    int privacy_stages = 0;
+    bool privacy_failed = false;
+    int record_stages = 0;
+    
+    graph_->registerType("camera",
+        [&, main_format, analytics_format](const StageConfig& config, const StreamFormat&) -> std::unique_ptr<GraphStage> {
+            bool analytics = config.stream == "analytics";
+            if (!analytics && config.stream != "main") {
+                std::cerr << "[WARN] Unknown camera stream '" << config.stream << "', using main" << std::endl;
+            }
+            (analytics ? analytics_names : main_names).push_back(config.name);
+            return std::make_unique<CameraSourceStage>(analytics ? analytics_format : main_format);
+        });
+    graph_->registerType("rtsp",
+        [this, main_format](const StageConfig& config, const StreamFormat& input) -> std::unique_ptr<GraphStage> {
+            // appsrc caps 는 메인 스트림 기준이므로 크기나 형식이 바뀐 프레임은 받을 수 없음
+            if (input.width != main_format.width || input.height != main_format.height ||
+                input.pixel_format != main_format.pixel_format) {
+                std::cerr << "[WARN] RTSP stage '" << config.name << "' must read full-size camera frames" << std::endl;
+                return nullptr;
+            }
+            return std::make_unique<RtspSinkStage>(rtsp_streamer_.get());
+        });
+    graph_->registerType("privacy",
+        [this, &privacy_stages, &privacy_failed](const StageConfig& config,
+                                                 const StreamFormat& input) -> std::unique_ptr<GraphStage> {
+            const PrivacyConfig& privacy_config = config_manager_->getPrivacyConfig();
+            if (!privacy_config.enabled || privacy_config.regions.empty()) {
+                return nullptr;
+            }
+            // 제자리에서 가리면 같은 캡처 버퍼를 읽는 단계가 반쯤 가린 픽셀을 보게 되므로 그때는 사본을 가림
+            // - 같은 입력을 읽는 다른 단계가 있거나
+            // - 보조 스트림이 없어 분석 소스가 메인 프레임 버퍼를 그대로 받는 경우 (재생 포함)
+            bool analytics_stream = camera_capture_ && camera_capture_->hasAnalyticsStream();
+            std::string shared_with;
+            for (const StageConfig& other : config_manager_->getGraphConfig().stages) {
+                if (other.name != config.name && other.input == config.input) {
+                    shared_with = other.name;
+                } else if (!analytics_stream && other.type == "camera" && other.stream == "analytics") {
+                    shared_with = other.name;
+                }
+            }
+            if (!shared_with.empty()) {
+                std::cout << "[INFO] Privacy stage '" << config.name << "' masks a copy of each frame because '"
+                          << shared_with << "' reads the same capture buffer" << std::endl;
+            }
+            auto stage = std::make_unique<PrivacyStage>(privacy_config, !shared_with.empty());
+            if (!stage->configure(input)) {
+                privacy_failed = true;
+                return nullptr;
+            }
+            privacy_stages++;
+            return stage;
+        });
+    graph_->registerType("pacer",
+        [this](const StageConfig& config, const StreamFormat&) -> std::unique_ptr<GraphStage> {
+            if (!config_manager_->getPacingConfig().enabled) {
+                return nullptr;
+            }
+            auto stage = std::make_unique<PacerStage>(config_manager_->getPacingConfig(), config.name, live_fps_);
+            pacer_stages_.push_back(stage.get());
+            return stage;
+        });
+    graph_->registerType("record",
+        [this, &record_stages](const StageConfig& config, const StreamFormat& input) -> std::unique_ptr<GraphStage> {
+            const RecordingConfig& recording_config = config_manager_->getRecordingConfig();
+            if (!recording_config.enabled) {
+                return nullptr;
+            }
+            // 파일 하나에 형식 하나이므로 첫 record 단계만 기록
+            if (record_stages > 0) {
+                std::cerr << "[WARN] Record stage '" << config.name << "' bypassed, only one stage can write "
+                          << recording_config.path << std::endl;
+                return nullptr;
+            }
+            // 재생 중인 파일을 O_TRUNC 로 다시 열면 매핑된 페이지 접근이 SIGBUS 로 끝남
+            const ReplayConfig& replay_config = config_manager_->getReplayConfig();
+            if (replay_config.enabled && replay_config.path == recording_config.path) {
+                std::cerr << "[WARN] Record stage '" << config.name << "' bypassed, it would overwrite the replayed file"
+                          << std::endl;
+                return nullptr;
+            }
+            record_stages++;
+            return std::make_unique<RecordStage>(recording_config, input.pixel_format,
+                                                 config_manager_->getVideoConfig().fps);
+        });
+    graph_->registerType("motion",
+        [this](const StageConfig&, const StreamFormat& input) -> std::unique_ptr<GraphStage> {
+            if (!motion_detector_ || motion_stage_) {
+                return nullptr;
+            }
+            if (!motion_detector_->configure(input.width, input.height, input.stride, input.pixel_format)) {
+                std::cerr << "[WARN] Motion detector disabled" << std::endl;
+                return nullptr;
+            }
+            auto stage = std::make_unique<MotionStage>(motion_detector_.get());
+            motion_stage_ = stage.get();
+            return stage;
+        });
+    graph_->registerType("detector",
+        [this, &detector_configured](const StageConfig&, const StreamFormat& input) -> std::unique_ptr<GraphStage> {
+            if (!object_detector_ || detector_configured) {
+                return nullptr;
+            }
+            // 객체 검출기 구성 (실패해도 스트리밍은 계속)
+            if (!object_detector_->configure(input.width, input.height, input.stride, input.pixel_format)) {
+                return nullptr;
+            }
+            detector_configured = true;
+            // 모션이 없을 때의 추론 간격 (keep-alive)
+            double keepalive_fps = config_manager_->getMotionConfig().keepalive_fps;
+            steady_clock::duration keepalive = keepalive_fps > 0.0
+                ? duration_cast<steady_clock::duration>(duration<double>(1.0 / keepalive_fps))
+                : steady_clock::duration::max();
+            return std::make_unique<DetectorStage>(object_detector_.get(), motion_stage_,
+                                                   config_manager_->getInferenceConfig().frame_interval,
+                                                   inference_interval_factor_, keepalive);
+        });
+    graph_->registerType("tracker",
+        [this, &tracker_attached](const StageConfig&, const StreamFormat&) -> std::unique_ptr<GraphStage> {
+            if (!object_tracker_ || tracker_attached) {
+                return nullptr;
+            }
+            tracker_attached = true;
+            return std::make_unique<TrackerStage>(object_tracker_.get());
+        });
+    graph_->registerType("scale",
+        [](const StageConfig& config, const StreamFormat& input) -> std::unique_ptr<GraphStage> {
+            auto stage = std::make_unique<ScaleStage>(config.width, config.height);
+            if (!stage->configure(input)) {
+                return nullptr;
+            }
+            return stage;
+        });
+    
+    if (!graph_->build()) {
+        return false;
+    }
+    // 마스크를 적용할 수 없으면 가리지 않은 영상을 내보내지 않도록 시작하지 않음
+    if (privacy_failed) {
+        std::cerr << "[ERROR] Privacy mask could not be configured" << std::endl;
+        return false;
+    }
+    if (config_manager_->getPrivacyConfig().enabled && privacy_stages == 0) {
+        std::cerr << "[WARN] Privacy masking is enabled but the graph has no privacy stage" << std::endl;
+    }
+    if (config_manager_->getRecordingConfig().enabled && record_stages == 0) {
+        std::cerr << "[WARN] Recording is enabled but the graph has no record stage" << std::endl;
+    }
+    if (object_detector_ && !detector_configured) {
+        std::cerr << "[WARN] Object detector disabled" << std::endl;
+        object_detector_.reset();
+    }
+    for (const std::string& name : main_names) {
+        main_sources_.push_back(graph_->find(name));
+    }
+    for (const std::string& name : analytics_names) {
+        analytics_sources_.push_back(graph_->find(name));
+    }
+    return true;
+}
+
 bool CameraStreamerApp::start() {
     std::cout << "[INFO] Starting CameraStreamerApp..." << std::endl;
     
     // RTSP 서버 시작
-    if (!rtsp_streamer_->start()) {
-        std::cerr << "[ERROR] Failed to start RTSP streamer" << std::endl;
+    {
+        StartupTimeline::Scope scope("rtsp_server_start");
+        if (!rtsp_streamer_->start()) {
+            std::cerr << "[ERROR] Failed to start RTSP streamer" << std::endl;
+            return false;
+        }
+    }
+    
+    // 메트릭 엔드포인트는 실패해도 스트리밍은 계속
+    if (metrics_server_ && !metrics_server_->start()) {
+        std::cerr << "[WARN] Metrics endpoint disabled" << std::endl;
+        metrics_server_.reset();
+    }
+    // 제어 소켓이 없어도 SIGHUP 으로 설정을 다시 읽을 수 있음
+    if (control_server_ && !control_server_->start()) {
+        std::cerr << "[WARN] Control socket disabled" << std::endl;
+        control_server_.reset();
+    }
+    
+    if (object_detector_ && !object_detector_->start()) {
+        std::cerr << "[ERROR] Failed to start object detector" << std::endl;
         return false;
     }
     
-    // 카메라 캡처 시작
-    if (!camera_capture_->start()) {
-        std::cerr << "[ERROR] Failed to start camera capture" << std::endl;
+    if (!graph_->start()) {
+        std::cerr << "[ERROR] Failed to start processing graph" << std::endl;
         return false;
     }
     
+    // 카메라 캡처 (또는 재생) 시작
+    {
+        StartupTimeline::Scope scope("camera_start");
+        if (replay_ ? !replay_->start() : !camera_capture_->start()) {
+            std::cerr << "[ERROR] Failed to start camera capture" << std::endl;
+            return false;
+        }
+    }
+    
+    setupWatchdog();
+    setupGovernor();
+    
     should_exit_.store(false);
     std::cout << "[INFO] CameraStreamerApp started successfully" << std::endl;
+    StartupTimeline::instance().print();
     return true;
 }
 
@@ -87,41 +441,457 @@ void CameraStreamerApp::stop() {
     if (camera_capture_) {
         camera_capture_->stop();
     }
+    if (replay_) {
+        replay_->stop();
+    }
+    
+    // 카메라가 멈춘 뒤 그래프를 멈춰야 놓인 요청이 다시 큐에 들어가지 않음
+    if (graph_) {
+        graph_->stop();
+        graph_->printStats();
+    }
+    
+    if (object_detector_) {
+        object_detector_->stop();
+    }
     
     if (rtsp_streamer_) {
         rtsp_streamer_->stop();
     }
     
+    if (metrics_server_) {
+        metrics_server_->stop();
+    }
+    
+    if (control_server_) {
+        control_server_->stop();
+    }
+    
     std::cout << "[INFO] CameraStreamerApp stopped" << std::endl;
+    
+    // 모든 작업 스레드가 멈춘 뒤 남은 로그를 비움
+    Logger::instance().stop();
+}
+
+void CameraStreamerApp::setupWatchdog() {
+    const WatchdogConfig& config = config_manager_->getWatchdogConfig();
+    if (!config.enabled) {
+        return;
+    }
+    // 재생 중에는 복구할 카메라가 없고, 재생이 끝나 프레임이 멈추는 것도 정상
+    if (!camera_capture_) {
+        std::cout << "[INFO] Stall watchdog disabled during replay" << std::endl;
+        return;
+    }
+    watchdog_ = std::make_unique<StallWatchdog>();
+    ZeroCopyCapture* capture = camera_capture_.get();
+    RtspStreamer* streamer = rtsp_streamer_.get();
+    uint64_t media_timeout_ns = static_cast<uint64_t>(config.media_timeout_ms) * 1000000ULL;
+
+    // 카메라: 먼저 요청을 다시 큐에 넣고, 그래도 멈춰 있으면 버퍼를 새로 잡아 다시 configure
+    watchdog_->addStage("capture", capture->heartbeat(), config.capture_timeout_ms,
+        [capture]() { return capture->isRunning(); },
+        [capture, streamer](int attempt) {
+            if (attempt == 1) {
+                return capture->restart();
+            }
+            // 이전 매핑을 가리키는 프레임이 하류에 남지 않도록 인코딩 체인을 먼저 비움
+            if (streamer->isMediaPlaying()) {
+                streamer->resetMediaChain();
+            }
+            return capture->reconfigure();
+        });
+
+    // 미디어: 카메라는 프레임을 내는데 appsrc 가 받지 않거나, push 는 되는데 인코더 출력이 없을 때
+    // RTSP 서버와 세션, AU 버스는 두고 인코딩 파이프라인의 appsrc~encsink 사이만 다시 시작
+    watchdog_->addStage("push", streamer->pushHeartbeat(), config.media_timeout_ms,
+        [capture, streamer, media_timeout_ns]() {
+            return streamer->isMediaPlaying() && capture->heartbeat().beatWithin(media_timeout_ns);
+        },
+        [streamer](int) { return streamer->resetMediaChain(); });
+    watchdog_->addStage("encode", streamer->encodeHeartbeat(), config.media_timeout_ms,
+        [streamer, media_timeout_ns]() {
+            return streamer->isMediaPlaying() && streamer->pushHeartbeat().beatWithin(media_timeout_ns);
+        },
+        [streamer](int) { return streamer->resetMediaChain(); });
+
+    std::cout << "[INFO] Stall watchdog enabled (capture " << config.capture_timeout_ms << " ms, media "
+              << config.media_timeout_ms << " ms)" << std::endl;
+}
+
+void CameraStreamerApp::setupGovernor() {
+    const GovernorConfig& config = config_manager_->getGovernorConfig();
+    if (!config.enabled) {
+        return;
+    }
+    governor_ = std::make_unique<QualityGovernor>(config);
+
+    // 비용이 작은 것(검출 주기)부터 시청자에게 보이는 것(fps, 비트레이트, 해상도) 순으로 ladder 에서 사용
+    if (object_detector_) {
+        int factor = std::max(config.inference_interval_factor, 1);
+        governor_->setAction("inference", [this, factor](bool degraded) {
+            inference_interval_factor_.store(degraded ? factor : 1);
+            return true;
+        });
+    }
+    // 재생 중에는 카메라 fps 를 바꿀 수 없음
+    // 회복할 때는 시작 값이 아니라 실행 중 바뀐 설정 값(live_fps_, live_bitrate_)으로 돌아감
+    if (camera_capture_) {
+        governor_->setAction("fps", [this](bool degraded) {
+            fps_degraded_ = degraded;
+            applyFrameRate();
+            return true;
+        });
+    }
+    governor_->setAction("bitrate", [this](bool degraded) {
+        bitrate_degraded_ = degraded;
+        return rtsp_streamer_->setBitrate(currentBitrate());
+    });
+    governor_->setAction("resolution", [this, width = config.degraded_width, height = config.degraded_height](bool degraded) {
+        return rtsp_streamer_->setOutputResolution(degraded ? width : 0, degraded ? height : 0);
+    });
+
+    if (!governor_->start()) {
+        std::cerr << "[WARN] Quality governor disabled (no readable sensor or ladder step)" << std::endl;
+        governor_.reset();
+    }
+}
+
+void CameraStreamerApp::applyFrameRate() {
+    if (!camera_capture_) {
+        return;
+    }
+    int fps = fps_degraded_ ? std::min(live_fps_, config_manager_->getGovernorConfig().degraded_fps) : live_fps_;
+    camera_capture_->setFrameRate(fps);
+    // pacing.fps 를 따로 정했으면 그 주기를 유지 (반복/버림으로 맞춤)
+    if (config_manager_->getPacingConfig().fps <= 0) {
+        for (PacerStage* pacer : pacer_stages_) {
+            pacer->setFrameRate(fps);
+        }
+    }
+}
+
+int CameraStreamerApp::currentBitrate() const {
+    if (!bitrate_degraded_) {
+        return live_bitrate_;
+    }
+    int reduced = config_manager_->getGovernorConfig().degraded_bitrate;
+    return live_bitrate_ > 0 ? std::min(live_bitrate_, reduced) : reduced;
+}
+
+std::string CameraStreamerApp::handleControlCommand(const std::string& command) {
+    std::istringstream in(command);
+    std::string verb;
+    std::string key;
+    std::string value;
+    in >> verb >> key >> value;
+
+    std::string message;
+    bool ok = false;
+    int width = 0;
+    int height = 0;
+    int number = 0;
+    if (verb == "status") {
+        std::ostringstream status;
+        status << "resolution=" << (camera_capture_ ? camera_capture_->getWidth() : live_width_) << "x"
+               << (camera_capture_ ? camera_capture_->getHeight() : live_height_) << " fps=" << live_fps_
+               << " bitrate=" << live_bitrate_ << " governor_level=" << (governor_ ? governor_->level() : 0);
+        message = status.str();
+        ok = true;
+    } else if (verb == "reload") {
+        ok = reloadConfig(message);
+    } else if (verb == "set" && key == "fps" && parsePositive(value, number)) {
+        ok = changeFrameRate(number, message);
+    } else if (verb == "set" && key == "bitrate" && parsePositive(value, number)) {
+        ok = changeBitrate(number, message);
+    } else if (verb == "set" && key == "resolution" && parseSize(value, width, height)) {
+        ok = changeResolution(width, height, message);
+    } else {
+        message = "usage: status | reload | set fps <n> | set bitrate <bps> | set resolution <w>x<h>";
+    }
+
+    if (verb != "status") {
+        LOG_INFO("app") << "Control command '" << command << "': " << (ok ? "" : "failed, ") << message;
+    }
+    return (ok ? "OK " : "ERROR ") + message;
+}
+
+bool CameraStreamerApp::reloadConfig(std::string& message) {
+    ConfigManager reloaded;
+    if (!reloaded.loadFromFile(config_file_)) {
+        message = "cannot load " + config_file_;
+        return false;
+    }
+
+    // 실행 중 바꿀 수 있는 값만 적용하고 나머지 설정은 다시 시작할 때 반영됨
+    std::vector<std::string> results;
+    bool ok = true;
+    auto apply = [&](bool success, const std::string& result) {
+        ok = ok && success;
+        results.push_back(result);
+    };
+    const VideoConfig& video = reloaded.getVideoConfig();
+    std::string result;
+    if (camera_capture_ && (video.width != live_width_ || video.height != live_height_)) {
+        apply(changeResolution(video.width, video.height, result), result);
+    }
+    if (camera_capture_ && video.fps != live_fps_) {
+        apply(changeFrameRate(video.fps, result), result);
+    }
+    if (reloaded.getRtspConfig().bitrate != live_bitrate_) {
+        apply(changeBitrate(reloaded.getRtspConfig().bitrate, result), result);
+    }
+
+    if (results.empty()) {
+        message = "no runtime setting changed";
+    }
+    for (const std::string& item : results) {
+        message += (message.empty() ? "" : "; ") + item;
+    }
+    return ok;
+}
+
+bool CameraStreamerApp::changeFrameRate(int fps, std::string& message) {
+    if (!camera_capture_) {
+        message = "fps cannot change during replay";
+        return false;
+    }
+    if (fps <= 0) {
+        message = "fps must be positive";
+        return false;
+    }
+    // 센서 프레임 시간만 바꾸므로 다음 요청부터 끊김 없이 적용됨
+    live_fps_ = fps;
+    applyFrameRate();
+    message = "fps " + std::to_string(fps);
+    if (fps_degraded_) {
+        message += " (quality governor keeps it reduced until recovery)";
+    }
+    return true;
+}
+
+bool CameraStreamerApp::changeBitrate(int bitrate, std::string& message) {
+    if (bitrate <= 0) {
+        message = "bitrate must be positive";
+        return false;
+    }
+    live_bitrate_ = bitrate;
+    if (!rtsp_streamer_->setBitrate(currentBitrate())) {
+        message = "no encoder accepted bitrate " + std::to_string(bitrate);
+        return false;
+    }
+    message = "bitrate " + std::to_string(bitrate);
+    if (bitrate_degraded_) {
+        message += " (quality governor keeps it reduced until recovery)";
+    }
+    return true;
+}
+
+bool CameraStreamerApp::changeResolution(int width, int height, std::string& message) {
+    if (!camera_capture_) {
+        message = "resolution cannot change during replay";
+        return false;
+    }
+    // 기록 파일 하나에는 형식 하나만 들어감
+    if (config_manager_->getRecordingConfig().enabled) {
+        message = "resolution cannot change while recording";
+        return false;
+    }
+    int previous_width = camera_capture_->getWidth();
+    int previous_height = camera_capture_->getHeight();
+    if (width == previous_width && height == previous_height) {
+        live_width_ = width;
+        live_height_ = height;
+        message = "resolution unchanged";
+        return true;
+    }
+    LOG_INFO("app") << "Changing resolution from " << previous_width << "x" << previous_height << " to " << width
+                    << "x" << height;
+    auto begin = steady_clock::now();
+    uint64_t begin_ns = Heartbeat::nowNs();
+
+    // 카메라를 먼저 멈춰야 그래프가 놓은 요청이 다시 큐에 들어가지 않음 (stop() 과 같은 순서)
+    camera_capture_->stop();
+    graph_->stop();
+    // 인코딩 체인을 새 caps 로 다시 시작하면서 체인이 잡고 있던 캡처 버퍼를 놓음 (RTSP 세션은 그대로)
+    rtsp_streamer_->setInputSize(width, height);
+    uint64_t last_unit_ns = rtsp_streamer_->encodeHeartbeat().lastNs();
+    auto stopped = steady_clock::now();
+
+    bool changed = camera_capture_->setResolution(width, height);
+    // 센서가 크기를 조정했거나 이전 크기로 되돌아갔으면 caps 를 실제 크기로 맞춤
+    if (camera_capture_->getWidth() != width || camera_capture_->getHeight() != height) {
+        rtsp_streamer_->setInputSize(camera_capture_->getWidth(), camera_capture_->getHeight());
+    }
+    auto configured = steady_clock::now();
+
+    // 단계들이 입력 크기로 configure 되므로 그래프를 새로 만들고, 새 크기로 만들 수 없으면 이전 크기로 되돌림
+    bool graph_ok = rebuildGraph();
+    if (!graph_ok && changed) {
+        LOG_ERROR("app") << "Processing graph cannot run at " << camera_capture_->getWidth() << "x"
+                         << camera_capture_->getHeight() << ", restoring " << previous_width << "x" << previous_height;
+        changed = false;
+        camera_capture_->setResolution(previous_width, previous_height);
+        rtsp_streamer_->setInputSize(camera_capture_->getWidth(), camera_capture_->getHeight());
+        graph_ok = rebuildGraph();
+    }
+    if (!graph_ok || !graph_->start() || !camera_capture_->start()) {
+        LOG_ERROR("app") << "Streaming could not resume after the resolution change, exiting";
+        g_should_exit.store(true);
+        message = "streaming could not resume";
+        return false;
+    }
+    auto resumed = steady_clock::now();
+    auto to_ms = [](steady_clock::duration elapsed) { return duration_cast<milliseconds>(elapsed).count(); };
+
+    std::ostringstream result;
+    if (changed) {
+        result << "resolution " << camera_capture_->getWidth() << "x" << camera_capture_->getHeight();
+    } else {
+        result << "camera rejected " << width << "x" << height << ", kept " << camera_capture_->getWidth() << "x"
+               << camera_capture_->getHeight();
+    }
+    result << " (stop " << to_ms(stopped - begin) << " ms, camera " << to_ms(configured - stopped) << " ms, graph "
+           << to_ms(resumed - configured) << " ms)";
+    // 시청자가 보는 끊김(변경 전 마지막 AU → 다시 시작한 인코더의 첫 AU)은 주 루프가 확인해 로그와 히스토그램에 남김
+    pending_reconfigure_ = {true, begin_ns, last_unit_ns, Heartbeat::nowNs(), result.str()};
+    message = result.str() + ", video gap is logged after the first encoded frame";
+    if (!changed) {
+        return false;
+    }
+    reconfigurations_.inc();
+    live_width_ = width;
+    live_height_ = height;
+    return true;
+}
+
+bool CameraStreamerApp::rebuildGraph() {
+    // 이전 단계를 가리키던 포인터를 비운 뒤 새 입력 형식으로 단계를 다시 만듦
+    graph_.reset();
+    main_sources_.clear();
+    analytics_sources_.clear();
+    motion_stage_ = nullptr;
+    pacer_stages_.clear();
+    bool built = buildGraph();
+    // 이전 크기 좌표의 트랙/칼만 상태와 검출기의 타일 결과, 모션 영역은 새 크기에서 의미가 없음
+    // (검출기 configure 뒤에 비워야 워커에 남은 이전 크기 추론 결과까지 버려짐)
+    if (object_detector_) {
+        object_detector_->reset();
+    }
+    if (object_tracker_) {
+        object_tracker_->reset();
+    }
+    if (!built) {
+        return false;
+    }
+    // 새 pacer 도 품질 조절로 낮춘 fps 를 따름
+    applyFrameRate();
+    return true;
+}
+
+void CameraStreamerApp::pollReconfigure() {
+    if (!pending_reconfigure_.active) {
+        return;
+    }
+    // AU 시각은 인코더 heartbeat 가 기록하므로 주 루프의 폴링 주기와 관계없이 정확함
+    uint64_t first_unit_ns = rtsp_streamer_->encodeHeartbeat().lastNs();
+    if (first_unit_ns > pending_reconfigure_.resumed_ns) {
+        uint64_t since_ns = pending_reconfigure_.last_unit_ns > 0 ? pending_reconfigure_.last_unit_ns
+                                                                  : pending_reconfigure_.begin_ns;
+        uint64_t gap_ns = first_unit_ns - since_ns;
+        reconfigure_gap_.observe(static_cast<double>(gap_ns) / 1e9);
+        LOG_INFO("app") << "Resolution change " << pending_reconfigure_.summary << ": video gap " << gap_ns / 1000000
+                        << " ms, first frame " << (first_unit_ns - pending_reconfigure_.resumed_ns) / 1000000
+                        << " ms after resume";
+        pending_reconfigure_.active = false;
+    } else if (Heartbeat::nowNs() - pending_reconfigure_.resumed_ns > 3000000000ULL) {
+        LOG_WARN("app") << "Resolution change " << pending_reconfigure_.summary << ": no encoded frame within 3 s";
+        pending_reconfigure_.active = false;
+    }
 }
 
 void CameraStreamerApp::run() {
     while (!should_exit_.load() && !g_should_exit.load()) {
         std::this_thread::sleep_for(100ms);
+        FrameTracer::instance().pollDump();
+        MemoryResidency::instance().reportPageFaults();
+        if (watchdog_) {
+            watchdog_->poll();
+        }
+        if (governor_) {
+            governor_->poll();
+        }
+        pollReconfigure();
+        if (g_reload_requested.exchange(false)) {
+            std::string message;
+            if (reloadConfig(message)) {
+                LOG_INFO("app") << "Config reloaded: " << message;
+            } else {
+                LOG_ERROR("app") << "Config reload failed: " << message;
+            }
+        }
+        if (control_server_) {
+            control_server_->poll([this](const std::string& command) { return handleControlCommand(command); });
+        }
+        if (replay_ && replay_->isFinished()) {
+            LOG_INFO("app") << "Replay finished";
+            break;
+        }
     }
     
-    std::cout << "\n[INFO] Main loop exited. Stopping application..." << std::endl;
-    stop();
-}
-
-void CameraStreamerApp::signalHandler(int signal) {
-    should_exit_.store(true);
+    if (int signal = g_exit_signal.load()) {
+        LOG_INFO("app") << "Signal " << signal << " received. Exiting gracefully...";
+    }
+    LOG_INFO("app") << "Main loop exited. Stopping application...";
     stop();
 }
 
-void CameraStreamerApp::onFrameReceived(const FrameData& frame_data) {
+void CameraStreamerApp::onFrameReceived(const FrameRef& frame, const FrameRef& analytics) {
     if (should_exit_.load()) {
         return;
     }
     
-    // RTSP 스트리머로 프레임 전송
-    if (rtsp_streamer_) {
-        rtsp_streamer_->pushFrame(frame_data);
+    if (frame_count_ == 0 && StartupTimeline::instance().markOnce("first_frame_captured")) {
+        LOG_INFO("app") << "First frame captured " << StartupTimeline::instance().elapsedMs()
+                        << " ms after process start";
+    }
+    
+    // 소스 단계 큐에 참조만 넣고 분배/처리는 그래프 작업 스레드에서 수행
+    for (int stage : main_sources_) {
+        graph_->push(stage, frame);
+    }
+    // 보조 스트림이 없으면 메인 프레임으로 분석
+    const FrameRef& analytics_frame = analytics.valid() ? analytics : frame;
+    for (int stage : analytics_sources_) {
+        graph_->push(stage, analytics_frame);
     }
     
     // 프레임 카운터 업데이트
     frame_count_++;
     if (frame_count_ % (config_manager_->getVideoConfig().fps * 5) == 0) {
-        std::cout << "[DEBUG] " << frame_count_ << " frames processed and sent to RTSP server." << std::endl;
+        LOG_DEBUG("app") << frame_count_.load() << " frames captured and queued to the processing graph.";
+    }
+}
+
+void CameraStreamerApp::onDetections(const std::vector<Detection>& detections) {
+    // 추적기가 있으면 다음 캡처 프레임에서 보정되도록 넘김
+    if (object_tracker_) {
+        object_tracker_->submitDetections(detections);
+        return;
     }
+    
+    // 검출 개수가 바뀔 때만 출력
+    if (detections.size() == last_track_count_) {
+        return;
+    }
+    last_track_count_ = detections.size();
+    if (detections.empty()) {
+        LOG_DEBUG("detector") << "No objects detected";
+        return;
+    }
+    
+    const Detection& best = detections.front();
+    LOG_DEBUG("detector") << detections.size() << " objects detected, top: class " << best.class_id
+                          << " (" << best.score << ") at " << static_cast<int>(best.x) << "," << static_cast<int>(best.y)
+                          << " " << static_cast<int>(best.width) << "x" << static_cast<int>(best.height);
 }
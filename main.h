@@ -4,16 +4,67 @@
 #include <atomic>
 #include <memory>
 #include <csignal>
+#include <chrono>
+#include <vector>
 
 #include "ConfigManager.h"
 #include "ZeroCopyCapture.h"
+#include "RawCapture.h"
 #include "RtspStreamer.h"
+#include "MotionDetector.h"
+#include "ObjectDetector.h"
+#include "ObjectTracker.h"
+#include "MetricsServer.h"
+#include "ControlServer.h"
+#include "MemoryResidency.h"
+#include "StallWatchdog.h"
+#include "QualityGovernor.h"
+#include "ProcessingGraph.h"
+#include "GraphStages.h"
 
 class CameraStreamerApp {
 private:
     std::unique_ptr<ConfigManager> config_manager_;
     std::unique_ptr<ZeroCopyCapture> camera_capture_;
+    std::unique_ptr<RawReplay> replay_;     // replay.enabled 면 카메라 대신 기록된 파일이 소스
     std::unique_ptr<RtspStreamer> rtsp_streamer_;
+    std::unique_ptr<MotionDetector> motion_detector_;
+    std::unique_ptr<ObjectDetector> object_detector_;
+    std::unique_ptr<ObjectTracker> object_tracker_;
+    std::unique_ptr<MetricsServer> metrics_server_;
+    std::unique_ptr<ControlServer> control_server_;
+    std::unique_ptr<StallWatchdog> watchdog_;
+    std::unique_ptr<QualityGovernor> governor_;
+    // 단계들이 위 구성요소를 가리키므로 먼저 소멸되도록 뒤에 둠
+    std::unique_ptr<ProcessingGraph> graph_;
+    std::vector<int> main_sources_;         // 메인 프레임을 받는 camera 단계
+    std::vector<int> analytics_sources_;    // 보조(없으면 메인) 프레임을 받는 camera 단계
+    MotionStage* motion_stage_;             // 검출 단계가 모션 영역을 읽음
+    std::vector<PacerStage*> pacer_stages_; // 품질 조절로 fps 가 바뀌면 출력 주기도 바꿈
+    
+    std::atomic<int> inference_interval_factor_;    // 품질 조절 중 frame_interval 배수
+    size_t last_track_count_;
+
+    // 실행 중 바꾼 설정 (config_manager_ 는 시작 때 읽은 값 그대로). 주 루프 스레드에서만 읽고 씀
+    std::string config_file_;
+    int live_width_;                // 요청한 크기 (센서 정렬로 실제 캡처 크기는 다를 수 있음)
+    int live_height_;
+    int live_fps_;
+    int live_bitrate_;              // 0 이면 인코더 파이프라인 설정 그대로
+    bool fps_degraded_;             // 품질 조절 단계가 적용 중이면 낮춘 값과 설정 값 중 작은 쪽을 씀
+    bool bitrate_degraded_;
+    Histogram& reconfigure_gap_;
+    Counter& reconfigurations_;
+
+    // 해상도 변경 뒤 새 크기의 첫 AU 를 기다리는 중인 측정 (주 루프를 막지 않도록 시각만 기록하고 run() 에서 확인)
+    struct PendingReconfigure {
+        bool active;
+        uint64_t begin_ns;          // 변경을 시작한 시각
+        uint64_t last_unit_ns;      // 변경 전 마지막 AU (없으면 0)
+        uint64_t resumed_ns;        // 캡처를 다시 시작한 시각
+        std::string summary;        // 해상도와 구간별 소요 시간
+    };
+    PendingReconfigure pending_reconfigure_;
     
     std::atomic<bool> should_exit_;
     std::atomic<size_t> frame_count_;
@@ -27,18 +78,35 @@ public:
     void stop();
     
     void run();
-    
-    void signalHandler(int signal);
 
 private:
-    void onFrameReceived(const FrameData& frame_data);
+    bool buildGraph();
+    void onFrameReceived(const FrameRef& frame, const FrameRef& analytics);
+    void onDetections(const std::vector<Detection>& detections);
+    void setupWatchdog();
+    void setupGovernor();
+
+    // 실행 중 설정 변경 (제어 소켓 명령, SIGHUP 설정 다시 읽기). message 에 결과를 씀
+    std::string handleControlCommand(const std::string& command);
+    bool reloadConfig(std::string& message);
+    bool changeFrameRate(int fps, std::string& message);
+    bool changeBitrate(int bitrate, std::string& message);
+    bool changeResolution(int width, int height, std::string& message);
+    bool rebuildGraph();
+    void pollReconfigure();
+    void applyFrameRate();
+    int currentBitrate() const;
 };
 
 // 전역 변수
 extern std::atomic<bool> g_should_exit;
+extern std::atomic<int> g_exit_signal;
+extern std::atomic<bool> g_reload_requested;
 extern CameraStreamerApp* g_app_instance;
 
 // 시그널 핸들러
 void globalSignalHandler(int signal);
+void traceSignalHandler(int signal);    // SIGUSR1: 프레임 trace 덤프 요청
+void reloadSignalHandler(int signal);   // SIGHUP: 설정 파일을 다시 읽어 해상도/fps/비트레이트 적용
 
 #endif // MAIN_H
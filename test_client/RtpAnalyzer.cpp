@@ -0,0 +1,313 @@
+#include "RtpAnalyzer.h"
+#include <algorithm>
+#include <cmath>
+
+constexpr uint32_t RtpAnalyzer::kSizeBounds[];
+
+namespace {
+
+uint16_t readU16(const uint8_t* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+uint32_t readU32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+} // namespace
+
+void RtpAnalyzer::SizeHistogram::add(uint32_t size) {
+    size_t bucket = 0;
+    while (bucket < kSizeBuckets - 1 && size > kSizeBounds[bucket]) {
+        bucket++;
+    }
+    buckets[bucket]++;
+    count++;
+    bytes += size;
+    max = std::max(max, size);
+}
+
+RtpAnalyzer::RtpAnalyzer(uint32_t clock_rate)
+    : clock_rate_(clock_rate > 0 ? clock_rate : 90000), have_seq_(false), ssrc_(0), expected_offset_(0),
+      base_ext_seq_(0), max_ext_seq_(0), seen_{}, have_transit_(false), arrival_base_ns_(0), last_arrival_(0),
+      last_ts_(0), jitter_(0.0), max_deviation_(0.0), in_frame_(false), frame_ts_(0), frame_bytes_(0),
+      frame_idr_(false), frame_params_(0), fu_active_(false), fu_broken_(false), fu_header_(0), fu_size_(0),
+      have_keyframe_(false), keyframe_index_(0), keyframe_ts_(0) {
+}
+
+void RtpAnalyzer::setClockRate(uint32_t clock_rate) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (clock_rate > 0 && clock_rate != clock_rate_) {
+        clock_rate_ = clock_rate;
+        have_transit_ = false;
+        jitter_ = 0.0;
+    }
+}
+
+void RtpAnalyzer::onPacket(const uint8_t* data, size_t size, uint64_t arrival_ns) {
+    std::lock_guard<std::mutex> lock(mtx_);
+
+    if (size < 12 || (data[0] >> 6) != 2) {
+        stats_.malformed++;
+        return;
+    }
+    size_t offset = 12 + 4 * (data[0] & 0x0f);
+    if ((data[0] & 0x10) && offset + 4 <= size) {
+        offset += 4 + 4 * static_cast<size_t>(readU16(data + offset + 2));
+    }
+    size_t end = size;
+    if (data[0] & 0x20) {
+        end = data[size - 1] <= size ? size - data[size - 1] : 0;
+    }
+    if (offset > end) {
+        stats_.malformed++;
+        return;
+    }
+    bool marker = data[1] & 0x80;
+    uint16_t seq = readU16(data + 2);
+    uint32_t timestamp = readU32(data + 4);
+    uint32_t ssrc = readU32(data + 8);
+
+    if (have_seq_ && ssrc != ssrc_) {
+        stats_.ssrc_changes++;
+        resetStream();
+    }
+    ssrc_ = ssrc;
+    stats_.packets++;
+    stats_.bytes += size;
+
+    SequenceResult result = updateSequence(seq);
+    if (result == kDuplicate) {
+        return;
+    }
+    updateJitter(timestamp, arrival_ns);
+    // 늦게 온 패킷의 프레임은 이미 닫혔으므로 프레임/NAL 집계에서는 뺌
+    if (result == kLate) {
+        return;
+    }
+
+    if (in_frame_ && timestamp != frame_ts_) {
+        finishFrame();
+    }
+    if (!in_frame_) {
+        in_frame_ = true;
+        frame_ts_ = timestamp;
+        frame_bytes_ = 0;
+        frame_idr_ = false;
+        frame_params_ = 0;
+    }
+    onPayload(data + offset, end - offset, result == kGap);
+    if (marker) {
+        finishFrame();
+    }
+}
+
+RtpAnalyzer::SequenceResult RtpAnalyzer::updateSequence(uint16_t seq) {
+    if (!have_seq_) {
+        // 첫 번호 앞의 늦은 패킷도 양수가 되도록 한 주기 올려서 시작
+        have_seq_ = true;
+        base_ext_seq_ = max_ext_seq_ = 65536 + seq;
+        seen_.fill(0);
+        seen_[seq >> 6] |= 1ULL << (seq & 63);
+        stats_.expected = expected_offset_ + 1;
+        return kInOrder;
+    }
+
+    // 가장 큰 번호에 가장 가까운 주기로 확장 (±32768 안)
+    uint64_t ext = (max_ext_seq_ & ~0xFFFFULL) | seq;
+    if (ext + 32768 < max_ext_seq_) {
+        ext += 65536;
+    } else if (ext > max_ext_seq_ + 32768 && ext >= 65536) {
+        ext -= 65536;
+    }
+
+    uint64_t& word = seen_[seq >> 6];
+    uint64_t bit = 1ULL << (seq & 63);
+    if (ext > max_ext_seq_) {
+        // 건너뛴 번호의 비트를 지워 다음 주기의 같은 번호와 섞이지 않게 함
+        for (uint64_t skipped = max_ext_seq_ + 1; skipped < ext; ++skipped) {
+            seen_[(skipped & 0xFFFF) >> 6] &= ~(1ULL << (skipped & 63));
+        }
+        word |= bit;
+        bool gap = ext != max_ext_seq_ + 1;
+        max_ext_seq_ = ext;
+        stats_.expected = expected_offset_ + (max_ext_seq_ - base_ext_seq_ + 1);
+        return gap ? kGap : kInOrder;
+    }
+    if (word & bit) {
+        stats_.duplicates++;
+        return kDuplicate;
+    }
+    word |= bit;
+    if (ext < base_ext_seq_) {
+        base_ext_seq_ = ext;
+        stats_.expected = expected_offset_ + (max_ext_seq_ - base_ext_seq_ + 1);
+    }
+    stats_.reordered++;
+    return kLate;
+}
+
+void RtpAnalyzer::updateJitter(uint32_t timestamp, uint64_t arrival_ns) {
+    // 도착 시각을 RTP 시계 단위로 바꿔 RTP 타임스탬프 간격과 비교 (RFC 3550 6.4.1)
+    if (!have_transit_) {
+        arrival_base_ns_ = static_cast<int64_t>(arrival_ns);
+    }
+    int64_t arrival = static_cast<int64_t>(
+        static_cast<double>(static_cast<int64_t>(arrival_ns) - arrival_base_ns_) * clock_rate_ / 1e9);
+    if (have_transit_) {
+        int64_t deviation = (arrival - last_arrival_) - static_cast<int32_t>(timestamp - last_ts_);
+        double magnitude = std::fabs(static_cast<double>(deviation));
+        jitter_ += (magnitude - jitter_) / 16.0;
+        max_deviation_ = std::max(max_deviation_, magnitude);
+    }
+    have_transit_ = true;
+    last_arrival_ = arrival;
+    last_ts_ = timestamp;
+}
+
+void RtpAnalyzer::onPayload(const uint8_t* payload, size_t size, bool gap) {
+    if (gap && fu_active_) {
+        fu_broken_ = true;
+    }
+    if (size < 1) {
+        return;
+    }
+    uint8_t type = payload[0] & 0x1f;
+    if (fu_active_ && type != 28) {
+        // 끝 조각 없이 다른 NAL 이 옴
+        stats_.broken_nals++;
+        fu_active_ = false;
+    }
+
+    if (type == 24) {
+        // STAP-A: 16 비트 크기 + NAL 반복
+        size_t pos = 1;
+        while (pos + 2 <= size) {
+            size_t nal_size = readU16(payload + pos);
+            pos += 2;
+            if (nal_size == 0 || pos + nal_size > size) {
+                break;
+            }
+            onNal(payload[pos], static_cast<uint32_t>(nal_size));
+            pos += nal_size;
+        }
+        return;
+    }
+    if (type == 28) {
+        // FU-A: 조각을 모아 원래 NAL 크기 (NAL 헤더 1 바이트 + 조각 합)를 셈
+        if (size < 2) {
+            return;
+        }
+        uint8_t fu = payload[1];
+        uint32_t fragment = static_cast<uint32_t>(size - 2);
+        if (fu & 0x80) {
+            if (fu_active_) {
+                stats_.broken_nals++;
+            }
+            fu_active_ = true;
+            fu_broken_ = false;
+            fu_header_ = static_cast<uint8_t>((payload[0] & 0xe0) | (fu & 0x1f));
+            fu_size_ = 1 + fragment;
+        } else if (fu_active_) {
+            fu_size_ += fragment;
+        }
+        if (fu & 0x40) {
+            if (!fu_active_ || fu_broken_) {
+                stats_.broken_nals++;
+            } else {
+                onNal(fu_header_, fu_size_);
+            }
+            fu_active_ = false;
+        }
+        return;
+    }
+    onNal(payload[0], static_cast<uint32_t>(size));
+}
+
+void RtpAnalyzer::onNal(uint8_t nal_header, uint32_t size) {
+    int kind = kNalOther;
+    switch (nal_header & 0x1f) {
+        case 1: kind = kNalSlice; break;
+        case 5: kind = kNalIdr; frame_idr_ = true; break;
+        case 6: kind = kNalSei; break;
+        case 7: kind = kNalSps; frame_params_ |= 1; break;
+        case 8: kind = kNalPps; frame_params_ |= 2; break;
+        default: break;
+    }
+    stats_.nal_sizes[kind].add(size);
+    frame_bytes_ += size;
+}
+
+void RtpAnalyzer::finishFrame() {
+    if (!in_frame_) {
+        return;
+    }
+    in_frame_ = false;
+    if (frame_bytes_ == 0) {
+        return;
+    }
+    stats_.frames++;
+    stats_.frame_sizes.add(frame_bytes_);
+    if (!frame_idr_) {
+        return;
+    }
+
+    stats_.keyframes++;
+    stats_.keyframe_sizes.add(frame_bytes_);
+    if (frame_params_ != 3) {
+        stats_.keyframes_without_params++;
+    }
+    uint64_t index = stats_.frames - 1;
+    if (have_keyframe_) {
+        uint64_t frames = index - keyframe_index_;
+        double seconds = static_cast<double>(static_cast<uint32_t>(frame_ts_ - keyframe_ts_)) / clock_rate_;
+        if (stats_.gop_count == 0) {
+            stats_.gop_frames_min = stats_.gop_frames_max = frames;
+            stats_.gop_seconds_min = stats_.gop_seconds_max = seconds;
+        } else {
+            stats_.gop_frames_min = std::min(stats_.gop_frames_min, frames);
+            stats_.gop_frames_max = std::max(stats_.gop_frames_max, frames);
+            stats_.gop_seconds_min = std::min(stats_.gop_seconds_min, seconds);
+            stats_.gop_seconds_max = std::max(stats_.gop_seconds_max, seconds);
+        }
+        stats_.gop_count++;
+        stats_.gop_frames_sum += frames;
+        stats_.gop_seconds_sum += seconds;
+    }
+    have_keyframe_ = true;
+    keyframe_index_ = index;
+    keyframe_ts_ = frame_ts_;
+}
+
+void RtpAnalyzer::resetStream() {
+    // 새 SSRC 는 번호와 타임스탬프가 무관하므로 순서/지터/프레임 상태를 처음부터 다시 셈
+    expected_offset_ = stats_.expected;
+    have_seq_ = false;
+    have_transit_ = false;
+    in_frame_ = false;
+    fu_active_ = false;
+    have_keyframe_ = false;
+}
+
+RtpAnalyzer::Stats RtpAnalyzer::snapshot(bool reset_interval) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    Stats stats = stats_;
+    stats.jitter_ms = jitter_ * 1000.0 / clock_rate_;
+    stats.max_deviation_ms = max_deviation_ * 1000.0 / clock_rate_;
+    if (reset_interval) {
+        max_deviation_ = 0.0;
+    }
+    return stats;
+}
+
+const char* RtpAnalyzer::nalKindName(int kind) {
+    switch (kind) {
+        case kNalIdr: return "IDR";
+        case kNalSlice: return "slice";
+        case kNalSps: return "SPS";
+        case kNalPps: return "PPS";
+        case kNalSei: return "SEI";
+        default: return "other";
+    }
+}
@@ -0,0 +1,140 @@
+#ifndef RTP_ANALYZER_H
+#define RTP_ANALYZER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// 디코딩 없이 H.264 RTP 패킷 헤더와 NAL 헤더만 읽어 스트림 품질을 집계
+// - 손실/순서 뒤바뀜/중복: 확장 sequence 번호와 최근 65536 번호의 수신 비트맵 (RFC 3550 A.1 방식)
+// - 지터: RTP 타임스탬프 간격 대비 도착 간격 차이의 RFC 3550 평활 지터와 구간 최대 편차
+// - 프레임(액세스 유닛)은 RTP 타임스탬프가 바뀌거나 marker 비트로 끝남. IDR 이 있으면 키프레임
+// - NAL 크기는 single/STAP-A/FU-A 를 풀어 원래 NAL 단위로 셈 (FU 조각이 빠지면 그 NAL 은 셈에서 뺌)
+// 패킷마다 고정 크기 배열만 갱신하고 할당하지 않음 (수신 스레드에서 바로 호출)
+class RtpAnalyzer {
+public:
+    // NAL 크기 분포 구간 상한 (바이트), 마지막은 그 이상
+    static constexpr size_t kSizeBuckets = 8;
+    static constexpr uint32_t kSizeBounds[kSizeBuckets - 1] = {64, 256, 1024, 4096, 16384, 65536, 262144};
+
+    enum NalKind {
+        kNalIdr,
+        kNalSlice,      // 비 IDR 슬라이스 (P/B)
+        kNalSps,
+        kNalPps,
+        kNalSei,
+        kNalOther,
+        kNalKinds
+    };
+
+    struct SizeHistogram {
+        uint64_t count = 0;
+        uint64_t bytes = 0;
+        uint32_t max = 0;
+        std::array<uint64_t, kSizeBuckets> buckets{};
+
+        void add(uint32_t size);
+    };
+
+    // 누적 값 (구간 값은 두 스냅샷의 차이로 계산)
+    struct Stats {
+        uint64_t packets = 0;
+        uint64_t bytes = 0;             // RTP 헤더 포함
+        uint64_t expected = 0;          // 첫 번호부터 가장 큰 번호까지
+        uint64_t reordered = 0;         // 더 큰 번호 뒤에 도착 (손실로 셌다가 되돌림)
+        uint64_t duplicates = 0;
+        uint64_t malformed = 0;         // RTP 버전/길이가 맞지 않는 패킷
+        uint32_t ssrc_changes = 0;      // 서버 재시작 등으로 SSRC 가 바뀌어 번호를 다시 셈
+        double jitter_ms = 0.0;         // RFC 3550 평활 지터
+        double max_deviation_ms = 0.0;  // 마지막 snapshot(true) 이후 가장 큰 |D|
+
+        uint64_t frames = 0;
+        uint64_t keyframes = 0;
+        uint64_t keyframes_without_params = 0;  // 같은 AU 에 SPS/PPS 가 없는 IDR (중간 접속 시 디코딩 불가)
+        uint64_t broken_nals = 0;               // 조각 손실로 크기를 알 수 없는 FU-A NAL
+
+        // 키프레임 간격 (프레임 수, RTP 시간 기준 초). gop_count 가 0 이면 아직 키프레임이 두 번 오지 않음
+        uint64_t gop_count = 0;
+        uint64_t gop_frames_sum = 0;
+        uint64_t gop_frames_min = 0;
+        uint64_t gop_frames_max = 0;
+        double gop_seconds_sum = 0.0;
+        double gop_seconds_min = 0.0;
+        double gop_seconds_max = 0.0;
+
+        std::array<SizeHistogram, kNalKinds> nal_sizes;
+        SizeHistogram frame_sizes;      // AU 당 NAL 바이트 합
+        SizeHistogram keyframe_sizes;
+
+        uint64_t lost() const { return expected > packets - duplicates ? expected - (packets - duplicates) : 0; }
+    };
+
+    explicit RtpAnalyzer(uint32_t clock_rate = 90000);
+
+    // 세션 caps 의 clock-rate (H.264 는 항상 90000)
+    void setClockRate(uint32_t clock_rate);
+
+    // RTP 패킷 하나 (arrival_ns 는 단조 시계)
+    void onPacket(const uint8_t* data, size_t size, uint64_t arrival_ns);
+
+    // 누적 통계 복사. reset_interval 이면 구간 최대 편차를 다시 셈
+    Stats snapshot(bool reset_interval = false);
+
+    static const char* nalKindName(int kind);
+
+private:
+    enum SequenceResult {
+        kInOrder,
+        kGap,           // 앞 번호가 빠짐
+        kLate,
+        kDuplicate
+    };
+
+    SequenceResult updateSequence(uint16_t seq);
+    void updateJitter(uint32_t timestamp, uint64_t arrival_ns);
+    void onPayload(const uint8_t* payload, size_t size, bool gap);
+    void onNal(uint8_t nal_header, uint32_t size);
+    void finishFrame();
+    void resetStream();
+
+    std::mutex mtx_;
+    Stats stats_;
+    uint32_t clock_rate_;
+
+    // 순서 추적
+    bool have_seq_;
+    uint32_t ssrc_;
+    uint64_t expected_offset_;      // SSRC 가 바뀌기 전까지의 expected
+    uint64_t base_ext_seq_;
+    uint64_t max_ext_seq_;
+    std::array<uint64_t, 65536 / 64> seen_;
+
+    // 지터 (RTP 시계 단위)
+    bool have_transit_;
+    int64_t arrival_base_ns_;
+    int64_t last_arrival_;
+    uint32_t last_ts_;
+    double jitter_;
+    double max_deviation_;
+
+    // 현재 프레임
+    bool in_frame_;
+    uint32_t frame_ts_;
+    uint32_t frame_bytes_;
+    bool frame_idr_;
+    uint8_t frame_params_;          // 1: SPS, 2: PPS
+
+    // 조립 중인 FU-A
+    bool fu_active_;
+    bool fu_broken_;
+    uint8_t fu_header_;
+    uint32_t fu_size_;
+
+    // 마지막 키프레임
+    bool have_keyframe_;
+    uint64_t keyframe_index_;
+    uint32_t keyframe_ts_;
+};
+
+#endif // RTP_ANALYZER_H
@@ -1,11 +1,12 @@
 #include "RtspClient.h"
 #include <iostream>
 #include <iomanip>
+#include <time.h>
 
-RtspClient::RtspClient(const std::string& rtsp_url) 
+RtspClient::RtspClient(const std::string& rtsp_url, bool multicast, bool analyze) 
     : pipeline_(nullptr), source_(nullptr), depay_(nullptr), decoder_(nullptr), 
       converter_(nullptr), sink_(nullptr), loop_(nullptr), running_(false), 
-      rtsp_url_(rtsp_url), frame_count_(0) {
+      rtsp_url_(rtsp_url), multicast_(multicast), analyzer_(analyze ? new RtpAnalyzer() : nullptr), frame_count_(0) {
     
     gst_init(nullptr, nullptr);
 }
@@ -21,19 +22,23 @@ bool RtspClient::initialize() {
     // GStreamer 요소들 생성 (더 안정적인 디코더 사용)
     pipeline_ = gst_pipeline_new("rtsp-client");
     source_ = gst_element_factory_make("rtspsrc", "source");
-    depay_ = gst_element_factory_make("rtph264depay", "depay");
+    sink_ = gst_element_factory_make("fakesink", "sink");
     
-    // 하드웨어 디코더 시도, 실패시 소프트웨어 디코더 사용
-    decoder_ = gst_element_factory_make("v4l2h264dec", "decoder");
-    if (!decoder_) {
-        std::cout << "[WARN] Hardware H264 decoder not available, using software decoder" << std::endl;
-        decoder_ = gst_element_factory_make("avdec_h264", "decoder");
+    // 분석 모드는 RTP 를 fakesink 로 바로 버림 (depay/디코더 없음)
+    if (!analyzer_) {
+        depay_ = gst_element_factory_make("rtph264depay", "depay");
+        
+        // 하드웨어 디코더 시도, 실패시 소프트웨어 디코더 사용
+        decoder_ = gst_element_factory_make("v4l2h264dec", "decoder");
+        if (!decoder_) {
+            std::cout << "[WARN] Hardware H264 decoder not available, using software decoder" << std::endl;
+            decoder_ = gst_element_factory_make("avdec_h264", "decoder");
+        }
+        
+        converter_ = gst_element_factory_make("videoconvert", "converter");
     }
     
-    converter_ = gst_element_factory_make("videoconvert", "converter");
-    sink_ = gst_element_factory_make("fakesink", "sink");
-    
-    if (!pipeline_ || !source_ || !depay_ || !decoder_ || !converter_ || !sink_) {
+    if (!pipeline_ || !source_ || !sink_ || (!analyzer_ && (!depay_ || !decoder_ || !converter_))) {
         std::cerr << "[ERROR] Failed to create GStreamer elements" << std::endl;
         return false;
     }
@@ -41,7 +46,7 @@ bool RtspClient::initialize() {
     // rtspsrc 설정 (더 안정적인 설정)
     g_object_set(G_OBJECT(source_), 
                  "location", rtsp_url_.c_str(),
-                 "protocols", 0x00000004,  // TCP만 사용 (더 안정적)
+                 "protocols", multicast_ ? 0x00000002 : 0x00000004,  // UDP 멀티캐스트 또는 TCP만 사용 (더 안정적)
                  "latency", 0,             // 지연시간 최소화
                  "timeout", 5000000,       // 5초 타임아웃
                  "tcp-timeout", 5000000,
@@ -49,19 +54,36 @@ bool RtspClient::initialize() {
                  "drop-on-latency", TRUE,
                  NULL);
     
-    // fakesink 설정 (실제 출력하지 않고 프레임만 카운트)
-    g_object_set(G_OBJECT(sink_), 
-                 "sync", TRUE,
-                 "signal-handoffs", TRUE,
-                 NULL);
-    
-    // 파이프라인에 요소들 추가
-    gst_bin_add_many(GST_BIN(pipeline_), source_, depay_, decoder_, converter_, sink_, NULL);
-    
-    // 요소들 연결 (rtspsrc는 동적 패드이므로 나중에 연결)
-    if (!gst_element_link_many(depay_, decoder_, converter_, sink_, NULL)) {
-        std::cerr << "[ERROR] Failed to link elements" << std::endl;
-        return false;
+    if (analyzer_) {
+        // 재생 시각에 맞춰 기다리지 않음 (스트림 여러 개를 동시에 보아도 CPU 는 패킷 헤더 파싱 정도)
+        g_object_set(G_OBJECT(sink_), "sync", FALSE, "async", FALSE, NULL);
+        gst_bin_add_many(GST_BIN(pipeline_), source_, sink_, NULL);
+        
+        // rtspsrc 안의 jitter buffer 는 순서를 바로잡고 늦은 패킷을 버리므로 그 앞(sink 패드)에서 집계
+        g_signal_connect(source_, "new-manager", G_CALLBACK(+[](GstElement*, GstElement* manager, gpointer data) {
+            g_signal_connect(manager, "new-jitterbuffer",
+                             G_CALLBACK(+[](GstElement*, GstElement* jitterbuffer, guint, guint, gpointer data) {
+                GstPad* pad = gst_element_get_static_pad(jitterbuffer, "sink");
+                gst_pad_add_probe(pad, static_cast<GstPadProbeType>(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST),
+                                  rtp_probe_callback, data, NULL);
+                gst_object_unref(pad);
+            }), data);
+        }), this);
+    } else {
+        // fakesink 설정 (실제 출력하지 않고 프레임만 카운트)
+        g_object_set(G_OBJECT(sink_), 
+                     "sync", TRUE,
+                     "signal-handoffs", TRUE,
+                     NULL);
+        
+        // 파이프라인에 요소들 추가
+        gst_bin_add_many(GST_BIN(pipeline_), source_, depay_, decoder_, converter_, sink_, NULL);
+        
+        // 요소들 연결 (rtspsrc는 동적 패드이므로 나중에 연결)
+        if (!gst_element_link_many(depay_, decoder_, converter_, sink_, NULL)) {
+            std::cerr << "[ERROR] Failed to link elements" << std::endl;
+            return false;
+        }
     }
     
     // rtspsrc 동적 패드 연결을 위한 신호 연결
@@ -80,11 +102,19 @@ bool RtspClient::initialize() {
             std::cout << "[DEBUG] New pad type: " << new_pad_type << std::endl;
             
             if (g_str_has_prefix(new_pad_type, "application/x-rtp")) {
-                GstPad* sink_pad = gst_element_get_static_pad(client->depay_, "sink");
+                if (client->analyzer_) {
+                    gint clock_rate = 0;
+                    if (gst_structure_get_int(new_pad_struct, "clock-rate", &clock_rate)) {
+                        client->analyzer_->setClockRate(static_cast<uint32_t>(clock_rate));
+                    }
+                }
+                GstPad* sink_pad = gst_element_get_static_pad(client->analyzer_ ? client->sink_ : client->depay_, "sink");
                 if (gst_pad_link(new_pad, sink_pad) == GST_PAD_LINK_OK) {
-                    std::cout << "[INFO] Successfully linked rtspsrc to depayloader" << std::endl;
+                    std::cout << "[INFO] Successfully linked rtspsrc to "
+                              << (client->analyzer_ ? "analyzer sink" : "depayloader") << std::endl;
                 } else {
-                    std::cerr << "[ERROR] Failed to link rtspsrc to depayloader" << std::endl;
+                    std::cerr << "[ERROR] Failed to link rtspsrc to "
+                              << (client->analyzer_ ? "analyzer sink" : "depayloader") << std::endl;
                 }
                 gst_object_unref(sink_pad);
             }
@@ -92,10 +122,12 @@ bool RtspClient::initialize() {
         }
     }), this);
     
-    // 프레임 카운트를 위한 프로브 추가
-    GstPad* sink_pad = gst_element_get_static_pad(sink_, "sink");
-    gst_pad_add_probe(sink_pad, GST_PAD_PROBE_TYPE_BUFFER, probe_callback, this, NULL);
-    gst_object_unref(sink_pad);
+    // 프레임 카운트를 위한 프로브 추가 (분석 모드는 RTP 프로브가 프레임을 셈)
+    if (!analyzer_) {
+        GstPad* sink_pad = gst_element_get_static_pad(sink_, "sink");
+        gst_pad_add_probe(sink_pad, GST_PAD_PROBE_TYPE_BUFFER, probe_callback, this, NULL);
+        gst_object_unref(sink_pad);
+    }
     
     return true;
 }
@@ -194,6 +226,33 @@ GstPadProbeReturn RtspClient::probe_callback(GstPad* pad, GstPadProbeInfo* info,
     return GST_PAD_PROBE_OK;
 }
 
+GstPadProbeReturn RtspClient::rtp_probe_callback(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+    RtspClient* client = static_cast<RtspClient*>(user_data);
+    
+    // 도착 시각은 소켓에서 읽은 스트리밍 스레드가 프로브를 부르는 시각 (디코딩/동기화 지연 없음)
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    uint64_t arrival_ns = static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + now.tv_nsec;
+    
+    auto analyze = [client, arrival_ns](GstBuffer* buffer) {
+        GstMapInfo map;
+        if (gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+            client->analyzer_->onPacket(map.data, map.size, arrival_ns);
+            gst_buffer_unmap(buffer, &map);
+        }
+    };
+    if (info->type & GST_PAD_PROBE_TYPE_BUFFER) {
+        analyze(GST_PAD_PROBE_INFO_BUFFER(info));
+    } else if (info->type & GST_PAD_PROBE_TYPE_BUFFER_LIST) {
+        GstBufferList* list = GST_PAD_PROBE_INFO_BUFFER_LIST(info);
+        for (guint i = 0; i < gst_buffer_list_length(list); ++i) {
+            analyze(gst_buffer_list_get(list, i));
+        }
+    }
+    
+    return GST_PAD_PROBE_OK;
+}
+
 void RtspClient::handleMessage(GstMessage* message) {
     switch (GST_MESSAGE_TYPE(message)) {
         case GST_MESSAGE_ERROR: {
@@ -6,6 +6,9 @@
 #include <atomic>
 #include <thread>
 #include <chrono>
+#include <memory>
+
+#include "RtpAnalyzer.h"
 
 class RtspClient {
 private:
@@ -21,11 +24,14 @@ private:
     std::atomic<bool> running_;
     
     std::string rtsp_url_;
+    bool multicast_;        // RTP 를 서버의 멀티캐스트 그룹으로 받음 (기본은 TCP interleaved)
+    std::unique_ptr<RtpAnalyzer> analyzer_;     // 분석 모드: 디코딩 없이 RTP 만 집계
     std::atomic<int> frame_count_;
     std::chrono::steady_clock::time_point start_time_;
 
 public:
-    RtspClient(const std::string& rtsp_url);
+    // analyze 이면 rtspsrc 뒤에 depay/디코더 없이 fakesink 만 두고, rtspsrc 의 jitter buffer 앞에서 RTP 를 집계
+    RtspClient(const std::string& rtsp_url, bool multicast = false, bool analyze = false);
     ~RtspClient();
 
     bool initialize();
@@ -34,10 +40,13 @@ public:
     
     int getFrameCount() const { return frame_count_.load(); }
     double getElapsedTime() const;
+    RtpAnalyzer* getAnalyzer() const { return analyzer_.get(); }
+    const std::string& getUrl() const { return rtsp_url_; }
 
 private:
     static gboolean bus_callback(GstBus* bus, GstMessage* message, gpointer data);
     static GstPadProbeReturn probe_callback(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+    static GstPadProbeReturn rtp_probe_callback(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
     void handleMessage(GstMessage* message);
 };
 
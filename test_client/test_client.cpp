@@ -1,57 +1,223 @@
 #include "RtspClient.h"
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <thread>
 #include <chrono>
 #include <csignal>
+#include <memory>
+#include <vector>
+#include <sys/resource.h>
 
 static std::atomic<bool> should_exit{false};
-static RtspClient* client_instance = nullptr;
 
+// 클라이언트 정지는 주 루프가 100 ms 안에 수행 (핸들러에서는 플래그만 설정)
 void signalHandler(int signal) {
     std::cout << "\n[INFO] Signal " << signal << " received. Stopping client..." << std::endl;
     should_exit.store(true);
-    if (client_instance) {
-        client_instance->stop();
-    }
 }
 
 void printUsage(const char* program_name) {
-    std::cout << "Usage: " << program_name << " [RTSP_URL]" << std::endl;
+    std::cout << "Usage: " << program_name << " [--multicast] [--analyze] [RTSP_URL...]" << std::endl;
     std::cout << "Default URL: rtsp://localhost:8554/stream" << std::endl;
+    std::cout << "  --multicast   receive RTP from the server's multicast group instead of TCP" << std::endl;
+    std::cout << "  --analyze     inspect RTP only, without decoding: loss, reordering, jitter, bitrate," << std::endl;
+    std::cout << "                GOP and NAL sizes every second (several URLs may be given)" << std::endl;
     std::cout << std::endl;
     std::cout << "Examples:" << std::endl;
     std::cout << "  " << program_name << std::endl;
     std::cout << "  " << program_name << " rtsp://192.168.1.100:8554/stream" << std::endl;
+    std::cout << "  " << program_name << " --multicast rtsp://192.168.1.100:8554/stream" << std::endl;
+    std::cout << "  " << program_name << " --analyze rtsp://cam1:8554/stream rtsp://cam2:8554/stream" << std::endl;
+}
+
+namespace {
+
+// 스트림별 초당 보고에 쓰는 직전 값
+struct StreamReport {
+    std::unique_ptr<RtspClient> client;
+    RtpAnalyzer::Stats last;
+    double min_mbps = -1.0;
+    double max_mbps = 0.0;
+};
+
+double processCpuSeconds() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+double percent(uint64_t part, uint64_t total) {
+    return total > 0 ? 100.0 * part / total : 0.0;
+}
+
+void printInterval(StreamReport& report, const std::string& label, double seconds) {
+    RtpAnalyzer::Stats stats = report.client->getAnalyzer()->snapshot(true);
+    const RtpAnalyzer::Stats& last = report.last;
+    uint64_t expected = stats.expected - last.expected;
+    uint64_t lost = stats.lost() - std::min(stats.lost(), last.lost());
+    double mbps = (stats.bytes - last.bytes) * 8.0 / seconds / 1e6;
+    if (stats.packets > 0 && last.packets > 0) {
+        report.min_mbps = report.min_mbps < 0.0 ? mbps : std::min(report.min_mbps, mbps);
+        report.max_mbps = std::max(report.max_mbps, mbps);
+    }
+
+    std::cout << "[RTP] " << label << std::fixed << std::setprecision(2) << mbps << " Mbit/s, "
+              << (stats.packets - last.packets) << " pkt, lost " << lost << " ("
+              << percent(lost, expected) << "%), reordered " << (stats.reordered - last.reordered)
+              << ", dup " << (stats.duplicates - last.duplicates) << ", jitter " << stats.jitter_ms
+              << " ms (max " << stats.max_deviation_ms << "), frames " << (stats.frames - last.frames)
+              << ", key " << (stats.keyframes - last.keyframes) << std::endl;
+    report.last = stats;
 }
 
+void printHistogramRow(const char* name, const RtpAnalyzer::SizeHistogram& histogram) {
+    std::cout << std::left << std::setw(8) << name << std::right;
+    for (uint64_t count : histogram.buckets) {
+        std::cout << std::setw(9) << count;
+    }
+    std::cout << std::setw(10) << (histogram.count > 0 ? histogram.bytes / histogram.count : 0)
+              << std::setw(10) << histogram.max << std::endl;
+}
+
+void printAnalysis(const StreamReport& report, double seconds) {
+    const RtpAnalyzer::Stats& stats = report.last;
+    uint64_t lost = stats.lost();
+
+    std::cout << "\n========== RTP Analysis: " << report.client->getUrl() << " ==========" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Packets: " << stats.packets << " received, " << stats.expected << " expected, " << lost
+              << " lost (" << percent(lost, stats.expected) << "%), " << stats.reordered << " reordered, "
+              << stats.duplicates << " duplicate, " << stats.malformed << " malformed";
+    if (stats.ssrc_changes > 0) {
+        std::cout << ", " << stats.ssrc_changes << " SSRC changes";
+    }
+    std::cout << std::endl;
+    std::cout << "Bitrate: " << (seconds > 0 ? stats.bytes * 8.0 / seconds / 1e6 : 0.0) << " Mbit/s avg, "
+              << std::max(report.min_mbps, 0.0) << " min, " << report.max_mbps << " max (per second)" << std::endl;
+    std::cout << "Jitter: " << stats.jitter_ms << " ms (RFC 3550)" << std::endl;
+    std::cout << "Frames: " << stats.frames << ", keyframes " << stats.keyframes << " ("
+              << stats.keyframes_without_params << " without SPS/PPS), " << stats.broken_nals
+              << " NALs with lost fragments" << std::endl;
+    if (stats.gop_count > 0) {
+        std::cout << "Keyframe interval: " << stats.gop_frames_min << " / "
+                  << static_cast<double>(stats.gop_frames_sum) / stats.gop_count << " / " << stats.gop_frames_max
+                  << " frames, " << stats.gop_seconds_min << " / " << stats.gop_seconds_sum / stats.gop_count
+                  << " / " << stats.gop_seconds_max << " s (min / avg / max)" << std::endl;
+    } else {
+        std::cout << "Keyframe interval: fewer than two keyframes received" << std::endl;
+    }
+
+    std::cout << "Sizes (bytes)";
+    std::cout << std::endl << std::left << std::setw(8) << "" << std::right;
+    for (size_t i = 0; i < RtpAnalyzer::kSizeBuckets - 1; ++i) {
+        std::cout << std::setw(9) << ("<=" + std::to_string(RtpAnalyzer::kSizeBounds[i]));
+    }
+    std::cout << std::setw(9) << "more" << std::setw(10) << "avg" << std::setw(10) << "max" << std::endl;
+    for (int kind = 0; kind < RtpAnalyzer::kNalKinds; ++kind) {
+        if (stats.nal_sizes[kind].count > 0) {
+            printHistogramRow(RtpAnalyzer::nalKindName(kind), stats.nal_sizes[kind]);
+        }
+    }
+    printHistogramRow("frame", stats.frame_sizes);
+    printHistogramRow("key", stats.keyframe_sizes);
+}
+
+// 디코딩 없이 RTP 만 보는 모드: 스트림마다 초당 한 줄, 종료 시 전체 요약
+int runAnalyzer(const std::vector<std::string>& urls, bool multicast) {
+    std::vector<StreamReport> reports(urls.size());
+    for (size_t i = 0; i < urls.size(); ++i) {
+        reports[i].client.reset(new RtspClient(urls[i], multicast, true));
+        if (!reports[i].client->initialize() || !reports[i].client->start()) {
+            std::cerr << "[FATAL] Failed to start RTSP client for " << urls[i] << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "[INFO] Analyzing " << urls.size() << " stream(s). Press Ctrl+C to stop." << std::endl;
+
+    auto start_time = std::chrono::steady_clock::now();
+    auto last_report = start_time;
+    double cpu_start = processCpuSeconds();
+    while (!should_exit.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        auto now = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(now - last_report).count();
+        if (seconds < 1.0) {
+            continue;
+        }
+        for (size_t i = 0; i < reports.size(); ++i) {
+            printInterval(reports[i], reports.size() > 1 ? "#" + std::to_string(i) + " " : "", seconds);
+        }
+        last_report = now;
+    }
+
+    double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    double cpu = processCpuSeconds() - cpu_start;
+    for (StreamReport& report : reports) {
+        report.client->stop();
+        report.last = report.client->getAnalyzer()->snapshot();
+        printAnalysis(report, total);
+    }
+    std::cout << "\nClient CPU: " << std::fixed << std::setprecision(1) << (total > 0 ? 100.0 * cpu / total : 0.0)
+              << "% of one core for " << reports.size() << " stream(s) over " << total << " s" << std::endl;
+    return 0;
+}
+
+} // namespace
+
 int main(int argc, char* argv[]) {
     signal(SIGINT, signalHandler);
     signal(SIGTERM, signalHandler);
     
-    std::string rtsp_url = "rtsp://localhost:8554/stream";
+    std::vector<std::string> urls;
+    bool multicast = false;
+    bool analyze = false;
     
-    if (argc == 2) {
-        if (std::string(argv[1]) == "--help" || std::string(argv[1]) == "-h") {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
             printUsage(argv[0]);
             return 0;
+        } else if (arg == "--multicast") {
+            multicast = true;
+        } else if (arg == "--analyze") {
+            analyze = true;
+        } else if (arg.compare(0, 2, "--") != 0) {
+            urls.push_back(arg);
+        } else {
+            std::cerr << "[ERROR] Unexpected argument: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
         }
-        rtsp_url = argv[1];
-    } else if (argc > 2) {
-        std::cerr << "[ERROR] Too many arguments" << std::endl;
+    }
+    
+    if (urls.empty()) {
+        urls.push_back("rtsp://localhost:8554/stream");
+    }
+    if (urls.size() > 1 && !analyze) {
+        std::cerr << "[ERROR] Several URLs need --analyze (decoding many streams measures the client, not the server)"
+                  << std::endl;
         printUsage(argv[0]);
         return 1;
     }
+    const std::string& rtsp_url = urls.front();
     
     std::cout << "========================================" << std::endl;
     std::cout << "        RTSP Stream Test Client" << std::endl;
     std::cout << "========================================" << std::endl;
-    std::cout << "Target URL: " << rtsp_url << std::endl;
+    for (const std::string& url : urls) {
+        std::cout << "Target URL: " << url << std::endl;
+    }
+    std::cout << "Transport: " << (multicast ? "UDP multicast" : "TCP") << std::endl;
+    std::cout << "Mode: " << (analyze ? "RTP analysis (no decoding)" : "decode") << std::endl;
     std::cout << "========================================" << std::endl;
     
     try {
-        RtspClient client(rtsp_url);
-        client_instance = &client;
+        if (analyze) {
+            return runAnalyzer(urls, multicast);
+        }
+        
+        RtspClient client(rtsp_url, multicast);
         
         if (!client.initialize()) {
             std::cerr << "[FATAL] Failed to initialize RTSP client" << std::endl;
@@ -0,0 +1,462 @@
+/*
+
+※ How to Compile
+
+make model_benchmark
+
+※ Usage
+
+./model_benchmark <frames_dir> [PRECISION:SIZE ...] [--config config.json] [--max-frames N]
+
+- frames_dir : 녹화된 프레임(PPM P6) 디렉토리. 모든 프레임은 같은 크기여야 함
+- PRECISION:SIZE : 측정할 변형 (예: FP32:320 FP16:416 INT8:640). 생략하면 FP32/FP16/INT8 x 320/416/640 전체
+- 검출 일치도는 같은 입력 크기의 FP32 결과를 기준으로 계산함 (FP32 가 없으면 생략)
+- 변형마다 별도 자식 프로세스에서 측정하므로 앞 변형의 모델/플러그인 메모리가 뒤 변형의 RSS 에 섞이지 않음
+
+*/
+
+#include "ConfigManager.h"
+#include "ObjectDetector.h"
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <dirent.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std::chrono;
+
+struct Frame {
+    std::string name;
+    std::vector<uint8_t> pixels;   // RGB888
+};
+
+struct Variant {
+    std::string precision;
+    int input_size;
+};
+
+struct VariantResult {
+    Variant variant;
+    bool ok;
+    double load_ms;
+    std::vector<double> latencies_ms;
+    double cpu_seconds;
+    double wall_seconds;
+    long peak_rss_kb;           // 컴파일 + 추론 동안의 VmHWM
+    size_t total_detections;
+    std::vector<std::vector<Detection>> detections;
+};
+
+// PPM(P6, maxval 255) 읽기
+static bool readPpm(const std::string& path, int& width, int& height, std::vector<uint8_t>& pixels) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::string magic;
+    int maxval = 0;
+    file >> magic;
+    // 주석 줄 건너뛰기
+    while (file >> std::ws && file.peek() == '#') {
+        std::string comment;
+        std::getline(file, comment);
+    }
+    file >> width >> height >> maxval;
+    file.get();
+    if (magic != "P6" || maxval != 255 || width <= 0 || height <= 0) {
+        return false;
+    }
+
+    pixels.resize(static_cast<size_t>(width) * height * 3);
+    file.read(reinterpret_cast<char*>(pixels.data()), pixels.size());
+    return static_cast<size_t>(file.gcount()) == pixels.size();
+}
+
+static bool loadFrames(const std::string& dir, size_t max_frames, int& width, int& height, std::vector<Frame>& frames) {
+    DIR* handle = opendir(dir.c_str());
+    if (!handle) {
+        std::cerr << "[ERROR] Could not open frame directory: " << dir << std::endl;
+        return false;
+    }
+    std::vector<std::string> names;
+    while (dirent* entry = readdir(handle)) {
+        std::string name = entry->d_name;
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, ".ppm") == 0) {
+            names.push_back(name);
+        }
+    }
+    closedir(handle);
+    std::sort(names.begin(), names.end());
+
+    width = height = 0;
+    for (const auto& name : names) {
+        if (frames.size() >= max_frames) break;
+        Frame frame;
+        int w, h;
+        if (!readPpm(dir + "/" + name, w, h, frame.pixels)) {
+            std::cerr << "[WARN] Skipping unreadable frame: " << name << std::endl;
+            continue;
+        }
+        if (width == 0) {
+            width = w;
+            height = h;
+        } else if (w != width || h != height) {
+            std::cerr << "[WARN] Skipping " << name << ": size " << w << "x" << h << " differs" << std::endl;
+            continue;
+        }
+        frame.name = name;
+        frames.push_back(std::move(frame));
+    }
+    return !frames.empty();
+}
+
+// /proc/self/status 의 "VmRSS:" / "VmHWM:" 값 (kB)
+static long readStatusKb(const std::string& key) {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, key.size(), key) == 0) {
+            return std::stol(line.substr(key.size()));
+        }
+    }
+    return 0;
+}
+
+static double cpuSeconds() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+static double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    size_t index = std::min(values.size() - 1, static_cast<size_t>(p * (values.size() - 1) + 0.5));
+    return values[index];
+}
+
+// 기준 결과와 같은 클래스, IoU 0.5 이상으로 탐욕 매칭한 개수
+static size_t countMatches(const std::vector<Detection>& baseline, const std::vector<Detection>& candidate) {
+    std::vector<bool> used(baseline.size(), false);
+    size_t matches = 0;
+    for (const auto& det : candidate) {
+        float best_iou = 0.5f;
+        int best = -1;
+        for (size_t i = 0; i < baseline.size(); ++i) {
+            if (used[i] || baseline[i].class_id != det.class_id) continue;
+            float iou = computeIoU(baseline[i], det);
+            if (iou >= best_iou) {
+                best_iou = iou;
+                best = static_cast<int>(i);
+            }
+        }
+        if (best >= 0) {
+            used[best] = true;
+            matches++;
+        }
+    }
+    return matches;
+}
+
+// 녹화 프레임은 패딩 없는 RGB888 단일 평면
+static FrameData toFrameData(const Frame& frame, int width, int height) {
+    FrameData frame_data = {};
+    frame_data.data = const_cast<uint8_t*>(frame.pixels.data());
+    frame_data.size = frame.pixels.size();
+    frame_data.width = width;
+    frame_data.height = height;
+    frame_data.num_planes = 1;
+    frame_data.strides[0] = width * 3;
+    return frame_data;
+}
+
+static VariantResult runVariant(const InferenceConfig& base_config, const Variant& variant,
+                                const std::vector<Frame>& frames, int width, int height) {
+    VariantResult result;
+    result.variant = variant;
+    result.ok = false;
+    result.total_detections = 0;
+
+    InferenceConfig config = base_config;
+    config.precision = variant.precision;
+    config.input_size = variant.input_size;
+    config.tiling_enabled = false;
+
+    auto load_start = steady_clock::now();
+    ObjectDetector detector(config);
+    if (!detector.initialize() || !detector.configure(width, height, width * 3, "RGB888")) {
+        return result;
+    }
+    result.load_ms = duration<double, std::milli>(steady_clock::now() - load_start).count();
+
+    // 워밍업
+    std::vector<Detection> detections;
+    for (size_t i = 0; i < std::min<size_t>(3, frames.size()); ++i) {
+        detector.detect(toFrameData(frames[i], width, height), detections);
+    }
+
+    double cpu_start = cpuSeconds();
+    auto wall_start = steady_clock::now();
+    for (const auto& frame : frames) {
+        FrameData frame_data = toFrameData(frame, width, height);
+        auto start = steady_clock::now();
+        if (!detector.detect(frame_data, detections)) {
+            return result;
+        }
+        result.latencies_ms.push_back(duration<double, std::milli>(steady_clock::now() - start).count());
+        result.total_detections += detections.size();
+        result.detections.push_back(detections);
+    }
+    result.wall_seconds = duration<double>(steady_clock::now() - wall_start).count();
+    result.cpu_seconds = cpuSeconds() - cpu_start;
+    result.peak_rss_kb = readStatusKb("VmHWM:");
+    result.ok = true;
+    return result;
+}
+
+static bool writeAll(int fd, const void* data, size_t size) {
+    const char* p = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t n = write(fd, p, size);
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+static bool readAll(int fd, void* data, size_t size) {
+    char* p = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t n = read(fd, p, size);
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+template <typename T>
+static bool writeVector(int fd, const std::vector<T>& values) {
+    uint64_t count = values.size();
+    return writeAll(fd, &count, sizeof(count)) && writeAll(fd, values.data(), count * sizeof(T));
+}
+
+template <typename T>
+static bool readVector(int fd, std::vector<T>& values) {
+    uint64_t count = 0;
+    if (!readAll(fd, &count, sizeof(count))) {
+        return false;
+    }
+    values.resize(count);
+    return readAll(fd, values.data(), count * sizeof(T));
+}
+
+static bool sendResult(int fd, const VariantResult& result) {
+    if (!writeAll(fd, &result.load_ms, sizeof(result.load_ms)) ||
+        !writeAll(fd, &result.cpu_seconds, sizeof(result.cpu_seconds)) ||
+        !writeAll(fd, &result.wall_seconds, sizeof(result.wall_seconds)) ||
+        !writeAll(fd, &result.peak_rss_kb, sizeof(result.peak_rss_kb)) ||
+        !writeVector(fd, result.latencies_ms)) {
+        return false;
+    }
+    for (const auto& detections : result.detections) {
+        if (!writeVector(fd, detections)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool receiveResult(int fd, size_t frame_count, VariantResult& result) {
+    if (!readAll(fd, &result.load_ms, sizeof(result.load_ms)) ||
+        !readAll(fd, &result.cpu_seconds, sizeof(result.cpu_seconds)) ||
+        !readAll(fd, &result.wall_seconds, sizeof(result.wall_seconds)) ||
+        !readAll(fd, &result.peak_rss_kb, sizeof(result.peak_rss_kb)) ||
+        !readVector(fd, result.latencies_ms)) {
+        return false;
+    }
+    result.detections.resize(frame_count);
+    result.total_detections = 0;
+    for (auto& detections : result.detections) {
+        if (!readVector(fd, detections)) {
+            return false;
+        }
+        result.total_detections += detections.size();
+    }
+    return true;
+}
+
+// 변형 하나를 자식 프로세스에서 측정하고 결과를 파이프로 받아옴
+// 같은 프로세스에서 이어서 돌리면 앞 변형이 남긴 플러그인/할당자 메모리 때문에 RSS 를 비교할 수 없음
+static VariantResult runVariantIsolated(const InferenceConfig& base_config, const Variant& variant,
+                                        const std::vector<Frame>& frames, int width, int height) {
+    VariantResult result;
+    result.variant = variant;
+    result.ok = false;
+    result.total_detections = 0;
+
+    int fds[2];
+    if (pipe(fds) < 0) {
+        std::cerr << "[ERROR] Failed to create result pipe" << std::endl;
+        return result;
+    }
+    // 버퍼에 남은 출력이 자식에서 한 번 더 찍히지 않도록
+    std::cout.flush();
+    std::cerr.flush();
+    pid_t pid = fork();
+    if (pid < 0) {
+        std::cerr << "[ERROR] Failed to fork benchmark process" << std::endl;
+        close(fds[0]);
+        close(fds[1]);
+        return result;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        VariantResult child = runVariant(base_config, variant, frames, width, height);
+        bool sent = child.ok && sendResult(fds[1], child);
+        close(fds[1]);
+        std::cout.flush();
+        std::cerr.flush();
+        _exit(sent ? 0 : 1);
+    }
+
+    close(fds[1]);
+    bool received = receiveResult(fds[0], frames.size(), result);
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    result.ok = received && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <frames_dir> [PRECISION:SIZE ...] [--config file] [--max-frames N]" << std::endl;
+        return -1;
+    }
+
+    std::string frames_dir = argv[1];
+    std::string config_file = "config.json";
+    size_t max_frames = 500;
+    std::vector<Variant> variants;
+
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--config" && i + 1 < argc) {
+            config_file = argv[++i];
+        } else if (arg == "--max-frames" && i + 1 < argc) {
+            max_frames = std::stoul(argv[++i]);
+        } else {
+            size_t colon = arg.find(':');
+            if (colon == std::string::npos) {
+                std::cerr << "[ERROR] Invalid variant: " << arg << " (expected PRECISION:SIZE)" << std::endl;
+                return -1;
+            }
+            variants.push_back({arg.substr(0, colon), std::stoi(arg.substr(colon + 1))});
+        }
+    }
+    if (variants.empty()) {
+        for (int size : {320, 416, 640}) {
+            for (const char* precision : {"FP32", "FP16", "INT8"}) {
+                variants.push_back({precision, size});
+            }
+        }
+    }
+
+    ConfigManager config_manager;
+    if (!config_manager.loadFromFile(config_file)) {
+        std::cerr << "[WARN] Failed to load config file, using default settings" << std::endl;
+    }
+
+    int width, height;
+    std::vector<Frame> frames;
+    if (!loadFrames(frames_dir, max_frames, width, height, frames)) {
+        std::cerr << "[FATAL] No frames loaded from " << frames_dir << std::endl;
+        return -1;
+    }
+    std::cout << "[INFO] Loaded " << frames.size() << " frames (" << width << "x" << height << ")" << std::endl;
+    long base_rss_kb = readStatusKb("VmRSS:");
+
+    std::vector<VariantResult> results;
+    for (const auto& variant : variants) {
+        std::cout << "[INFO] Benchmarking " << variant.precision << " " << variant.input_size << "..." << std::endl;
+        results.push_back(runVariantIsolated(config_manager.getInferenceConfig(), variant, frames, width, height));
+        if (!results.back().ok) {
+            std::cerr << "[WARN] Variant " << variant.precision << ":" << variant.input_size << " failed" << std::endl;
+        }
+    }
+
+    // 입력 크기별 FP32 기준
+    std::map<int, const VariantResult*> baselines;
+    for (const auto& result : results) {
+        if (result.ok && result.variant.precision == "FP32") {
+            baselines[result.variant.input_size] = &result;
+        }
+    }
+
+    std::cout << std::endl;
+    std::cout << std::left << std::setw(12) << "Variant"
+              << std::right << std::setw(10) << "Load(ms)" << std::setw(9) << "p50" << std::setw(9) << "p90"
+              << std::setw(9) << "p99" << std::setw(9) << "FPS" << std::setw(10) << "FPS/core"
+              << std::setw(10) << "Peak(MB)" << std::setw(8) << "Dets" << std::setw(10) << "Recall"
+              << std::setw(10) << "Precis." << std::setw(8) << "F1" << std::endl;
+
+    for (const auto& result : results) {
+        std::string name = result.variant.precision + ":" + std::to_string(result.variant.input_size);
+        std::cout << std::left << std::setw(12) << name << std::right;
+        if (!result.ok) {
+            std::cout << "  (failed)" << std::endl;
+            continue;
+        }
+
+        double fps = result.latencies_ms.size() / result.wall_seconds;
+        double fps_per_core = result.cpu_seconds > 0.0 ? result.latencies_ms.size() / result.cpu_seconds : 0.0;
+        std::cout << std::fixed << std::setprecision(1)
+                  << std::setw(10) << result.load_ms
+                  << std::setw(9) << percentile(result.latencies_ms, 0.50)
+                  << std::setw(9) << percentile(result.latencies_ms, 0.90)
+                  << std::setw(9) << percentile(result.latencies_ms, 0.99)
+                  << std::setw(9) << fps
+                  << std::setw(10) << fps_per_core
+                  << std::setw(10) << result.peak_rss_kb / 1024.0
+                  << std::setw(8) << result.total_detections;
+
+        auto baseline = baselines.find(result.variant.input_size);
+        if (baseline == baselines.end()) {
+            std::cout << std::setw(10) << "-" << std::setw(10) << "-" << std::setw(8) << "-" << std::endl;
+            continue;
+        }
+
+        size_t matches = 0, baseline_count = 0;
+        for (size_t i = 0; i < result.detections.size(); ++i) {
+            matches += countMatches(baseline->second->detections[i], result.detections[i]);
+            baseline_count += baseline->second->detections[i].size();
+        }
+        double recall = baseline_count ? 1.0 * matches / baseline_count : 1.0;
+        double precision = result.total_detections ? 1.0 * matches / result.total_detections : 1.0;
+        double f1 = (recall + precision) > 0.0 ? 2.0 * recall * precision / (recall + precision) : 0.0;
+        std::cout << std::setprecision(3) << std::setw(10) << recall << std::setw(10) << precision
+                  << std::setw(8) << f1 << std::endl;
+    }
+
+    std::cout << std::endl << "FPS/core = frames / process CPU seconds, Peak = peak resident memory (VmHWM) of the variant's "
+              << "own process while compiling and running, including " << std::setprecision(1) << base_rss_kb / 1024.0
+              << " MB of loaded frames shared by every variant" << std::endl;
+    return 0;
+}
@@ -0,0 +1,838 @@
+/*
+
+※ How to Compile
+
+make offline_analyzer
+
+※ Usage
+
+./offline_analyzer [--config config.json] [--jobs N] [--decode-share F] [--chunk-frames N] [--raw WxH:FORMAT]
+                   [--fps N] [--max-frames N] [--output detections.cdet] <file> [file ...]
+
+- file : 녹화 파일. record 단계가 기록한 캡처 컨테이너(.craw)는 헤더의 형식대로 mmap 해서 읽고,
+         그 외는 GStreamer decodebin 으로 디코딩 (H.264/H.265 MP4, MKV 등)
+- --raw WxH:FORMAT : 헤더 없는 프레임 덤프로 읽음 (예: 1920x1080:YUV420, FORMAT 은 BGR888/RGB888/YUV420)
+- --jobs N : 동시에 처리할 작업 수 (기본 코어 수 / 2). 작업마다 코어 수 / N 개를 디코더와 검출기가 나눠 씀
+- --decode-share F : 디코딩할 입력이 있을 때 작업별 코어 중 디코더 스레드 몫 (0~1, 기본 0.25, 최소 1 스레드).
+                     나머지는 검출기 스레드 (inference.threads 를 지정하면 그 값을 쓰고 디코더는 남은 코어)
+- --chunk-frames N : 캡처 컨테이너와 raw 파일을 N 프레임 구간으로 나눠 병렬 처리 (구간마다 추적기 상태와 트랙 ID 가 새로 시작됨)
+- --fps N : 모션 keep-alive 주기 계산에 쓰는 녹화 fps (기본: 디코딩한 스트림의 fps, 없으면 video.fps)
+- --max-frames N : 작업마다 처리할 최대 프레임 수 (빠른 확인용)
+- 라이브 파이프라인과 같은 설정(motion, inference, tracker)으로 모션 → 검출 → 추적을 실행하고
+  결과를 압축된 바이너리 파일(--output)로 저장한 뒤 작업별/전체 fps 와 전체 fps/core 를 출력
+
+※ Output Format (little-endian)
+
+header : char[4] "CDET", uint16 version(1), uint16 reserved, uint32 block_count
+block  : uint16 name_length, char[name_length] name, uint16 width, uint16 height,
+         uint32 first_frame, uint32 frame_count, uint32 record_count, record[record_count]
+record : uint32 frame (블록 안의 번호, 파일 기준은 first_frame + frame), int32 track_id (-1 이면 추적기 없이 검출만), uint16 x, y, width, height (프레임 크기 대비 0..65535),
+         uint16 class_id, uint16 score (0..65535) = 20 bytes
+
+*/
+
+#include "ConfigManager.h"
+#include "MotionDetector.h"
+#include "ObjectDetector.h"
+#include "ObjectTracker.h"
+#include "RawCapture.h"
+
+#include <gst/gst.h>
+#include <gst/app/gstappsink.h>
+#include <gst/video/video.h>
+
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono;
+
+// 검출 결과 한 건 (출력 파일 레코드)
+struct DetectionRecord {
+    uint32_t frame;
+    int32_t track_id;
+    uint16_t x;
+    uint16_t y;
+    uint16_t width;
+    uint16_t height;
+    uint16_t class_id;
+    uint16_t score;
+};
+static_assert(sizeof(DetectionRecord) == 20, "DetectionRecord must stay packed");
+
+struct RawFormat {
+    int width;
+    int height;
+    std::string pixel_format;
+    size_t frame_size;
+};
+
+struct Options {
+    std::string config_path = "config.json";
+    std::string output_path = "detections.cdet";
+    int jobs = 0;
+    double decode_share = 0.25;     // 디코딩 입력이 있을 때 작업별 코어 중 디코더 몫
+    uint64_t chunk_frames = 0;
+    uint64_t max_frames = 0;
+    double fps = 0.0;
+    bool raw = false;
+    RawFormat raw_format = {0, 0, "", 0};
+    int inference_threads = 0;      // 작업 하나의 검출기 스레드 수
+    int decoder_threads = 0;        // 작업 하나의 디코더 스레드 수
+};
+
+enum class InputKind {
+    Decoded,
+    Raw,
+    Capture
+};
+
+// 처리 단위: 파일 전체 또는 캡처 컨테이너/raw 파일의 프레임 구간
+struct Job {
+    InputKind kind;
+    std::string path;
+    std::string name;
+    uint64_t first_frame;
+    uint64_t frame_count;   // 0 이면 파일 끝까지
+};
+
+struct JobResult {
+    bool ok;
+    int width;
+    int height;
+    uint64_t frames;
+    uint64_t inferences;
+    double wall_seconds;
+    std::vector<DetectionRecord> records;
+};
+
+static double cpuSeconds(int who) {
+    rusage usage;
+    getrusage(who, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+static bool hasProperty(GstElement* element, const char* name) {
+    return g_object_class_find_property(G_OBJECT_GET_CLASS(element), name) != nullptr;
+}
+
+// "1920x1080:YUV420" 파싱
+static bool parseRawFormat(const std::string& text, RawFormat& format) {
+    size_t x = text.find('x');
+    size_t colon = text.find(':');
+    if (x == std::string::npos || colon == std::string::npos || colon < x) {
+        return false;
+    }
+    try {
+        format.width = std::stoi(text.substr(0, x));
+        format.height = std::stoi(text.substr(x + 1, colon - x - 1));
+    } catch (const std::exception&) {
+        return false;
+    }
+    format.pixel_format = text.substr(colon + 1);
+    if (format.width <= 0 || format.height <= 0) {
+        return false;
+    }
+    size_t pixels = static_cast<size_t>(format.width) * format.height;
+    if (format.pixel_format == "BGR888" || format.pixel_format == "RGB888") {
+        format.frame_size = pixels * 3;
+    } else if (format.pixel_format == "YUV420" && format.width % 2 == 0 && format.height % 2 == 0) {
+        format.frame_size = pixels + pixels / 2;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static uint16_t normalize(float value, int extent) {
+    float scaled = value / extent * 65535.0f;
+    return static_cast<uint16_t>(std::min(std::max(scaled, 0.0f), 65535.0f) + 0.5f);
+}
+
+static DetectionRecord makeRecord(uint32_t frame, int32_t track_id, float x, float y, float width, float height,
+                                  int class_id, float score, int frame_width, int frame_height) {
+    DetectionRecord record;
+    record.frame = frame;
+    record.track_id = track_id;
+    record.x = normalize(x, frame_width);
+    record.y = normalize(y, frame_height);
+    record.width = normalize(width, frame_width);
+    record.height = normalize(height, frame_height);
+    record.class_id = static_cast<uint16_t>(std::max(class_id, 0));
+    record.score = normalize(score, 1);
+    return record;
+}
+
+// 프레임 공급원. next 가 채운 픽셀은 다음 next 호출 전까지 유효
+class FrameReader {
+public:
+    virtual ~FrameReader() = default;
+
+    // 다음 프레임 (끝이거나 읽기 실패면 false, 실패는 failed() 로 구분)
+    virtual bool next(FrameData& frame) = 0;
+    virtual bool failed() const = 0;
+    virtual const std::string& pixelFormat() const = 0;
+    virtual double frameRate() const = 0;
+};
+
+// 헤더 없는 프레임 덤프. 파일을 mmap 해서 복사 없이 프레임 포인터만 넘김
+class RawReader : public FrameReader {
+private:
+    RawFormat format_;
+    uint8_t* map_;
+    size_t map_size_;
+    uint64_t index_;
+    uint64_t end_;
+
+public:
+    explicit RawReader(const RawFormat& format) : format_(format), map_(nullptr), map_size_(0), index_(0), end_(0) {}
+
+    ~RawReader() override {
+        if (map_) {
+            munmap(map_, map_size_);
+        }
+    }
+
+    bool open(const std::string& path, uint64_t first_frame, uint64_t frame_count) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "[ERROR] Cannot open " << path << ": " << strerror(errno) << std::endl;
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            std::cerr << "[ERROR] Cannot read size of " << path << std::endl;
+            ::close(fd);
+            return false;
+        }
+        map_size_ = static_cast<size_t>(st.st_size);
+        void* map = mmap(nullptr, map_size_, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) {
+            std::cerr << "[ERROR] Cannot map " << path << ": " << strerror(errno) << std::endl;
+            map_size_ = 0;
+            return false;
+        }
+        map_ = static_cast<uint8_t*>(map);
+
+        uint64_t total = map_size_ / format_.frame_size;
+        index_ = std::min(first_frame, total);
+        end_ = frame_count > 0 ? std::min(total, first_frame + frame_count) : total;
+        // 맡은 구간만 순차로 미리 읽게 함
+        madvise(map_ + index_ * format_.frame_size, (end_ - index_) * format_.frame_size, MADV_SEQUENTIAL);
+        return true;
+    }
+
+    bool next(FrameData& frame) override {
+        if (index_ >= end_) {
+            return false;
+        }
+        size_t pixels = static_cast<size_t>(format_.width) * format_.height;
+        frame.data = map_ + index_ * format_.frame_size;
+        frame.size = format_.frame_size;
+        frame.buffer_index = 0;
+        frame.width = format_.width;
+        frame.height = format_.height;
+        frame.offsets[0] = 0;
+        if (format_.pixel_format == "YUV420") {
+            frame.num_planes = 3;
+            frame.strides[0] = format_.width;
+            frame.strides[1] = frame.strides[2] = format_.width / 2;
+            frame.offsets[1] = pixels;
+            frame.offsets[2] = pixels + pixels / 4;
+        } else {
+            frame.num_planes = 1;
+            frame.strides[0] = format_.width * 3;
+        }
+        frame.sequence = static_cast<uint32_t>(index_);
+        frame.timestamp_ns = 0;
+        frame.duration_ns = 0;
+        index_++;
+        return true;
+    }
+
+    bool failed() const override { return false; }
+    const std::string& pixelFormat() const override { return format_.pixel_format; }
+    double frameRate() const override { return 0.0; }
+};
+
+// 캡처 컨테이너 (record 단계 기록). 크기/형식/평면 배치는 헤더에서 읽고 매핑된 슬롯을 그대로 넘김
+class CaptureReader : public FrameReader {
+private:
+    RawCaptureFile file_;
+    uint64_t index_;
+    uint64_t end_;
+
+public:
+    CaptureReader() : index_(0), end_(0) {}
+
+    bool open(const std::string& path, uint64_t first_frame, uint64_t frame_count) {
+        if (!file_.open(path)) {
+            return false;
+        }
+        uint64_t total = file_.frameCount();
+        index_ = std::min(first_frame, total);
+        end_ = frame_count > 0 ? std::min(total, first_frame + frame_count) : total;
+        return true;
+    }
+
+    bool next(FrameData& frame) override {
+        // 다 본 슬롯은 놓고 앞 슬롯을 미리 읽어 구간이 길어도 상주 메모리가 늘지 않게 함
+        if (index_ > 0) {
+            file_.release(index_ - 1);
+        }
+        if (index_ >= end_) {
+            return false;
+        }
+        file_.frame(index_, frame);
+        file_.prefetch(index_ + 4, 1);
+        index_++;
+        return true;
+    }
+
+    bool failed() const override { return false; }
+    const std::string& pixelFormat() const override { return file_.pixelFormat(); }
+    double frameRate() const override { return file_.header().fps; }
+};
+
+// 압축된 녹화 파일. decodebin 으로 디코딩해 BGR888 프레임을 appsink 에서 당겨 옴 (sync=false 로 최대 속도)
+class DecodeReader : public FrameReader {
+private:
+    GstElement* pipeline_;
+    GstElement* sink_;
+    GstSample* sample_;
+    GstVideoFrame video_frame_;
+    bool mapped_;
+    bool failed_;
+    GstVideoInfo info_;
+    bool has_info_;
+    uint32_t sequence_;
+    int decoder_threads_;
+    std::string pixel_format_;
+
+    // libav 디코더는 기본으로 코어 수만큼 스레드를 띄우므로 병렬 작업끼리 코어를 나눠 쓰게 제한
+    static void onDeepElementAdded(GstBin*, GstBin*, GstElement* element, gpointer user_data) {
+        DecodeReader* self = static_cast<DecodeReader*>(user_data);
+        if (hasProperty(element, "max-threads")) {
+            g_object_set(element, "max-threads", self->decoder_threads_, NULL);
+        }
+    }
+
+    void releaseFrame() {
+        if (mapped_) {
+            gst_video_frame_unmap(&video_frame_);
+            mapped_ = false;
+        }
+        if (sample_) {
+            gst_sample_unref(sample_);
+            sample_ = nullptr;
+        }
+    }
+
+    void reportError() {
+        GstBus* bus = gst_element_get_bus(pipeline_);
+        GstMessage* message = gst_bus_pop_filtered(bus, GST_MESSAGE_ERROR);
+        if (message) {
+            GError* error = nullptr;
+            gchar* debug = nullptr;
+            gst_message_parse_error(message, &error, &debug);
+            std::cerr << "[ERROR] Decoding failed: " << (error ? error->message : "unknown error") << std::endl;
+            g_clear_error(&error);
+            g_free(debug);
+            gst_message_unref(message);
+        } else {
+            std::cerr << "[ERROR] Decoding stopped before end of stream" << std::endl;
+        }
+        gst_object_unref(bus);
+    }
+
+public:
+    explicit DecodeReader(int decoder_threads)
+        : pipeline_(nullptr), sink_(nullptr), sample_(nullptr), mapped_(false), failed_(false), has_info_(false),
+          sequence_(0), decoder_threads_(decoder_threads), pixel_format_("BGR888") {
+        gst_video_info_init(&info_);
+    }
+
+    ~DecodeReader() override {
+        releaseFrame();
+        if (pipeline_) {
+            gst_element_set_state(pipeline_, GST_STATE_NULL);
+        }
+        if (sink_) {
+            gst_object_unref(sink_);
+        }
+        if (pipeline_) {
+            gst_object_unref(pipeline_);
+        }
+    }
+
+    bool open(const std::string& path) {
+        GError* error = nullptr;
+        pipeline_ = gst_parse_launch("filesrc name=src ! decodebin ! videoconvert ! video/x-raw,format=BGR ! "
+                                     "appsink name=sink sync=false max-buffers=4",
+                                     &error);
+        if (!pipeline_) {
+            std::cerr << "[ERROR] Failed to create decode pipeline: " << (error ? error->message : "unknown")
+                      << std::endl;
+            g_clear_error(&error);
+            return false;
+        }
+        GstElement* src = gst_bin_get_by_name(GST_BIN(pipeline_), "src");
+        g_object_set(src, "location", path.c_str(), NULL);
+        gst_object_unref(src);
+        sink_ = gst_bin_get_by_name(GST_BIN(pipeline_), "sink");
+        if (decoder_threads_ > 0) {
+            g_signal_connect(pipeline_, "deep-element-added", G_CALLBACK(onDeepElementAdded), this);
+        }
+
+        if (gst_element_set_state(pipeline_, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+            reportError();
+            return false;
+        }
+        return true;
+    }
+
+    bool next(FrameData& frame) override {
+        releaseFrame();
+        sample_ = gst_app_sink_pull_sample(GST_APP_SINK(sink_));
+        if (!sample_) {
+            // EOS 가 아니면 파이프라인 에러
+            if (!gst_app_sink_is_eos(GST_APP_SINK(sink_))) {
+                failed_ = true;
+                reportError();
+            }
+            return false;
+        }
+        if (!has_info_) {
+            has_info_ = gst_video_info_from_caps(&info_, gst_sample_get_caps(sample_));
+            if (!has_info_) {
+                std::cerr << "[ERROR] Decoded caps are not raw video" << std::endl;
+                failed_ = true;
+                return false;
+            }
+        }
+        GstBuffer* buffer = gst_sample_get_buffer(sample_);
+        if (!buffer || !gst_video_frame_map(&video_frame_, &info_, buffer, GST_MAP_READ)) {
+            failed_ = true;
+            return false;
+        }
+        mapped_ = true;
+
+        // 디코더가 행 끝을 정렬해 둔 경우가 있으므로 stride 는 비디오 메타에서 가져옴
+        frame.data = GST_VIDEO_FRAME_PLANE_DATA(&video_frame_, 0);
+        frame.size = GST_VIDEO_INFO_SIZE(&info_);
+        frame.buffer_index = 0;
+        frame.width = GST_VIDEO_INFO_WIDTH(&info_);
+        frame.height = GST_VIDEO_INFO_HEIGHT(&info_);
+        frame.num_planes = 1;
+        frame.offsets[0] = 0;
+        frame.strides[0] = GST_VIDEO_FRAME_PLANE_STRIDE(&video_frame_, 0);
+        frame.sequence = sequence_++;
+        frame.timestamp_ns = GST_BUFFER_PTS(buffer);
+        frame.duration_ns = GST_BUFFER_DURATION_IS_VALID(buffer) ? GST_BUFFER_DURATION(buffer) : 0;
+        return true;
+    }
+
+    bool failed() const override { return failed_; }
+    const std::string& pixelFormat() const override { return pixel_format_; }
+
+    double frameRate() const override {
+        if (!has_info_ || GST_VIDEO_INFO_FPS_D(&info_) == 0) {
+            return 0.0;
+        }
+        return static_cast<double>(GST_VIDEO_INFO_FPS_N(&info_)) / GST_VIDEO_INFO_FPS_D(&info_);
+    }
+};
+
+// 작업 스레드 하나의 분석기. 검출기는 모델 컴파일 비용 때문에 작업 사이에 재사용
+class Analyzer {
+private:
+    const ConfigManager& config_;
+    const Options& options_;
+    ObjectDetector detector_;
+    int configured_width_;
+    int configured_height_;
+    int configured_stride_;
+    std::string configured_format_;
+
+public:
+    Analyzer(const ConfigManager& config, const Options& options, const InferenceConfig& inference_config)
+        : config_(config), options_(options), detector_(inference_config), configured_width_(0),
+          configured_height_(0), configured_stride_(0) {}
+
+    bool initialize() { return detector_.initialize(); }
+
+    JobResult run(const Job& job) {
+        JobResult result = {false, 0, 0, 0, 0, 0.0, {}};
+        auto wall_start = steady_clock::now();
+
+        std::unique_ptr<FrameReader> reader;
+        if (job.kind == InputKind::Capture) {
+            std::unique_ptr<CaptureReader> capture(new CaptureReader());
+            if (!capture->open(job.path, job.first_frame, job.frame_count)) {
+                return result;
+            }
+            reader = std::move(capture);
+        } else if (job.kind == InputKind::Raw) {
+            std::unique_ptr<RawReader> raw(new RawReader(options_.raw_format));
+            if (!raw->open(job.path, job.first_frame, job.frame_count)) {
+                return result;
+            }
+            reader = std::move(raw);
+        } else {
+            std::unique_ptr<DecodeReader> decoded(new DecodeReader(options_.decoder_threads));
+            if (!decoded->open(job.path)) {
+                return result;
+            }
+            reader = std::move(decoded);
+        }
+
+        // 라이브 그래프와 같은 설정. 추적기는 구간마다 새로 시작
+        const MotionConfig& motion_config = config_.getMotionConfig();
+        const InferenceConfig& inference_config = config_.getInferenceConfig();
+        const TrackerConfig& tracker_config = config_.getTrackerConfig();
+        std::unique_ptr<MotionDetector> motion;
+        std::unique_ptr<ObjectTracker> tracker;
+        if (tracker_config.enabled) {
+            tracker.reset(new ObjectTracker(tracker_config));
+        }
+        int frame_interval = std::max(inference_config.frame_interval, 1);
+        uint64_t keepalive_frames = UINT64_MAX;
+        int frames_since_inference = frame_interval;
+        uint64_t frames_since_keepalive = 0;
+        std::vector<Detection> detections;
+
+        FrameData frame;
+        while ((options_.max_frames == 0 || result.frames < options_.max_frames) && reader->next(frame)) {
+            if (result.frames == 0) {
+                if (frame.width != configured_width_ || frame.height != configured_height_ ||
+                    frame.strides[0] != configured_stride_ || reader->pixelFormat() != configured_format_) {
+                    if (!detector_.configure(frame.width, frame.height, frame.strides[0], reader->pixelFormat())) {
+                        configured_width_ = 0;
+                        return result;
+                    }
+                    configured_width_ = frame.width;
+                    configured_height_ = frame.height;
+                    configured_stride_ = frame.strides[0];
+                    configured_format_ = reader->pixelFormat();
+                } else {
+                    // 같은 크기의 이전 구간이 남긴 타일 결과가 이번 구간 첫 검출에 섞이지 않도록
+                    detector_.reset();
+                }
+                if (motion_config.enabled) {
+                    motion.reset(new MotionDetector(motion_config));
+                    if (!motion->configure(frame.width, frame.height, frame.strides[0], reader->pixelFormat())) {
+                        return result;
+                    }
+                }
+                // keep-alive 는 실시간 주기 대신 녹화 fps 기준 프레임 수로 셈
+                double fps = options_.fps > 0.0 ? options_.fps : reader->frameRate();
+                if (fps <= 0.0) {
+                    fps = config_.getVideoConfig().fps;
+                }
+                if (motion_config.keepalive_fps > 0.0) {
+                    keepalive_frames = static_cast<uint64_t>(std::max(fps / motion_config.keepalive_fps, 1.0));
+                    frames_since_keepalive = keepalive_frames;
+                }
+                result.width = frame.width;
+                result.height = frame.height;
+            }
+
+            uint32_t index = static_cast<uint32_t>(result.frames);
+            bool motion_active = !motion || motion->process(frame);
+            frames_since_inference++;
+            frames_since_keepalive++;
+            if (frames_since_inference >= frame_interval && (motion_active || frames_since_keepalive >= keepalive_frames)) {
+                if (motion) {
+                    detector_.setMotionRegions(motion->getRegions());
+                }
+                if (detector_.detect(frame, detections)) {
+                    result.inferences++;
+                    frames_since_inference = 0;
+                    frames_since_keepalive = 0;
+                    if (tracker) {
+                        tracker->submitDetections(detections);
+                    } else {
+                        for (const Detection& d : detections) {
+                            result.records.push_back(makeRecord(index, -1, d.x, d.y, d.width, d.height, d.class_id,
+                                                                d.score, frame.width, frame.height));
+                        }
+                    }
+                }
+            }
+            if (tracker) {
+                for (const TrackedObject& t : tracker->step()) {
+                    if (t.confirmed) {
+                        result.records.push_back(makeRecord(index, t.id, t.x, t.y, t.width,
+                                                            t.height, t.class_id, t.score, frame.width,
+                                                            frame.height));
+                    }
+                }
+            }
+            result.frames++;
+        }
+
+        result.ok = !reader->failed() && result.frames > 0;
+        if (result.frames == 0 && !reader->failed()) {
+            std::cerr << "[ERROR] " << job.name << ": no frames" << std::endl;
+        }
+        result.wall_seconds = duration<double>(steady_clock::now() - wall_start).count();
+        return result;
+    }
+};
+
+template <typename T>
+static void writeValue(std::ofstream& out, T value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static bool writeResults(const std::string& path, const std::vector<Job>& jobs, const std::vector<JobResult>& results) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "[ERROR] Cannot write " << path << std::endl;
+        return false;
+    }
+    uint32_t blocks = static_cast<uint32_t>(std::count_if(results.begin(), results.end(),
+                                                          [](const JobResult& r) { return r.ok; }));
+    out.write("CDET", 4);
+    writeValue<uint16_t>(out, 1);
+    writeValue<uint16_t>(out, 0);
+    writeValue<uint32_t>(out, blocks);
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        const JobResult& result = results[i];
+        if (!result.ok) {
+            continue;
+        }
+        const std::string& name = jobs[i].name;
+        writeValue<uint16_t>(out, static_cast<uint16_t>(name.size()));
+        out.write(name.data(), name.size());
+        writeValue<uint16_t>(out, static_cast<uint16_t>(result.width));
+        writeValue<uint16_t>(out, static_cast<uint16_t>(result.height));
+        writeValue<uint32_t>(out, static_cast<uint32_t>(jobs[i].first_frame));
+        writeValue<uint32_t>(out, static_cast<uint32_t>(result.frames));
+        writeValue<uint32_t>(out, static_cast<uint32_t>(result.records.size()));
+        out.write(reinterpret_cast<const char*>(result.records.data()),
+                  result.records.size() * sizeof(DetectionRecord));
+    }
+    return out.good();
+}
+
+static std::string baseName(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+// 캡처 컨테이너와 raw 파일은 프레임 구간으로 나누고, 압축 파일은 파일 하나가 작업 하나
+static bool planJobs(const std::vector<std::string>& inputs, const Options& options, std::vector<Job>& jobs) {
+    for (const std::string& path : inputs) {
+        uint64_t total = 0;
+        InputKind kind = InputKind::Decoded;
+        if (RawCaptureFile::isRawCapture(path)) {
+            RawCaptureFile file;
+            if (!file.open(path)) {
+                return false;
+            }
+            kind = InputKind::Capture;
+            total = file.frameCount();
+        } else if (options.raw) {
+            struct stat st;
+            if (stat(path.c_str(), &st) != 0) {
+                std::cerr << "[ERROR] Cannot open " << path << std::endl;
+                return false;
+            }
+            kind = InputKind::Raw;
+            total = static_cast<uint64_t>(st.st_size) / options.raw_format.frame_size;
+            if (static_cast<uint64_t>(st.st_size) % options.raw_format.frame_size != 0) {
+                std::cerr << "[WARN] " << path << " is not a whole number of " << options.raw_format.frame_size
+                          << "-byte frames, ignoring the tail" << std::endl;
+            }
+        } else {
+            jobs.push_back({kind, path, baseName(path), 0, 0});
+            continue;
+        }
+        if (total == 0) {
+            std::cerr << "[ERROR] " << path << " holds no complete frame" << std::endl;
+            return false;
+        }
+        uint64_t chunk = options.chunk_frames > 0 ? options.chunk_frames : total;
+        for (uint64_t first = 0; first < total; first += chunk) {
+            uint64_t count = std::min(chunk, total - first);
+            std::string name = baseName(path);
+            if (chunk < total) {
+                name += "#" + std::to_string(first) + "-" + std::to_string(first + count - 1);
+            }
+            jobs.push_back({kind, path, name, first, count});
+        }
+    }
+    return true;
+}
+
+static void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--config config.json] [--jobs N] [--decode-share F] [--chunk-frames N]"
+              << " [--raw WxH:FORMAT] [--fps N] [--max-frames N] [--output detections.cdet] <file> [file ...]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    std::vector<std::string> inputs;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--config" && has_value) {
+            options.config_path = argv[++i];
+        } else if (arg == "--output" && has_value) {
+            options.output_path = argv[++i];
+        } else if (arg == "--jobs" && has_value) {
+            options.jobs = std::atoi(argv[++i]);
+        } else if (arg == "--decode-share" && has_value) {
+            options.decode_share = std::atof(argv[++i]);
+            if (options.decode_share < 0.0 || options.decode_share > 1.0) {
+                std::cerr << "[ERROR] --decode-share must be between 0 and 1" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--chunk-frames" && has_value) {
+            options.chunk_frames = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--max-frames" && has_value) {
+            options.max_frames = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--fps" && has_value) {
+            options.fps = std::atof(argv[++i]);
+        } else if (arg == "--raw" && has_value) {
+            options.raw = true;
+            if (!parseRawFormat(argv[++i], options.raw_format)) {
+                std::cerr << "[ERROR] Invalid raw format: " << argv[i]
+                          << " (expected WxH:FORMAT, FORMAT is BGR888, RGB888 or YUV420)" << std::endl;
+                return 1;
+            }
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            printUsage(argv[0]);
+            return 1;
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+    if (inputs.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    ConfigManager config_manager;
+    if (!config_manager.loadFromFile(options.config_path)) {
+        std::cerr << "[WARN] Failed to load config file, using default settings" << std::endl;
+    }
+
+    std::vector<Job> jobs;
+    if (!planJobs(inputs, options, jobs)) {
+        return 1;
+    }
+
+    // 작업 수만큼 검출기를 띄우고 코어를 나눠 줌 (각 검출기가 코어 전체를 쓰려 하면 서로 밀어냄)
+    // 디코더와 검출기는 같은 작업 안에서 동시에 돌므로 작업별 코어 몫 하나를 둘이 나눔
+    int cores = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+    if (options.jobs <= 0) {
+        options.jobs = std::max(cores / 2, 1);
+    }
+    options.jobs = std::min(options.jobs, static_cast<int>(jobs.size()));
+    int job_cores = std::max(cores / options.jobs, 1);
+    bool has_decoded = std::any_of(jobs.begin(), jobs.end(), [](const Job& job) { return job.kind == InputKind::Decoded; });
+    InferenceConfig inference_config = config_manager.getInferenceConfig();
+    if (!has_decoded) {
+        options.decoder_threads = 0;
+        options.inference_threads = inference_config.threads > 0 ? inference_config.threads : job_cores;
+    } else if (inference_config.threads > 0) {
+        options.inference_threads = inference_config.threads;
+        options.decoder_threads = std::max(job_cores - options.inference_threads, 1);
+    } else {
+        options.decoder_threads = std::max(static_cast<int>(job_cores * options.decode_share + 0.5), 1);
+        options.inference_threads = std::max(job_cores - options.decoder_threads, 1);
+    }
+    inference_config.threads = options.inference_threads;
+
+    if (has_decoded) {
+        gst_init(&argc, &argv);
+    }
+
+    std::cout << "[INFO] " << jobs.size() << " jobs from " << inputs.size() << " files on " << options.jobs
+              << " workers (" << options.inference_threads << " inference + " << options.decoder_threads
+              << " decoder threads each, " << cores << " cores)" << std::endl;
+
+    std::vector<JobResult> results(jobs.size());
+    std::atomic<size_t> next_job(0);
+    std::atomic<bool> init_failed(false);
+    double cpu_start = cpuSeconds(RUSAGE_SELF);
+    auto wall_start = steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (int w = 0; w < options.jobs; ++w) {
+        workers.emplace_back([&]() {
+            Analyzer analyzer(config_manager, options, inference_config);
+            if (!analyzer.initialize()) {
+                init_failed = true;
+                return;
+            }
+            for (size_t index = next_job++; index < jobs.size(); index = next_job++) {
+                results[index] = analyzer.run(jobs[index]);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    double wall_seconds = duration<double>(steady_clock::now() - wall_start).count();
+    double cpu_seconds = cpuSeconds(RUSAGE_SELF) - cpu_start;
+    if (init_failed) {
+        std::cerr << "[ERROR] Detector initialization failed" << std::endl;
+        return 1;
+    }
+
+    std::cout << std::endl << std::fixed << std::setprecision(1);
+    std::cout << std::left << std::setw(32) << "Job" << std::right << std::setw(10) << "Frames" << std::setw(8)
+              << "Infer" << std::setw(10) << "Wall(s)" << std::setw(9) << "FPS" << std::setw(10) << "FPS/core"
+              << std::setw(9) << "Records" << std::endl;
+    uint64_t total_frames = 0;
+    size_t total_records = 0;
+    size_t failed = 0;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        const JobResult& result = results[i];
+        std::cout << std::left << std::setw(32) << jobs[i].name << std::right;
+        if (!result.ok) {
+            failed++;
+            std::cout << std::setw(10) << "failed" << std::endl;
+            continue;
+        }
+        total_frames += result.frames;
+        total_records += result.records.size();
+        std::cout << std::setw(10) << result.frames << std::setw(8) << result.inferences << std::setw(10)
+                  << result.wall_seconds << std::setw(9) << result.frames / std::max(result.wall_seconds, 1e-9)
+                  << std::setw(10) << "" << std::setw(9) << result.records.size() << std::endl;
+    }
+
+    // fps/core 는 프로세스 CPU 기준 (디코더와 OpenVINO 추론 스레드 포함). 작업들이 같은 프로세스에서 동시에 돌아
+    // 작업별로는 나눌 수 없으므로 전체만 출력
+    std::cout << std::left << std::setw(32) << "Total" << std::right << std::setw(10) << total_frames
+              << std::setw(8) << "" << std::setw(10) << wall_seconds << std::setw(9)
+              << total_frames / std::max(wall_seconds, 1e-9) << std::setw(10)
+              << total_frames / std::max(cpu_seconds, 1e-9) << std::setw(9) << total_records << std::endl;
+    std::cout << "(FPS/core is process-wide: decoding and inference threads of all jobs, " << cpu_seconds
+              << " CPU s)" << std::endl;
+
+    if (!writeResults(options.output_path, jobs, results)) {
+        return 1;
+    }
+    std::cout << "[INFO] Wrote " << total_records << " records to " << options.output_path << std::endl;
+    return failed > 0 ? 1 : 0;
+}